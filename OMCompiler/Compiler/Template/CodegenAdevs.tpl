@@ -2332,7 +2332,7 @@ case efn as EXTERNAL_FUNCTION(__) then
   // make sure the variable is named "out", doh!
   let retVar = if outVars then outDecl(retType, &varDecls /*BUFD*/)
   let &outputAlloc = buffer "" /*BUFD*/
-  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("state", &varDecls /*BUFD*/)
+  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("omc_memory_state", &varDecls /*BUFD*/)
   let callPart = extFunCall(fn, &preExp /*BUFC*/, &varDecls /*BUFD*/)
   let _ = (outVars |> var hasindex i1 fromindex 1 =>
       varInit(var, retVar, i1, &varDecls /*BUFD*/, &outputAlloc /*BUFC*/)
@@ -2427,7 +2427,7 @@ template functionBodyBoxedImpl(Absyn.Path name, list<Variable> funargs, list<Var
   let &varDecls = buffer ""
   let retVar = if outvars then tempDecl(retTypeBoxed, &varDecls)
   let funRetVar = if outvars then tempDecl(retType, &varDecls)
-  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("state", &varDecls)
+  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("omc_memory_state", &varDecls)
   let &varBox = buffer ""
   let &varUnbox = buffer ""
   let args = (funargs |> arg => funArgUnbox(arg, &varDecls, &varBox) ;separator=", ")
@@ -3301,7 +3301,7 @@ template algStmtForRange_impl(Exp range, Ident iterator, String type, String sho
 match range
 case RANGE(__) then
   let iterName = contextIteratorName(iterator, context)
-  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("state", &varDecls)
+  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("omc_memory_state", &varDecls)
   let startVar = tempDecl(type, &varDecls)
   let stepVar = tempDecl(type, &varDecls)
   let stopVar = tempDecl(type, &varDecls)
@@ -3348,7 +3348,7 @@ template algStmtForGeneric_impl(Exp exp, Ident iterator, String type,
  "The implementation of algStmtForGeneric, which is also used by daeExpReduction."
 ::=
   let iterName = contextIteratorName(iterator, context)
-  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("state", &varDecls)
+  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("omc_memory_state", &varDecls)
   let tvar = tempDecl("int", &varDecls)
   let ivar = tempDecl(type, &varDecls)
   let &preExp = buffer ""
@@ -4655,7 +4655,7 @@ template daeExpReduction(Exp exp, Context context, Text &preExp /*BUFP*/,
   let &bodyExpPre = buffer ""
   let &guardExpPre = buffer ""
   let &rangeExpPre = buffer ""
-  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("state", &varDecls /*BUFD*/)
+  let stateVar = if not acceptMetaModelicaGrammar() then tempDecl("omc_memory_state", &varDecls /*BUFD*/)
   let identType = expTypeFromExpModelica(iter.exp)
   let arrayType = expTypeFromExpArray(iter.exp)
   let arrayTypeResult = expTypeFromExpArray(r)
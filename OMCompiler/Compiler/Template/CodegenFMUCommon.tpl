@@ -59,9 +59,12 @@ match simCode
 case SIMCODE(__) then
   let modelIdentifier = modelNamePrefix(simCode)
   let pdd = providesDirectionalDerivative(simCode)
+  let fmuState = canGetAndSetFMUstate()
   <<
   <ModelExchange
-    modelIdentifier="<%modelIdentifier%>"<% if not pdd then '>' %>
+    modelIdentifier="<%modelIdentifier%>"
+    canGetAndSetFMUstate="<%fmuState%>"
+    canSerializeFMUstate="<%fmuState%>"<% if not pdd then '>' %>
     <% if pdd then 'providesDirectionalDerivative="' + pdd + '">' %>
     <%SourceFiles(sourceFiles)%>
   </ModelExchange>
@@ -92,6 +95,15 @@ case SIMCODE(__) then
   '<%result%>'
 end providesDirectionalDerivative;
 
+template canGetAndSetFMUstate()
+ "Returns true if the FMU states can be saved, restored and serialized; only the C runtime implements them"
+::=
+  match Config.simCodeTarget()
+    case "C" then "true"
+    else "false"
+  end match
+end canGetAndSetFMUstate;
+
 template fmiModelVariables(SimCode simCode, String FMUVersion)
  "Generates code for ModelVariables file for FMU target."
 ::=
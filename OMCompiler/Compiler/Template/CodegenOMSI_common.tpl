@@ -587,6 +587,7 @@ template generateInitalizationAlgSystem (SimEqSystem equationSystem, String File
       'if (<%FileNamePrefix%>_<%omsiName%>_instantiate_derivativeMatFunc_<%algSysIndex%>_OMSIFunc(algSystem->jacobian) == omsi_error){
         return omsi_error;
       }' else '' %>
+      <%generateSparsityPatternInitialization(matrix)%>
 
       /* Instantiate omsi_function_t function */
       algSystem->functions = omsu_instantiate_omsi_function (function_vars, pre_vars);
@@ -611,6 +612,37 @@ template generateInitalizationAlgSystem (SimEqSystem equationSystem, String File
 end generateInitalizationAlgSystem;
 
 
+template generateSparsityPatternInitialization (Option<DerivativeMatrix> matrix)
+"Generates code for sparsity pattern and coloring of the jacobian of an algebraic system."
+::=
+  match matrix
+  case SOME(DERIVATIVE_MATRIX(sparsity=sparsity as _::_)) then
+    let nColumns = listLength(sparsity)
+    let nNonZeros = lengthListElements(unzipSecond(sparsity))
+    let columnCount = (sparsity |> (i, rows) => listLength(rows) ;separator=", ")
+    let rowIndex = (sparsity |> (i, rows) => (rows |> row => row ;separator=", ") ;separator=", ")
+    let columnColor = (coloredCols |> colorColumns hasindex color fromindex 1 =>
+      (colorColumns |> column => 'column_color[<%column%>] = <%color%>;' ;separator="\n")
+    ;separator="\n")
+    match nNonZeros
+    case "0" then ''
+    case _ then
+    <<
+
+    /* Set sparsity pattern and coloring of jacobian */
+    {
+      const omsi_unsigned_int column_count[<%nColumns%>] = {<%columnCount%>};
+      const omsi_unsigned_int row_index[<%nNonZeros%>] = {<%rowIndex%>};
+      omsi_unsigned_int column_color[<%nColumns%>] = {0};
+      <%columnColor%>
+      algSystem->sparsity_pattern = omsu_instantiate_sparsity_pattern(<%nColumns%>, column_count, row_index, <%maxColorCols%>, column_color);
+    }
+    >>
+    end match
+  else ''
+end generateSparsityPatternInitialization;
+
+
 template generateOmsiIndexTypeInitialization (list<SimVar> variables, String StrucPrefix, String targetName, String omsiFuncName)
 "Generates code for instantiation and initialization of struct omsi_index_type "
 ::=
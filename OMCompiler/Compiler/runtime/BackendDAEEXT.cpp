@@ -47,6 +47,7 @@
 #include <string>
 #include <vector>
 #include <cassert>
+#include <cstring>
 
 
 static std::set<int> e_mark;
@@ -63,12 +64,24 @@ using namespace std;
 extern "C" {
 #include "matchmaker.h"
 
-static unsigned int n=0; /* size of match */
-static unsigned int m=0; /* size of row_match */
-static int* match=NULL;
-static int* row_match=NULL;
-static int* col_ptrs=NULL;
-static int* col_ids=NULL;
+/* Matching state, the adjacency structure in compressed column format and the
+ * matchings of both sides. The Impl functions only work on the state they get,
+ * the MetaModelica interface passes them the single matchingState. */
+typedef struct matching_state {
+  unsigned int n; /* size of match */
+  unsigned int m; /* size of row_match */
+  unsigned int n_capacity; /* allocated size of match */
+  unsigned int m_capacity; /* allocated size of row_match */
+  int* match;
+  int* row_match;
+  unsigned int ncols; /* number of columns of col_ptrs */
+  unsigned int ncols_capacity;
+  unsigned int nz_capacity;
+  int* col_ptrs;
+  int* col_ids;
+} matching_state;
+
+static matching_state matchingState = {0, 0, 0, 0, NULL, NULL, 0, 0, 0, NULL, NULL};
 
 void BackendDAEEXTImpl__initMarks(int nvars, int neqns)
 {
@@ -228,124 +241,162 @@ int BackendDAEEXTImpl__getV(int i)
   return v[i-1];
 }
 
-void BackendDAEExtImpl__cheapmatching(int nvars, int neqns, int cheapID, int clear_match)
+/* Grows an integer array to at least size elements, keeping the first used elements */
+static int* BackendDAEEXTImpl__growArray(int* array, unsigned int used, unsigned int* capacity, unsigned int size)
 {
-  int i=0;
-  if (clear_match==0){
-    if (neqns>n) {
-      if(match)
-      {
-        int* tmp = (int*) malloc(neqns * sizeof(int));
-        memcpy(tmp,match,n*sizeof(int));
-        free(match);
-        match = tmp;
-        for (i = n; i < neqns; i++) {
-          match[i] = -1;
-        }
-      } else {
-         match = (int*) malloc(neqns * sizeof(int));
-         memset(match,-1,neqns * sizeof(int));
-      }
-      n = neqns;
-    }
-    if (nvars>m) {
-      if(row_match)
-      {
-        int* tmp = (int*) malloc(nvars * sizeof(int));
-        memcpy(tmp,row_match,m*sizeof(int));
-        free(row_match);
-        row_match = tmp;
-        for (i = m; i < nvars; i++) {
-          row_match[i] = -1;
-        }
-      } else {
-        row_match = (int*) malloc(nvars * sizeof(int));
-         memset(row_match,-1,nvars * sizeof(int));
-      }
-      m = nvars;
+  if (size > *capacity) {
+    int* tmp = (int*) malloc(size * sizeof(int));
+    if (array) {
+      memcpy(tmp, array, used * sizeof(int));
+      free(array);
     }
+    array = tmp;
+    *capacity = size;
   }
-  else {
-  if (neqns>n) {
-      if (match) free(match);
-      match = (int*) malloc(neqns * sizeof(int));
-      memset(match,-1,neqns * sizeof(int));
+  return array;
+}
+
+/* Sizes the matchings for neqns columns and nvars rows. New entries are unmatched,
+ * with clear_match all of them. */
+static void BackendDAEEXTImpl__initMatching(matching_state* state, unsigned int nvars, unsigned int neqns, int clear_match)
+{
+  if (clear_match==0) {
+    if (neqns>state->n) {
+      state->match = BackendDAEEXTImpl__growArray(state->match, state->n, &state->n_capacity, neqns);
+      memset(state->match+state->n, -1, (neqns-state->n) * sizeof(int));
+      state->n = neqns;
+    }
+    if (nvars>state->m) {
+      state->row_match = BackendDAEEXTImpl__growArray(state->row_match, state->m, &state->m_capacity, nvars);
+      memset(state->row_match+state->m, -1, (nvars-state->m) * sizeof(int));
+      state->m = nvars;
+    }
   } else {
-      memset(match,-1,n * sizeof(int));
+    state->match = BackendDAEEXTImpl__growArray(state->match, 0, &state->n_capacity, neqns);
+    state->n = neqns;
+    if (state->match) memset(state->match, -1, state->n * sizeof(int));
+    state->row_match = BackendDAEEXTImpl__growArray(state->row_match, 0, &state->m_capacity, nvars);
+    state->m = nvars;
+    if (state->row_match) memset(state->row_match, -1, state->m * sizeof(int));
   }
-    n = neqns;
-    if (nvars>m) {
-      if (row_match) free(row_match);
-      row_match = (int*) malloc(nvars * sizeof(int));
-      memset(row_match,-1,nvars * sizeof(int));
-    } else {
-      memset(row_match,-1,m * sizeof(int));
-    }
-    m = nvars;
+}
+
+/* Provides room for an adjacency structure of neqns columns and nz entries, the
+ * buffers of the previous structure are reused if they are large enough. */
+static void BackendDAEEXTImpl__initAdjacency(matching_state* state, unsigned int neqns, unsigned int nz)
+{
+  state->col_ptrs = BackendDAEEXTImpl__growArray(state->col_ptrs, 0, &state->ncols_capacity, neqns+1);
+  state->col_ids = BackendDAEEXTImpl__growArray(state->col_ids, 0, &state->nz_capacity, nz > 0 ? nz : 1);
+  state->ncols = neqns;
+  state->col_ptrs[neqns] = nz;
+}
+
+void BackendDAEExtImpl__cheapmatching(matching_state* state, int nvars, int neqns, int cheapID, int clear_match)
+{
+  BackendDAEEXTImpl__initMatching(state, nvars, neqns, clear_match);
+  if ((state->match != NULL) && (state->row_match != NULL)) {
+    cheapmatching(state->col_ptrs,state->col_ids,state->match,state->row_match,neqns,nvars,cheapID,0 /*clear_match already done*/);
   }
-  if ((match != NULL) && (row_match != NULL)) {
-    cheapmatching(col_ptrs,col_ids,match,row_match,neqns,nvars,cheapID,0 /*clear_match already done*/);
+}
+
+void BackendDAEExtImpl__matching(matching_state* state, int nvars, int neqns, int matchingID, int cheapID, double relabel_period, int clear_match)
+{
+  BackendDAEEXTImpl__initMatching(state, nvars, neqns, clear_match);
+  if ((state->match != NULL) && (state->row_match != NULL)) {
+    matching(state->col_ptrs,state->col_ids,state->match,state->row_match,neqns,nvars,matchingID,cheapID,relabel_period,0 /*clear_match already done*/);
   }
 }
 
-void BackendDAEExtImpl__matching(int nvars, int neqns, int matchingID, int cheapID, double relabel_period, int clear_match)
+/* Sets the adjacency structure from the incidence matrix, an array of lists of
+ * variables per equation. Entries <= 0 are skipped, with nz < 0 they are counted first. */
+void BackendDAEEXTImpl__setIncidenceMatrix(matching_state* state, int neqns, int nz, modelica_metatype incidencematrix)
 {
   int i=0;
-  if (clear_match==0){
-    if (neqns>n) {
-      if(match)
-      {
-        int* tmp = (int*) malloc(neqns * sizeof(int));
-        memcpy(tmp,match,n*sizeof(int));
-        free(match);
-        match = tmp;
-        for (i = n; i < neqns; i++) {
-          match[i] = -1;
+  mmc_sint_t i1;
+  int j=0;
+
+  /* count the entries here if the caller did not, walking the lists is cheap compared to a MetaModelica pass */
+  if (nz < 0) {
+    nz = 0;
+    for(i=0; i<neqns; ++i) {
+      modelica_metatype ie = MMC_STRUCTDATA(incidencematrix)[i];
+      while(MMC_GETHDR(ie) == MMC_CONSHDR) {
+        if (MMC_UNTAGFIXNUM(MMC_CAR(ie))>0) {
+          nz++;
         }
-      } else {
-         match = (int*) malloc(neqns * sizeof(int));
-         memset(match,-1,neqns * sizeof(int));
+        ie = MMC_CDR(ie);
       }
-      n = neqns;
     }
-    if (nvars>m) {
-      if(row_match)
-      {
-        int* tmp = (int*) malloc(nvars * sizeof(int));
-        memcpy(tmp,row_match,m*sizeof(int));
-        free(row_match);
-        row_match = tmp;
-        for (i = m; i < nvars; i++) {
-          row_match[i] = -1;
-        }
-      } else {
-        row_match = (int*) malloc(nvars * sizeof(int));
-         memset(row_match,-1,nvars * sizeof(int));
+  }
+
+  BackendDAEEXTImpl__initAdjacency(state, neqns, nz);
+
+  for(i=0; i<neqns; ++i) {
+    modelica_metatype ie = MMC_STRUCTDATA(incidencematrix)[i];
+    state->col_ptrs[i] = j;
+    while(MMC_GETHDR(ie) == MMC_CONSHDR) {
+      i1 = MMC_UNTAGFIXNUM(MMC_CAR(ie));
+      if (i1>0) {
+        state->col_ids[j++] = (int)i1-1;
       }
-      m = nvars;
+      ie = MMC_CDR(ie);
     }
   }
-  else {
-    if (neqns>n) {
-      if (match) free(match);
-      match = (int*) malloc(neqns * sizeof(int));
-      memset(match,-1,neqns * sizeof(int));
-    } else {
-      memset(match,-1,n * sizeof(int));
+}
+
+/* Copies the matchings to the assignment arrays, unmatched entries become -1 */
+void BackendDAEEXTImpl__getAssignment(matching_state* state, modelica_metatype ass1, modelica_metatype ass2)
+{
+  int i=0;
+  mmc_uint_t len1 = MMC_HDRSLOTS(MMC_GETHDR(ass1));
+  mmc_uint_t len2 = MMC_HDRSLOTS(MMC_GETHDR(ass2));
+  if (state->n > len1 || state->m > len2) {
+    char nstr[64],mstr[64],len1str[64],len2str[64];
+    const char *tokens[4] = {len2str,mstr,len1str,nstr};
+    snprintf(nstr,64,"%ld", (long) state->n);
+    snprintf(mstr,64,"%ld", (long) state->m);
+    snprintf(len1str,64,"%ld", (long) len1);
+    snprintf(len2str,64,"%ld", (long) len2);
+    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.getAssignment failed because n=%s>arrayLength(ass1)=%s or m=%s>arrayLength(ass2)=%s",tokens,4);
+    MMC_THROW();
+  }
+  if (state->match != NULL) {
+    for(i=0; i<state->n; ++i) {
+      MMC_STRUCTDATA(ass1)[i] = mmc_mk_icon(state->match[i] >= 0 ? state->match[i]+1 : -1);
     }
-    n = neqns;
-    if (nvars>m) {
-      if (row_match) free(row_match);
-      row_match = (int*) malloc(nvars * sizeof(int));
-      memset(row_match,-1,nvars * sizeof(int));
-    } else {
-      memset(row_match,-1,m * sizeof(int));
+  }
+  if (state->row_match != NULL) {
+    for(i=0; i<state->m; ++i) {
+      MMC_STRUCTDATA(ass2)[i] = mmc_mk_icon(state->row_match[i] >= 0 ? state->row_match[i]+1 : -1);
     }
-    m = nvars;
   }
-  if ((match != NULL) && (row_match != NULL)) {
-    matching(col_ptrs,col_ids,match,row_match,neqns,nvars,matchingID,cheapID,relabel_period,0 /*clear_match already done*/);
+}
+
+/* Sets the matchings from the assignment arrays, used to continue a previous matching */
+int BackendDAEEXTImpl__setAssignment(matching_state* state, int lenass1, int lenass2, modelica_metatype ass1, modelica_metatype ass2)
+{
+  int nelts=0;
+  int i=0;
+
+  nelts = MMC_HDRSLOTS(MMC_GETHDR(ass1));
+  if (nelts > 0) {
+    state->match = BackendDAEEXTImpl__growArray(state->match, 0, &state->n_capacity, lenass1);
+    state->n = lenass1;
+    for(i=0; i<state->n; ++i) {
+      state->match[i] = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass1)[i])-1;
+      if (state->match[i]<0) state->match[i] = -1;
+    }
+  }
+  nelts = MMC_HDRSLOTS(MMC_GETHDR(ass2));
+  if (nelts > 0) {
+    state->row_match = BackendDAEEXTImpl__growArray(state->row_match, 0, &state->m_capacity, lenass2);
+    state->m = lenass2;
+    for(i=0; i<state->m; ++i) {
+      state->row_match[i] = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass2)[i])-1;
+      if (state->row_match[i]<0) state->row_match[i] = -1;
+    }
   }
+  return 1;
 }
 
 }
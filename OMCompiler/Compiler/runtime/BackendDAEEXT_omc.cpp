@@ -41,9 +41,9 @@
  */
 
 #include "meta_modelica.h"
+#include "errorext.h"
 #include "BackendDAEEXT.cpp"
 #include <stdlib.h>
-#include "errorext.h"
 
 extern "C" {
 
@@ -110,99 +110,22 @@ extern void BackendDAEEXT_vMark(int _inInteger)
 
 extern void BackendDAEEXT_setIncidenceMatrix(modelica_integer nvars, modelica_integer neqns, modelica_integer nz, modelica_metatype incidencematrix)
 {
-  int i=0;
-  mmc_sint_t i1;
-  int j=0;
-  modelica_integer nelts = MMC_HDRSLOTS(MMC_GETHDR(incidencematrix));
-
-  if (col_ptrs) free(col_ptrs);
-  col_ptrs = (int*) malloc((neqns+1) * sizeof(int));
-  col_ptrs[neqns]=nz;
-  if (col_ids) free(col_ids);
-  col_ids = (int*) malloc(nz * sizeof(int));
-
-  for(i=0; i<neqns; ++i) {
-    modelica_metatype ie = MMC_STRUCTDATA(incidencematrix)[i];
-    col_ptrs[i] = j;
-    while(MMC_GETHDR(ie) == MMC_CONSHDR) {
-      i1 = MMC_UNTAGFIXNUM(MMC_CAR(ie));
-      if (i1>0) {
-        col_ids[j++] = (int)i1-1;
-      }
-      ie = MMC_CDR(ie);
-    }
-  }
+  BackendDAEEXTImpl__setIncidenceMatrix(&matchingState, neqns, nz, incidencematrix);
 }
 
 extern void BackendDAEEXT_matching(modelica_integer nv, modelica_integer ne, modelica_integer matchingID, modelica_integer cheapID, modelica_real relabel_period, modelica_integer clear_match)
 {
-  int i=0;
-  BackendDAEExtImpl__matching(nv, ne, matchingID, cheapID, relabel_period, clear_match);
+  BackendDAEExtImpl__matching(&matchingState, nv, ne, matchingID, cheapID, relabel_period, clear_match);
 }
 
 extern void BackendDAEEXT_getAssignment(modelica_metatype ass1, modelica_metatype ass2)
 {
-  int i=0;
-  mmc_uint_t len1 = MMC_HDRSLOTS(MMC_GETHDR(ass1));
-  mmc_uint_t len2 = MMC_HDRSLOTS(MMC_GETHDR(ass2));
-  if (n > len1 || m > len2) {
-    char nstr[64],mstr[64],len1str[64],len2str[64];
-    const char *tokens[4] = {len2str,mstr,len1str,nstr};
-    snprintf(nstr,64,"%ld", (long) n);
-    snprintf(mstr,64,"%ld", (long) m);
-    snprintf(len1str,64,"%ld", (long) len1);
-    snprintf(len2str,64,"%ld", (long) len2);
-    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.getAssignment failed because n=%s>arrayLength(ass1)=%s or m=%s>arrayLength(ass2)=%s",tokens,4);
-    MMC_THROW();
-  }
-  if (match != NULL) {
-    for(i=0; i<n; ++i) {
-      if (match[i] >= 0)
-        MMC_STRUCTDATA(ass1)[i] = mmc_mk_icon(match[i]+1);
-      else
-        MMC_STRUCTDATA(ass1)[i] = mmc_mk_icon(-1);
-    }
-  }
-  if (row_match != NULL) {
-    for(i=0; i<m; ++i) {
-      if (row_match[i] >= 0)
-        MMC_STRUCTDATA(ass2)[i] = mmc_mk_icon(row_match[i]+1);
-      else
-        MMC_STRUCTDATA(ass2)[i] = mmc_mk_icon(-1);
-    }
-  }
+  BackendDAEEXTImpl__getAssignment(&matchingState, ass1, ass2);
 }
 
 extern int BackendDAEEXT_setAssignment(int lenass1, int lenass2, modelica_metatype ass1, modelica_metatype ass2)
 {
-  int nelts=0;
-  int i=0;
-
-  nelts = MMC_HDRSLOTS(MMC_GETHDR(ass1));
-  if (nelts > 0) {
-    n = lenass1;
-    if(match) {
-      free(match);
-    }
-    match = (int*) malloc(n * sizeof(int));
-    for(i=0; i<n; ++i) {
-      match[i] = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass1)[i])-1;
-      if (match[i]<0) match[i] = -1;
-    }
-  }
-  nelts = MMC_HDRSLOTS(MMC_GETHDR(ass2));
-  if (nelts > 0) {
-    m = lenass2;
-    if(row_match) {
-      free(row_match);
-    }
-    row_match = (int*) malloc(m * sizeof(int));
-    for(i=0; i<m; ++i) {
-      row_match[i] = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass2)[i])-1;
-      if (row_match[i]<0) row_match[i] = -1;
-    }
-  }
-  return 1;
+  return BackendDAEEXTImpl__setAssignment(&matchingState, lenass1, lenass2, ass1, ass2);
 }
 
 }
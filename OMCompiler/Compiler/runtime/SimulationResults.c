@@ -1,4 +1,5 @@
 #include "read_matlab4.h"
+#include "read_col.h"
 #include "write_matlab4.h"
 #include <stdint.h>
 #include <string.h>
@@ -27,9 +28,10 @@ typedef enum {
   UNKNOWN_PLOT=0,
   MATLAB4,
   PLT,
-  CSV
+  CSV,
+  COL
 } PlotFormat;
-const char *PlotFormatStr[] = {"Unknown","MATLAB4","PLT","CSV"};
+const char *PlotFormatStr[] = {"Unknown","MATLAB4","PLT","CSV","COL"};
 
 typedef struct {
   PlotFormat curFormat;
@@ -38,6 +40,7 @@ typedef struct {
   ModelicaMatReader matReader;
   FILE *pltReader;
   struct csv_data *csvReader;
+  ModelicaColReader colReader;
 } SimulationResult_Globals;
 
 static SimulationResult_Globals simresglob = {
@@ -51,6 +54,7 @@ static void SimulationResultsImpl__close(SimulationResult_Globals* simresglob)
   case MATLAB4: omc_free_matlab4_reader(&simresglob->matReader); break;
   case PLT: fclose(simresglob->pltReader); break;
   case CSV: omc_free_csv_reader(simresglob->csvReader); simresglob->csvReader=NULL; break;
+  case COL: omc_free_col_reader(&simresglob->colReader); break;
   default: break;
   }
   simresglob->curFormat = UNKNOWN_PLOT;
@@ -90,6 +94,7 @@ static PlotFormat SimulationResultsImpl__openFile(const char *filename, Simulati
   else if (0 == strcmp(filename+len-4, ".mat")) format = MATLAB4;
   else if (0 == strcmp(filename+len-4, ".plt")) format = PLT;
   else if (0 == strcmp(filename+len-4, ".csv")) format = CSV;
+  else if (0 == strcmp(filename+len-4, ".col")) format = COL;
   else {
     msg[0] = filename;
     c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Unknown result-file suffix of file '%s'"), msg, 1);
@@ -123,6 +128,13 @@ static PlotFormat SimulationResultsImpl__openFile(const char *filename, Simulati
       return UNKNOWN_PLOT;
     }
     break;
+  case COL:
+    if (0!=(msg[0]=omc_new_col_reader(filename,&simresglob->colReader))) {
+      msg[1] = filename;
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Failed to open simulation result %s: %s"), msg, 2);
+      return UNKNOWN_PLOT;
+    }
+    break;
   default:
     msg[0] = filename;
     c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Failed to open simulation result %s"), msg, 1);
@@ -169,6 +181,28 @@ static double SimulationResultsImpl__val(const char *filename, const char *varna
     }
     return res;
   }
+  case COL: {
+    ModelicaMatVariable_t *var;
+    if (0 == (var=omc_col_find_var(&simresglob->colReader,varname))) {
+      msg[1] = varname;
+      msg[0] = filename;
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("%s not found in %s\n"), msg, 2);
+      return NAN;
+    }
+    if (omc_col_val(&res,&simresglob->colReader,var,timeStamp)) {
+      char buf[64],buf2[64],buf3[64];
+      snprintf(buf,60,"%g",timeStamp);
+      snprintf(buf2,60,"%g",omc_col_startTime(&simresglob->colReader));
+      snprintf(buf3,60,"%g",omc_col_stopTime(&simresglob->colReader));
+      msg[3] = varname;
+      msg[2] = buf;
+      msg[1] = buf2;
+      msg[0] = buf3;
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("%s not defined at time %s (startTime=%s, stopTime=%s)."), msg, 4);
+      return NAN;
+    }
+    return res;
+  }
   case PLT: {
     char *strToFind = (char*) malloc(strlen(varname)+30);
     char line[255];
@@ -224,6 +258,9 @@ static int SimulationResultsImpl__readSimulationResultSize(const char *filename,
   case MATLAB4: {
     return simresglob->matReader.nrows;
   }
+  case COL: {
+    return simresglob->colReader.nrows;
+  }
   case PLT: {
     size = read_ptolemy_dataset_size(filename);
     msg[0] = filename;
@@ -276,6 +313,15 @@ static void* SimulationResultsImpl__readVars(const char *filename, int readParam
     }
     return res;
   }
+  case COL: {
+    int i;
+    for (i=simresglob->colReader.nall-1; i>=0; i--) {
+      if (readParameters || !simresglob->colReader.allInfo[i].isParam) {
+        res = mmc_mk_cons(makeOMCStyle(simresglob->colReader.allInfo[i].name, omcStyle),res);
+      }
+    }
+    return res;
+  }
   case PLT: {
     return read_ptolemy_variables(filename /* Assume it is in OMC style */);
   }
@@ -324,10 +370,50 @@ static void* SimulationResultsImpl__readVarsFilterAliases(const char *filename,
     free(vars);
     return res;
   }
+  case COL: {
+    void *res = mmc_mk_nil();
+    int i;
+    int *vars = (int*) calloc(simresglob->colReader.nvar+1,sizeof(int));
+    for (i=simresglob->colReader.nall-1; i>=0; i--) {
+      if (simresglob->colReader.allInfo[i].isParam || 0 >= simresglob->colReader.allInfo[i].index) continue; /* Negated aliases always have a real variable, so skip it */
+      if (vars[simresglob->colReader.allInfo[i].index]) continue;
+      vars[simresglob->colReader.allInfo[i].index] = 1;
+      res = mmc_mk_cons(mmc_mk_scon(simresglob->colReader.allInfo[i].name),res);
+    }
+    free(vars);
+    return res;
+  }
   default: return SimulationResultsImpl__readVars(filename, 0, 0, simresglob);
   }
 }
 
+/* Reads all (non-parameter) variables of the list in one pass over the file */
+static void SimulationResultsImpl__prefetchMatVars(void *vars, SimulationResult_Globals* simresglob)
+{
+  ModelicaMatVariable_t *mat_var;
+  int n = 0, *indices;
+  void *v;
+  if (simresglob->curFormat != MATLAB4) {
+    return;
+  }
+  for (v = vars; MMC_NILHDR != MMC_GETHDR(v); v = MMC_CDR(v)) {
+    n++;
+  }
+  if (n < 2) {
+    return;
+  }
+  indices = (int*) malloc(n*sizeof(int));
+  n = 0;
+  for (v = vars; MMC_NILHDR != MMC_GETHDR(v); v = MMC_CDR(v)) {
+    mat_var = omc_matlab4_find_var(&simresglob->matReader, MMC_STRINGDATA(MMC_CAR(v)));
+    if (mat_var && !mat_var->isParam) {
+      indices[n++] = mat_var->index;
+    }
+  }
+  omc_matlab4_read_vars(&simresglob->matReader, indices, n);
+  free(indices);
+}
+
 static void* SimulationResultsImpl__readDataset(const char *filename, void *vars, int dimsize, int suggestReadAllVars, SimulationResult_Globals* simresglob, int runningTestsuite)
 {
   const char *msg[2] = {"",""};
@@ -350,7 +436,11 @@ static void* SimulationResultsImpl__readDataset(const char *filename, void *vars
       return NULL;
     }
     if (suggestReadAllVars) {
+      /* The values end up as boxed reals; single precision files can stay floats until then */
+      simresglob->matReader.keepSinglePrecision = simresglob->matReader.doublePrecision != 1;
       omc_matlab4_read_all_vals(&simresglob->matReader);
+    } else {
+      SimulationResultsImpl__prefetchMatVars(vars, simresglob);
     }
     while (MMC_NILHDR != MMC_GETHDR(vars)) {
       var = MMC_STRINGDATA(MMC_CAR(vars));
@@ -366,7 +456,43 @@ static void* SimulationResultsImpl__readDataset(const char *filename, void *vars
         for (i=0;i<dimsize;i++) col=mmc_mk_cons(mmc_mk_rcon((mat_var->index<0)?-simresglob->matReader.params[abs(mat_var->index)-1]:simresglob->matReader.params[abs(mat_var->index)-1]),col);
         res = mmc_mk_cons(col,res);
       } else {
-        vals = omc_matlab4_read_vals(&simresglob->matReader,mat_var->index);
+        ModelicaMatVarView view;
+        if (omc_matlab4_var_view(&simresglob->matReader,mat_var->index,&view)) {
+          msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+          msg[1] = var;
+          c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not read variable %s in file %s."), msg, 2);
+          return NULL;
+        }
+        col=mmc_mk_nil();
+        for (i=0;i<dimsize;i++) col=mmc_mk_cons(mmc_mk_rcon(omc_matlab4_view_val(&view,i)),col);
+        res = mmc_mk_cons(col,res);
+      }
+    }
+    return res;
+  }
+  case COL: {
+    ModelicaMatVariable_t *col_var;
+    if (dimsize == 0) {
+      dimsize = simresglob->colReader.nrows;
+    } else if (simresglob->colReader.nrows != dimsize) {
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("readDataset(...): Expected and actual dimension sizes do not match."), NULL, 0);
+      return NULL;
+    }
+    while (MMC_NILHDR != MMC_GETHDR(vars)) {
+      var = MMC_STRINGDATA(MMC_CAR(vars));
+      vars = MMC_CDR(vars);
+      col_var = omc_col_find_var(&simresglob->colReader,var);
+      vals = col_var == NULL || col_var->isParam ? NULL : omc_col_read_vals(&simresglob->colReader,col_var->index);
+      if (col_var == NULL || (!col_var->isParam && vals == NULL)) {
+        msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+        msg[1] = var;
+        c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not read variable %s in file %s."), msg, 2);
+        return NULL;
+      } else if (col_var->isParam) {
+        col=mmc_mk_nil();
+        for (i=0;i<dimsize;i++) col=mmc_mk_cons(mmc_mk_rcon((col_var->index<0)?-simresglob->colReader.params[abs(col_var->index)-1]:simresglob->colReader.params[abs(col_var->index)-1]),col);
+        res = mmc_mk_cons(col,res);
+      } else {
         col=mmc_mk_nil();
         for (i=0;i<dimsize;i++) col=mmc_mk_cons(mmc_mk_rcon(vals[i]),col);
         res = mmc_mk_cons(col,res);
@@ -459,7 +585,7 @@ int SimulationResults_filterSimulationResults(const char *inFile, const char *ou
     parameter_indexes[0] = 1; /* time */
     omc_matlab4_read_all_vals(&simresglob.matReader);
     if (endsWith(outFile,".csv")) {
-      double **vals = omc_alloc_interface.malloc(sizeof(double*)*numToFilter);
+      ModelicaMatVarView *vals = omc_alloc_interface.malloc(sizeof(ModelicaMatVarView)*numToFilter);
       FILE *fout = NULL;
       for (i=0; i<numToFilter; i++) {
         const char *var = MMC_STRINGDATA(MMC_CAR(vars));
@@ -475,8 +601,11 @@ int SimulationResults_filterSimulationResults(const char *inFile, const char *ou
           msg[0] = var;
           c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not filter parameter %s since the output format is CSV (only variables are allowed)."), msg, 1);
           return 0;
-        } else {
-          vals[i] = omc_matlab4_read_vals(&simresglob.matReader, mat_var[i]->index);
+        } else if (omc_matlab4_var_view(&simresglob.matReader, mat_var[i]->index, vals+i)) {
+          msg[0] = SystemImpl__basename(inFile);
+          msg[1] = var;
+          c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not read variable %s in file %s."), msg, 2);
+          return 0;
         }
       }
       fout = fopen(outFile, "w");
@@ -486,9 +615,9 @@ int SimulationResults_filterSimulationResults(const char *inFile, const char *ou
       }
       fprintf(fout, ",nrows=%d\n", simresglob.matReader.nrows);
       for (i=0; i<simresglob.matReader.nrows; i++) {
-        fprintf(fout, "%.15g", vals[0][i]);
+        fprintf(fout, "%.15g", omc_matlab4_view_val(vals, i));
         for (j=1; j<numToFilter; j++) {
-          fprintf(fout, ",%.15g", vals[j][i]);
+          fprintf(fout, ",%.15g", omc_matlab4_view_val(vals+j, i));
         }
         fprintf(fout, "\n");
       }
@@ -34,11 +34,15 @@
 #include <errno.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "systemimpl.h"
 
 /* Size of the buffer for warnings and other messages */
 #define WARNINGBUFFSIZE 4096
+/* Memory for the values of the variables compared at the same time; larger
+ * files are compared in several batches */
+#define CMP_BATCH_BYTES ((size_t)256*1024*1024)
 
 typedef struct {
   double *data;
@@ -146,6 +150,124 @@ static DataField getData(const char *varname,const char *filename, unsigned int
   return res;
 }
 
+/* Like getData, but copies the values of the variable straight from the
+ * reader instead of going through MetaModelica lists. Matlab columns are
+ * released from the reader after copying, so prefetched batches do not pile
+ * up. Falls back to getData for the other formats. */
+static DataField getDataColumn(const char *varname, const char *filename, unsigned int size, SimulationResult_Globals* srg, int runningTestsuite)
+{
+  const char *msg[2] = {"",""};
+  DataField res;
+  ModelicaMatVariable_t *v = NULL;
+  double *vals = NULL, *params = NULL;
+  unsigned int i, row, nrows = size;
+  int fail = 0;
+  res.n = 0;
+  res.data = NULL;
+
+  switch (srg->curFormat) {
+  case MATLAB4:
+    nrows = srg->matReader.nrows;
+    params = srg->matReader.params;
+    v = omc_matlab4_find_var(&srg->matReader,varname);
+    break;
+  case COL:
+    nrows = srg->colReader.nrows;
+    params = srg->colReader.params;
+    v = omc_col_find_var(&srg->colReader,varname);
+    break;
+  case CSV:
+    vals = srg->csvReader ? read_csv_dataset(srg->csvReader,varname) : NULL;
+    break;
+  default:
+    return getData(varname,filename,size,0,srg,runningTestsuite);
+  }
+  if (size != 0 && nrows != size) {
+    c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("readDataset(...): Expected and actual dimension sizes do not match."), NULL, 0);
+    return res;
+  }
+  if (v == NULL && vals == NULL) {
+    msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+    msg[1] = varname;
+    c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not read variable %s in file %s."), msg, 2);
+    return res;
+  }
+  if (nrows == 0) {
+    return res;
+  }
+  res.data = (double*) malloc(sizeof(double)*nrows);
+  if (vals) {
+    memcpy(res.data, vals, sizeof(double)*nrows);
+  } else if (v->isParam) {
+    double p = (v->index<0) ? -params[abs(v->index)-1] : params[abs(v->index)-1];
+    for (i=0; i<nrows; i++) {
+      res.data[i] = p;
+    }
+  } else if (srg->curFormat == MATLAB4) {
+    vals = omc_matlab4_read_vals(&srg->matReader,v->index);
+    if (vals) {
+      memcpy(res.data, vals, sizeof(double)*nrows);
+    } else {
+      fail = 1;
+    }
+    omc_matlab4_release_vars(&srg->matReader,&v->index,1);
+  } else {
+    /* Decode the chunks directly; nothing is cached in the reader */
+    for (i=0, row=0; !fail && i<srg->colReader.nchunks; i++) {
+      fail = omc_col_read_chunk(&srg->colReader,i,abs(v->index),res.data+row);
+      row += srg->colReader.chunks[i].nrows;
+    }
+    if (v->index < 0) {
+      for (i=0; i<nrows; i++) {
+        res.data[i] = -res.data[i];
+      }
+    }
+  }
+  if (fail) {
+    free(res.data);
+    res.data = NULL;
+    msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+    msg[1] = varname;
+    c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Could not read variable %s in file %s."), msg, 2);
+    return res;
+  }
+  res.n = nrows;
+  return res;
+}
+
+/* Reads the given variables of a matlab file in one pass over the file */
+static void prefetchColumns(char **varnames, unsigned int n, SimulationResult_Globals* srg)
+{
+  ModelicaMatVariable_t *mat_var;
+  int *indices, nindices = 0;
+  unsigned int i;
+  if (srg->curFormat != MATLAB4 || n < 2) {
+    return;
+  }
+  indices = (int*) malloc(n*sizeof(int));
+  for (i=0; i<n; i++) {
+    mat_var = omc_matlab4_find_var(&srg->matReader, varnames[i]);
+    if (mat_var && !mat_var->isParam) {
+      indices[nindices++] = mat_var->index;
+    }
+  }
+  omc_matlab4_read_vars(&srg->matReader, indices, nindices);
+  free(indices);
+}
+
+/* Drops a prefetched matlab column that is not going to be loaded */
+static void releaseColumn(const char *varname, SimulationResult_Globals* srg)
+{
+  ModelicaMatVariable_t *mat_var;
+  if (srg->curFormat != MATLAB4) {
+    return;
+  }
+  mat_var = omc_matlab4_find_var(&srg->matReader, varname);
+  if (mat_var && !mat_var->isParam) {
+    omc_matlab4_release_vars(&srg->matReader, &mat_var->index, 1);
+  }
+}
+
 /* see http://randomascii.wordpress.com/2012/02/25/comparing-floating-point-numbers-2012-edition/ */
 static char almostEqualRelativeAndAbs(double a, double b, double reltol, double abstol)
 {
@@ -214,7 +336,11 @@ static double deltaData(ErrorMethod errMethod, DataField *time, DataField *refti
 }
 
 
-static unsigned int cmpData(int isResultCmp, char* varname, DataField *time, DataField *reftime, DataField *data, DataField *refdata, double reltol, double abstol, DiffDataField *ddf, char **cmpdiffvars, unsigned int vardiffindx, int keepEqualResults, void **diffLst, const char *prefix)
+/* Compares one variable against its reference. The points that differ are
+ * appended to ddf (only for isResultCmp). Returns 1 if the variable differs.
+ * Only touches ddf and the per-variable csv file, so different variables may
+ * be compared concurrently. */
+static char cmpData(int isResultCmp, char* varname, DataField *time, DataField *reftime, DataField *data, DataField *refdata, double reltol, double abstol, DiffDataField *ddf, int keepEqualResults, const char *prefix)
 {
   unsigned int i,j,k,j_event;
   double t,tr,d,dr,err,d_left,d_right,dr_left,dr_right,t_event;
@@ -525,13 +651,6 @@ static unsigned int cmpData(int isResultCmp, char* varname, DataField *time, Dat
       }
     }
   }
-  if (isdifferent) {
-    cmpdiffvars[vardiffindx] = varname;
-    vardiffindx++;
-    if (!isResultCmp) {
-      *diffLst = mmc_mk_cons(mmc_mk_scon(varname),*diffLst);
-    }
-  }
   if (fout) {
     fclose(fout);
   }
@@ -541,7 +660,7 @@ static unsigned int cmpData(int isResultCmp, char* varname, DataField *time, Dat
   if (fname) {
     free(fname);
   }
-  return vardiffindx;
+  return isdifferent;
 }
 
 static int writeLogFile(const char *filename,DiffDataField *ddf,const char *f,const char *reff,double reltol,double abstol)
@@ -583,6 +702,106 @@ static const char* getTimeVarName(void *vars) {
 
 #include "SimulationResultsCmpTubes.c"
 
+/* One compared variable; the loaded values and the result of the comparison */
+typedef struct {
+  char *name;
+  DataField data;
+  DataField dataref;
+  DiffDataField ddf;
+  char isdifferent;
+} CmpVar;
+
+/* The variables of a batch, shared by the comparison threads */
+typedef struct {
+  pthread_mutex_t mutex;
+  CmpVar *vars;
+  unsigned int current;
+  unsigned int len;
+  int isResultCmp;
+  int keepEqualResults;
+  int isHtml;
+  char **htmlOut;
+  const char *prefix;
+  DataField *time;
+  DataField *timeref;
+  double reltol;
+  double abstol;
+  double rangeDelta;
+  double reltolDiffMaxMin;
+} CmpWork;
+
+static void cmpVar(CmpWork *work, CmpVar *v)
+{
+  if (work->isHtml) {
+    v->isdifferent = cmpDataTubes(work->isResultCmp,v->name,work->time,work->timeref,&v->data,&v->dataref,work->reltol,work->rangeDelta,work->reltolDiffMaxMin,work->keepEqualResults,work->prefix,1,work->htmlOut);
+  } else if (work->isResultCmp) {
+    v->isdifferent = cmpData(work->isResultCmp,v->name,work->time,work->timeref,&v->data,&v->dataref,work->reltol,work->abstol,&v->ddf,work->keepEqualResults,work->prefix);
+  } else {
+    v->isdifferent = cmpDataTubes(work->isResultCmp,v->name,work->time,work->timeref,&v->data,&v->dataref,work->reltol,work->rangeDelta,work->reltolDiffMaxMin,work->keepEqualResults,work->prefix,0,0);
+  }
+}
+
+static void* cmpVarsThread(void *in)
+{
+  CmpWork *work = (CmpWork*) in;
+  CmpVar *v;
+  while (1) {
+    pthread_mutex_lock(&work->mutex);
+    v = work->current < work->len ? work->vars + work->current++ : NULL;
+    pthread_mutex_unlock(&work->mutex);
+    if (!v) break;
+    if (v->data.n && v->dataref.n) {
+      cmpVar(work, v);
+    }
+  }
+  return NULL;
+}
+
+/* Compares the variables of the batch on up to numThreads threads, the
+ * calling thread included. The results stay in the variables and are
+ * collected afterwards in order, so the report does not depend on the
+ * scheduling. If no thread can be created, the calling thread does all. */
+static void cmpVars(CmpWork *work, int numThreads)
+{
+  pthread_t *th = NULL;
+  int i, n = 0;
+  work->current = 0;
+  numThreads = work->len < numThreads ? work->len : numThreads;
+  if (numThreads > 1) {
+    th = (pthread_t*) malloc(sizeof(pthread_t)*(numThreads-1));
+    for (n=0; n<numThreads-1; n++) {
+      if (GC_pthread_create(&th[n],NULL,cmpVarsThread,work)) {
+        break;
+      }
+    }
+  }
+  cmpVarsThread(work);
+  for (i=0; i<n; i++) {
+    GC_pthread_join(th[i], NULL);
+  }
+  if (th) {
+    free(th);
+  }
+}
+
+/* Appends the differing points of one variable to the report */
+static void appendDiffData(DiffDataField *ddf, DiffDataField *vddf)
+{
+  if (ddf->n + vddf->n > ddf->n_max) {
+    DiffData *newData;
+    unsigned int n_max = ddf->n_max ? ddf->n_max : 1024;
+    while (n_max < ddf->n + vddf->n) {
+      n_max *= 2;
+    }
+    newData = (DiffData*) realloc(ddf->data, sizeof(DiffData)*n_max);
+    if (!newData) return; /* realloc failed... pretty bad, but let's continue */
+    ddf->data = newData;
+    ddf->n_max = n_max;
+  }
+  memcpy(ddf->data + ddf->n, vddf->data, sizeof(DiffData)*vddf->n);
+  ddf->n += vddf->n;
+}
+
 /* Common, huge function, for both result comparison and result diff */
 void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite, const char *filename, const char *reffilename, const char *resultfilename, double reltol, double abstol, double reltolDiffMaxMin, double rangeDelta, void *vars, int keepEqualResults, int *success, int isHtml, char **htmlOut)
 {
@@ -592,13 +811,15 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
   unsigned int ncmpvars = 0;
   unsigned int ngetfailedvars = 0;
   void *allvars,*allvarsref,*res;
-  unsigned int i,size,size_ref,len,j,k;
-  char *var,*var1,*var2;
-  DataField time,timeref,data,dataref;
+  unsigned int i,size,size_ref,len,j,k,first,last,batch;
+  char *var;
+  char **names=NULL;
+  DataField time,timeref;
   DiffDataField ddf;
+  CmpWork work;
   const char *msg[2] = {"",""};
   const char *timeVarName, *timeVarNameRef;
-  int suggestReadAll=0;
+  int numThreads;
   ddf.data=NULL;
   ddf.n=0;
   ddf.n_max=0;
@@ -638,7 +859,6 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
   allvars = SimulationResultsImpl__readVarsFilterAliases(filename,&simresglob_c);
   allvarsref = SimulationResultsImpl__readVarsFilterAliases(reffilename,&simresglob_ref);
   if (ncmpvars==0) {
-    suggestReadAll = 1;
     cmpvars = getVars(allvarsref,&ncmpvars);
     if (ncmpvars==0) return mmc_mk_cons(mmc_mk_scon("Error Get Vars!"),mmc_mk_nil());
   }
@@ -651,12 +871,12 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
   /* fprintf(stderr, "get time\n"); */
   timeVarName = getTimeVarName(allvars);
   timeVarNameRef = getTimeVarName(allvarsref);
-  time = getData(timeVarName,filename,size,suggestReadAll,&simresglob_c,runningTestsuite);
+  time = getDataColumn(timeVarName,filename,size,&simresglob_c,runningTestsuite);
   if (time.n==0) {
     return mmc_mk_cons(mmc_mk_scon("Error get time!"),mmc_mk_nil());
   }
   /* fprintf(stderr, "get reftime\n"); */
-  timeref = getData(timeVarNameRef,reffilename,size_ref,suggestReadAll,&simresglob_ref,runningTestsuite);
+  timeref = getDataColumn(timeVarNameRef,reffilename,size_ref,&simresglob_ref,runningTestsuite);
   if (timeref.n==0) {
     return mmc_mk_cons(mmc_mk_scon("Error get ref time!"),mmc_mk_nil());
   }
@@ -676,84 +896,118 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
   /* calculate offsets */
   for(offset=0; offset<time.n-1 && time.data[offset] == time.data[offset+1]; ++offset);
   for(offsetRef=0; offsetRef<timeref.n-1 && timeref.data[offsetRef] == timeref.data[offsetRef+1]; ++offsetRef);
-  var1=NULL;
-  var2=NULL;
-  /* compare vars */
-  /* fprintf(stderr, "compare vars\n"); */
+  /* The names without quotes, as stored in the files */
+  names = (char**)omc_alloc_interface.malloc(sizeof(char*)*(ncmpvars));
   for (i=0;i<ncmpvars;i++) {
     var = cmpvars[i];
     len = strlen(var);
-    if (var1) {
-      free(var1);
-      var1 = NULL;
-    }
-    var1 = (char*) omc_alloc_interface.malloc(len+10);
+    names[i] = (char*) omc_alloc_interface.malloc_atomic(len+1);
     k = 0;
     for (j=0;j<len;j++) {
       if (var[j] !='\"' ) {
-        var1[k] = var[j];
+        names[i][k] = var[j];
         k +=1;
       }
     }
-    var1[k] = 0;
-    /* fprintf(stderr, "compare var: %s\n",var); */
-    /* check if in ref_file */
-    dataref = getData(var1,reffilename,size_ref,suggestReadAll,&simresglob_ref,runningTestsuite);
-    if (dataref.n==0) {
-      if (dataref.data) {
-        free(dataref.data);
+    names[i][k] = 0;
+  }
+  /* Compare the variables in batches bounded by CMP_BATCH_BYTES; the
+   * values of a batch are read in one pass over each file (the reader's
+   * copy is released once loaded) and compared in parallel. A html diff
+   * writes to a single output, so it stays on this thread */
+  batch = CMP_BATCH_BYTES / (2*sizeof(double)*((size_t)size+size_ref+1));
+  batch = batch < 1 ? 1 : batch;
+  numThreads = isHtml ? 1 : System_numProcessors();
+  memset(&work, 0, sizeof(CmpWork));
+  pthread_mutex_init(&work.mutex,NULL);
+  work.vars = (CmpVar*) calloc(batch < ncmpvars ? batch : ncmpvars, sizeof(CmpVar));
+  work.isResultCmp = isResultCmp;
+  work.keepEqualResults = keepEqualResults;
+  work.isHtml = isHtml;
+  work.htmlOut = htmlOut;
+  work.prefix = resultfilename;
+  work.time = &time;
+  work.timeref = &timeref;
+  work.reltol = reltol;
+  work.abstol = abstol;
+  work.rangeDelta = rangeDelta;
+  work.reltolDiffMaxMin = reltolDiffMaxMin;
+  for (first=0;first<ncmpvars;first=last) {
+    last = ncmpvars-first > batch ? first+batch : ncmpvars;
+    work.len = last-first;
+    memset(work.vars, 0, sizeof(CmpVar)*work.len);
+    prefetchColumns(names+first,work.len,&simresglob_ref);
+    prefetchColumns(names+first,work.len,&simresglob_c);
+    /* load the variables; messages are only added from this thread */
+    for (i=first;i<last;i++) {
+      CmpVar *v = work.vars + (i-first);
+      v->name = cmpvars[i];
+      /* fprintf(stderr, "compare var: %s\n",v->name); */
+      /* check if in ref_file */
+      v->dataref = getDataColumn(names[i],reffilename,size_ref,&simresglob_ref,runningTestsuite);
+      if (v->dataref.n==0) {
+        if (v->dataref.data) {
+          free(v->dataref.data);
+          v->dataref.data = NULL;
+        }
+        msg[0] = runningTestsuite ? SystemImpl__basename(reffilename) : reffilename;
+        msg[1] = v->name;
+        c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
+        ngetfailedvars++;
+        releaseColumn(names[i],&simresglob_c);
+        continue;
       }
-      if (var1) {
-        GC_free(var1);
-        var1 = NULL;
+      /*  check if in file */
+      v->data = getDataColumn(names[i],filename,size,&simresglob_c,runningTestsuite);
+      if (v->data.n==0)  {
+        if (v->data.data) {
+          free(v->data.data);
+          v->data.data = NULL;
+        }
+        msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+        msg[1] = v->name;
+        c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
+        ngetfailedvars++;
+        continue;
       }
-      msg[0] = runningTestsuite ? SystemImpl__basename(reffilename) : reffilename;
-      msg[1] = var;
-      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
-      ngetfailedvars++;
-      continue;
+      /* adjust initial data points */
+      for(j=offset; j>0; j--)
+        v->data.data[j-1] = v->data.data[j];
+      for(j=offsetRef; j>0; j--)
+        v->dataref.data[j-1] = v->dataref.data[j];
     }
-    /*  check if in file */
-    data = getData(var1,filename,size,suggestReadAll,&simresglob_c,runningTestsuite);
-    if (data.n==0)  {
-      if (data.data) {
-        free(data.data);
+    /* compare */
+    cmpVars(&work, numThreads);
+    /* collect the results in the order of the variables */
+    for (i=0;i<work.len;i++) {
+      CmpVar *v = work.vars + i;
+      if (v->isdifferent) {
+        cmpdiffvars[vardiffindx++] = v->name;
+        if (!isResultCmp) {
+          res = mmc_mk_cons(mmc_mk_scon(v->name),res);
+        }
       }
-      if (var1) {
-        GC_free(var1);
-        var1 = NULL;
+      if (v->ddf.n) {
+        appendDiffData(&ddf,&v->ddf);
+      }
+      /* free */
+      if (v->ddf.data) {
+        free(v->ddf.data);
+      }
+      if (v->dataref.data) {
+        free(v->dataref.data);
+      }
+      if (v->data.data) {
+        free(v->data.data);
       }
-      msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
-      msg[1] = var;
-      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_warning, gettext("Get data of variable %s from file %s failed!\n"), msg, 2);
-      ngetfailedvars++;
-      continue;
-    }
-    /* adjust initial data points */
-    for(j=offset; j>0; j--)
-      data.data[j-1] = data.data[j];
-    for(j=offsetRef; j>0; j--)
-      dataref.data[j-1] = dataref.data[j];
-    /* compare */
-    if (isHtml) {
-      vardiffindx = cmpDataTubes(isResultCmp,var,&time,&timeref,&data,&dataref,reltol,rangeDelta,reltolDiffMaxMin,&ddf,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename,1,htmlOut);
-    } else if (isResultCmp) {
-      vardiffindx = cmpData(isResultCmp,var,&time,&timeref,&data,&dataref,reltol,abstol,&ddf,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename);
-    } else {
-      vardiffindx = cmpDataTubes(isResultCmp,var,&time,&timeref,&data,&dataref,reltol,rangeDelta,reltolDiffMaxMin,&ddf,cmpdiffvars,vardiffindx,keepEqualResults,&res,resultfilename,0,0);
-    }
-    /* free */
-    if (dataref.data) {
-      free(dataref.data);
-    }
-    if (data.data) {
-      free(data.data);
-    }
-    if (var1) {
-      GC_free(var1);
-      var1 = NULL;
     }
   }
+  pthread_mutex_destroy(&work.mutex);
+  free(work.vars);
+  for (i=0;i<ncmpvars;i++) {
+    GC_free(names[i]);
+  }
+  GC_free(names);
 
   if (isResultCmp) {
     if (writeLogFile(resultfilename,&ddf,filename,reffilename,reltol,abstol)) {
@@ -778,8 +1032,6 @@ void* SimulationResultsCmp_compareResults(int isResultCmp, int runningTestsuite,
     }
   }
 
-  // if (var1) free(var1);
-  // if (var2) free(var2);
   if (ddf.data) free(ddf.data);
   if (cmpvars) GC_free(cmpvars);
   if (time.data) free(time.data);
@@ -638,12 +638,14 @@ static double* validate(int n, addTargetEventTimesRes ref, double *low, double *
   return NULL;
 }
 
-static unsigned int cmpDataTubes(int isResultCmp, char* varname, DataField *time, DataField *reftime, DataField *data, DataField *refdata, double reltol, double rangeDelta, double reltolDiffMaxMin, DiffDataField *ddf, char **cmpdiffvars, unsigned int vardiffindx, int keepEqualResults, void **diffLst, const char *prefix, int isHtml, char **htmlOut)
+/* Returns 1 if the variable leaves the tubes around the reference */
+static char cmpDataTubes(int isResultCmp, char* varname, DataField *time, DataField *reftime, DataField *data, DataField *refdata, double reltol, double rangeDelta, double reltolDiffMaxMin, int keepEqualResults, const char *prefix, int isHtml, char **htmlOut)
 {
   int withTubes = 0 == rangeDelta;
   FILE *fout = NULL;
   char *fname = NULL;
   char *html;
+  char isdifferent;
   /* The tolerance for detecting events is proportional to the number of output points in the file */
   double xabstol = (reftime->data[reftime->n-1]-reftime->data[0])*(withTubes ? rangeDelta : 1e-3) / fmax(time->n,reftime->n);
   /* Calculate the tubes without additional events added */
@@ -786,13 +788,7 @@ static unsigned int cmpDataTubes(int isResultCmp, char* varname, DataField *time
     }
     fputs(isHtml ? "],\n" : "\n", fout);
   }
-  if (error) {
-    cmpdiffvars[vardiffindx] = varname;
-    vardiffindx++;
-    if (!isResultCmp) {
-      *diffLst = mmc_mk_cons(mmc_mk_scon(varname),*diffLst);
-    }
-  }
+  isdifferent = error != NULL;
   if (fout) {
     if (isHtml) {
 fprintf(fout, "{title: '%s',\n"
@@ -864,5 +860,5 @@ fprintf(fout, "{title: '%s',\n"
   GC_free(priv->yLow);
   GC_free(priv);
   GC_free(calibrated_values);
-  return vardiffindx;
+  return isdifferent;
 }
@@ -867,29 +867,62 @@ extern int System_fileIsNewerThan(const char *file1, const char *file2)
 
 typedef void* voidp;
 
-/* Work in progress: Threading support in OMC */
+/* Threading support in OMC.
+ *
+ * The tasks of System.launchParallelTasks run on a process-wide pool of
+ * GC-registered worker threads. The pool is created on first use and grows to
+ * the largest number of threads requested. Workers claim tasks through an
+ * atomic index; the pool mutex is only taken to start a job and to report that
+ * a worker is done with it. If the pool is busy, e.g. for a nested call from one
+ * of the tasks, fresh threads are started for the call instead.
+ */
+#if defined(_MSC_VER)
+#define SYSTEM_ATOMIC_INCREMENT(ptr) (InterlockedIncrement((volatile LONG*)(ptr))-1)
+#else
+#define SYSTEM_ATOMIC_INCREMENT(ptr) __atomic_fetch_add((ptr), 1, __ATOMIC_RELAXED)
+#endif
+
 typedef struct thread_data {
-  pthread_mutex_t mutex;
   modelica_metatype (*fn)(threadData_t*,modelica_metatype);
-  int fail;
-  int current;
+  volatile int fail;
+  int current;    /* next task to start, claimed atomically */
   int len;
+  int numThreads; /* number of threads working on the tasks */
+  int finished;   /* number of pool workers done with the tasks, guarded by the pool mutex */
+  int *order;     /* order in which the tasks are started, NULL for list order */
   void **commands;
   void **status;
   threadData_t *parent;
 } thread_data;
 
-static void* System_launchParallelTasksThread(void *in)
+typedef struct thread_pool {
+  pthread_mutex_t mutex;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  int numThreads;           /* number of created workers */
+  int busy;
+  unsigned long generation; /* incremented for every job */
+  thread_data *job;
+  int jobThreads;           /* workers with a smaller id take part in the current job */
+} thread_pool;
+
+static thread_pool threadPool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, NULL, 0};
+
+typedef struct task_size {
+  double size;
+  int index;
+} task_size;
+
+static void System_launchParallelTasksWork(thread_data *data)
 {
-  int exitstatus = 1;
   int n;
-  thread_data *data = (thread_data*) in;
   while (1) {
     int fail = 1;
-    pthread_mutex_lock(&data->mutex);
-    n = data->current++;
-    pthread_mutex_unlock(&data->mutex);
+    n = SYSTEM_ATOMIC_INCREMENT(&data->current);
     if (data->fail || n >= data->len) break;
+    if (data->order) {
+      n = data->order[n];
+    }
     MMC_TRY_TOP()
     threadData->parent = data->parent;
     threadData->mmc_thread_work_exit = threadData->mmc_jumper;
@@ -900,9 +933,123 @@ static void* System_launchParallelTasksThread(void *in)
       data->fail = 1;
     }
   }
+}
+
+static void* System_launchParallelTasksThread(void *in)
+{
+  System_launchParallelTasksWork((thread_data*) in);
+  return NULL;
+}
+
+static void* System_launchParallelTasksWorker(void *in)
+{
+  int id = (int) (size_t) in;
+  unsigned long generation;
+  thread_data *data;
+  pthread_mutex_lock(&threadPool.mutex);
+  /* Workers are created while the job that needs them is started. The job
+   * cannot finish without this worker, so it is still the current one. */
+  generation = threadPool.generation - 1;
+  while (1) {
+    while (threadPool.generation == generation) {
+      pthread_cond_wait(&threadPool.start, &threadPool.mutex);
+    }
+    generation = threadPool.generation;
+    data = id < threadPool.jobThreads ? threadPool.job : NULL;
+    pthread_mutex_unlock(&threadPool.mutex);
+    if (data) {
+      System_launchParallelTasksWork(data);
+    }
+    pthread_mutex_lock(&threadPool.mutex);
+    if (data && ++data->finished == data->numThreads) {
+      pthread_cond_signal(&threadPool.done);
+    }
+  }
   return NULL;
 }
 
+/* Runs the tasks on the worker pool. Returns 0 if the pool was busy or no worker could be created. */
+static int System_launchParallelTasksPool(thread_data *data, pthread_attr_t *attr)
+{
+  pthread_t th;
+  pthread_mutex_lock(&threadPool.mutex);
+  if (threadPool.busy) {
+    pthread_mutex_unlock(&threadPool.mutex);
+    return 0;
+  }
+  while (threadPool.numThreads < data->numThreads) {
+    if (GC_pthread_create(&th, attr, System_launchParallelTasksWorker, (void*) (size_t) threadPool.numThreads)) {
+      break;
+    }
+    threadPool.numThreads++;
+  }
+  if (threadPool.numThreads == 0) {
+    pthread_mutex_unlock(&threadPool.mutex);
+    return 0;
+  }
+  if (data->numThreads > threadPool.numThreads) {
+    data->numThreads = threadPool.numThreads;
+  }
+  threadPool.busy = 1;
+  threadPool.job = data;
+  threadPool.jobThreads = data->numThreads;
+  threadPool.generation++;
+  pthread_cond_broadcast(&threadPool.start);
+  while (data->finished < data->numThreads) {
+    pthread_cond_wait(&threadPool.done, &threadPool.mutex);
+  }
+  threadPool.busy = 0;
+  pthread_mutex_unlock(&threadPool.mutex);
+  return 1;
+}
+
+/* Runs the tasks on threads that are created for this call only. */
+static void System_launchParallelTasksThreads(thread_data *data, pthread_attr_t *attr)
+{
+  int i;
+#if !defined(_MSC_VER)
+  pthread_t th[data->numThreads];
+#else /* MSVC */
+  pthread_t *th = (pthread_t*) omc_alloc_interface.malloc(sizeof(pthread_t)*data->numThreads);
+#endif
+  memset(th, 0, data->numThreads*sizeof(pthread_t));
+  for (i=0; i<data->numThreads; i++) {
+    if (GC_pthread_create(&th[i], attr, System_launchParallelTasksThread, data)) {
+      /* GC_pthread_create failed. We need to join already created threads though... */
+      const char *tok[1] = {strerror(errno)};
+      data->fail = 1;
+      c_add_message(NULL,5999,
+        ErrorType_scripting,
+        ErrorLevel_internal,
+        gettext("System.launchParallelTasks: Failed to create thread: %s"),
+        NULL,
+        0);
+      break;
+    }
+  }
+  for (i=0; i<data->numThreads; i++) {
+    if (th[i] && GC_pthread_join(th[i], NULL)) {
+      const char *tok[1] = {strerror(errno)};
+      data->fail = 1;
+      c_add_message(NULL,5999,
+        ErrorType_scripting,
+        ErrorLevel_internal,
+        gettext("System.launchParallelTasks: Failed to join thread: %s"),
+        NULL,
+        0);
+    }
+  }
+}
+
+static int System_compareTaskSize(const void *a, const void *b)
+{
+  const task_size *t1 = (const task_size*) a, *t2 = (const task_size*) b;
+  if (t1->size != t2->size) {
+    return t1->size < t2->size ? 1 : -1;
+  }
+  return t1->index - t2->index;
+}
+
 static void* System_launchParallelTasksSerial(threadData_t *threadData, void *dataLst, modelica_metatype (*fn)(threadData_t *,modelica_metatype))
 {
   void *result = mmc_mk_nil();
@@ -910,24 +1057,27 @@ static void* System_launchParallelTasksSerial(threadData_t *threadData, void *da
     result = mmc_mk_cons(fn(threadData, MMC_CAR(dataLst)),result);
     dataLst = MMC_CDR(dataLst);
   }
-  return listReverse(dataLst);
+  return listReverse(result);
 }
 
-extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads, void *dataLst, modelica_metatype (*fn)(threadData_t *,modelica_metatype))
+static void* System_launchParallelTasksImpl(threadData_t *threadData, int numThreads, void *dataLst, void *sizeLst, modelica_metatype (*fn)(threadData_t *,modelica_metatype))
 {
   int len = listLength(dataLst), i;
   void *result = mmc_mk_nil();
   thread_data data = {0};
+  pthread_attr_t *attr = NULL;
 #if !defined(_MSC_VER)
   void *commands[len];
   void *status[len];
-  pthread_t th[numThreads];
+  int order[len];
+  task_size sizes[len];
   int isInteger = 0;
 
 #if defined(__MINGW32__)
   /* adrpo: set thread stack size on Windows to 4MB */
-  pthread_attr_t attr;
-  if (pthread_attr_init(&attr))
+  pthread_attr_t mingwAttr;
+  attr = &mingwAttr;
+  if (pthread_attr_init(attr))
   {
     const char *tok[1] = {strerror(errno)};
     data.fail = 1;
@@ -940,13 +1090,13 @@ extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads
     MMC_THROW_INTERNAL();
   }
   /* try to set a stack size of 4MB */
-  if (pthread_attr_setstacksize(&attr, 4194304))
+  if (pthread_attr_setstacksize(attr, 4194304))
   {
     /* did not work, try half 2MB */
-    if (pthread_attr_setstacksize(&attr, 2097152))
+    if (pthread_attr_setstacksize(attr, 2097152))
     {
       /* did not work, try half 1MB */
-      if (pthread_attr_setstacksize(&attr, 1048576))
+      if (pthread_attr_setstacksize(attr, 1048576))
       {
         const char *tok[1] = {strerror(errno)};
         data.fail = 1;
@@ -965,7 +1115,9 @@ extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads
 #else /* MSVC */
   void **commands = (void**) omc_alloc_interface.malloc(sizeof(void*)*len);
   void **status = (void**) omc_alloc_interface.malloc(sizeof(void*)*len);
-  pthread_t *th = (pthread_t*) omc_alloc_interface.malloc(sizeof(pthread_t)*numThreads);
+  int *order = (int*) omc_alloc_interface.malloc_atomic(sizeof(int)*len);
+  task_size *sizes = (task_size*) omc_alloc_interface.malloc_atomic(sizeof(task_size)*len);
+  int isInteger = 0;
 #endif
   if (len == 0) {
     return mmc_mk_nil();
@@ -976,9 +1128,7 @@ extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads
   /* Make sure we get nothing unexpected here */
   memset(commands, 0, len*sizeof(void*));
   memset(status, 0, len*sizeof(void*));
-  memset(th, 0, numThreads*sizeof(pthread_t));
 
-  pthread_mutex_init(&data.mutex,NULL);
   data.fn = fn;
   data.current = 0;
   data.len = len;
@@ -990,38 +1140,32 @@ extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads
     commands[i] = MMC_CAR(dataLst);
     status[i] = 0; /* just in case */
   }
-  numThreads = numThreads > len ? len : numThreads;
-  for (i=0; i<numThreads; i++) {
-    if (GC_pthread_create(&th[i],
-#if defined(__MINGW32__)
-    &attr,
-#else
-    NULL,
-#endif
-    System_launchParallelTasksThread,&data)) {
-      /* GC_pthread_create failed. We need to join already created threads though... */
-      const char *tok[1] = {strerror(errno)};
-      data.fail = 1;
+
+  /* Start the largest tasks first */
+  if (sizeLst) {
+    if (listLength(sizeLst) != len) {
       c_add_message(NULL,5999,
         ErrorType_scripting,
         ErrorLevel_internal,
-        gettext("System.launchParallelTasks: Failed to create thread: %s"),
+        gettext("System.launchParallelTasksSized: Got a different number of sizes than tasks."),
         NULL,
         0);
-      break;
+      MMC_THROW_INTERNAL();
     }
-  }
-  for (i=0; i<numThreads; i++) {
-    if (th[i] && GC_pthread_join(th[i], NULL)) {
-      const char *tok[1] = {strerror(errno)};
-      data.fail = 1;
-      c_add_message(NULL,5999,
-        ErrorType_scripting,
-        ErrorLevel_internal,
-        gettext("System.launchParallelTasks: Failed to join thread: %s"),
-        NULL,
-        0);
+    for (i=0; i<len; i++, sizeLst = MMC_CDR(sizeLst)) {
+      sizes[i].size = mmc_unbox_real(MMC_CAR(sizeLst));
+      sizes[i].index = i;
+    }
+    qsort(sizes, len, sizeof(task_size), System_compareTaskSize);
+    for (i=0; i<len; i++) {
+      order[i] = sizes[i].index;
     }
+    data.order = order;
+  }
+
+  data.numThreads = numThreads > len ? len : numThreads;
+  if (!System_launchParallelTasksPool(&data, attr)) {
+    System_launchParallelTasksThreads(&data, attr);
   }
   if (data.fail) {
     MMC_THROW_INTERNAL();
@@ -1051,6 +1195,16 @@ extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads
   return result;
 }
 
+extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads, void *dataLst, modelica_metatype (*fn)(threadData_t *,modelica_metatype))
+{
+  return System_launchParallelTasksImpl(threadData, numThreads, dataLst, NULL, fn);
+}
+
+extern void* System_launchParallelTasksSized(threadData_t *threadData, int numThreads, void *dataLst, void *sizeLst, modelica_metatype (*fn)(threadData_t *,modelica_metatype))
+{
+  return System_launchParallelTasksImpl(threadData, numThreads, dataLst, sizeLst, fn);
+}
+
 void System_initGarbageCollector(void)
 {
   SystemImpl__initGarbageCollector();
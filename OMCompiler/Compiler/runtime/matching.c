@@ -24,8 +24,24 @@
 #include <ctype.h>
 #include <math.h>
 
+#include <pthread.h>
+
 #include "matchmaker.h"
 
+#if defined(_MSC_VER)
+#define NOMINMAX
+#include <windows.h>
+#define match_atomic_load(ptr) (*(volatile int*)(ptr))
+#define match_atomic_store(ptr, val) (*(volatile int*)(ptr) = (val))
+#define match_atomic_cas(ptr, old, val) (InterlockedCompareExchange((volatile LONG*)(ptr), (val), (old)) == (old))
+#define match_atomic_fetch_add(ptr, val) InterlockedExchangeAdd((volatile LONG*)(ptr), (val))
+#else
+#define match_atomic_load(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define match_atomic_store(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+#define match_atomic_cas(ptr, old, val) __atomic_compare_exchange_n((ptr), &(old), (val), 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#define match_atomic_fetch_add(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_RELAXED)
+#endif
+
 #define max(a, b) (a > b ? a : b)
 
 void match_dfs(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m) {
@@ -446,6 +462,164 @@ void match_pf_fair(int* col_ptrs, int* col_ids, int* match, int* row_match, int
   free(visited);
 }
 
+/* Shared data of the threads of match_pf_par */
+typedef struct pf_par_data {
+  int* col_ptrs;
+  int* col_ids;
+  int* match;
+  int* row_match;
+  int n;
+  int* visited;
+  int* colptrs;
+  int* lookahead;
+  int* unmatched;
+  int nunmatched;
+  int* nextunmatched;
+  int nnextunmatched;
+  int next;
+  int phase;
+  int augmented;
+} pf_par_data;
+
+/* Claims a row for the DFS of the calling thread, every row is claimed at most once per phase */
+static int pf_par_claim(int* visited, int row, int phase) {
+  int temp = match_atomic_load(&visited[row]);
+  return temp != phase && match_atomic_cas(&visited[row], temp, phase);
+}
+
+static void* pf_par_thread(void* arg) {
+  pf_par_data* d = (pf_par_data*) arg;
+  int* col_ptrs = d->col_ptrs;
+  int* col_ids = d->col_ids;
+  int* stack = (int*)malloc(sizeof(int) * d->n);
+  int i, row, col, stack_col, temp, ptr, eptr, stack_last, current_col, phase = d->phase;
+
+  while((i = match_atomic_fetch_add(&d->next, 1)) < d->nunmatched) {
+    current_col = d->unmatched[i];
+    stack[0] = current_col; stack_last = 0; d->colptrs[current_col] = col_ptrs[current_col];
+
+    while(stack_last > -1) {
+      stack_col = stack[stack_last];
+
+      eptr = col_ptrs[stack_col + 1];
+      for(ptr = d->lookahead[stack_col]; ptr < eptr; ptr++) {
+        row = col_ids[ptr];
+        if(match_atomic_load(&d->row_match[row]) == -1 && pf_par_claim(d->visited, row, phase)) {
+          break;
+        }
+      }
+      d->lookahead[stack_col] = ptr + 1;
+
+      if(ptr >= eptr) {
+        for(ptr = d->colptrs[stack_col]; ptr < eptr; ptr++) {
+          if(pf_par_claim(d->visited, col_ids[ptr], phase)) {
+            break;
+          }
+        }
+        d->colptrs[stack_col] = ptr + 1;
+
+        if(ptr == eptr) {
+          --stack_last;
+          continue;
+        }
+
+        row = col_ids[ptr];
+        col = match_atomic_load(&d->row_match[row]);
+        if(col != -1) {
+          stack[++stack_last] = col; d->colptrs[col] = col_ptrs[col];
+          continue;
+        }
+      }
+
+      /* the claimed rows and the columns matched to them belong to this thread for the rest of the phase */
+      row = col_ids[ptr];
+      while(row != -1){
+        col = stack[stack_last--];
+        temp = d->match[col];
+        d->match[col] = row; match_atomic_store(&d->row_match[row], col);
+        row = temp;
+      }
+      match_atomic_store(&d->augmented, 1);
+      break;
+    }
+
+    if(d->match[current_col] == -1) {
+      d->nextunmatched[match_atomic_fetch_add(&d->nnextunmatched, 1)] = current_col;
+    }
+  }
+
+  free(stack);
+  return NULL;
+}
+
+/*
+ * Multithreaded variant of match_pf (PF with lookahead), following
+ * A. Azad, M. Halappanavar, S. Rajamanickam, E. G. Boman, A. Khan and A. Pothen,
+ * 'Multithreaded Algorithms for Maximum Matching in Bipartite Graphs', IPDPS 2012.
+ *
+ * In every phase the threads start DFS searches from the unmatched columns. A row
+ * is claimed atomically by the first search that reaches it, so the augmenting
+ * paths found within a phase are vertex disjoint and can be applied without
+ * locks. The matching is maximum once a phase finds no augmenting path.
+ */
+void match_pf_par(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m, int nthreads) {
+  pf_par_data d;
+  pthread_t* threads;
+  int* swap;
+  int i, nstarted;
+
+  if(nthreads <= 1) {
+    match_pf(col_ptrs, col_ids, match, row_match, n, m);
+    return;
+  }
+
+  d.col_ptrs = col_ptrs; d.col_ids = col_ids; d.match = match; d.row_match = row_match; d.n = n;
+  d.visited = (int*)malloc(sizeof(int) * m);
+  d.colptrs = (int*)malloc(sizeof(int) * n);
+  d.lookahead = (int*)malloc(sizeof(int) * n);
+  d.unmatched = (int*)malloc(sizeof(int) * n);
+  d.nextunmatched = (int*)malloc(sizeof(int) * n);
+  threads = (pthread_t*)malloc(sizeof(pthread_t) * nthreads);
+
+  memset(d.visited, 0, sizeof(int) * m);
+  memcpy(d.lookahead, col_ptrs, sizeof(int) * n);
+
+  d.nunmatched = 0;
+  for(i = 0; i < n; i++) {
+    if(match[i] == -1 && col_ptrs[i] != col_ptrs[i+1]) {
+      d.unmatched[d.nunmatched++] = i;
+    }
+  }
+
+  d.phase = 1;
+  d.augmented = 1;
+  while(d.augmented && d.nunmatched > 0) {
+    d.augmented = 0; d.next = 0; d.nnextunmatched = 0;
+
+    /* threads that could not be started leave their work to the others, at worst to this one */
+    for(nstarted = 0; nstarted < nthreads - 1; nstarted++) {
+      if(pthread_create(&threads[nstarted], NULL, pf_par_thread, &d)) {
+        break;
+      }
+    }
+    pf_par_thread(&d);
+    for(i = 0; i < nstarted; i++) {
+      pthread_join(threads[i], NULL);
+    }
+
+    swap = d.unmatched; d.unmatched = d.nextunmatched; d.nextunmatched = swap;
+    d.nunmatched = d.nnextunmatched;
+    d.phase++;
+  }
+
+  free(threads);
+  free(d.nextunmatched);
+  free(d.unmatched);
+  free(d.lookahead);
+  free(d.colptrs);
+  free(d.visited);
+}
+
 void match_hk(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m) {
   int* queue = (int*)malloc(sizeof(int) * n);
   int* stack = (int*)malloc(sizeof(int) * m);
@@ -1245,7 +1419,7 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
     }
   }
 
-  if(matching_id >= do_hk || cheap_id > do_old_cheap) {
+  if((matching_id >= do_hk && matching_id <= do_pr_fifo_fair) || cheap_id > do_old_cheap) {
 
     row_ptrs = (int*) malloc((m+1) * sizeof(int));
     memset(row_ptrs, 0, (m+1) * sizeof(int));
@@ -1294,8 +1468,10 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
     match_abmp_bfs(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m);
   } else if(matching_id == do_pr_fifo_fair) {
     match_pr_fifo_fair(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m, relabel_period);
+  } else if(matching_id == do_pf_par) {
+    match_pf_par(col_ptrs, col_ids, match, row_match, n, m, (int) relabel_period);
   }
-  if(matching_id >= do_hk || cheap_id > do_old_cheap) {
+  if((matching_id >= do_hk && matching_id <= do_pr_fifo_fair) || cheap_id > do_old_cheap) {
     free(row_ids);
     free(row_ptrs);
   }
@@ -76,6 +76,12 @@ omsi_function_t* omsu_instantiate_omsi_function (omsi_values*   function_vars,
 
 omsi_algebraic_system_t* omsu_instantiate_alg_system_array (omsi_unsigned_int n_algebraic_system);
 
+omsi_sparsity_pattern* omsu_instantiate_sparsity_pattern (omsi_unsigned_int          n_columns,
+                                                          const omsi_unsigned_int*   column_count,
+                                                          const omsi_unsigned_int*   row_index,
+                                                          omsi_unsigned_int          n_colors,
+                                                          const omsi_unsigned_int*   column_color);
+
 omsi_status omsu_set_model_vars_and_params_start (omsi_values*     model_vars_and_params,
                                                   model_data_t*    model_data);
 
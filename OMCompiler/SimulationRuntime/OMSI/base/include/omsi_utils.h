@@ -94,6 +94,8 @@ void omsu_free_omsi_function(omsi_function_t*   omsi_function,
 void omsu_free_alg_system (omsi_algebraic_system_t* algebraic_system,
                            omsi_bool                shared_vars);
 
+void omsu_free_sparsity_pattern (omsi_sparsity_pattern* sparsity_pattern);
+
 void omsu_free_omsi_values(omsi_values* values);
 
 omsi_bool omsi_vr_out_of_range(omsi_t*               omsu,
@@ -379,6 +379,198 @@ omsi_algebraic_system_t* omsu_instantiate_alg_system_array (omsi_unsigned_int n_
 }
 
 
+/**
+ * \brief Color columns of a sparsity pattern greedily.
+ *
+ * Each column gets the smallest color that is not used by a column with a
+ * non-zero element in a common row.
+ *
+ * \param [in]      sparsity_pattern    Sparsity pattern in compressed sparse column format.
+ * \param [in,out]  color               On input: Zero initialized array of size `n_columns`. <br>
+ *                                      On output: Color `1,...,n_colors` of each column.
+ * \return                              Number of used colors or `0` in error case.
+ */
+static omsi_unsigned_int omsu_color_sparsity_pattern (const omsi_sparsity_pattern*  sparsity_pattern,
+                                                      omsi_unsigned_int*            color) {
+
+    /* Variables */
+    omsi_unsigned_int n_columns, n_colors;
+    omsi_unsigned_int* row_leadindex;
+    omsi_unsigned_int* row_columns;
+    omsi_unsigned_int* forbidden;
+    omsi_unsigned_int i, j, k, l, c;
+
+    n_columns = sparsity_pattern->n_columns;
+    n_colors = 0;
+
+    /* Allocate memory */
+    row_leadindex = (omsi_unsigned_int*) global_callback->allocateMemory(n_columns+1, sizeof(omsi_unsigned_int));
+    row_columns = (omsi_unsigned_int*) global_callback->allocateMemory(sparsity_pattern->n_nonzeros+1, sizeof(omsi_unsigned_int));
+    forbidden = (omsi_unsigned_int*) global_callback->allocateMemory(n_columns+2, sizeof(omsi_unsigned_int));
+    if (!row_leadindex || !row_columns || !forbidden) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+            "fmi2Instantiate: Could not allocate memory for coloring of sparsity pattern.");
+        global_callback->freeMemory(row_leadindex);
+        global_callback->freeMemory(row_columns);
+        global_callback->freeMemory(forbidden);
+        return 0;
+    }
+
+    /* Get columns of each row */
+    for (k=0; k<sparsity_pattern->n_nonzeros; k++) {
+        row_leadindex[sparsity_pattern->index[k]+1]++;
+    }
+    for (i=0; i<n_columns; i++) {
+        row_leadindex[i+1] += row_leadindex[i];
+        forbidden[i] = row_leadindex[i];
+    }
+    for (j=0; j<n_columns; j++) {
+        for (k=sparsity_pattern->leadindex[j]; k<sparsity_pattern->leadindex[j+1]; k++) {
+            row_columns[forbidden[sparsity_pattern->index[k]]++] = j;
+        }
+    }
+    memset(forbidden, 0, (n_columns+2)*sizeof(omsi_unsigned_int));
+
+    /* Give each column smallest color not used in any of its rows */
+    for (j=0; j<n_columns; j++) {
+        for (k=sparsity_pattern->leadindex[j]; k<sparsity_pattern->leadindex[j+1]; k++) {
+            i = sparsity_pattern->index[k];
+            for (l=row_leadindex[i]; l<row_leadindex[i+1]; l++) {
+                forbidden[color[row_columns[l]]] = j+1;
+            }
+        }
+        for (c=1; forbidden[c]==j+1; c++);
+        color[j] = c;
+        if (c > n_colors) {
+            n_colors = c;
+        }
+    }
+
+    /* Free memory */
+    global_callback->freeMemory(row_leadindex);
+    global_callback->freeMemory(row_columns);
+    global_callback->freeMemory(forbidden);
+
+    return n_colors;
+}
+
+
+/**
+ * \brief Create sparsity pattern with column coloring for Jacobian of an algebraic system.
+ *
+ * Builds compressed sparse column format from number of non-zero elements per
+ * column. If no valid coloring is given, columns get colored greedily.
+ *
+ * \param [in]  n_columns       Number of columns and rows of square Jacobian.
+ * \param [in]  column_count    Array of size `n_columns` with number of non-zero elements per column.
+ * \param [in]  row_index       Row index of each non-zero element, sorted by column.
+ * \param [in]  n_colors        Number of colors used in `column_color`.
+ * \param [in]  column_color    Array of size `n_columns` with color `1,...,n_colors` of each column.
+ *                              Can be `NULL`.
+ * \return                      New created `omsi_sparsity_pattern* sparsity_pattern`
+ *                              or `NULL` in error case.
+ */
+omsi_sparsity_pattern* omsu_instantiate_sparsity_pattern (omsi_unsigned_int          n_columns,
+                                                          const omsi_unsigned_int*   column_count,
+                                                          const omsi_unsigned_int*   row_index,
+                                                          omsi_unsigned_int          n_colors,
+                                                          const omsi_unsigned_int*   column_color) {
+
+    /* Variables */
+    omsi_sparsity_pattern* sparsity_pattern;
+    omsi_unsigned_int* color;
+    omsi_unsigned_int i;
+
+    if (n_columns == 0) {
+        return NULL;
+    }
+
+    /* Allocate memory */
+    sparsity_pattern = (omsi_sparsity_pattern*) global_callback->allocateMemory(1, sizeof(omsi_sparsity_pattern));
+    color = (omsi_unsigned_int*) global_callback->allocateMemory(n_columns, sizeof(omsi_unsigned_int));
+    if (!sparsity_pattern || !color) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+            "fmi2Instantiate: Could not allocate memory for omsi_sparsity_pattern struct.");
+        global_callback->freeMemory(sparsity_pattern);
+        global_callback->freeMemory(color);
+        return NULL;
+    }
+
+    /* Set compressed sparse column format */
+    sparsity_pattern->n_columns = n_columns;
+    sparsity_pattern->leadindex = (omsi_unsigned_int*) global_callback->allocateMemory(n_columns+1, sizeof(omsi_unsigned_int));
+    if (sparsity_pattern->leadindex) {
+        for (i=0; i<n_columns; i++) {
+            sparsity_pattern->leadindex[i+1] = sparsity_pattern->leadindex[i] + column_count[i];
+        }
+        sparsity_pattern->n_nonzeros = sparsity_pattern->leadindex[n_columns];
+        sparsity_pattern->index = (omsi_unsigned_int*) global_callback->allocateMemory(sparsity_pattern->n_nonzeros+1, sizeof(omsi_unsigned_int));
+        sparsity_pattern->values = (omsi_real*) global_callback->allocateMemory(sparsity_pattern->n_nonzeros+1, sizeof(omsi_real));
+    }
+    if (!sparsity_pattern->leadindex || !sparsity_pattern->index || !sparsity_pattern->values) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+            "fmi2Instantiate: Could not allocate memory for omsi_sparsity_pattern struct.");
+        omsu_free_sparsity_pattern(sparsity_pattern);
+        global_callback->freeMemory(color);
+        return NULL;
+    }
+    for (i=0; i<sparsity_pattern->n_nonzeros; i++) {
+        if (row_index[i] >= n_columns) {
+            filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "fmi2Instantiate: Row index %u of sparsity pattern is out of range.", row_index[i]);
+            omsu_free_sparsity_pattern(sparsity_pattern);
+            global_callback->freeMemory(color);
+            return NULL;
+        }
+        sparsity_pattern->index[i] = row_index[i];
+    }
+
+    /* Use given coloring or color columns */
+    for (i=0; column_color!=NULL && i<n_columns; i++) {
+        if (column_color[i] < 1 || column_color[i] > n_colors) {
+            break;
+        }
+        color[i] = column_color[i];
+    }
+    if (column_color!=NULL && i==n_columns) {
+        sparsity_pattern->n_colors = n_colors;
+    } else {
+        memset(color, 0, n_columns*sizeof(omsi_unsigned_int));
+        sparsity_pattern->n_colors = omsu_color_sparsity_pattern(sparsity_pattern, color);
+    }
+
+    /* Sort columns by color */
+    sparsity_pattern->color_leadindex = (omsi_unsigned_int*) global_callback->allocateMemory(sparsity_pattern->n_colors+1, sizeof(omsi_unsigned_int));
+    sparsity_pattern->color_columns = (omsi_unsigned_int*) global_callback->allocateMemory(n_columns, sizeof(omsi_unsigned_int));
+    if (sparsity_pattern->n_colors==0 || !sparsity_pattern->color_leadindex || !sparsity_pattern->color_columns) {
+        omsu_free_sparsity_pattern(sparsity_pattern);
+        global_callback->freeMemory(color);
+        return NULL;
+    }
+    for (i=0; i<n_columns; i++) {
+        sparsity_pattern->color_leadindex[color[i]]++;
+    }
+    for (i=1; i<=sparsity_pattern->n_colors; i++) {
+        sparsity_pattern->color_leadindex[i] += sparsity_pattern->color_leadindex[i-1];
+    }
+    for (i=n_columns; i-->0; ) {
+        sparsity_pattern->color_columns[--sparsity_pattern->color_leadindex[color[i]]] = i;
+    }
+    for (i=0; i<sparsity_pattern->n_colors; i++) {
+        sparsity_pattern->color_leadindex[i] = sparsity_pattern->color_leadindex[i+1];
+    }
+    sparsity_pattern->color_leadindex[sparsity_pattern->n_colors] = n_columns;
+
+    global_callback->freeMemory(color);
+
+    filtered_base_logger(global_logCategories, log_all, omsi_ok,
+        "fmi2Instantiate: Jacobian with %u non-zero elements evaluated with %u of %u directional derivatives.",
+        sparsity_pattern->n_nonzeros, sparsity_pattern->n_colors, n_columns);
+
+    return sparsity_pattern;
+}
+
+
 /**
  * \brief Create `values` struct of type `omsi_values`.
  *
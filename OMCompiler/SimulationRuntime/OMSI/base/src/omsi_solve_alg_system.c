@@ -120,7 +120,11 @@ omsi_status omsi_solve_algebraic_system (omsi_algebraic_system_t*   alg_system,
 /**
  * \brief Evaluate `omsi_function` jacobian to get the analytical jacobian.
  *
- * Build jacobian row wise with directional derivatives.
+ * Build jacobian column wise with directional derivatives. If the algebraic
+ * system has a sparsity pattern, all columns of one color are evaluated with
+ * one directional derivative and the whole matrix is handed to the solver in
+ * compressed sparse column format. Otherwise each column is evaluated on its
+ * own and copied as dense column.
  *
  * \param [in,out] alg_system                   Pointer to struct containing algebraic system.
  * \param [in] read_only_model_vars_and_params  Pointer to read only `model_vars_and_params`
@@ -132,34 +136,84 @@ omsi_status omsi_get_analytical_jacobian (omsi_algebraic_system_t*  alg_system,
                                           const omsi_values*        read_only_model_vars_and_params) {
 
     /* Variables */
-    omsi_unsigned_int i;
+    omsi_function_t* jacobian;
+    omsi_sparsity_pattern* sparsity_pattern;
+    omsi_real* column;
+    omsi_unsigned_int i, j, k, c;
     omsi_unsigned_int seed_index;
 
+    jacobian = alg_system->jacobian;
+    sparsity_pattern = alg_system->sparsity_pattern;
+
     /* Set seed vars */
-    for (i=0; i<alg_system->jacobian->n_input_vars; i++) {
-        seed_index = alg_system->jacobian->input_vars_indices[i].index;
-        alg_system->jacobian->local_vars->reals[seed_index] = 0;
+    for (i=0; i<jacobian->n_input_vars; i++) {
+        seed_index = jacobian->input_vars_indices[i].index;
+        jacobian->local_vars->reals[seed_index] = 0;
+    }
+
+    if (sparsity_pattern != NULL && sparsity_pattern->n_columns == jacobian->n_input_vars) {
+        /* Build jacobian with one directional derivative per color */
+        for (c=0; c<sparsity_pattern->n_colors; c++) {
+            /* Activate seeds for all columns of current color */
+            for (i=sparsity_pattern->color_leadindex[c]; i<sparsity_pattern->color_leadindex[c+1]; i++) {
+                seed_index = jacobian->input_vars_indices[sparsity_pattern->color_columns[i]].index;
+                jacobian->local_vars->reals[seed_index] = 1;
+            }
+
+            /* Evaluate directional derivative */
+            jacobian->evaluate(jacobian, read_only_model_vars_and_params, NULL);
+
+            /* Extract non-zero elements of each column of current color and reset seeds */
+            for (i=sparsity_pattern->color_leadindex[c]; i<sparsity_pattern->color_leadindex[c+1]; i++) {
+                j = sparsity_pattern->color_columns[i];
+                for (k=sparsity_pattern->leadindex[j]; k<sparsity_pattern->leadindex[j+1]; k++) {
+                    sparsity_pattern->values[k] = jacobian->local_vars->reals[jacobian->output_vars_indices[sparsity_pattern->index[k]].index];
+                }
+                seed_index = jacobian->input_vars_indices[j].index;
+                jacobian->local_vars->reals[seed_index] = 0;
+            }
+        }
+
+        /* Set all columns of matrix A */
+        solver_set_matrix_A_sparse(alg_system->solver_data,
+                     NULL, sparsity_pattern->n_columns,
+                     sparsity_pattern->leadindex,
+                     sparsity_pattern->index,
+                     sparsity_pattern->values);
+
+        return omsi_ok;
+    }
+
+    /* Allocate memory */
+    column = (omsi_real*) global_callback->allocateMemory(jacobian->n_output_vars, sizeof(omsi_real));
+    if (column == NULL) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                        "fmi2Evaluate: Could not allocate memory.");
+        return omsi_fatal;
     }
 
-    /* Build jacobian row wise with directional derivatives */  /* ToDo: check if realy row wise and not column wise... */
-    for (i=0; i<alg_system->jacobian->n_output_vars; i++) {    /* ToDo: Add coloring here */
-        /* Activate seed for current row*/
-        seed_index = alg_system->jacobian->input_vars_indices[i].index;
-        alg_system->jacobian->local_vars->reals[seed_index] = 1;
+    /* Build jacobian column wise with directional derivatives */
+    for (i=0; i<jacobian->n_input_vars; i++) {
+        /* Activate seed for current column */
+        seed_index = jacobian->input_vars_indices[i].index;
+        jacobian->local_vars->reals[seed_index] = 1;
 
         /* Evaluate directional derivative */
-        alg_system->jacobian->evaluate(alg_system->jacobian, read_only_model_vars_and_params, NULL);
+        jacobian->evaluate(jacobian, read_only_model_vars_and_params, NULL);
 
-        /* Set i-th row of matrix A */
-        solver_set_matrix_A(alg_system->solver_data,
-                     NULL, alg_system->jacobian->n_output_vars,
-                     &i, 1,
-                     &alg_system->jacobian->local_vars->reals[alg_system->jacobian->output_vars_indices[0].index]);
+        /* Set i-th column of matrix A */
+        for (j=0; j<jacobian->n_output_vars; j++) {
+            column[j] = jacobian->local_vars->reals[jacobian->output_vars_indices[j].index];
+        }
+        solver_set_matrix_A_columns(alg_system->solver_data, &i, 1, column);
 
         /* Reset seed vector */
-        alg_system->jacobian->local_vars->reals[seed_index] = 0;
+        jacobian->local_vars->reals[seed_index] = 0;
     }
 
+    /* Free memory */
+    global_callback->freeMemory(column);
+
     return omsi_ok;
 }
 
@@ -421,6 +421,7 @@ void omsu_free_alg_system (omsi_algebraic_system_t* algebraic_system,
     global_callback->freeMemory(algebraic_system->zerocrossing_indices);
     omsu_free_omsi_function(algebraic_system->jacobian, shared_vars);
     omsu_free_omsi_function(algebraic_system->functions, shared_vars);
+    omsu_free_sparsity_pattern(algebraic_system->sparsity_pattern);
 
     /* Free solver data */
     solver_free(algebraic_system->solver_data);
@@ -429,6 +430,25 @@ void omsu_free_alg_system (omsi_algebraic_system_t* algebraic_system,
 }
 
 
+/*
+ * Deallocate memory of omsi_sparsity_pattern struct.
+ */
+void omsu_free_sparsity_pattern (omsi_sparsity_pattern* sparsity_pattern) {
+
+    if (sparsity_pattern==NULL) {
+        return;
+    }
+
+    global_callback->freeMemory(sparsity_pattern->leadindex);
+    global_callback->freeMemory(sparsity_pattern->index);
+    global_callback->freeMemory(sparsity_pattern->color_leadindex);
+    global_callback->freeMemory(sparsity_pattern->color_columns);
+    global_callback->freeMemory(sparsity_pattern->values);
+
+    global_callback->freeMemory(sparsity_pattern);
+}
+
+
 /*
  * Free memory for omsi_values struct and all its components
 */
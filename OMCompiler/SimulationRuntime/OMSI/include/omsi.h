@@ -331,6 +331,29 @@ typedef struct omsi_sample {
 }omsi_sample;
 
 
+/**
+ * \brief Sparsity pattern of a Jacobian matrix with column coloring.
+ *
+ * Pattern is stored in compressed sparse column (CSC) format. Columns of the
+ * same color have no non-zero element in a common row, so they can be
+ * evaluated with one directional derivative.
+ */
+typedef struct omsi_sparsity_pattern {
+    omsi_unsigned_int   n_columns;          /**< Number of columns of matrix. */
+    omsi_unsigned_int   n_nonzeros;         /**< Number of non-zero elements. */
+    omsi_unsigned_int*  leadindex;          /**< Array of size `n_columns+1`. Non-zero elements of column `j`
+                                              *   are stored at `leadindex[j]` to `leadindex[j+1]-1`. */
+    omsi_unsigned_int*  index;              /**< Array of size `n_nonzeros` with row index of each non-zero element. */
+
+    omsi_unsigned_int   n_colors;           /**< Number of colors. */
+    omsi_unsigned_int*  color_leadindex;    /**< Array of size `n_colors+1`. Columns of color `c` are stored
+                                              *   at `color_leadindex[c]` to `color_leadindex[c+1]-1`. */
+    omsi_unsigned_int*  color_columns;      /**< Array of size `n_columns` with columns sorted by color. */
+
+    omsi_real*          values;             /**< Work array of size `n_nonzeros` for non-zero elements. */
+}omsi_sparsity_pattern;
+
+
 /** \brief General algebraic system.
  *
  *  Struct containing information for one linear or non-linear algebraic system
@@ -356,6 +379,8 @@ typedef struct omsi_algebraic_system_t {
                                           *    * non-linear case: jacobian describes f' */
 
     struct omsi_function_t* functions;  /**< Pointer to omsi_function for residual function. */
+    omsi_sparsity_pattern* sparsity_pattern; /**< Sparsity pattern of `jacobian`.
+                                              *   If `NULL` jacobian is evaluated column by column. */
     solver_data* solver_data;           /**< Pointer to solver instance. */
 }omsi_algebraic_system_t;
 
@@ -226,6 +226,26 @@ typedef void    (*solver_interact_matrix_element)   (void*,
                                                      solver_unsigned_int,
                                                      solver_real*);
 
+/** \fn void (*solver_interact_matrix_columns) (void* specific_data, const solver_unsigned_int* column, solver_unsigned_int n_column, const solver_unsigned_int* leadindex, const solver_unsigned_int* index, const solver_real* value)
+ * \brief Overwrite whole columns of a matrix in solver specific data.
+ *
+ * \param [in,out]  specific_data   Solver specific data containing matrix.
+ * \param [in]      column          Array of size `n_column` with columns to set.
+ *                                  If `NULL` set first `n_column` columns.
+ * \param [in]      n_column        Number of columns to set.
+ * \param [in]      leadindex       Array of size `n_column+1` in compressed sparse column format.
+ *                                  `NULL` if `value` contains dense columns.
+ * \param [in]      index           Row indices of non-zero elements, `NULL` for dense columns.
+ * \param [in]      value           Dense columns in column-major order of size `n*n_column`
+ *                                  or non-zero elements at positions given by `leadindex`.
+ */
+typedef void    (*solver_interact_matrix_columns)   (void*,
+                                                     const solver_unsigned_int*,
+                                                     solver_unsigned_int,
+                                                     const solver_unsigned_int*,
+                                                     const solver_unsigned_int*,
+                                                     const solver_real*);
+
 typedef void    (*solver_interact_vector_element)   (void*,
                                                      solver_unsigned_int,
                                                      solver_real*);
@@ -256,6 +276,7 @@ typedef solver_int (*residual_wrapper_func)         (solver_real*,
 typedef struct solver_linear_callbacks {
     solver_interact_matrix_element get_A_element;   /**< Callback function to get element(s) of `A`. */
     solver_interact_matrix_element set_A_element;   /**< Callback function to set element(s) of `A`. */
+    solver_interact_matrix_columns set_A_columns;   /**< Callback function to set whole columns of `A`. */
 
     solver_interact_vector_element get_b_element;   /**< Callback function to get element(s) of `b`. */
     solver_interact_vector_element set_b_element;   /**< Callback function to set element(s) of `b`. */
@@ -275,6 +296,7 @@ typedef struct solver_non_linear_callbacks {
     solver_interact_vector_element get_x_element;           /**< Callback function to get element(s) of solution vector `x`. */
 
     solver_interact_matrix_element set_jacobian_element;    /**< Callback function to set element of Jacobian matrix*/
+    solver_interact_matrix_columns set_jacobian_columns;    /**< Callback function to set whole columns of Jacobian matrix. */
 } solver_non_linear_callbacks;
 
 
@@ -73,6 +73,18 @@ void solver_set_matrix_A(const solver_data*            solver,
                          const solver_unsigned_int     n_row,
                          solver_real*                  value);
 
+void solver_set_matrix_A_columns(const solver_data*            solver,
+                                 const solver_unsigned_int*    column,
+                                 const solver_unsigned_int     n_column,
+                                 const solver_real*            value);
+
+void solver_set_matrix_A_sparse(const solver_data*            solver,
+                                const solver_unsigned_int*    column,
+                                const solver_unsigned_int     n_column,
+                                const solver_unsigned_int*    leadindex,
+                                const solver_unsigned_int*    index,
+                                const solver_real*            value);
+
 void solver_get_matrix_A(solver_data*          solver,
                          solver_unsigned_int*  column,
                          solver_unsigned_int   n_column,
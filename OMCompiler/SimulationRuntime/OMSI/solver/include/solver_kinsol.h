@@ -45,6 +45,7 @@
 
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
 
 /* Headers for sundials kinsol */
 #include <kinsol/kinsol.h>
@@ -117,6 +118,13 @@ void solver_kinsol_set_jacobian_element(void*                  solver_specififc_
                                         solver_unsigned_int    column,
                                         solver_real*           value);
 
+void solver_kinsol_set_jacobian_columns(void*                       solver_specififc_data,
+                                        const solver_unsigned_int*  column,
+                                        solver_unsigned_int         n_column,
+                                        const solver_unsigned_int*  leadindex,
+                                        const solver_unsigned_int*  index,
+                                        const solver_real*          value);
+
 solver_status solver_kinsol_scaling (solver_data* general_solver_data);
 
 solver_status solver_kinsol_error_handler(solver_data*  solver,
@@ -51,6 +51,7 @@
 
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -98,6 +99,13 @@ void solver_lapack_set_A_element(void*                  solver_specififc_data,
                                  solver_unsigned_int    column,
                                  solver_real*           value);
 
+void solver_lapack_set_A_columns(void*                      specific_data,
+                                 const solver_unsigned_int* column,
+                                 solver_unsigned_int        n_column,
+                                 const solver_unsigned_int* leadindex,
+                                 const solver_unsigned_int* index,
+                                 const solver_real*         value);
+
 void solver_lapack_get_b_element(void*                  solver_specififc_data,
                                  solver_unsigned_int    index,
                                  solver_real*           value);
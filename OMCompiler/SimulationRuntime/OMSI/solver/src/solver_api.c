@@ -122,6 +122,7 @@ solver_data* solver_allocate(solver_name            name,
 
             lin_callbacks->get_A_element = &solver_lapack_get_A_element;
             lin_callbacks->set_A_element = &solver_lapack_set_A_element;
+            lin_callbacks->set_A_columns = &solver_lapack_set_A_columns;
 
             lin_callbacks->get_b_element = &solver_lapack_get_b_element;
             lin_callbacks->set_b_element = &solver_lapack_set_b_element;
@@ -137,6 +138,7 @@ solver_data* solver_allocate(solver_name            name,
             non_lin_callbacks->solve_eq_system = solver_kinsol_solve;
             non_lin_callbacks->get_x_element = solver_kinsol_get_x_element;
             non_lin_callbacks->set_jacobian_element = solver_kinsol_set_jacobian_element;
+            non_lin_callbacks->set_jacobian_columns = solver_kinsol_set_jacobian_columns;
             solver->solver_callbacks = non_lin_callbacks;
             break;
         default:
@@ -352,6 +354,82 @@ void solver_set_matrix_A(const solver_data*            solver,
 }
 
 
+/** \brief Overwrite whole columns of matrix A with dense columns from array value.
+ *
+ * For linear solvers columns of matrix `A` are set, for non-linear solvers
+ * columns of the Jacobian matrix. Each column is copied in one piece into
+ * the solver specific data.
+ *
+ * \param [in,out]  solver      Struct with used solver, containing matrix in
+ *                              solver specific format.
+ * \param [in]      column      Array of dimension `n_column` of unsigned integers,
+ *                              specifying which columns to set. If column equals
+ *                              `NULL`, set the first `n_column` columns.
+ * \param [in]      n_column    Size of array `column`.
+ * \param [in]      value       Pointer to matrix with values, stored as array
+ *                              in column-major order of size `n_column*dim_n`.
+ */
+void solver_set_matrix_A_columns(const solver_data*            solver,
+                                 const solver_unsigned_int*    column,
+                                 const solver_unsigned_int     n_column,
+                                 const solver_real*            value)
+{
+    solver_set_matrix_A_sparse(solver, column, n_column, NULL, NULL, value);
+}
+
+
+/** \brief Overwrite whole columns of matrix A with sparse columns.
+ *
+ * For linear solvers columns of matrix `A` are set, for non-linear solvers
+ * columns of the Jacobian matrix. Values are given in compressed sparse column
+ * format, all elements of the given columns not contained in the pattern are
+ * set to zero.
+ *
+ *   e.g set_matrix_A_sparse(solver, [1,3], 2, [0,2,3], [0,2,1], [0.1, 0.2, 0.3]);
+ *   will set columns 1 and 3 of 4-times-4 matrix A to:<br>
+ *         / a_00  0.1   a_02  0   \<br>
+ *     A = | a_10  0     a_12  0.3 |<br>
+ *         | a_20  0.2   a_22  0   |<br>
+ *         \ a_30  0     a_32  0   /<br>
+ *
+ * \param [in,out]  solver      Struct with used solver, containing matrix in
+ *                              solver specific format.
+ * \param [in]      column      Array of dimension `n_column` of unsigned integers,
+ *                              specifying which columns to set. If column equals
+ *                              `NULL`, set the first `n_column` columns.
+ * \param [in]      n_column    Size of array `column`.
+ * \param [in]      leadindex   Array of size `n_column+1`. Non-zero elements of
+ *                              `i`-th column are stored in `index` and `value` from
+ *                              `leadindex[i]` to `leadindex[i+1]-1`. If `NULL`,
+ *                              `value` contains dense columns.
+ * \param [in]      index       Row index of each non-zero element.
+ * \param [in]      value       Values of non-zero elements.
+ */
+void solver_set_matrix_A_sparse(const solver_data*            solver,
+                                const solver_unsigned_int*    column,
+                                const solver_unsigned_int     n_column,
+                                const solver_unsigned_int*    leadindex,
+                                const solver_unsigned_int*    index,
+                                const solver_real*            value)
+{
+    /* Variables */
+    solver_linear_callbacks* lin_callbacks;
+    solver_non_linear_callbacks* non_lin_callbacks;
+
+    if (leadindex == NULL) {
+        index = NULL;
+    }
+
+    if (solver->linear) {
+        lin_callbacks = solver->solver_callbacks;
+        lin_callbacks->set_A_columns(solver->specific_data, column, n_column, leadindex, index, value);
+    } else {
+        non_lin_callbacks = solver->solver_callbacks;
+        non_lin_callbacks->set_jacobian_columns(solver->specific_data, column, n_column, leadindex, index, value);
+    }
+}
+
+
 /** \brief Read matrix A and saves result in array value.
  *
  *  Used for linear solvers, to get values of matrix A stored in its solver
@@ -717,6 +795,8 @@ void solver_print_data (solver_data*    solver,
                     "\t\t get_A_element set: \t %s \t ( Address: %x )\n", lin_callbacks->get_A_element?"yes":"no", lin_callbacks->get_A_element);
             length += snprintf(buffer+length, MAX_BUFFER_SIZE-length,
                     "\t\t set_A_element set: \t %s \t ( Address: %x )\n", lin_callbacks->set_A_element?"yes":"no", lin_callbacks->set_A_element);
+            length += snprintf(buffer+length, MAX_BUFFER_SIZE-length,
+                    "\t\t set_A_columns set: \t %s \t ( Address: %x )\n", lin_callbacks->set_A_columns?"yes":"no", lin_callbacks->set_A_columns);
             length += snprintf(buffer+length, MAX_BUFFER_SIZE-length,
                     "\t\t get_b_element set: \t %s \t ( Address: %x )\n", lin_callbacks->get_b_element?"yes":"no", lin_callbacks->get_b_element);
             length += snprintf(buffer+length, MAX_BUFFER_SIZE-length,
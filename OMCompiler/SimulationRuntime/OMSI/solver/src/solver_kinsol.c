@@ -442,6 +442,58 @@ void solver_kinsol_set_jacobian_element(void*                  solver_specififc_
 }
 
 
+/**
+ * \brief Overwrite whole columns of Jacobian matrix in kinsol specific solver data.
+ *
+ * Elements of a sparse column that are not in its pattern are set to zero.
+ *
+ * \param [in,out] solver_specififc_data    kinsol specific solver data.
+ * \param [in]     column                   Array of size `n_column` with columns to set.
+ *                                          If `NULL` set first `n_column` columns.
+ * \param [in]     n_column                 Number of columns to set.
+ * \param [in]     leadindex                Array of size `n_column+1`, non-zero elements
+ *                                          of `i`-th column are `leadindex[i]` to `leadindex[i+1]-1`.
+ *                                          `NULL` if `value` contains dense columns.
+ * \param [in]     index                    Row index of each non-zero element. `NULL` for dense columns.
+ * \param [in]     value                    Dense columns in column-major order or non-zero elements.
+ */
+void solver_kinsol_set_jacobian_columns(void*                       solver_specififc_data,
+                                        const solver_unsigned_int*  column,
+                                        solver_unsigned_int         n_column,
+                                        const solver_unsigned_int*  leadindex,
+                                        const solver_unsigned_int*  index,
+                                        const solver_real*          value)
+{
+    /* Variables */
+    solver_data_kinsol* kinsol_data;
+    solver_real* jacobian_column;
+    solver_unsigned_int i, k, n;
+
+    kinsol_data = solver_specififc_data;
+
+    if (kinsol_data->Jacobian == NULL) {
+        solver_logger(log_solver_error, "In function solver_kinsol_set_jacobian_columns: "
+                "Jacobian matrix not allocated.");
+        return;
+    }
+    n = kinsol_data->Jacobian->M;
+
+    for (i=0; i<n_column; i++) {
+        /* Access Jacobian(:,column) */
+        jacobian_column = DENSE_COL(kinsol_data->Jacobian, column ? column[i] : i);
+
+        if (index == NULL) {
+            memcpy(jacobian_column, &value[i*n], n*sizeof(solver_real));
+        } else {
+            memset(jacobian_column, 0, n*sizeof(solver_real));
+            for (k=leadindex[i]; k<leadindex[i+1]; k++) {
+                jacobian_column[index[k]] = value[k];
+            }
+        }
+    }
+}
+
+
 /*
  * ============================================================================
  * Helper functions
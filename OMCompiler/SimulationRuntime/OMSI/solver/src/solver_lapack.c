@@ -211,6 +211,51 @@ void solver_lapack_set_A_element(void*                  specific_data,
 }
 
 
+/**
+ * Overwrite whole columns of matrix `A` in LAPACK solver specific data.
+ *
+ * Elements of a sparse column that are not in its pattern are set to zero.
+ *
+ * \param [in,out] specific_data    LAPACK specific solver data.
+ * \param [in]     column           Array of size `n_column` with columns to set.
+ *                                  If `NULL` set first `n_column` columns.
+ * \param [in]     n_column         Number of columns to set.
+ * \param [in]     leadindex        Array of size `n_column+1`, non-zero elements
+ *                                  of `i`-th column are `leadindex[i]` to `leadindex[i+1]-1`.
+ *                                  `NULL` if `value` contains dense columns.
+ * \param [in]     index            Row index of each non-zero element. `NULL` for dense columns.
+ * \param [in]     value            Dense columns in column-major order or non-zero elements.
+ */
+void solver_lapack_set_A_columns(void*                      specific_data,
+                                 const solver_unsigned_int* column,
+                                 solver_unsigned_int        n_column,
+                                 const solver_unsigned_int* leadindex,
+                                 const solver_unsigned_int* index,
+                                 const solver_real*         value) {
+
+    /* Variables */
+    solver_data_lapack* lapack_data;
+    solver_real* A_column;
+    solver_unsigned_int i, k;
+
+    lapack_data = specific_data;
+
+    for (i=0; i<n_column; i++) {
+        /* Access A(:,column) */
+        A_column = &lapack_data->A[(column ? column[i] : i)*lapack_data->lda];
+
+        if (index == NULL) {
+            memcpy(A_column, &value[i*lapack_data->n], lapack_data->n*sizeof(solver_real));
+        } else {
+            memset(A_column, 0, lapack_data->n*sizeof(solver_real));
+            for (k=leadindex[i]; k<leadindex[i+1]; k++) {
+                A_column[index[k]] = value[k];
+            }
+        }
+    }
+}
+
+
 /**
  * Get value of element `b(index)` in LAPACK solver specific data.
  *
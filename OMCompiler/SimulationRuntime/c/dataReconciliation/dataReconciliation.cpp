@@ -34,12 +34,14 @@
 #include "simulation/solver/external_input.h"
 #include "simulation/options.h"
 #include "simulation/solver/model_help.h"
+#include "simulation/solver/jacobianColors.h"
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <fstream>
 #include <vector>
 #include <algorithm>
+#include <utility>
 #include <iomanip>
 #include <stdlib.h>
 #include <math.h>
@@ -50,11 +52,14 @@
 
 extern "C"
 {
-int dgesv_(int *n, int *nrhs, double *a, int *lda, int *ipiv, double *b, int *ldb, int *info);
 int dgemm_(char *transa, char *transb, int *m, int *n, int *k, double *alpha, double *a, int *lda,
 		double *b, int *ldb, double *beta, double *c, int *ldc);
-int dgetrf_(int *m, int *n, double *a, int *lda, int *ipiv, int *info);
-int dgetri_(int *n, double *a, int *lda, int *ipiv, double *work, int *lwork, int *info);
+int dgemv_(char *trans, int *m, int *n, double *alpha, double *a, int *lda, double *x, int *incx,
+		double *beta, double *y, int *incy);
+int dpotrf_(char *uplo, int *n, double *a, int *lda, int *info);
+int dpotrs_(char *uplo, int *n, int *nrhs, double *a, int *lda, double *b, int *ldb, int *info);
+int dsytrf_(char *uplo, int *n, double *a, int *lda, int *ipiv, double *work, int *lwork, int *info);
+int dsytrs_(char *uplo, int *n, int *nrhs, double *a, int *lda, int *ipiv, double *b, int *ldb, int *info);
 int dscal_(int *n, double *da, double *dx, int *incx);
 int dcopy_(int *n, double *dx, int *incx, double *dy, int *incy);
 }
@@ -77,17 +82,86 @@ struct csvData {
 	vector< vector<string> > rx;
 };
 
+/*
+ * Dense matrix stored in column major, the handle owns the data.
+ * It can only be moved, so matrices are never copied by accident,
+ * use copyMatrix() for an explicit copy
+ */
 struct matrixData {
 	int rows;
 	int column;
 	double * data;
+
+	matrixData() : rows(0), column(0), data(NULL) {}
+	matrixData(int r, int c) : rows(r), column(c), data((double*)calloc((size_t)r*c > 0 ? (size_t)r*c : 1,sizeof(double))) {}
+	matrixData(matrixData && other) : rows(other.rows), column(other.column), data(other.data)
+	{
+		other.rows = 0;
+		other.column = 0;
+		other.data = NULL;
+	}
+	matrixData & operator=(matrixData && other)
+	{
+		if(this != &other)
+		{
+			free(data);
+			rows = other.rows;
+			column = other.column;
+			data = other.data;
+			other.rows = 0;
+			other.column = 0;
+			other.data = NULL;
+		}
+		return *this;
+	}
+	~matrixData() { free(data); }
+	int size() const { return rows*column; }
+
+	matrixData(const matrixData &) = delete;
+	matrixData & operator=(const matrixData &) = delete;
 };
 
-struct inputData {
+/*
+ * Sparse matrix in compressed sparse column format, the rows of
+ * column j are index[leadindex[j]] ... index[leadindex[j+1]-1]
+ */
+struct sparseMatrixData {
 	int rows;
 	int column;
-	double * data;
+	vector<int> leadindex;
 	vector<int> index;
+	vector<double> values;
+
+	sparseMatrixData() : rows(0), column(0), leadindex(1,0) {}
+	sparseMatrixData(sparseMatrixData &&) = default;
+	sparseMatrixData & operator=(sparseMatrixData &&) = default;
+
+	sparseMatrixData(const sparseMatrixData &) = delete;
+	sparseMatrixData & operator=(const sparseMatrixData &) = delete;
+};
+
+/*
+ * Factorization of a symmetric matrix, Cholesky if ipiv is empty
+ * and LDLt with the pivots ipiv otherwise
+ */
+struct symmetricFactorization {
+	matrixData factor;
+	vector<int> ipiv;
+};
+
+/*
+ * Matrices of the reconciliation which only depend on the
+ * Jacobian F and Sx, they are reused as long as F does not change
+ */
+struct reconciliationSystem {
+	sparseMatrixData jacF;
+	matrixData FSx;                 // F*Sx, the transpose of Sx*Ft
+	symmetricFactorization FSxFt;   // factorization of F*Sx*Ft
+	matrixData Fstar;               // F* = (F*Sx*Ft)^-1 * F*Sx
+	matrixData reconciledSx;        // Sx - (Sx*Ft*F*)
+	int factorizations;
+
+	reconciliationSystem() : factorizations(0) {}
 };
 
 /*
@@ -272,21 +346,6 @@ csvData readcsvInputs(const char * filename, ofstream & logfile)
 	return data;
 }
 
-/*
- * Function which arranges the elements in column major
- */
-void initColumnMatrix(vector<double> data, int rows, int cols, double * tempSx)
-{
-	for (int i=0; i<rows; i++)
-	{
-		for (int j=0; j<cols;j++)
-		{
-			// store the matrix in column order
-			tempSx[j+i*rows]=data[i+j*rows];
-		}
-	}
-}
-
 /*
  * Function to print and debug whether the matrices are stored in column major
  */
@@ -383,271 +442,302 @@ void getDiagonalElements(double *matrix, int rows, int cols, double* result)
 }
 
 /*
- * Function to transpose the Matrix
+ * Function to Print the sparse matrix or its transpose in row based
+ * format, with the headers of the rows if given
  */
-void transposeMatrix(double * jacF, double * jacFT, int rows, int cols)
+void printSparseMatrix(const sparseMatrixData & A, bool transpose, const vector<string> * headers, string name, ofstream& logfile)
 {
-	for (int i=0;i<rows; i++)
+	int rows = transpose ? A.column : A.rows;
+	int cols = transpose ? A.rows : A.column;
+	int nnz = A.leadindex[A.column];
+	vector<int> start(rows+1,0), entryCols(nnz);
+	vector<double> entryValues(nnz), row(cols,0.0);
+
+	/* group the entries by printed row */
+	for (int j=0; j<A.column; j++)
 	{
-		for (int j=0;j<cols;j++)
+		for (int k=A.leadindex[j]; k<A.leadindex[j+1]; k++)
 		{
-			// Perform matrix transpose store the elements in column major
-			jacFT[i*cols+j]= jacF[i+j*rows] ;
+			start[(transpose ? j : A.index[k])+1]++;
 		}
 	}
+	for (int i=0; i<rows; i++)
+	{
+		start[i+1] += start[i];
+	}
+	vector<int> next(start.begin(), start.end()-1);
+	for (int j=0; j<A.column; j++)
+	{
+		for (int k=A.leadindex[j]; k<A.leadindex[j+1]; k++)
+		{
+			int p = next[transpose ? j : A.index[k]]++;
+			entryCols[p] = transpose ? A.index[k] : j;
+			entryValues[p] = A.values[k];
+		}
+	}
+
+	logfile << "\n" << "************ "<< name << " **********" <<"\n";
+	for (int i=0; i<rows; i++)
+	{
+		for (int p=start[i]; p<start[i+1]; p++)
+		{
+			row[entryCols[p]] = entryValues[p];
+		}
+		if(headers)
+		{
+			logfile << std::right << setw(10) << (*headers)[i];
+		}
+		for (int j=0; j<cols; j++)
+		{
+			logfile << std::right << setw(15) << row[j];
+		}
+		logfile << "\n";
+		for (int p=start[i]; p<start[i+1]; p++)
+		{
+			row[entryCols[p]] = 0.0;
+		}
+	}
+	logfile << "\n";
+	logfile.flush();
 }
 
+/*
+ * Function to Print the transpose of the matrix in row based format
+ */
+void printTransposedMatrix(double* matrix, int rows, int cols, string name, ofstream& logfile)
+{
+	logfile << "\n" << "************ "<< name << " **********" <<"\n";
+	for (int j=0;j<cols; j++)
+	{
+		for (int i=0;i<rows;i++)
+		{
+			logfile << std::right << setw(15) << matrix[i+j*rows];
+		}
+		logfile << "\n";
+	}
+	logfile << "\n";
+	logfile.flush();
+}
 
 /*
- * Matrix Multiplication using dgemm LaPack routine
+ * Function  which Copy Matrix
+ * using dcopy_ LAPACK routine
+ * this is mostly used when LAPACK routines override arrays
  */
-void solveMatrixMultiplication(double *matrixA, double *matrixB, int rowsa, int colsa, int rowsb, int colsb , double *matrixC, ofstream & logfile)
+matrixData copyMatrix(const matrixData & matdata)
 {
-	char trans = 'N';
-	double one = 1.0, zero = 0.0;
-	int rowsA = rowsa;
-	int colsA = colsa;
-	int rowsB = rowsb;
-	int colsB = colsb;
-	int common = colsa;
-
-	if(colsA!=rowsB)
-	{
-		//cout << "\n Error: Column of First Matrix not equal to Rows  of Second Matrix \n ";
-		//errorStreamPrint(LOG_STDOUT, 0, "solveMatrixMultiplication() Failed!, Column of First Matrix not equal to Rows of Second Matrix %i != %i.",colsA,rowsB);
-		logfile << "|  error   |   " << "solveMatrixMultiplication() Failed!, Column of First Matrix not equal to Rows of Second Matrix " << colsA << " != "<< rowsB <<  "\n";
-		logfile.close();
-		exit(1);
+	matrixData tmpcopymatrixdata(matdata.rows, matdata.column);
+	int n = matdata.size();
+	int inc = 1;
+	if(n > 0)
+	{
+		dcopy_(&n,matdata.data,&inc,tmpcopymatrixdata.data,&inc);
 	}
-	// solve matrix multiplication using dgemm_ LAPACK routine
-	dgemm_(&trans, &trans, &rowsA, &colsB, &common, &one, matrixA, &rowsA, matrixB, &common, &zero, matrixC, &rowsA);
+	return tmpcopymatrixdata;
 }
 
 /*
- * Solve the Linear System A*x=b using LAPACK Solver routine dgesv_
+ * Function which converts the sparse matrix to a
+ * dense matrix in column major
  */
-void solveSystemFstar(int n, int nhrs, double * tmpMatrixD, double * tmpMatrixC, ofstream & logfile)
+matrixData getDenseMatrix(const sparseMatrixData & A)
 {
-	int N=n; // number of rows of Matrix A
-	int NRHS=nhrs;  // number of columns of Matrix B
-	int LDA=N;
-	int LDB=N;
-	int ipiv[N];
-	int info;
-	// call the external function
-	dgesv_( &N, &NRHS, tmpMatrixD, &LDA, ipiv, tmpMatrixC, &LDB, &info);
-	if( info > 0 ) {
-		//cout << "The solution could not be computed, The info satus is : " << info;
-		//errorStreamPrint(LOG_STDOUT, 0, "solveSystemFstar() Failed !, The solution could not be computed, The info satus is %i.", info);
-		logfile << "|  error   |   " << "solveSystemFstar() Failed !, The solution could not be computed, The info satus is" << info << "\n";
-		logfile.close();
-		exit(1);
+	matrixData dense(A.rows, A.column);
+	for (int j=0; j<A.column; j++)
+	{
+		for (int k=A.leadindex[j]; k<A.leadindex[j+1]; k++)
+		{
+			dense.data[A.index[k]+(size_t)j*A.rows] = A.values[k];
+		}
 	}
+	return dense;
 }
 
 /*
- * Solve the matrix Subtraction of two matrices
+ * Function which computes the dense matrix product C=A*B
+ * of two sparse matrices, eg: F*Sx
  */
-void solveMatrixSubtraction(matrixData A, matrixData B, double * result, ofstream & logfile)
+matrixData solveSparseMatrixMultiplication(const sparseMatrixData & A, const sparseMatrixData & B, ofstream & logfile)
 {
-	if(A.rows!=B.rows && A.column!=B.column)
+	if(A.column!=B.rows)
 	{
-		//cout << "The Matrix Dimensions are not equal to Compute ! \n";
-		//errorStreamPrint(LOG_STDOUT, 0, "solveMatrixSubtraction() Failed !, The Matrix Dimensions are not equal to Compute ! %i != %i.", A.rows,B.rows);
-		logfile << "|  error   |   " << "solveMatrixSubtraction() Failed !, The Matrix Dimensions are not equal to Compute" << A.rows << " != " << B.rows << "\n";
+		logfile << "|  error   |   " << "solveSparseMatrixMultiplication() Failed!, Column of First Matrix not equal to Rows of Second Matrix " << A.column << " != "<< B.rows <<  "\n";
 		logfile.close();
 		exit(1);
 	}
-	//printColumnAlginment(A.data,A.rows,A.column,"A-Matrix");
-	//printColumnAlginment(B.data,B.rows,B.column,"B-Matrix");
-
-	// subtract elements in cloumn major
-	for(int i=0; i < A.rows*A.column; i++)
+	matrixData C(A.rows, B.column);
+	for (int j=0; j<B.column; j++)
 	{
-		result[i]=A.data[i]-B.data[i];
+		double * Cj = C.data + (size_t)j*C.rows;
+		for (int k=B.leadindex[j]; k<B.leadindex[j+1]; k++)
+		{
+			int i = B.index[k];
+			double b = B.values[k];
+			for (int l=A.leadindex[i]; l<A.leadindex[i+1]; l++)
+			{
+				Cj[A.index[l]] += A.values[l]*b;
+			}
+		}
 	}
+	return C;
 }
 
 /*
- * Solve the matrix addition of two matrices
+ * Function which computes the dense matrix product C=A*Bt of a dense
+ * matrix and the transpose of a sparse matrix, eg: (F*Sx)*Ft
  */
-matrixData solveMatrixAddition(matrixData A, matrixData B, ofstream & logfile)
+matrixData solveMatrixMultiplicationSparseTranspose(const matrixData & A, const sparseMatrixData & B, ofstream & logfile)
 {
-	double* result = (double*)calloc(A.rows*A.column,sizeof(double));
-	if(A.rows!=B.rows && A.column!=B.column)
+	if(A.column!=B.column)
 	{
-		//cout << "The Matrix Dimensions are not equal to Compute ! \n";
-		//errorStreamPrint(LOG_STDOUT, 0, "solveMatrixAddition() Failed !, The Matrix Dimensions are not equal to Compute ! %i != %i.", A.rows,B.rows);
-		logfile << "|  error   |   " << "solveMatrixAddition() Failed !, The Matrix Dimensions are not equal to Compute" << A.rows << " != " << B.rows << "\n";
+		logfile << "|  error   |   " << "solveMatrixMultiplicationSparseTranspose() Failed!, Column of First Matrix not equal to Column of Second Matrix " << A.column << " != "<< B.column <<  "\n";
 		logfile.close();
 		exit(1);
 	}
-	//printColumnAlginment(A.data,A.rows,A.column,"A-Matrix");
-	//printColumnAlginment(B.data,B.rows,B.column,"B-Matrix");
-	// Add the elements in cloumn major
-	for(int i=0; i < A.rows*A.column; i++)
+	matrixData C(A.rows, B.rows);
+	for (int j=0; j<B.column; j++)
 	{
-		result[i]=A.data[i]+B.data[i];
+		const double * Aj = A.data + (size_t)j*A.rows;
+		for (int k=B.leadindex[j]; k<B.leadindex[j+1]; k++)
+		{
+			double * Cp = C.data + (size_t)B.index[k]*C.rows;
+			double b = B.values[k];
+			for (int i=0; i<A.rows; i++)
+			{
+				Cp[i] += Aj[i]*b;
+			}
+		}
 	}
-	matrixData tmpadd_a_b = {A.rows,A.column,result};
-	return tmpadd_a_b;
+	return C;
 }
 
 /*
- * Function which Calculates the Matrix Multiplication
- * of (Sx*Ft)*Fstar
+ * Function which factorizes the symmetric matrix A with the Cholesky
+ * decomposition dpotrf_ LAPACK routine. If A is not positive definite,
+ * eg: linear dependent equations, the LDLt decomposition dsytrf_ is used
  */
-matrixData Calculate_Sx_Ft_Fstar(matrixData Sx, matrixData Ft, matrixData Fstar, ofstream & logfile)
+symmetricFactorization factorizeSymmetricMatrix(matrixData A, ofstream & logfile)
 {
-	// Sx*Ft
-	double* tmpMatrixA = (double*)calloc(Sx.rows*Ft.column,sizeof(double));
-	solveMatrixMultiplication(Sx.data,Ft.data,Sx.rows,Sx.column,Ft.rows,Ft.column,tmpMatrixA,logfile);
-	//printMatrix1(tmpMatrixA,Sx.rows,Ft.column,"Reconciled-(Sx*Ft)");
-	//printMatrix1(Fstar.data,Fstar.rows,Fstar.column,"REconciled-FStar");
-
-	//(Sx*Ft)*Fstar
-	double* tmpMatrixB = (double*)calloc(Sx.rows*Fstar.column,sizeof(double));
-	solveMatrixMultiplication(tmpMatrixA,Fstar.data,Sx.rows,Ft.column,Fstar.rows,Fstar.column,tmpMatrixB,logfile);
-	matrixData rhsdata= {Sx.rows,Fstar.column,tmpMatrixB};
-
-	free(tmpMatrixA);
-	free(tmpMatrixB);
-	return rhsdata;
-}
+	char uplo = 'L';
+	int n = A.rows;
+	int info = 0;
+	symmetricFactorization result;
+
+	result.factor = copyMatrix(A);
+	dpotrf_(&uplo, &n, result.factor.data, &n, &info);
+	if(info == 0)
+	{
+		return result;
+	}
 
-/*
- * Solves the system
- * recon_x = x - (Sx*Ft*fstar)
- */
-matrixData solveReconciledX(matrixData x, matrixData Sx, matrixData Ft, matrixData Fstar, ofstream& logfile)
-{
-	// Sx*Ft
-	double* tmpMatrixAf = (double*)calloc(Sx.rows*Ft.column,sizeof(double));
-	solveMatrixMultiplication(Sx.data,Ft.data,Sx.rows,Sx.column,Ft.rows,Ft.column,tmpMatrixAf,logfile);
-	//printMatrix(tmpMatrixAf,Sx.rows,Ft.column,"Sx*Ft");
-	//(Sx*Ft)*fstar
-	double* tmpMatrixBf = (double*)calloc(Sx.rows*Fstar.column,sizeof(double));
-	solveMatrixMultiplication(tmpMatrixAf,Fstar.data,Sx.rows,Ft.column,Fstar.rows,Fstar.column,tmpMatrixBf,logfile);
-	//printMatrix(tmpMatrixBf,Sx.rows,Fstar.column,"(Sx*Ft*fstar)");
-
-	matrixData rhs= {Sx.rows,Fstar.column,tmpMatrixBf};
-	//matrixData rhs = Calculate_Sx_Ft_Fstar(Sx,Ft,Fstar);
-
-	double* reconciledX = (double*)calloc(x.rows*x.column,sizeof(double));
-	solveMatrixSubtraction(x,rhs,reconciledX,logfile);
-	//printMatrix(reconciledX,x.rows,x.column,"reconciled X^cap ===> (x - (Sx*Ft*fstar))");
-	if(ACTIVE_STREAM(LOG_JAC))
+	/* dpotrf_ overrides the matrix, start again from A */
+	int lwork = -1;
+	double workSize = 0;
+	result.factor = std::move(A);
+	result.ipiv.resize(n);
+	dsytrf_(&uplo, &n, result.factor.data, &n, &result.ipiv[0], &workSize, &lwork, &info);
+	lwork = max(1, (int)workSize);
+	vector<double> work(lwork);
+	dsytrf_(&uplo, &n, result.factor.data, &n, &result.ipiv[0], &work[0], &lwork, &info);
+	if(info != 0)
 	{
-		logfile << "Calculations of Reconciled_x ==> (x - (Sx*Ft*f*))" << "\n";
-		logfile << "====================================================";
-		printMatrix(tmpMatrixAf,Sx.rows,Ft.column,"Sx*Ft",logfile);
-		printMatrix(tmpMatrixBf,Sx.rows,Fstar.column,"(Sx*Ft*f*)",logfile);
-		printMatrix(reconciledX,x.rows,x.column,"x - (Sx*Ft*f*))",logfile);
-		logfile << "***** Completed ****** \n\n";
+		logfile << "|  error   |   " << "factorizeSymmetricMatrix() Failed !, The matrix (F*Sx*Ft) is singular, The info satus is " << info << "\n";
+		logfile.close();
+		exit(1);
 	}
-	matrixData recon_x = {x.rows,x.column,reconciledX};
-	//free(reconciledX);
-	free(tmpMatrixAf);
-	free(tmpMatrixBf);
-	return recon_x;
+	return result;
 }
 
 /*
- * Solves the system
- * recon_Sx = Sx - (Sx*Ft*Fstar)
+ * Solve the Linear System A*X=B using the factorization of A,
+ * LAPACK Solver routines dpotrs_ and dsytrs_. B will be overridden with X
  */
-matrixData solveReconciledSx(matrixData Sx, matrixData Ft, matrixData Fstar, ofstream& logfile)
+void solveSymmetricSystem(const symmetricFactorization & A, matrixData & B, ofstream & logfile)
 {
-	// Sx*Ft
-	double* tmpMatrixA = (double*)calloc(Sx.rows*Ft.column,sizeof(double));
-	solveMatrixMultiplication(Sx.data,Ft.data,Sx.rows,Sx.column,Ft.rows,Ft.column,tmpMatrixA, logfile);
-	//printMatrix(tmpMatrixA,Sx.rows,Ft.column,"Reconciled-(Sx*Ft)");
-	//printMatrix(Fstar.data,Fstar.rows,Fstar.column,"REconciled-FStar");
-
-	//(Sx*Ft)*Fstar
-	double* tmpMatrixB = (double*)calloc(Sx.rows*Fstar.column,sizeof(double));
-	solveMatrixMultiplication(tmpMatrixA,Fstar.data,Sx.rows,Ft.column,Fstar.rows,Fstar.column,tmpMatrixB, logfile);
-	//printMatrix(tmpMatrixB,Sx.rows,Fstar.column,"Reconciled-(Sx*Ft*Fstar)");
-
-	matrixData rhs= {Sx.rows,Fstar.column,tmpMatrixB};
-
-	//matrixData rhs = Calculate_Sx_Ft_Fstar(Sx,Ft,Fstar);
-	double* reconciledSx = (double*)calloc(Sx.rows*Sx.column,sizeof(double));
-	solveMatrixSubtraction(Sx,rhs,reconciledSx, logfile);
-	//printMatrix(reconciledSx,Sx.rows,Sx.column,"reconciled Sx ===> (Sx - (Sx*Ft*Fstar))");
-	if(ACTIVE_STREAM(LOG_JAC))
+	char uplo = 'L';
+	int n = A.factor.rows;
+	int nrhs = B.column;
+	int info = 0;
+	if(A.ipiv.empty())
 	{
-		logfile << "Calculations of Reconciled_Sx ===> (Sx - (Sx*Ft*F*))" << "\n";
-		logfile << "============================================";
-		printMatrix(tmpMatrixA,Sx.rows,Ft.column,"(Sx*Ft)",logfile);
-		printMatrix(tmpMatrixB,Sx.rows,Fstar.column,"(Sx*Ft*F*)",logfile);
-		printMatrix(reconciledSx,Sx.rows,Sx.column,"Sx - (Sx*Ft*F*))",logfile);
-		logfile << "***** Completed ****** \n\n";
+		dpotrs_(&uplo, &n, &nrhs, A.factor.data, &n, B.data, &n, &info);
+	}
+	else
+	{
+		dsytrs_(&uplo, &n, &nrhs, A.factor.data, &n, const_cast<int*>(&A.ipiv[0]), B.data, &n, &info);
+	}
+	if(info != 0)
+	{
+		logfile << "|  error   |   " << "solveSymmetricSystem() Failed !, The solution could not be computed, The info satus is " << info << "\n";
+		logfile.close();
+		exit(1);
 	}
-	matrixData recon_sx ={Sx.rows,Sx.column,reconciledSx};
-	//free(reconciledSx);
-	free(tmpMatrixA);
-	free(tmpMatrixB);
-	return recon_sx;
 }
 
 /*
- * Function Which Computes the
- * Jacobian Matrix F
+ * Solve the matrix Subtraction of two matrices
  */
-matrixData getJacobianMatrixF(DATA* data, threadData_t *threadData, ofstream & logfile)
+void solveMatrixSubtraction(const matrixData & A, const matrixData & B, double * result, ofstream & logfile)
 {
-	// initialize the jacobian call
-	const int index = data->callback->INDEX_JAC_F;
-	ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
-	data->callback->initialAnalyticJacobianF(data, threadData, jacobian);
-	int cols = jacobian->sizeCols;
-	int rows = jacobian->sizeRows;
-	if(cols == 0) {
-		//errorStreamPrint(LOG_STDOUT, 0, "Cannot Compute Jacobian Matrix F");
-		logfile << "|  error   |   " << "Cannot Compute Jacobian Matrix F" << "\n";
+	if(A.rows!=B.rows || A.column!=B.column)
+	{
+		logfile << "|  error   |   " << "solveMatrixSubtraction() Failed !, The Matrix Dimensions are not equal to Compute" << A.rows << " != " << B.rows << "\n";
 		logfile.close();
 		exit(1);
 	}
-	double* jacF = (double*)calloc(rows*cols,sizeof(double)); // allocate for Matrix F
-	int k=0;
-	for (int x=0; x < cols ; x++)
+	// subtract elements in cloumn major
+	for(int i=0; i < A.size(); i++)
 	{
-		jacobian->seedVars[x] = 1.0;
-		data->callback->functionJacF_column(data, threadData, jacobian, NULL);
-		//cout << "Calculate one column\n:";
-		for (int y=0; y < rows ; y++)
-		{
-			jacF[k++]=jacobian->resultVars[y];
-		}
-		jacobian->seedVars[x] = 0.0;
+		result[i]=A.data[i]-B.data[i];
 	}
-	matrixData Fdata ={rows,cols,jacF};
-	return Fdata;
 }
 
 /*
- * Function Which Computes the
- * Transpose of Jacobian Matrix FT
+ * Copies one evaluated column of the colored Jacobian F
+ * to the values of its sparse pattern
  */
-matrixData getTransposeMatrix(matrixData jacF)
+void storeJacobianColumnF(void *userData, unsigned int column, const ANALYTIC_JACOBIAN *jacobian)
 {
-	int rows=jacF.column;
-	int cols=jacF.rows;
-	double* jacFT = (double*)calloc(rows*cols,sizeof(double)); // allocate for Matrix F-transpose
-	int k=0;
-	for (int i=0;i<jacF.rows; i++)
+	sparseMatrixData * jacF = (sparseMatrixData*) userData;
+	for (int k=jacF->leadindex[column]; k<jacF->leadindex[column+1]; k++)
 	{
-		for (int j=0;j<jacF.column;j++)
-		{
-			// Perform matrix transpose store the elements in column major
-			//cout << (i1*jacF.rows+j1) << " index :" << (i1+j1*jacF.rows) << " value is: " << jacF.data[i1+j1*jacF.rows] << "\n";
-			jacFT[k++]= jacF.data[i+j*jacF.rows];
+		jacF->values[k] = jacobian->resultVars[jacF->index[k]];
+	}
+}
 
-		}
+/*
+ * Function Which Computes the sparse
+ * Jacobian Matrix F, one model evaluation for each color
+ */
+sparseMatrixData getJacobianMatrixF(DATA* data, threadData_t *threadData, ofstream & logfile)
+{
+	// initialize the jacobian once, the sparse pattern is the same for all iterations
+	const int index = data->callback->INDEX_JAC_F;
+	ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
+	if(jacobian->sparsePattern.leadindex == NULL)
+	{
+		data->callback->initialAnalyticJacobianF(data, threadData, jacobian);
+	}
+	int cols = jacobian->sizeCols;
+	int rows = jacobian->sizeRows;
+	if(cols == 0 || jacobian->sparsePattern.leadindex == NULL) {
+		//errorStreamPrint(LOG_STDOUT, 0, "Cannot Compute Jacobian Matrix F");
+		logfile << "|  error   |   " << "Cannot Compute Jacobian Matrix F" << "\n";
+		logfile.close();
+		exit(1);
 	}
-	matrixData Ft_data ={rows,cols,jacFT};
-	return Ft_data;
+	sparseMatrixData jacF;
+	jacF.rows = rows;
+	jacF.column = cols;
+	jacF.leadindex.assign(jacobian->sparsePattern.leadindex, jacobian->sparsePattern.leadindex+cols+1);
+	jacF.index.assign(jacobian->sparsePattern.index, jacobian->sparsePattern.index+jacF.leadindex[cols]);
+	jacF.values.assign(jacF.leadindex[cols], 0.0);
+
+	JACOBIAN_COLORS colors;
+	initJacobianColors(&colors, &jacobian->sparsePattern, cols);
+	evalJacobianColors(data, threadData, jacobian, &colors, NULL, data->callback->functionJacF_column, storeJacobianColumnF, &jacF);
+	freeJacobianColors(&colors);
+	return jacF;
 }
 
 /*
@@ -672,91 +762,68 @@ csvData readCovarianceMatrixSx(DATA* data, threadData_t *threadData, ofstream &
 }
 
 /*
- * Function which reads the vector
- * and assign to c pointer arrays
- */
-matrixData getCovarianceMatrixSx(csvData Sx_result, DATA* data, threadData_t *threadData)
-{
-	double* tempSx = (double*)calloc(Sx_result.rowcount*Sx_result.columncount,sizeof(double));
-	initColumnMatrix(Sx_result.sxdata , Sx_result.rowcount, Sx_result.columncount, tempSx);
-	matrixData Sx_data = {Sx_result.rowcount,Sx_result.columncount,tempSx};
-	return Sx_data;
-}
-
-/*
- * Function which Computes
+ * Function which Computes the sparse
  * covariance matrix Sx based on
  * Half width confidence interval provided by user
- * Sx=(Wxi/1.96)^2
+ * Sx=(Wxi/1.96)^2 and the correlation coefficients
+ * Sx_ik=rx_ik*sqrt(Sx_i)*sqrt(Sx_k)
  */
-
-matrixData computeCovarianceMatrixSx(csvData Sx_result, DATA* data, threadData_t *threadData, ofstream & logfile)
+sparseMatrixData computeCovarianceMatrixSx(csvData & Sx_result, DATA* data, threadData_t *threadData, ofstream & logfile)
 {
-	double* tempSx = (double*)calloc(Sx_result.sxdata.size()*Sx_result.sxdata.size(),sizeof(double));
-	vector<double> tmpdata;
-	int k=0;
-	for (unsigned int i=0;i<Sx_result.sxdata.size(); i++)
+	int n = Sx_result.sxdata.size();
+	vector<double> variance(n);
+	vector< vector< pair<int,double> > > columns(n);
+	for (int i=0; i<n; i++)
 	{
-		double data = pow(Sx_result.sxdata[k]/1.96,2);
-		for (unsigned int j=0;j<Sx_result.sxdata.size();j++)
-		{
-			if(i==j)
-			{
-				//tmpdata.push_back(pow(Sx_result.sxdata[k]/1.96,2));
-				//k++;
-				tmpdata.push_back(data);
-			}
-			else
-			{
-				tmpdata.push_back(0);
-			}
-			// logfile << " data " << count << "=="<< tmpdata[count++] << "\n";
-		}
-		k++;
+		variance[i] = pow(Sx_result.sxdata[i]/1.96,2);
+		columns[i].push_back(make_pair(i,variance[i]));
 	}
-	//logfile << "tmpdatasize" << tmpdata.size() << "\n";
-	//logfile << "Size of vector :" << Sx_result.rx.size() << "\n";
 
 	/* check for corelation coefficient matrix and insert the elements in correct position*/
-	for (unsigned int l=0; l < Sx_result.rx.size();l++)
+	for (unsigned int l=0; l < Sx_result.rx.size(); l++)
 	{
-		int pos1;
-		int pos2;
-		double xi;
-		double xk ;
-		for(unsigned int m=0; m<Sx_result.rx[l].size();m++)
+		if(Sx_result.rx[l].size() < 3)
 		{
-			if(m==0)
+			continue;
+		}
+		int pos1 = getVariableIndex(Sx_result.headers,Sx_result.rx[l][0],logfile);
+		int pos2 = getVariableIndex(Sx_result.headers,Sx_result.rx[l][1],logfile);
+		double tmprx = atof((Sx_result.rx[l][2]).c_str())*sqrt(variance[pos1])*sqrt(variance[pos2]);
+		// find the symmetric position and insert the elements
+		for (int s=0; s < 2; s++)
+		{
+			vector< pair<int,double> > & column = columns[s == 0 ? pos1 : pos2];
+			int row = s == 0 ? pos2 : pos1;
+			unsigned int k = 0;
+			while (k < column.size() && column[k].first != row)
 			{
-				pos1 = getVariableIndex(Sx_result.headers,Sx_result.rx[l][m],logfile);
-				xi   =  tmpdata[(Sx_result.rowcount*pos1)+pos1];
-				//logfile << "xi =>"<< pos1 << "= "<< xi << "\n";
+				k++;
 			}
-
-			if(m==1)
+			if(k < column.size())
 			{
-				pos2 = getVariableIndex(Sx_result.headers,Sx_result.rx[l][m],logfile);
-				xk   = tmpdata[(Sx_result.rowcount*pos2)+pos2];
-				//logfile << "xk =>"<< pos2 << "= "<< xk << "\n";
+				column[k].second = tmprx;
 			}
-			if(m==2)
+			else
 			{
-				//logfile << "position:" << pos1 << ": " << pos2 << "\n";
-				//logfile << "rx_ik" << Sx_result.rx[l][m] << "*" << xi << "*" << xk << "\n";
-				//logfile << atof((Sx_result.rx[l][m]).c_str())*sqrt(xi)*sqrt(xk) << "\n";
-				double tmprx = atof((Sx_result.rx[l][m]).c_str())*sqrt(xi)*sqrt(xk);
-				// find the symmetric position and insert the elements
-				//logfile << "final position :" << (Sx_result.rowcount*pos1)+pos2 << "value is: "<< tmprx << "\n";
-				//logfile << "final position :" << (Sx_result.rowcount*pos2)+pos1 << "value is: "<< tmprx << "\n";
-				tmpdata[(Sx_result.rowcount*pos1)+pos2]=tmprx;
-				tmpdata[(Sx_result.rowcount*pos2)+pos1]=tmprx;
+				column.push_back(make_pair(row,tmprx));
 			}
 		}
-		//logfile << "\n";
 	}
-	initColumnMatrix(tmpdata , Sx_result.rowcount, Sx_result.rowcount, tempSx);
-	matrixData Sx_data = {Sx_result.rowcount,Sx_result.rowcount,tempSx};
-	return Sx_data;
+
+	sparseMatrixData Sx;
+	Sx.rows = n;
+	Sx.column = n;
+	for (int j=0; j<n; j++)
+	{
+		sort(columns[j].begin(), columns[j].end());
+		for (unsigned int k=0; k < columns[j].size(); k++)
+		{
+			Sx.index.push_back(columns[j][k].first);
+			Sx.values.push_back(columns[j][k].second);
+		}
+		Sx.leadindex.push_back(Sx.index.size());
+	}
+	return Sx;
 }
 
 /*
@@ -764,63 +831,22 @@ matrixData computeCovarianceMatrixSx(csvData Sx_result, DATA* data, threadData_t
  * and also stores the index of input variables which are the
  * variables to be reconciled for Data Reconciliation
  */
-inputData getInputDataFromStartAttribute(csvData Sx_result , DATA* data, threadData_t *threadData, ofstream & logfile)
+matrixData getInputDataFromStartAttribute(csvData & Sx_result , DATA* data, threadData_t *threadData, ofstream & logfile)
 {
-	double *tempx = (double*)calloc(Sx_result.rowcount,sizeof(double));
+	matrixData x_data(Sx_result.rowcount, 1);
 	char ** knowns = (char**)malloc(data->modelData->nInputVars * sizeof(char*));
-	vector<int> index;
 	data->callback->inputNames(data, knowns);
 	int headercount = Sx_result.headers.size();
 	/* Read data from input vars which has start attribute value set as input */
 
 	for (int h=0; h < headercount; h++)
 	{
-		tempx[h]=Sx_result.xdata[h];
-		/*
-		bool flag=false;
-		for (int in=0; in < data->modelData->nInputVars; in++)
-		{
-			if(strcmp(knowns[in], Sx_result.headers[h].c_str()) == 0)
-			{
-				//tempx[h] = data->simulationInfo->inputVars[in];
-				index.push_back(in);
-				flag=true;
-				//logfile << knowns[in] << "  start value :" << data->simulationInfo->inputVars[in] << "\n";
-				//logfile << "fetch index :" << in << "\n";
-			}
-		}
-		if(flag==false)
-		{
-			logfile << "|  error   |   " << "Input Variable Not matched or not generated: "<< Sx_result.headers[h] << " , getInputDataFromStartAttribute failed()! \n";
-			logfile.close();
-			exit(1);
-		} */
+		x_data.data[h]=Sx_result.xdata[h];
 	}
-	inputData x_data ={Sx_result.rowcount,1,tempx,index};
 	free(knowns);
 	return x_data;
 }
 
-/*
- * Function  which Copy Matrix
- * using dcopy_ LAPACK routine
- * this is mostly used when LAPACK routines override arrays
- */
-matrixData copyMatrix(matrixData matdata)
-{
-	double * tmpcopymatrix = (double*)calloc(matdata.rows*matdata.column,sizeof(double));
-	int n = matdata.rows*matdata.column;
-	int inc = 1;
-	dcopy_(&n,matdata.data,&inc,tmpcopymatrix,&inc);
-
-	//  for (int i=0; i < matdata.rows*matdata.column; i++)
-	//  {
-	//	  tmpcopymatrix[i]=matdata.data[i];
-	//  }
-	matrixData tmpcopymatrixdata = {matdata.rows, matdata.column, tmpcopymatrix};
-	return tmpcopymatrixdata;
-}
-
 /*
  * Function which scales the MAtrix with constant
  * dscal_ LAPACK_routine and result is updated in data
@@ -848,299 +874,232 @@ void calculateSquareRoot(double * data, int length)
 }
 
 /*
- * Function which calculates
- * J*=(recon_x-x)T*(Sx^-1)*(recon_x-x)+2.[f+F*(recon_x-x)]T*fstar
- * where T= transpose of matrix
- * and returns the converged value
+ * Function which updates the matrices that only depend on F and Sx
+ * F*Sx, the factorization of (F*Sx*Ft), F* and recon_Sx = Sx - (Sx*Ft*F*)
+ * they are reused as long as the Jacobian F does not change,
+ * returns false if nothing had to be computed
  */
-
-double solveConvergence(DATA* data, matrixData conv_recon_x, matrixData conv_recon_sx, inputData conv_x, matrixData conv_sx, matrixData conv_jacF, matrixData conv_vector_c, matrixData conv_fstar, ofstream & logfile)
+bool updateReconciliationSystem(reconciliationSystem & sys, sparseMatrixData jacF, const sparseMatrixData & Sx, ofstream & logfile)
 {
-
-	//printMatrix(conv_vector_c.data,conv_vector_c.rows,conv_vector_c.column,"Convergence_C(x,y)");
-	//printMatrix(conv_fstar.data,conv_fstar.rows,conv_fstar.column,"Convergence_f*");
-	//printMatrix(conv_recon_x.data,conv_recon_x.rows,conv_recon_x.column,"check_recon_x*");
-
-	// calculate(recon_x-x)
-	double* conv_data1 = (double*)calloc(conv_x.rows*conv_x.column,sizeof(double));
-	matrixData conv_inputs = {conv_x.rows,conv_x.column,conv_x.data};
-	solveMatrixSubtraction(conv_recon_x,conv_inputs,conv_data1,logfile);
-	matrixData conv_data1result={conv_x.rows,conv_x.column,conv_data1};
-	matrixData copy_reconx_x = copyMatrix(conv_data1result);
-
-	//printMatrix(conv_inputs.data,conv_inputs.rows,conv_inputs.column,"check_inputs");
-	//printMatrix(conv_data1result.data,conv_data1result.rows,conv_data1result.column,"(recon_X - X)");
-
-	// calculate Transpose_(recon_x-x)
-	matrixData conv_data1Transpose = getTransposeMatrix(conv_data1result);
-	//printMatrix(conv_data1Transpose.data,conv_data1Transpose.rows,conv_data1Transpose.column,"Transpose(recon_X - X)");
-
-	/* solves (Sx^-1)*(recon_x-x)
-	 * Solve the inverse of matrix Sx using linear form
-	 * Ax=b
-	 * where A=Sx and b= (recon_x-x) to avoid inversion of Sx which is
-	 * expensive
-	 */
-	solveSystemFstar(conv_sx.rows,1,conv_sx.data,conv_data1result.data,logfile);
-	//printMatrix(conv_data1result.data,conv_sx.rows,conv_data1result.column,"inverse multiplication_without inverse");
-
-	double *conv_tmpmatrixlhs = (double*)calloc(conv_data1Transpose.rows*conv_data1result.column,sizeof(double));
-	/*
-	 * Solve (recon_x-x)T*(Sx^-1)*(recon_x-x)
-	 */
-	solveMatrixMultiplication(conv_data1Transpose.data,conv_data1result.data,conv_data1Transpose.rows,conv_data1Transpose.column,conv_data1result.rows,conv_data1result.column,conv_tmpmatrixlhs,logfile);
-	//printMatrix(conv_tmpmatrixlhs,conv_data1Transpose.rows,conv_data1result.column,"(recon_x-x)T*(Sx^-1)*(recon_x-x)");
-	matrixData struct_conv_tmpmatrixlhs = {conv_data1Transpose.rows,conv_data1result.column,conv_tmpmatrixlhs};
-
-	/*
-	 * Solve rhs = 2.[f+F*(recon_x-x)]T*fstar
-	 *
-	 */
-	// Calculate F*(recon_x-x)
-	double * tmp_F_recon_x_x = (double*)calloc(conv_jacF.rows*copy_reconx_x.column,sizeof(double));
-	solveMatrixMultiplication(conv_jacF.data, copy_reconx_x.data, conv_jacF.rows, conv_jacF.column, copy_reconx_x.rows, copy_reconx_x.column,tmp_F_recon_x_x, logfile);
-	//printMatrix(tmp_F_recon_x_x,conv_jacF.rows,copy_reconx_x.column,"F*(recon_x-x)");
-	matrixData mult_F_recon_x_x = {conv_jacF.rows,copy_reconx_x.column,tmp_F_recon_x_x};
-
-	// Calculate f + F*(recon_x-x)
-	matrixData add_f_F_recon_x_x = solveMatrixAddition(conv_vector_c, mult_F_recon_x_x, logfile);
-	//printMatrix(add_f_F_recon_x_x.data,add_f_F_recon_x_x.rows,add_f_F_recon_x_x.column,"f + F*(recon_x-x)");
-
-	matrixData transpose_add_f_F_recon_x_x = getTransposeMatrix(add_f_F_recon_x_x);
-	//printMatrix(transpose_add_f_F_recon_x_x.data,transpose_add_f_F_recon_x_x.rows,transpose_add_f_F_recon_x_x.column,"transpose-[f + F*(recon_x-x)]");
-
-	// calculate [f + F*(recon_x-x)]T*fstar
-	double *conv_tmpmatrixrhs = (double*)calloc(transpose_add_f_F_recon_x_x.rows*conv_fstar.column,sizeof(double));
-	solveMatrixMultiplication(transpose_add_f_F_recon_x_x.data, conv_fstar.data, transpose_add_f_F_recon_x_x.rows, transpose_add_f_F_recon_x_x.column, conv_fstar.rows, conv_fstar.column, conv_tmpmatrixrhs, logfile);
-	//printMatrix(conv_tmpmatrixrhs, transpose_add_f_F_recon_x_x.rows, conv_fstar.column,"[f + F*(recon_x-x)]*fstar");
-
-	// scale the matrix with 2*[f + F*(recon_x-x)]T*fstar
-	scaleVector(transpose_add_f_F_recon_x_x.rows , conv_fstar.column, 2.0, conv_tmpmatrixrhs);
-	//printMatrix(conv_tmpmatrixrhs, transpose_add_f_F_recon_x_x.rows, conv_fstar.column,"2*[f + F*(recon_x-x)]*fstar");
-	matrixData struct_conv_tmpmatrixrhs= {transpose_add_f_F_recon_x_x.rows, conv_fstar.column,conv_tmpmatrixrhs};
+	if(sys.factorizations > 0 && sys.jacF.leadindex == jacF.leadindex && sys.jacF.index == jacF.index && sys.jacF.values == jacF.values)
+	{
+		return false;
+	}
+	sys.jacF = std::move(jacF);
+	sys.FSx = solveSparseMatrixMultiplication(sys.jacF, Sx, logfile);
+	matrixData FSxFt = solveMatrixMultiplicationSparseTranspose(sys.FSx, sys.jacF, logfile);
+	if(ACTIVE_STREAM(LOG_JAC))
+	{
+		logfile << "Calculations of Matrix (F*Sx*Ft) F* = F*Sx " << "\n";
+		logfile << "===============================================\n";
+		printMatrix(sys.FSx.data,sys.FSx.rows,sys.FSx.column,"F*Sx",logfile);
+		printMatrix(FSxFt.data,FSxFt.rows,FSxFt.column,"F*Sx*Ft",logfile);
+	}
+	sys.FSxFt = factorizeSymmetricMatrix(std::move(FSxFt), logfile);
 
 	/*
-	 * solve the final J*=J*=(recon_x-x)T*(Sx^-1)*(recon_x-x)+2.[f+F*(recon_x-x)]T*fstar
-	 * J*=_struct_conv_tmpmatrixlhs + struct_conv_tmpmatrixrhs
+	 * calculate F* for covariance matrix (F*Sx*Ftranspose).F*= (F*Sx)
 	 */
-	matrixData struct_Jstar= solveMatrixAddition(struct_conv_tmpmatrixlhs,struct_conv_tmpmatrixrhs, logfile);
-	//printMatrix(struct_Jstar.data,struct_Jstar.rows,struct_Jstar.column,"J*",logfile);
-
-	int r=data->modelData->nSetcVars; // number of setc equations
-	double val=1.0/r;
+	sys.Fstar = copyMatrix(sys.FSx);
+	solveSymmetricSystem(sys.FSxFt, sys.Fstar, logfile);
+	if(ACTIVE_STREAM(LOG_JAC))
+	{
+		printMatrix(sys.Fstar.data,sys.Fstar.rows,sys.Fstar.column,"F*",logfile);
+		logfile << "***** Completed ****** \n\n";
+	}
 
 	/*
-	 * calculate J/r < epselon
+	 * recon_Sx = Sx - (Sx*Ft*F*), where Sx*Ft is the transpose of F*Sx
+	 * as Sx is symmetric, solved with dgemm_
 	 */
-	scaleVector(struct_Jstar.rows,struct_Jstar.column,val,struct_Jstar.data);
-	//printMatrix(struct_Jstar.data,struct_Jstar.rows,struct_Jstar.column,"J*/r ");
-	double convergedvalue=struct_Jstar.data[0];
-
-	//  free(struct_Jstar.data);
-	//  free(struct_conv_tmpmatrixrhs.data);
-	//  free(conv_tmpmatrixrhs);
-	//  free(transpose_add_f_F_recon_x_x.data);
-	//  free(add_f_F_recon_x_x.data);
-	//  free(transpose_add_f_F_recon_x_x.data);
-	//  free(mult_F_recon_x_x.data);
-	//  free(tmp_F_recon_x_x);
-	//  free(struct_conv_tmpmatrixlhs.data);
-	//  free(conv_tmpmatrixlhs);
-	//  free(conv_data1Transpose.data);
-	//  free(copy_reconx_x.data);
-	//  free(conv_data1result.data);
-	//  free(conv_data1);
-
-	return convergedvalue;
+	char transa = 'T', transb = 'N';
+	int n = Sx.rows, r = sys.FSx.rows;
+	double alpha = -1.0, beta = 1.0;
+	sys.reconciledSx = getDenseMatrix(Sx);
+	if(n > 0 && r > 0)
+	{
+		dgemm_(&transa, &transb, &n, &n, &r, &alpha, sys.FSx.data, &r, sys.Fstar.data, &r, &beta, sys.reconciledSx.data, &n);
+	}
+	if(ACTIVE_STREAM(LOG_JAC))
+	{
+		logfile << "Calculations of Reconciled_Sx ===> (Sx - (Sx*Ft*F*))" << "\n";
+		logfile << "============================================";
+		printTransposedMatrix(sys.FSx.data,sys.FSx.rows,sys.FSx.column,"(Sx*Ft)",logfile);
+		printMatrix(sys.reconciledSx.data,sys.reconciledSx.rows,sys.reconciledSx.column,"Sx - (Sx*Ft*F*))",logfile);
+		logfile << "***** Completed ****** \n\n";
+	}
+	sys.factorizations++;
+	return true;
 }
 
 /*
- * Example Function which performs matrix inverse
- * using dgetri_ and dgetrf_ LAPACK routine
- * which is expensive one and not recommended
- * use it when no other way to compute it
+ * Function which reads the setc vector c(x,y),
+ * the elements are stored in reverse order
  */
-void checkExpensiveMatrixInverse()
+matrixData getSetcVector(DATA* data)
 {
-	double  newval[3*3]={3,2,0,
-			0,0,1,
-			2,-2,1};
-
-	int N=3;
-	int LDA=N;
-	int LDB=N;
-	int ipiv[N];
-	int info=1;
-	int LWORK =N;
-	double * WORK = (double*)calloc(LWORK,sizeof(double));
-
-	dgetrf_(&N,&N,newval,&N,ipiv,&info);
-	dgetri_(&N,newval,&N,ipiv,WORK,&LWORK,&info);
-	//printMatrix(newval,3,3,"Expensive_Matrix_Inverse");
+	int nsetcvars = data->modelData->nSetcVars;
+	matrixData vector_c(nsetcvars, 1);
+	for (int t=0; t < nsetcvars; t++)
+	{
+		vector_c.data[t] = data->simulationInfo->setcVars[nsetcvars-1-t];
+	}
+	return vector_c;
 }
 
 /*
- * Function which performs matrix inverse without performing
- * actual matrix inverse, Instead use the dgesv to get result
- * Ax=b where matrix mutiplication of x=bA gives the inversed
- * mutiplication result b with A inverse
+ * Solves the system
+ * recon_x = x - (Sx*Ft*fstar), where (F*Sx*Ft).f* = c(x,y)
  */
-void checkInExpensiveMatrixInverse(ofstream & logfile)
-{
-	double newchecksx[3*3]={1,1,1,
-			0,0.95,0,
-			0,0,0.95};
-	double checksx[3*1]={-0.028,0.026,-0.004};
-	solveSystemFstar(3,1,newchecksx,checksx,logfile);
-	//printMatrix(checksx,3,1,"InExpensive_Matrix_Inverse");
-}
-
-int RunReconciliation(DATA* data, threadData_t *threadData, inputData x, matrixData Sx, matrixData tmpjacF, matrixData tmpjacFt, double eps, int iterationcount, csvData csvinputs, matrixData xdiag, matrixData sxdiag, ofstream& logfile)
+matrixData solveReconciledX(const matrixData & x, const matrixData & vector_c, const reconciliationSystem & sys, matrixData & fstar, ofstream& logfile)
 {
-	// set the inputs first
-    /*
-	for (int i=0; i< x.rows*x.column; i++)
-	{
-		data->simulationInfo->inputVars[x.index[i]]=x.data[i];
-		//logfile << "input data:" << x.data[i]<<"\n";
-	}*/
-
-	for (int i=0; i< x.rows*x.column; i++)
-	{
-		data->simulationInfo->datainputVars[i]=x.data[i];
-		//logfile << "input data:" << x.data[i]<<"\n";
-	}
-
-    /* set the inputs via this special function generated for dataReconciliation
-     * which also sets inputs for models not involving top level inputs
-     */
-    data->callback->data_function(data, threadData);
-	//data->callback->input_function(data, threadData);
-	data->callback->functionDAE(data,threadData);
-	//data->callback->functionODE(data,threadData);
-	data->callback->setc_function(data, threadData);
-
-	matrixData jacF = getJacobianMatrixF(data,threadData,logfile);
-	matrixData jacFt = getTransposeMatrix(jacF);
-
-	printMatrix(jacF.data,jacF.rows,jacF.column,"F",logfile);
-	printMatrix(jacFt.data,jacFt.rows,jacFt.column,"Ft",logfile);
-
-
-	double* setc = (double*)calloc(data->modelData->nSetcVars,sizeof(double)); // allocate data for setc array
-	// store the setc data to compute for convergence as setc will be overriddeen with new values
-	double* tmpsetc = (double*)calloc(data->modelData->nSetcVars,sizeof(double));
-
-	/* loop to store the data C(x,y) rhs side, get the elements in reverse order */
-	int t=0;
-	for (int i=data->modelData->nSetcVars; i > 0; i--)
-	{
-		setc[t]=data->simulationInfo->setcVars[i-1];
-		tmpsetc[t]=data->simulationInfo->setcVars[i-1];
-		t++;
-		//cout << "array_setc_vars:=>" << t << ":" << data->simulationInfo->setcVars[i-1] << "\n";
-	}
-
-	int nsetcvars= data->modelData->nSetcVars;
-	matrixData vector_c = {nsetcvars,1,tmpsetc};
-	//allocate data for matrix multiplication F*Sx
-	double * tmpmatrixC = (double*)calloc(jacF.rows*Sx.column,sizeof(double));
-	solveMatrixMultiplication(jacF.data,Sx.data,jacF.rows,jacF.column,Sx.rows,Sx.column,tmpmatrixC,logfile);
-	//printMatrix(tmpmatrixC,jacF.rows,Sx.column,"F*Sx");
-
-	//allocate data for matrix multiplication (F*Sx)*Ftranspose
-	double * tmpmatrixD = (double*)calloc(jacF.rows*jacFt.column,sizeof(double));
-	solveMatrixMultiplication(tmpmatrixC,jacFt.data,jacF.rows,Sx.column,jacFt.rows,jacFt.column,tmpmatrixD,logfile);
-	//printMatrix(tmpmatrixD,jacF.rows,jacFt.column,"F*Sx*Ft");
-	//printMatrix(setc,nsetcvars,1,"c(x,y)");
 	/*
-	 * Copy tmpmatrixC and tmpmatrixD to avoid loss of data
-	 * when calculating F*
+	 * calculate f* for covariance matrix (F*Sx*Ftranspose).F*= c(x,y)
+	 * with the factorization of (F*Sx*Ft)
 	 */
-	matrixData cpytmpmatrixC = {jacF.rows,Sx.column,tmpmatrixC};
-	matrixData cpytmpmatrixD = {jacF.rows,jacFt.column,tmpmatrixD};
-	matrixData tmpmatrixC1 = copyMatrix(cpytmpmatrixC);
-	matrixData tmpmatrixD1 = copyMatrix(cpytmpmatrixD);
-
+	fstar = copyMatrix(vector_c);
+	solveSymmetricSystem(sys.FSxFt, fstar, logfile);
 	if(ACTIVE_STREAM(LOG_JAC))
 	{
 		logfile << "Calculations of Matrix (F*Sx*Ft) f* = c(x,y) " << "\n";
 		logfile << "============================================\n";
-		printMatrix(tmpmatrixC,jacF.rows,Sx.column,"F*Sx",logfile);
-		printMatrix(tmpmatrixD,jacF.rows,jacFt.column,"F*Sx*Ft",logfile);
-		printMatrix(setc,nsetcvars,1,"c(x,y)",logfile);
+		printMatrix(vector_c.data,vector_c.rows,1,"c(x,y)",logfile);
+		printMatrix(fstar.data,fstar.rows,1,"f*",logfile);
+		logfile << "***** Completed ****** \n\n";
+	}
+
+	// x - (Sx*Ft)*fstar, where Sx*Ft is the transpose of F*Sx
+	char trans = 'T';
+	int r = sys.FSx.rows, n = sys.FSx.column, inc = 1;
+	double alpha = -1.0, beta = 1.0;
+	matrixData recon_x = copyMatrix(x);
+	if(n > 0 && r > 0)
+	{
+		dgemv_(&trans, &r, &n, &alpha, sys.FSx.data, &r, fstar.data, &inc, &beta, recon_x.data, &inc);
 	}
-	/*
-	 * calculate f* for covariance matrix (F*Sx*Ftranspose).F*= c(x,y)
-	 * matrix setc will be overridden with new values which is the output
-	 * for the calculation A *x =B
-	 * A = tmpmatrixD
-	 * B = setc
-	 */
-	solveSystemFstar(jacF.rows,1,tmpmatrixD,setc,logfile);
-	//printMatrix(setc,jacF.rows,1,"f*");
 	if(ACTIVE_STREAM(LOG_JAC))
 	{
-		printMatrix(setc,jacF.rows,1,"f*",logfile);
+		logfile << "Calculations of Reconciled_x ==> (x - (Sx*Ft*f*))" << "\n";
+		logfile << "====================================================";
+		printMatrix(recon_x.data,recon_x.rows,recon_x.column,"x - (Sx*Ft*f*))",logfile);
 		logfile << "***** Completed ****** \n\n";
 	}
-	matrixData tmpxcap ={x.rows,1,x.data};
-	matrixData tmpfstar = {jacF.rows,1,setc};
-	matrixData reconciled_X = solveReconciledX(tmpxcap,Sx,jacFt,tmpfstar,logfile);
-	//printMatrix(reconciled_X.data,reconciled_X.rows,reconciled_X.column,"reconciled_X ===> (x - (Sx*Ft*fstar))");
-	if(ACTIVE_STREAM(LOG_JAC))
+	return recon_x;
+}
+
+/*
+ * Function which calculates
+ * J*=(recon_x-x)T*(Sx^-1)*(recon_x-x)+2.[f+F*(recon_x-x)]T*fstar
+ * where T= transpose of matrix
+ * and returns the converged value J/r.
+ * As recon_x-x = -(Sx*Ft*fstar), (Sx^-1)*(recon_x-x) is -(Ft*fstar)
+ * and Sx is never inverted
+ */
+double solveConvergence(DATA* data, const matrixData & conv_recon_x, const matrixData & conv_x, const sparseMatrixData & conv_jacF, const matrixData & conv_vector_c, const matrixData & conv_fstar, ofstream & logfile)
+{
+	// calculate(recon_x-x)
+	vector<double> recon_x_x(conv_x.size());
+	solveMatrixSubtraction(conv_recon_x,conv_x,&recon_x_x[0],logfile);
+
+	double lhs = 0, rhs = 0;
+	vector<double> F_recon_x_x(conv_jacF.rows, 0.0);
+	for (int j=0; j<conv_jacF.column; j++)
 	{
-		logfile << "Calculations of Matrix (F*Sx*Ft) F* = F*Sx " << "\n";
-		logfile << "===============================================\n";
-		//printMatrix(tmpmatrixC,jacF.rows,Sx.column,"F*Sx");
-		//printMatrix(tmpmatrixD,jacF.rows,jacFt.column,"F*Sx*Ft");
-		printMatrix(tmpmatrixC1.data,tmpmatrixC1.rows,tmpmatrixC1.column,"F*Sx",logfile);
-		printMatrix(tmpmatrixD1.data,tmpmatrixD1.rows,tmpmatrixD1.column,"F*Sx*Ft",logfile);
+		double Ft_fstar = 0;
+		for (int k=conv_jacF.leadindex[j]; k<conv_jacF.leadindex[j+1]; k++)
+		{
+			// Ft*fstar and F*(recon_x-x)
+			Ft_fstar += conv_jacF.values[k]*conv_fstar.data[conv_jacF.index[k]];
+			F_recon_x_x[conv_jacF.index[k]] += conv_jacF.values[k]*recon_x_x[j];
+		}
+		// (recon_x-x)T*(Sx^-1)*(recon_x-x)
+		lhs -= recon_x_x[j]*Ft_fstar;
 	}
-	/*
-	 * calculate F* for covariance matrix (F*Sx*Ftranspose).F*= (F*Sx)
-	 * tmpmatrixC1 will be overridden with new values which is the output
-	 * for the calculation A *x =B
-	 * A = tmpmatrixD
-	 * B = tmpmatrixC
-	 */
-	solveSystemFstar(jacF.rows,Sx.column,tmpmatrixD1.data,tmpmatrixC1.data,logfile);
-	//printMatrix(tmpmatrixC,jacF.rows,Sx.column,"Sx_F*");
+	// 2.[f+F*(recon_x-x)]T*fstar
+	for (int i=0; i<conv_jacF.rows; i++)
+	{
+		rhs += (conv_vector_c.data[i]+F_recon_x_x[i])*conv_fstar.data[i];
+	}
+	rhs *= 2.0;
+
 	if(ACTIVE_STREAM(LOG_JAC))
 	{
-		printMatrix(tmpmatrixC1.data,jacF.rows,Sx.column,"F*",logfile);
+		logfile << "Calculations of J* ==> (recon_x-x)T*(Sx^-1)*(recon_x-x)+2.[f+F*(recon_x-x)]T*f*" << "\n";
+		logfile << "==================================================================================\n";
+		logfile << "(recon_x-x)T*(Sx^-1)*(recon_x-x) : " << lhs << "\n";
+		logfile << "2.[f+F*(recon_x-x)]T*f*          : " << rhs << "\n";
 		logfile << "***** Completed ****** \n\n";
 	}
 
-	matrixData tmpFstar = {jacF.rows,Sx.column,tmpmatrixC1.data};
-	matrixData reconciled_Sx = solveReconciledSx(Sx,jacFt,tmpFstar,logfile);
-	//printMatrix(reconciled_Sx.data,reconciled_Sx.rows,reconciled_Sx.column,"reconciled Sx ===> (Sx - (Sx*Ft*Fstar))");
+	int r=data->modelData->nSetcVars; // number of setc equations
 
-	double value = solveConvergence(data,reconciled_X,reconciled_Sx,x,Sx,jacF,vector_c,tmpfstar,logfile);
-	if(value > eps )
-	{
-		logfile << "J*/r" << "(" << value << ")"  << " > " << eps << ", Value not Converged \n";
-		logfile << "==========================================\n\n";
-	}
-	if(value > eps)
+	/*
+	 * calculate J/r < epselon
+	 */
+	return (lhs+rhs)/r;
+}
+
+/*
+ * Function which reconciles the measured values x, the reconciliation
+ * is repeated with the reconciled values until J/r < eps.
+ * Returns the number of iterations, the reconciled values are stored in recon_x
+ */
+int reconcileMeasurements(DATA* data, threadData_t *threadData, reconciliationSystem & sys, const sparseMatrixData & Sx, matrixData x, double eps, const csvData & csvinputs, bool printIterations, matrixData & recon_x, double & value, ofstream& logfile)
+{
+	int iterationcount = 1;
+	while(true)
 	{
-		logfile << "Running Convergence iteration: " << iterationcount << " with the following reconciled values:" << "\n";
-		logfile << "========================================================================" << "\n";
-		//cout << "J*/r :=" << value << "\n";
-		//printMatrix(jacF.data,jacF.rows,jacF.column,"F");
-		//printMatrix(jacFt.data,jacFt.rows,jacFt.column,"Ft");
-		//printMatrix(setc,jacF.rows,1,"f*");
-		//printMatrix(tmpmatrixC,jacF.rows,Sx.column,"F*");
-		printMatrixWithHeaders(reconciled_X.data,reconciled_X.rows,reconciled_X.column,csvinputs.headers,"reconciled_X ===> (x - (Sx*Ft*fstar))",logfile);
-		printMatrixWithHeaders(reconciled_Sx.data,reconciled_Sx.rows,reconciled_Sx.column,csvinputs.headers,"reconciled_Sx ===> (Sx - (Sx*Ft*Fstar))",logfile);
-		//free(x.data);
-		//free(Sx.data);
-		x.data=reconciled_X.data;
-		//Sx.data=reconciled_Sx.data;
+		for (int i=0; i< x.size(); i++)
+		{
+			data->simulationInfo->datainputVars[i]=x.data[i];
+		}
+
+		/* set the inputs via this special function generated for dataReconciliation
+		 * which also sets inputs for models not involving top level inputs
+		 */
+		data->callback->data_function(data, threadData);
+		data->callback->functionDAE(data,threadData);
+		data->callback->setc_function(data, threadData);
+
+		// store the setc data c(x,y), it will be overridden at the reconciled values
+		matrixData vector_c = getSetcVector(data);
+		updateReconciliationSystem(sys, getJacobianMatrixF(data,threadData,logfile), Sx, logfile);
+		if(printIterations)
+		{
+			printSparseMatrix(sys.jacF,false,NULL,"F",logfile);
+			printSparseMatrix(sys.jacF,true,NULL,"Ft",logfile);
+		}
+
+		matrixData fstar;
+		recon_x = solveReconciledX(x,vector_c,sys,fstar,logfile);
+		value = solveConvergence(data,recon_x,x,sys.jacF,vector_c,fstar,logfile);
+		if(!(value > eps))
+		{
+			return iterationcount;
+		}
+		if(printIterations)
+		{
+			logfile << "J*/r" << "(" << value << ")"  << " > " << eps << ", Value not Converged \n";
+			logfile << "==========================================\n\n";
+			logfile << "Running Convergence iteration: " << iterationcount << " with the following reconciled values:" << "\n";
+			logfile << "========================================================================" << "\n";
+			printMatrixWithHeaders(recon_x.data,recon_x.rows,recon_x.column,csvinputs.headers,"reconciled_X ===> (x - (Sx*Ft*fstar))",logfile);
+			printMatrixWithHeaders(sys.reconciledSx.data,sys.reconciledSx.rows,sys.reconciledSx.column,csvinputs.headers,"reconciled_Sx ===> (Sx - (Sx*Ft*Fstar))",logfile);
+		}
+		x = std::move(recon_x);
 		iterationcount++;
-		return RunReconciliation(data, threadData, x, Sx, jacF, jacFt,eps,iterationcount,csvinputs,xdiag,sxdiag,logfile);
 	}
-	if(value < eps && iterationcount==1)
+}
+
+int RunReconciliation(DATA* data, threadData_t *threadData, reconciliationSystem & sys, const sparseMatrixData & Sx, const matrixData & x, double eps, csvData & csvinputs, const matrixData & sxdiag, ofstream& logfile)
+{
+	double value = 0;
+	matrixData reconciled_X;
+	int iterationcount = reconcileMeasurements(data, threadData, sys, Sx, copyMatrix(x), eps, csvinputs, true, reconciled_X, value, logfile);
+	const matrixData & xdiag = x;
+	const matrixData & reconciled_Sx = sys.reconciledSx;
+
+	if(iterationcount==1)
 	{
 		logfile << "J*/r" << "(" << value << ")"  << " > " << eps << ", Convergence iteration not required \n\n";
 	}
@@ -1162,10 +1121,8 @@ int RunReconciliation(DATA* data, threadData_t *threadData, inputData x, matrixD
 	 * where lamba = 1.96 and
 	 * Sx - diagonal elements of reconciled_Sx
 	 */
-	double* reconSx_diag = (double*)calloc(reconciled_Sx.rows*1,sizeof(double));
-	getDiagonalElements(reconciled_Sx.data,reconciled_Sx.rows,reconciled_Sx.column,reconSx_diag);
-
-	matrixData copyreconSx_diag = {reconciled_Sx.rows,1,reconSx_diag};
+	matrixData copyreconSx_diag(reconciled_Sx.rows, 1);
+	getDiagonalElements(reconciled_Sx.data,reconciled_Sx.rows,reconciled_Sx.column,copyreconSx_diag.data);
 	matrixData tmpcopyreconSx_diag = copyMatrix(copyreconSx_diag);
 	if(ACTIVE_STREAM(LOG_JAC))
 	{
@@ -1187,30 +1144,30 @@ int RunReconciliation(DATA* data, threadData_t *threadData, inputData x, matrixD
 	 * Calculate individual tests
 	 * (recon_x - x)/sqrt(Sx-recon_Sx)
 	 */
-	double* newSx_diag = (double*)calloc(reconciled_Sx.rows*1,sizeof(double));
-	solveMatrixSubtraction(sxdiag,tmpcopyreconSx_diag,newSx_diag,logfile);
+	vector<double> newSx_diag(reconciled_Sx.rows);
+	solveMatrixSubtraction(sxdiag,tmpcopyreconSx_diag,&newSx_diag[0],logfile);
 	if(ACTIVE_STREAM(LOG_JAC))
 	{
 		logfile << "Calculations of Individual Tests " << "\n";
 		logfile << "===============================================\n";
-		printMatrix(newSx_diag,sxdiag.rows,sxdiag.column,"Sx-recon_Sx",logfile);
+		printMatrix(&newSx_diag[0],sxdiag.rows,sxdiag.column,"Sx-recon_Sx",logfile);
 	}
-	calculateSquareRoot(newSx_diag,reconciled_Sx.rows);
+	calculateSquareRoot(&newSx_diag[0],reconciled_Sx.rows);
 	if(ACTIVE_STREAM(LOG_JAC))
 	{
-		printMatrix(newSx_diag,sxdiag.rows,sxdiag.column,"squareroot-newSx",logfile);
+		printMatrix(&newSx_diag[0],sxdiag.rows,sxdiag.column,"squareroot-newSx",logfile);
 	}
 
-	double *newX = (double*)calloc(xdiag.rows*1,sizeof(double));
-	solveMatrixSubtraction(reconciled_X,xdiag,newX,logfile);
+	vector<double> newX(xdiag.rows);
+	solveMatrixSubtraction(reconciled_X,xdiag,&newX[0],logfile);
 	// calculate absolute value for this numeric analysis
-	for (unsigned int a=0; a < sizeof(newX); a++)
+	for (int a=0; a < xdiag.rows; a++)
 	{
 		newX[a] = fabs(newX[a]);
 	}
 	if(ACTIVE_STREAM(LOG_JAC))
 	{
-		printMatrix(newX,xdiag.rows,xdiag.column,"recon_X - X",logfile);
+		printMatrix(&newX[0],xdiag.rows,xdiag.column,"recon_X - X",logfile);
 		logfile << "*********Completed***********\n";
 	}
 
@@ -1219,7 +1176,7 @@ int RunReconciliation(DATA* data, threadData_t *threadData, inputData x, matrixD
 		newX[val]=newX[val]/max(newSx_diag[val],sqrt(sxdiag.data[val]/10));
 	}
 
-	printMatrixWithHeaders(newX,xdiag.rows,xdiag.column,csvinputs.headers,"IndividualTests_Value- (recon_x-x)/sqrt(Sx_diag)",logfile);
+	printMatrixWithHeaders(&newX[0],xdiag.rows,xdiag.column,csvinputs.headers,"IndividualTests_Value- (recon_x-x)/sqrt(Sx_diag)",logfile);
 
 	/*
 	 * create HTML Report
@@ -1330,25 +1287,145 @@ int RunReconciliation(DATA* data, threadData_t *threadData, inputData x, matrixD
 	myfile << "</table>\n";
 	myfile << "</body>\n</html>";
 	myfile.close();
-
-	free(tmpFstar.data);
-	free(tmpfstar.data);
-	//free(tmpmatrixC);
-	//free(tmpmatrixD);
-	//free(setc);
-	free(reconciled_Sx.data);
-	free(reconciled_X.data);
-	free(copyreconSx_diag.data);
-	free(tmpcopyreconSx_diag.data);
-	free(newSx_diag);
-	free(newX);
-	//free(jacF.data);
-	//free(jacFt.data);
-	//free(x.data);
-	//free(Sx.data);
 	return 0;
 }
 
+/*
+ * Function which reads the csv file with the measurement snapshots
+ * for batch reconciliation, the first line holds the variable names
+ * and every further line the measured values of one snapshot
+ */
+csvData readBatchSnapshots(const char * filename, ofstream & logfile)
+{
+	ifstream ip(filename);
+	string line;
+	vector<double> xdata;
+	vector<string> names;
+	int rowcount=0;
+	int linecount=1;
+	if(!ip.good())
+	{
+		logfile << "|  error   |   " << "file name not found " << filename << "\n";
+		logfile.close();
+		exit(1);
+	}
+	while(ip.good())
+	{
+		getline(ip,line);
+		std::replace(line.begin(), line.end(), ';', ' ');
+		std::replace(line.begin(), line.end(), ',', ' ');
+		stringstream ss(line);
+		string temp;
+		if(linecount==1)
+		{
+			while(ss >> temp)
+			{
+				names.push_back(temp);
+			}
+		}
+		else if(!line.empty())
+		{
+			unsigned int count=0;
+			while(ss >> temp)
+			{
+				xdata.push_back(atof(temp.c_str()));
+				count++;
+			}
+			if(count==0)
+			{
+				linecount++;
+				continue;
+			}
+			if(count!=names.size())
+			{
+				logfile << "|  error   |   " << filename << "|  line " << linecount << " has " << count << " values for " << names.size() << " variables, " << "DataReconciliation cannot be computed ! \n";
+				logfile.close();
+				exit(1);
+			}
+			rowcount++;
+		}
+		linecount++;
+	}
+	csvData data={linecount,rowcount,(int)names.size(),xdata,vector<double>(),names,vector< vector<string> >()};
+	return data;
+}
+
+/*
+ * Function which reconciles every snapshot of the batch file -reconcileBatch
+ * with the uncertainties Sx of the -sx file. The factorization of (F*Sx*Ft)
+ * is reused as long as the Jacobian F does not change, eg: for linear equations
+ * it is computed only once for all snapshots
+ */
+void RunBatchReconciliation(DATA* data, threadData_t *threadData, reconciliationSystem & sys, const sparseMatrixData & Sx, double eps, csvData & csvinputs, ofstream& logfile)
+{
+	const char* batchfile = omc_flagValue[FLAG_DATA_RECONCILE_BATCH];
+	csvData batch = readBatchSnapshots(batchfile, logfile);
+	int n = csvinputs.headers.size();
+
+	// column of each variable to be reconciled in the batch file
+	vector<int> pos(n);
+	for (int i=0; i < n; i++)
+	{
+		vector<string>::iterator it = std::find(batch.headers.begin(), batch.headers.end(), csvinputs.headers[i]);
+		if(it == batch.headers.end())
+		{
+			logfile << "|  error   |   " << "Batch Variable Name not Matched:  " << csvinputs.headers[i] << " ,RunBatchReconciliation() failed!"<< "\n";
+			logfile.close();
+			exit(1);
+		}
+		pos[i] = it - batch.headers.begin();
+	}
+
+	ofstream csvfile;
+	std::stringstream csv_file;
+	if (omc_flag[FLAG_OUTPUT_PATH])
+	{
+		csv_file << string(omc_flagValue[FLAG_OUTPUT_PATH]) << "/" << data->modelData->modelName << "_Batch_Outputs.csv";
+	}
+	else
+	{
+		csv_file << data->modelData->modelName <<"_Batch_Outputs.csv";
+	}
+	string tmpcsv= csv_file.str();
+	csvfile.open(tmpcsv.c_str());
+	if(!csvfile.is_open())
+	{
+		logfile << "|  error   |   " << "Cannot create file " << tmpcsv << " ,RunBatchReconciliation() failed!" << "\n";
+		logfile.close();
+		exit(1);
+	}
+	csvfile << "Snapshot ," << "Iterations to Converge ," << "Final Converged Value(J*/r) ";
+	for (int i=0; i < n; i++)
+	{
+		csvfile << "," << csvinputs.headers[i];
+	}
+	csvfile << "\n";
+
+	int factorizations = sys.factorizations;
+	logfile << "\n\nBatch Reconciliation \n" << "=====================\n";
+	for (int s=0; s < batch.rowcount; s++)
+	{
+		matrixData x(n, 1);
+		for (int i=0; i < n; i++)
+		{
+			x.data[i] = batch.xdata[(size_t)s*batch.columncount+pos[i]];
+		}
+		double value = 0;
+		matrixData reconciled_X;
+		int iterationcount = reconcileMeasurements(data, threadData, sys, Sx, std::move(x), eps, csvinputs, false, reconciled_X, value, logfile);
+		logfile << "Snapshot " << s+1 << ": Total Iteration to Converge : " << iterationcount << ", Final Converged Value(J*/r) : " << value << "\n";
+
+		csvfile << s+1 << "," << iterationcount << "," << value;
+		for (int i=0; i < n; i++)
+		{
+			csvfile << "," << reconciled_X.data[i];
+		}
+		csvfile << "\n";
+	}
+	csvfile.close();
+	logfile << "|  info    |   " << "Batch Reconciliation of " << batch.rowcount << " snapshots with " << (sys.factorizations-factorizations) << " factorizations of (F*Sx*Ft) Completed! \n";
+}
+
 
 int dataReconciliation(DATA* data, threadData_t *threadData)
 {
@@ -1382,39 +1459,37 @@ int dataReconciliation(DATA* data, threadData_t *threadData)
 		exit(1);
 	}
 	csvData Sx_data = readCovarianceMatrixSx(data, threadData,logfile);
-	//matrixData Sx = getCovarianceMatrixSx(Sx_data, data, threadData); // Prepare the data from csv file *
-	matrixData Sx = computeCovarianceMatrixSx(Sx_data,data,threadData,logfile); // Compute the covariance matrix from csv inputs
-	inputData x = getInputDataFromStartAttribute(Sx_data, data, threadData, logfile);  // Read the inputs from the start attribute of the modelica model
-	matrixData jacF = getJacobianMatrixF(data, threadData, logfile); // Compute the Jacobian Matrix F
-	matrixData jacFt = getTransposeMatrix(jacF); // Compute the Transpose of jacobian Matrix F
+	sparseMatrixData Sx = computeCovarianceMatrixSx(Sx_data,data,threadData,logfile); // Compute the covariance matrix from csv inputs
+	matrixData x = getInputDataFromStartAttribute(Sx_data, data, threadData, logfile);  // Read the inputs from the start attribute of the modelica model
 
-	double* Sx_diag = (double*)calloc(Sx.rows*1,sizeof(double));
-	getDiagonalElements(Sx.data,Sx.rows,Sx.column,Sx_diag);
-	matrixData tmpSx_diag={Sx.rows,1,Sx_diag};
-
-	matrixData tmp_x={x.rows,x.column,x.data};
-	matrixData x_diag=copyMatrix(tmp_x);
+	matrixData Sx_diag(Sx.rows, 1);
+	for (int j=0; j < Sx.column; j++)
+	{
+		for (int k=Sx.leadindex[j]; k < Sx.leadindex[j+1]; k++)
+		{
+			if(Sx.index[k] == j)
+			{
+				Sx_diag.data[j] = Sx.values[k];
+			}
+		}
+	}
 
 	// Print the initial information
 	logfile << "\n\nInitial Data \n" << "=============\n";
 	printMatrixWithHeaders(x.data,x.rows,x.column,Sx_data.headers,"X",logfile);
 	printVectorMatrixWithHeaders(Sx_data.sxdata,Sx_data.rowcount,1,Sx_data.headers,"Half-WidthConfidenceInterval",logfile);
-	printMatrixWithHeaders(Sx.data,Sx.rows,Sx.column,Sx_data.headers,"Sx",logfile);
-	//printMatrix(Sx_diag,Sx.rows,1,"Sx-Diagonal elements",logfile);
+	printSparseMatrix(Sx,false,&Sx_data.headers,"Sx",logfile);
 
-	//printMatrix(jacF.data,jacF.rows,jacF.column,"F",logfile);
-	//printMatrix(jacFt.data,jacFt.rows,jacFt.column,"Ft",logfile);
 	// Start the Algorithm
-	RunReconciliation(data,threadData,x,Sx,jacF,jacFt,atof(epselon),1,Sx_data,x_diag,tmpSx_diag,logfile);
+	reconciliationSystem sys;
+	RunReconciliation(data,threadData,sys,Sx,x,atof(epselon),Sx_data,Sx_diag,logfile);
+	if(omc_flag[FLAG_DATA_RECONCILE_BATCH])
+	{
+		RunBatchReconciliation(data,threadData,sys,Sx,atof(epselon),Sx_data,logfile);
+	}
 	logfile << "|  info    |   " << "DataReconciliation Completed! \n";
 	logfile.flush();
 	logfile.close();
-	free(Sx.data);
-	free(x.data);
-	free(jacF.data);
-	free(jacFt.data);
-	free(tmpSx_diag.data);
-	free(x_diag.data);
 	TRACE_POP
 	return 0;
 }
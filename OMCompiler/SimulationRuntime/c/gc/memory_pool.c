@@ -54,18 +54,121 @@ typedef struct list_s {
   struct list_s *next;
 } list;
 
+/* Every thread allocates from its own arena, so no lock is needed. */
+typedef struct memory_arena_s {
+  list *pools;       /* current block first */
+  list *spare;       /* block dropped by restore_memory_state, reused by pool_expand */
+  size_t full;       /* bytes used in the blocks behind the current one */
+  size_t highWater;  /* most bytes ever used at the same time */
+} memory_arena;
+
+static int pool_zero_atomic = 1;
+static size_t pool_high_water = 0;
+
+#if defined(_MSC_VER) && !defined(__GNUC__)
+#include <intrin.h>
+#endif
+
+/* pool_high_water is shared by the arenas of all threads */
+static size_t load_high_water(void)
+{
+#if defined(__GNUC__)
+  return __atomic_load_n(&pool_high_water, __ATOMIC_RELAXED);
+#else
+  return *(volatile size_t*)&pool_high_water;
+#endif
+}
+
+static void raise_high_water(size_t inUse)
+{
+#if defined(__GNUC__)
+  size_t global = __atomic_load_n(&pool_high_water, __ATOMIC_RELAXED);
+  while (global < inUse && !__atomic_compare_exchange_n(&pool_high_water, &global, inUse, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#elif defined(_MSC_VER)
+  size_t global = load_high_water();
+  while (global < inUse) {
+    size_t old = (size_t) _InterlockedCompareExchangePointer((void* volatile*) &pool_high_water, (void*) inUse, (void*) global);
+    if (old == global) {
+      break;
+    }
+    global = old;
+  }
+#else
+  /* no atomics; a concurrent update may get lost, the value is only for statistics */
+  if (load_high_water() < inUse) {
+    *(volatile size_t*)&pool_high_water = inUse;
+  }
+#endif
+}
+
+static void arena_free_list(list *pools)
+{
+  while (pools) {
+    list *next = pools->next;
+    omc_alloc_interface.free_uncollectable(pools->memory);
+    omc_alloc_interface.free_uncollectable(pools);
+    pools = next;
+  }
+}
+
 #if !defined(OMC_NO_THREADS)
-static pthread_mutex_t memory_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t memory_arena_key;
+static pthread_once_t memory_arena_once = PTHREAD_ONCE_INIT;
+
+static void arena_destroy(void *ptr)
+{
+  memory_arena *arena = (memory_arena*) ptr;
+  arena_free_list(arena->pools);
+  arena_free_list(arena->spare);
+  free(arena);
+}
+
+static void arena_key_init(void)
+{
+  pthread_key_create(&memory_arena_key, arena_destroy);
+}
+
+static inline memory_arena* get_arena(void)
+{
+  memory_arena *arena;
+  pthread_once(&memory_arena_once, arena_key_init);
+  arena = (memory_arena*) pthread_getspecific(memory_arena_key);
+  if (0==arena) {
+    arena = (memory_arena*) calloc(1, sizeof(memory_arena));
+    pthread_setspecific(memory_arena_key, arena);
+  }
+  return arena;
+}
+#else
+static memory_arena main_arena;
+
+static inline memory_arena* get_arena(void)
+{
+  return &main_arena;
+}
 #endif
-static list *memory_pools = NULL;
+
+static list* new_block(size_t size)
+{
+  list *block = (list*) omc_alloc_interface.malloc_uncollectable(sizeof(list));
+  block->used = 0;
+  block->size = size;
+  block->memory = omc_alloc_interface.malloc_uncollectable(size);
+  block->next = NULL;
+  return block;
+}
+
+static void arena_init(memory_arena *arena)
+{
+  if (0==arena->pools) {
+    arena->pools = new_block(2*1024*1024); /* 2MB pool by default */
+    arena->full = 0;
+  }
+}
 
 static void pool_init(void)
 {
-  memory_pools = (list*) omc_alloc_interface.malloc_uncollectable(sizeof(list));
-  memory_pools->used = 0;
-  memory_pools->size = 2*1024*1024; /* 2MB pool by default */
-  memory_pools->memory = omc_alloc_interface.malloc_uncollectable(memory_pools->size);
-  memory_pools->next = NULL;
+  arena_init(get_arena());
 }
 
 static unsigned long upper_power_of_two(unsigned long v)
@@ -85,67 +188,131 @@ static inline size_t round_up(size_t num, size_t factor)
   return num + factor - 1 - (num - 1) % factor;
 }
 
-static inline void pool_expand(size_t len)
+static inline void pool_expand(memory_arena *arena, size_t len)
 {
   list *newlist = NULL;
-  if (0==memory_pools) {
-    pool_init();
+  if (0==arena->pools) {
+    arena_init(arena);
   }
   /* Check if we have enough memory already */
-  if (memory_pools->size - memory_pools->used >= len) {
+  if (arena->pools->size - arena->pools->used >= len) {
     return;
   }
-  newlist = (list*) omc_alloc_interface.malloc_uncollectable(sizeof(list));
-  newlist->next = memory_pools;
-  memory_pools = newlist;
-  memory_pools->used = 0;
-  memory_pools->size = upper_power_of_two(3*memory_pools->next->size/2 + len); /* expand by 1.5x the old memory pool. More if we request a very large array. */
-  memory_pools->memory = omc_alloc_interface.malloc_uncollectable(memory_pools->size);
+  if (arena->spare && arena->spare->size >= len) {
+    newlist = arena->spare;
+    newlist->used = 0;
+  } else {
+    arena_free_list(arena->spare);
+    newlist = new_block(upper_power_of_two(3*arena->pools->size/2 + len)); /* expand by 1.5x the old memory pool. More if we request a very large array. */
+  }
+  arena->spare = NULL;
+  arena->full += arena->pools->used;
+  newlist->next = arena->pools;
+  arena->pools = newlist;
+}
+
+static inline void* arena_malloc(memory_arena *arena, size_t sz)
+{
+  void *res;
+  size_t inUse;
+  pool_expand(arena, sz);
+  res = (void*)((char*)arena->pools->memory + arena->pools->used);
+  arena->pools->used += sz;
+  inUse = arena->full + arena->pools->used;
+  if (inUse > arena->highWater) {
+    arena->highWater = inUse;
+    raise_high_water(inUse);
+  }
+  return res;
 }
 
 static void* pool_malloc(size_t sz)
 {
   void *res;
   sz = round_up(sz,8);
-#if !defined(OMC_NO_THREADS)
-  pthread_mutex_lock(&memory_pool_mutex);
-#endif
-  pool_expand(sz);
-  res = (void*)((char*)memory_pools->memory + memory_pools->used);
-  memory_pools->used += sz;
-#if !defined(OMC_NO_THREADS)
-  pthread_mutex_unlock(&memory_pool_mutex);
-#endif
+  res = arena_malloc(get_arena(), sz);
   memset(res,0,sz);
   return res;
 }
 
+/* Memory for data without pointers. Only cleared if requested, since
+ * generated code overwrites the arrays anyway. */
+static void* pool_malloc_atomic(size_t sz)
+{
+  void *res;
+  sz = round_up(sz,8);
+  res = arena_malloc(get_arena(), sz);
+  if (pool_zero_atomic) {
+    memset(res,0,sz);
+  }
+  return res;
+}
+
 static int pool_free_extra_list(void)
 {
-  list *freelist;
-  if (NULL == memory_pools) {
+  memory_arena *arena = get_arena();
+  if (NULL == arena->pools) {
     return 0;
   }
-  freelist = memory_pools->next;
-  while (freelist) {
-    list *next = freelist->next;
-    omc_alloc_interface.free_uncollectable(freelist->memory);
-    omc_alloc_interface.free_uncollectable(freelist);
-    freelist = next;
-  }
-  memory_pools->used = 0;
-  memory_pools->next = 0;
+  arena_free_list(arena->pools->next);
+  arena_free_list(arena->spare);
+  arena->spare = NULL;
+  arena->pools->used = 0;
+  arena->pools->next = 0;
+  arena->full = 0;
   return 0;
 }
 
 void free_memory_pool()
 {
+  memory_arena *arena = get_arena();
   pool_free_extra_list();
-  if (memory_pools) {
-    omc_alloc_interface.free_uncollectable(memory_pools->memory);
-    omc_alloc_interface.free_uncollectable(memory_pools);
-    memory_pools = NULL;
+  arena_free_list(arena->pools);
+  arena->pools = NULL;
+}
+
+omc_memory_state get_memory_state(void)
+{
+  omc_memory_state state;
+  memory_arena *arena = get_arena();
+  arena_init(arena);
+  state.block = arena->pools;
+  state.used = arena->pools->used;
+  return state;
+}
+
+void restore_memory_state(omc_memory_state state)
+{
+  memory_arena *arena = get_arena();
+  list *block;
+  /* nothing to do if the block was already released by collect_a_little */
+  for (block = arena->pools; block && block != state.block; block = block->next);
+  if (0==block) {
+    return;
   }
+  while (arena->pools != block) {
+    list *dropped = arena->pools;
+    arena->pools = dropped->next;
+    arena->full -= arena->pools->used;
+    dropped->next = NULL;
+    if (arena->spare && arena->spare->size >= dropped->size) {
+      arena_free_list(dropped);
+    } else {
+      arena_free_list(arena->spare);
+      arena->spare = dropped;
+    }
+  }
+  block->used = state.used;
+}
+
+void memory_pool_set_zero_atomic(int zero)
+{
+  pool_zero_atomic = zero;
+}
+
+size_t memory_pool_high_water(void)
+{
+  return load_high_water();
 }
 
 static void nofree(void* ptr)
@@ -159,7 +326,7 @@ static void* malloc_zero(size_t sz) {
 omc_alloc_interface_t omc_alloc_interface_pooled = {
   pool_init,
   pool_malloc,
-  pool_malloc,
+  pool_malloc_atomic,
   (char*(*)(size_t)) malloc,
   strdup,
   pool_free_extra_list,
@@ -226,7 +393,7 @@ omc_alloc_interface_t omc_alloc_interface = {
 #else
   pool_init,
   pool_malloc,
-  pool_malloc,
+  pool_malloc_atomic,
   (char*(*)(size_t)) malloc,
   strdup,
   pool_free_extra_list,
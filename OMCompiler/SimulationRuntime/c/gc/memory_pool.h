@@ -50,6 +50,24 @@ void* generic_alloc(int n, size_t sze);
 
 void free_memory_pool();
 
+/* Mark in the memory pool of the calling thread. Everything allocated from
+ * the pool by this thread after get_memory_state is released by
+ * restore_memory_state. Pool memory is only valid in the thread that
+ * allocated it and until the thread exits.
+ */
+typedef struct omc_memory_state {
+  void *block;
+  size_t used;
+} omc_memory_state;
+
+omc_memory_state get_memory_state(void);
+void restore_memory_state(omc_memory_state state);
+
+/* Clear arrays allocated with malloc_atomic (default 1) */
+void memory_pool_set_zero_atomic(int zero);
+/* Most bytes used at the same time by the pool of any thread */
+size_t memory_pool_high_water(void);
+
 #if defined(__cplusplus)
 } /* end extern "C" */
 #endif
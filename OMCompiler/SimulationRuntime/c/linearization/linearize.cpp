@@ -34,10 +34,13 @@
 #include "simulation/solver/external_input.h"
 #include "simulation/options.h"
 #include "simulation/solver/model_help.h"
+#include "simulation/solver/jacobianColors.h"
+#include "util/write_matlab4.h"
 #include "linearize.h"
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -67,6 +70,257 @@ static string array2string(double* array, int row, int col)
   return retVal.str();
 }
 
+/* Returns the jacobian if its sparse pattern is available, initializing it on first use */
+static ANALYTIC_JACOBIAN* getLinearizationJacobian(DATA* data, threadData_t *threadData, int index,
+                                                   int (*initialAnalyticJacobian)(void*, threadData_t*, ANALYTIC_JACOBIAN*))
+{
+  ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
+  if(NULL == jacobian->sparsePattern.leadindex && (NULL == initialAnalyticJacobian || initialAnalyticJacobian(data, threadData, jacobian)))
+  {
+    return NULL;
+  }
+  return NULL == jacobian->sparsePattern.leadindex ? NULL : jacobian;
+}
+
+/* Colors the columns of the numerical Jacobian of (f, g) with respect to one set of
+ * variables, given the sparse patterns of df/dv and dg/dv. Two columns get different
+ * colors if they have a nonzero in the same row of either pattern, so all columns of
+ * a color can be perturbed in one model evaluation. Returns the number of colors or
+ * 0 if a pattern is missing or does not fit. */
+static unsigned int colorNumericJacobian(const ANALYTIC_JACOBIAN* jacF, const ANALYTIC_JACOBIAN* jacG, unsigned int sizeCols,
+                                         unsigned int sizeF, unsigned int sizeG, vector<unsigned int>& colorCols)
+{
+  const ANALYTIC_JACOBIAN* jac[2] = {jacF, jacG};
+  unsigned int size[2] = {sizeF, sizeG};
+  vector<unsigned int> rowStart, rowCols, forbidden;
+  unsigned int nColors = 0, nRows = 0, i, k, p, q, row, col, color;
+
+  for(k = 0; k < 2; k++)
+  {
+    if(size[k] == 0)
+      continue;
+    if(!jac[k] || jac[k]->sizeCols != sizeCols || jac[k]->sizeRows != size[k])
+      return 0;
+    nRows += size[k];
+  }
+
+  /* rows of both patterns, the rows of g after the rows of f */
+  rowStart.assign(nRows+1, 0);
+  for(k = 0, row = 0; k < 2; row += size[k], k++)
+  {
+    if(size[k] == 0)
+      continue;
+    for(p = 0; p < jac[k]->sparsePattern.leadindex[sizeCols]; p++)
+      rowStart[row + jac[k]->sparsePattern.index[p] + 1]++;
+  }
+  for(i = 0; i < nRows; i++)
+    rowStart[i+1] += rowStart[i];
+  rowCols.resize(rowStart[nRows]);
+  {
+    vector<unsigned int> next(rowStart.begin(), rowStart.end()-1);
+    for(k = 0, row = 0; k < 2; row += size[k], k++)
+    {
+      if(size[k] == 0)
+        continue;
+      for(col = 0; col < sizeCols; col++)
+        for(p = jac[k]->sparsePattern.leadindex[col]; p < jac[k]->sparsePattern.leadindex[col+1]; p++)
+          rowCols[next[row + jac[k]->sparsePattern.index[p]]++] = col;
+    }
+  }
+
+  /* greedy coloring, colors are 1-based like the colors of the sparse pattern */
+  colorCols.assign(sizeCols, 0);
+  forbidden.assign(sizeCols+2, sizeCols);
+  for(col = 0; col < sizeCols; col++)
+  {
+    for(k = 0, row = 0; k < 2; row += size[k], k++)
+    {
+      if(size[k] == 0)
+        continue;
+      for(p = jac[k]->sparsePattern.leadindex[col]; p < jac[k]->sparsePattern.leadindex[col+1]; p++)
+      {
+        i = row + jac[k]->sparsePattern.index[p];
+        for(q = rowStart[i]; q < rowStart[i+1]; q++)
+          forbidden[colorCols[rowCols[q]]] = col;
+      }
+    }
+    for(color = 1; forbidden[color] == col; color++);
+    colorCols[col] = color;
+    if(color > nColors)
+      nColors = color;
+  }
+  return nColors;
+}
+
+/* Groups the columns of a numerical Jacobian into colors, with the sparse patterns of
+ * jacF and jacG if they fit and one column per color otherwise. Returns 1 if the
+ * patterns are used; then only their nonzeros have to be stored. */
+static int numericJacobianColors(const ANALYTIC_JACOBIAN* jacF, const ANALYTIC_JACOBIAN* jacG, unsigned int sizeCols,
+                                 unsigned int sizeF, unsigned int sizeG, JACOBIAN_COLORS* colors)
+{
+  vector<unsigned int> colorCols;
+  SPARSE_PATTERN pattern;
+  unsigned int nColors = colorNumericJacobian(jacF, jacG, sizeCols, sizeF, sizeG, colorCols);
+  int sparse = nColors > 0;
+  unsigned int i;
+
+  if(!sparse)
+  {
+    nColors = sizeCols;
+    colorCols.resize(sizeCols);
+    for(i = 0; i < sizeCols; i++)
+      colorCols[i] = i+1;
+  }
+  memset(&pattern, 0, sizeof(SPARSE_PATTERN));
+  pattern.colorCols = colorCols.empty() ? NULL : &colorCols[0];
+  pattern.maxColors = nColors;
+  initJacobianColors(colors, &pattern, sizeCols);
+  return sparse;
+}
+
+/* Stores the difference quotients of one perturbed column into the dense, column major
+ * matrix, only the rows of the sparse pattern of jacobian if it is given */
+static void storeNumericColumn(double* matrix, unsigned int column, unsigned int sizeRows, const double* f1, const double* f0,
+                               double delta, const ANALYTIC_JACOBIAN* jacobian)
+{
+  unsigned int ii, l;
+  if(jacobian)
+  {
+    for(ii = jacobian->sparsePattern.leadindex[column]; ii < jacobian->sparsePattern.leadindex[column+1]; ii++)
+    {
+      l = jacobian->sparsePattern.index[ii];
+      matrix[column*sizeRows + l] = (f1[l] - f0[l]) * delta;
+    }
+  }
+  else
+  {
+    for(l = 0; l < sizeRows; l++)
+      matrix[column*sizeRows + l] = (f1[l] - f0[l]) * delta;
+  }
+}
+
+/* Stores the rows of the sparse pattern of one column of a symbolic Jacobian into the
+ * dense, column major matrix given as userData */
+static void storeLinearizationColumn(void *userData, unsigned int column, const ANALYTIC_JACOBIAN *jacobian)
+{
+  double* jac = (double*) userData;
+  unsigned int ii, l;
+  for(ii = jacobian->sparsePattern.leadindex[column]; ii < jacobian->sparsePattern.leadindex[column+1]; ii++)
+  {
+    l = jacobian->sparsePattern.index[ii];
+    jac[column*jacobian->sizeRows + l] = jacobian->resultVars[l];
+  }
+}
+
+/* Evaluates a symbolic Jacobian color by color, with -jacobianThreads worker threads.
+ * Returns 1 if the sparse pattern has no colors, then nothing is evaluated. */
+static int functionJacColored(DATA* data, threadData_t *threadData, ANALYTIC_JACOBIAN* jacobian,
+                              int (*jacobianColumn)(void*, threadData_t*, ANALYTIC_JACOBIAN*, ANALYTIC_JACOBIAN*), double* jac)
+{
+  JACOBIAN_COLORS colors;
+  JACOBIAN_THREADS* threads = NULL;
+
+  if(NULL == jacobian->sparsePattern.leadindex || NULL == jacobian->sparsePattern.colorCols || 0 == jacobian->sparsePattern.maxColors)
+    return 1;
+
+  memset(jac, 0, (size_t)jacobian->sizeRows*jacobian->sizeCols*sizeof(double));
+  initJacobianColors(&colors, &jacobian->sparsePattern, jacobian->sizeCols);
+  if(omc_flag[FLAG_JACOBIAN_THREADS])
+    threads = initJacobianThreads(data, threadData, jacobian, atoi(omc_flagValue[FLAG_JACOBIAN_THREADS]));
+  infoStreamPrint(LOG_JAC, 0, "symbolic Jacobian: %u columns in %u colors", jacobian->sizeCols, colors.nColors);
+
+  evalJacobianColors(data, threadData, jacobian, &colors, threads, jacobianColumn, storeLinearizationColumn, jac);
+
+  freeJacobianThreads(threads);
+  freeJacobianColors(&colors);
+  return 0;
+}
+
+/* Name of the file of the linearized model, linear_<model><extension> next to the result file */
+static string linearModelFileName(DATA* data, const char* extension)
+{
+    string filename;
+	std::size_t pos, pos1, pos2;
+
+    /* Use the result file name rather than the model name so that the linear file name can be changed with the -r flag, however strip _res.mat from the filename */
+    filename = string(data->modelData->resultFileName) + extension;
+	pos = filename.rfind("_res.mat");
+	if (pos != std::string::npos)
+	{
+      // not found, use the modelFilePrefix
+	  filename = string(data->modelData->modelFilePrefix) + extension;
+	}
+	else
+	{
+      filename = filename.substr(0, pos) + extension;
+	}
+#if defined(__MINGW32__) || defined(_MSC_VER)
+    pos1 = filename.rfind('\\');
+	pos2 = filename.rfind('/');
+	if (pos1 < pos2)
+	{
+      pos = pos2;
+	}
+	else
+	{
+      pos = pos1;
+	}
+    if(pos >= filename.length()) {
+      filename = "linear_" + filename;
+    }else{
+      filename.replace(pos, 1, "/linear_");
+    }
+#else
+    if(filename.rfind('/') >= filename.length()) {
+      filename = "linear_" + filename;
+    }else{
+      filename.replace(filename.rfind('/'), 1, "/linear_");
+    }
+#endif
+    return filename;
+}
+
+/* writes a dense column vector, an empty one only as header */
+static int writeLinearModelVector(FILE* fout, const char* name, int size, const double* values)
+{
+    if(size > 0)
+        return writeMatVer4Matrix(fout, name, size, 1, values, sizeof(double));
+    return writeMatVer4MatrixHeader(fout, name, 0, 1, sizeof(double));
+}
+
+/* Writes the linearized model to linear_<model>.mat: the sparse matrices A, B, C, D and
+ * the operating point x0, u0, with data recovery also Cz, Dz and z0. The order of the
+ * variables is the one of the Modelica linear model. */
+static int writeLinearModelMat(DATA* data, threadData_t *threadData, const double* matrixA, const double* matrixB, const double* matrixC,
+                               const double* matrixD, const double* matrixCz, const double* matrixDz, const double* z0)
+{
+    int size_x = data->modelData->nStates;
+    int size_u = data->modelData->nInputVars;
+    int size_y = data->modelData->nOutputVars;
+    int size_z = data->modelData->nVariablesReal - 2*data->modelData->nStates;
+    string filename = linearModelFileName(data, ".mat");
+    int ret;
+
+    FILE *fout = fopen(filename.c_str(),"wb");
+    assertStreamPrint(threadData,0!=fout,"Cannot open File %s",filename.c_str());
+    ret = writeLinearModelVector(fout, "x0", size_x, data->localData[0]->realVars)
+       || writeLinearModelVector(fout, "u0", size_u, data->simulationInfo->inputVars)
+       || writeMatVer4SparseMatrix(fout, "A", size_x, size_x, matrixA)
+       || writeMatVer4SparseMatrix(fout, "B", size_x, size_u, matrixB)
+       || writeMatVer4SparseMatrix(fout, "C", size_y, size_x, matrixC)
+       || writeMatVer4SparseMatrix(fout, "D", size_y, size_u, matrixD);
+    if(!ret && matrixCz){
+        ret = writeLinearModelVector(fout, "z0", size_z, z0)
+           || writeMatVer4SparseMatrix(fout, "Cz", size_z, size_x, matrixCz)
+           || writeMatVer4SparseMatrix(fout, "Dz", size_z, size_u, matrixDz);
+    }
+    fclose(fout);
+    if(ret){
+        errorStreamPrint(LOG_STDOUT, 0, "Cannot write the linear model to %s", filename.c_str());
+    }
+    return ret;
+}
+
 extern "C" {
 
 int functionODE_residual(DATA* data, threadData_t *threadData, double *dx, double *dy, double *dz)
@@ -117,13 +371,15 @@ int functionJacAC_num(DATA* data, threadData_t *threadData, double *matrixA, dou
 {
     const double delta_h = numericalDifferentiationDeltaXlinearize;
     double delta_hh;
-    double xsave;
 
     double* x;
 
-    int i,j,k;
+    int i;
+    unsigned int color;
+    const unsigned int *col;
 
     int do_data_recovery = 0;
+    int sparse;
 
     int size_A = data->modelData->nStates;
     int size_C = data->modelData->nOutputVars;
@@ -136,6 +392,9 @@ int functionJacAC_num(DATA* data, threadData_t *threadData, double *matrixA, dou
     double* z0 = 0;
     double* z1 = 0;
     double *xScaling = (double*)calloc(size_A,sizeof(double));
+    vector<double> xsave(size_A), delta(size_A);
+    ANALYTIC_JACOBIAN *jacA = NULL, *jacC = NULL;
+    JACOBIAN_COLORS colors;
 
     assertStreamPrint(threadData,0!=x0,"calloc failed");
     assertStreamPrint(threadData,0!=y0,"calloc failed");
@@ -151,7 +410,13 @@ int functionJacAC_num(DATA* data, threadData_t *threadData, double *matrixA, dou
         z1 = (double*)calloc(size_z,sizeof(double));
         assertStreamPrint(threadData,0!=z0,"calloc failed");
         assertStreamPrint(threadData,0!=z1,"calloc failed");
+    } else {
+        /* there is no sparse pattern for the data recovery matrix */
+        jacA = getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_A, data->callback->initialAnalyticJacobianA);
+        jacC = getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_C, data->callback->initialAnalyticJacobianC);
     }
+    sparse = numericJacobianColors(jacA, jacC, size_A, size_A, size_C, &colors);
+    infoStreamPrint(LOG_JAC, 0, "numerical Jacobian A and C: %d states in %u model evaluations", size_A, colors.nColors);
 
     functionODE_residual(data, threadData, x0, y0, z0);
 
@@ -162,35 +427,36 @@ int functionJacAC_num(DATA* data, threadData_t *threadData, double *matrixA, dou
         xScaling[i] = fmax(data->modelData->realVarsData[i].attribute.nominal,fabs(x[i]));
     }
 
-    /* solverData->f1 must be set outside this function based on x */
-    for(i = 0; i < size_A; i++) {
-        xsave = x[i];
-        delta_hh = delta_h * (fabs(xsave) + 1.0);
-        if ((xsave + delta_hh >=  data->modelData->realVarsData[i].attribute.max))
-            delta_hh *= -1;
-        x[i] += delta_hh / xScaling[i];
-        /* Calculate scaled difference quotient */
-        delta_hh = 1. / delta_hh * xScaling[i];
+    /* perturb all states of one color at once, they do not influence the same rows */
+    for(color = 0; color < colors.nColors; color++) {
+        const unsigned int *first = colors.columns + colors.colorStart[color];
+        const unsigned int *last = colors.columns + colors.colorStart[color + 1];
+
+        for(col = first; col < last; col++) {
+            i = *col;
+            xsave[i] = x[i];
+            delta_hh = delta_h * (fabs(xsave[i]) + 1.0);
+            if ((xsave[i] + delta_hh >=  data->modelData->realVarsData[i].attribute.max))
+                delta_hh *= -1;
+            x[i] += delta_hh / xScaling[i];
+            /* Calculate scaled difference quotient */
+            delta[i] = 1. / delta_hh * xScaling[i];
+        }
 
         functionODE_residual(data, threadData, x1, y1, z1);
 
-        for(j = 0; j < size_A; j++) {
-            k = i * size_A + j;
-            matrixA[k] = (x1[j] - x0[j]) * delta_hh;
-        }
-        for(j = 0; j < size_C; j++) {
-            k = i * size_C + j;
-            matrixC[k] = (y1[j] - y0[j]) * delta_hh;
-        }
-        if(do_data_recovery > 0){
-            for(j = 0; j < size_z; j++) {
-                k = i * size_z + j;
-                matrixCz[k] = (z1[j] - z0[j]) * delta_hh;
+        for(col = first; col < last; col++) {
+            i = *col;
+            storeNumericColumn(matrixA, i, size_A, x1, x0, delta[i], sparse ? jacA : NULL);
+            storeNumericColumn(matrixC, i, size_C, y1, y0, delta[i], sparse ? jacC : NULL);
+            if(do_data_recovery > 0){
+                storeNumericColumn(matrixCz, i, size_z, z1, z0, delta[i], NULL);
             }
+            x[i] = xsave[i];
         }
-        x[i] = xsave;
     }
 
+    freeJacobianColors(&colors);
     free(xScaling);
     free(x0);
     free(y0);
@@ -208,12 +474,14 @@ int functionJacBD_num(DATA* data, threadData_t *threadData, double *matrixB, dou
 {
     const double delta_h = numericalDifferentiationDeltaXlinearize;
     double delta_hh;
-    double usave;
     double* u;
 
-    int i,j,k;
+    int i;
+    unsigned int color;
+    const unsigned int *col;
 
     int do_data_recovery = 0;
+    int sparse;
     if(matrixDz){
         do_data_recovery = 1;
     }
@@ -228,6 +496,9 @@ int functionJacBD_num(DATA* data, threadData_t *threadData, double *matrixB, dou
     double* y1 = (double*)calloc(size_y,sizeof(double));
     double* z0 = 0;
     double* z1 = 0;
+    vector<double> usave(size_u), delta(size_u);
+    ANALYTIC_JACOBIAN *jacB = NULL, *jacD = NULL;
+    JACOBIAN_COLORS colors;
 
     assertStreamPrint(threadData,0!=x0,"calloc failed");
     assertStreamPrint(threadData,0!=y0,"calloc failed");
@@ -239,38 +510,45 @@ int functionJacBD_num(DATA* data, threadData_t *threadData, double *matrixB, dou
         z1 = (double*)calloc(size_z,sizeof(double));
         assertStreamPrint(threadData,0!=z0,"calloc failed");
         assertStreamPrint(threadData,0!=z1,"calloc failed");
+    } else {
+        /* there is no sparse pattern for the data recovery matrix */
+        jacB = getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_B, data->callback->initialAnalyticJacobianB);
+        jacD = getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_D, data->callback->initialAnalyticJacobianD);
     }
+    sparse = numericJacobianColors(jacB, jacD, size_u, size_x, size_y, &colors);
+    infoStreamPrint(LOG_JAC, 0, "numerical Jacobian B and D: %d inputs in %u model evaluations", size_u, colors.nColors);
 
     functionODE_residual(data, threadData, x0, y0, z0);
 
     u = data->simulationInfo->inputVars;
 
-    /* solverData->f1 must be set outside this function based on x */
-    for(i = 0; i < size_u; i++) {
-        usave = u[i];
-        delta_hh = delta_h * (fabs(usave) + 1.0);
-        u[i] += delta_hh;
-        delta_hh = 1. / delta_hh;
+    /* perturb all inputs of one color at once, they do not influence the same rows */
+    for(color = 0; color < colors.nColors; color++) {
+        const unsigned int *first = colors.columns + colors.colorStart[color];
+        const unsigned int *last = colors.columns + colors.colorStart[color + 1];
+
+        for(col = first; col < last; col++) {
+            i = *col;
+            usave[i] = u[i];
+            delta_hh = delta_h * (fabs(usave[i]) + 1.0);
+            u[i] += delta_hh;
+            delta[i] = 1. / delta_hh;
+        }
 
         functionODE_residual(data, threadData, x1, y1, z1);
 
-        for(j = 0; j < size_x; j++) {
-            k = i * size_x + j;
-            matrixB[k] = (x1[j] - x0[j]) * delta_hh;
-        }
-        for(j = 0; j < size_y; j++) {
-            k = i * size_y + j;
-            matrixD[k] = (y1[j] - y0[j]) * delta_hh;
-        }
-        if(do_data_recovery > 0){
-            for(j = 0; j < size_z; j++) {
-                k = i * size_z + j;
-                matrixDz[k] = (z1[j] - z0[j]) * delta_hh;
+        for(col = first; col < last; col++) {
+            i = *col;
+            storeNumericColumn(matrixB, i, size_x, x1, x0, delta[i], sparse ? jacB : NULL);
+            storeNumericColumn(matrixD, i, size_y, y1, y0, delta[i], sparse ? jacD : NULL);
+            if(do_data_recovery > 0){
+                storeNumericColumn(matrixDz, i, size_z, z1, z0, delta[i], NULL);
             }
+            u[i] = usave[i];
         }
-        u[i] = usave;
     }
 
+    freeJacobianColors(&colors);
     free(x0);
     free(y0);
     free(x1);
@@ -290,6 +568,10 @@ int functionJacA(DATA* data, threadData_t *threadData, double* jac){
   const int index = data->callback->INDEX_JAC_A;
   ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
   unsigned int i,j,k;
+
+  if(0 == functionJacColored(data, threadData, jacobian, data->callback->functionJacA_column, jac))
+    return 0;
+
   k = 0;
   for(i=0; i < jacobian->sizeCols; i++)
   {
@@ -333,6 +615,10 @@ int functionJacB(DATA* data, threadData_t *threadData, double* jac){
   ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
 
   unsigned int i,j,k;
+
+  if(0 == functionJacColored(data, threadData, jacobian, data->callback->functionJacB_column, jac))
+    return 0;
+
   k = 0;
   for(i=0; i < jacobian->sizeCols; i++)
   {
@@ -374,6 +660,10 @@ int functionJacC(DATA* data, threadData_t *threadData, double* jac){
   const int index = data->callback->INDEX_JAC_C;
   ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
   unsigned int i,j,k;
+
+  if(0 == functionJacColored(data, threadData, jacobian, data->callback->functionJacC_column, jac))
+    return 0;
+
   k = 0;
   for(i=0; i < jacobian->sizeCols; i++)
   {
@@ -413,6 +703,10 @@ int functionJacD(DATA* data, threadData_t *threadData, double* jac){
   const int index = data->callback->INDEX_JAC_D;
   ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
   unsigned int i,j,k;
+
+  if(0 == functionJacColored(data, threadData, jacobian, data->callback->functionJacD_column, jac))
+    return 0;
+
   k = 0;
   for(i=0; i < jacobian->sizeCols; i++)
   {
@@ -456,6 +750,10 @@ int linearize(DATA* data, threadData_t *threadData)
     TRACE_PUSH
     /* Check if data recovery is requested */
     int do_data_recovery = omc_flag[FLAG_L_DATA_RECOVERY] ? 1 : 0;
+    /* Write the matrices in sparse MAT v4 format instead of a Modelica model */
+    int write_mat = omc_flag[FLAG_L_FORMAT] && 0 == strcmp(omc_flagValue[FLAG_L_FORMAT], "mat");
+    /* The symbolic Jacobian is used if it was set up by the integrator */
+    int use_symbolic = data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A].sizeTmpVars > 0;
 
     /* init linearization sizes */
     int size_A = data->modelData->nStates;
@@ -469,7 +767,7 @@ int linearize(DATA* data, threadData_t *threadData)
     double* matrixCz = 0;
     double* matrixDz = 0;
     string strA, strB, strC, strD, strCz, strDz, strX, strU, strZ0, filename;
-	std::size_t pos, pos1, pos2;
+    vector<double> z0;
 
     assertStreamPrint(threadData,0!=matrixA,"calloc failed");
     assertStreamPrint(threadData,0!=matrixB,"calloc failed");
@@ -484,7 +782,9 @@ int linearize(DATA* data, threadData_t *threadData)
     }
 
     /* Need to do this before changing anything so that we get a proper z0 */
-    if(do_data_recovery > 0){
+    if(do_data_recovery > 0 && write_mat){
+        z0.assign(data->localData[0]->realVars + 2*size_A, data->localData[0]->realVars + 2*size_A + size_z);
+    }else if(do_data_recovery > 0){
         if(size_z){
             strZ0 = "{" + array2string(&data->localData[0]->realVars[2*size_A],1,size_z) + "}";
         }else{
@@ -493,7 +793,7 @@ int linearize(DATA* data, threadData_t *threadData)
     }
 
     /* Can currently only extract data recovery matrices Cz and Dz numerically, so we do this first if necessary */
-    if(do_data_recovery > 0 || data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A].sizeTmpVars == 0){
+    if(do_data_recovery > 0 || !use_symbolic){
         /* Calculate numeric Jacobian */
         if(functionJacAC_num(data, threadData, matrixA, matrixC, matrixCz))
         {
@@ -510,33 +810,43 @@ int linearize(DATA* data, threadData_t *threadData)
     }
 
     /* Check if symbolic Jacobian available, if it is then use it (overwriting A,B,C,D if also doing data recovery) */
-    if (data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A].sizeTmpVars > 0){
-        /* Retrieve symbolic Jacobian */
+    if (use_symbolic){
+        /* Retrieve symbolic Jacobian, the Jacobians are only initialized once */
         /* Determine Matrix A */
-        ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]);
-        if(!data->callback->initialAnalyticJacobianA(data, threadData, jacobian)){
+        if(getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_A, data->callback->initialAnalyticJacobianA)){
             assertStreamPrint(threadData,0==functionJacA(data, threadData, matrixA),"Error, can not get Matrix A ");
         }
 
         /* Determine Matrix B */
-        jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_B]);
-        if(!data->callback->initialAnalyticJacobianB(data, threadData, jacobian)){
+        if(getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_B, data->callback->initialAnalyticJacobianB)){
             assertStreamPrint(threadData,0==functionJacB(data, threadData, matrixB),"Error, can not get Matrix B ");
         }
 
         /* Determine Matrix C */
-        jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_C]);
-        if(!data->callback->initialAnalyticJacobianC(data, threadData, jacobian)){
+        if(getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_C, data->callback->initialAnalyticJacobianC)){
             assertStreamPrint(threadData,0==functionJacC(data, threadData, matrixC),"Error, can not get Matrix C ");
         }
 
         /* Determine Matrix D */
-        jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_D]);
-        if(!data->callback->initialAnalyticJacobianD(data, threadData, jacobian)){
+        if(getLinearizationJacobian(data, threadData, data->callback->INDEX_JAC_D, data->callback->initialAnalyticJacobianD)){
             assertStreamPrint(threadData,0==functionJacD(data, threadData, matrixD),"Error, can not get Matrix D ");
         }
     }
 
+    if(write_mat){
+        int ret = writeLinearModelMat(data, threadData, matrixA, matrixB, matrixC, matrixD, matrixCz, matrixDz, z0.empty() ? NULL : &z0[0]);
+        free(matrixA);
+        free(matrixB);
+        free(matrixC);
+        free(matrixD);
+        if(do_data_recovery > 0){
+            free(matrixCz);
+            free(matrixDz);
+        }
+        TRACE_POP
+        return ret;
+    }
+
     strA = array2string(matrixA,size_A,size_A);
     strB = array2string(matrixB,size_A,size_Inputs);
     strC = array2string(matrixC,size_Outputs,size_A);
@@ -568,42 +878,7 @@ int linearize(DATA* data, threadData_t *threadData)
         free(matrixDz);
     }
 
-    /* Use the result file name rather than the model name so that the linear file name can be changed with the -r flag, however strip _res.mat from the filename */
-    filename = string(data->modelData->resultFileName) + ".mo";
-	pos = filename.rfind("_res.mat");
-	if (pos != std::string::npos)
-	{
-      // not found, use the modelFilePrefix
-	  filename = string(data->modelData->modelFilePrefix) + ".mo";
-	}
-	else
-	{
-      filename = filename.substr(0, pos) + ".mo";
-	}
-#if defined(__MINGW32__) || defined(_MSC_VER)
-    pos1 = filename.rfind('\\');
-	pos2 = filename.rfind('/');
-	if (pos1 < pos2)
-	{
-      pos = pos2;
-	}
-	else
-	{
-      pos = pos1;
-	}
-    if(pos >= filename.length()) {
-      filename = "linear_" + filename;
-    }else{
-      filename.replace(pos, 1, "/linear_");
-    }
-#else
-    if(filename.rfind('/') >= filename.length()) {
-      filename = "linear_" + filename;
-    }else{
-      filename.replace(filename.rfind('/'), 1, "/linear_");
-    }
-#endif
-
+    filename = linearModelFileName(data, ".mo");
 
     FILE *fout = fopen(filename.c_str(),"wb");
     assertStreamPrint(threadData,0!=fout,"Cannot open File %s",filename.c_str());
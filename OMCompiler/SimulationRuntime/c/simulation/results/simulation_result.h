@@ -42,6 +42,7 @@ typedef struct simulation_result {
   const char *filename;
   long numpoints;
   int cpuTime;
+  int writerThread; /* emit runs on the asynchronous result writer thread and must leave the timers of the solver thread alone */
   void *storage; /* Internal data used for each storage scheme */
   void (*init)(struct simulation_result*,DATA*,threadData_t *threadData);
   void (*emit)(struct simulation_result*,DATA*,threadData_t *threadData);
@@ -0,0 +1,326 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * Asynchronous result output.
+ *
+ * The solver thread is the only producer and the writer thread the only
+ * consumer of the ring: head is written by the solver thread and tail by the
+ * writer thread only, so a time-point is handed over without taking a lock.
+ * The mutex and the condition variables are only used to put one side to
+ * sleep when it cannot make progress (writer: nothing to do, solver: ring
+ * full), which bounds the memory and throttles the solver to the disk speed.
+ */
+
+#include "util/omc_error.h"
+#include "util/omc_init.h"
+#include "util/rtclock.h"
+#include "simulation/options.h"
+#include "meta/meta_modelica.h"
+#include "simulation_result_async.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(OMC_MINIMAL_RUNTIME) && !defined(OMC_NO_THREADS) && defined(__GNUC__)
+#define OMC_ASYNC_RESULT
+#endif
+
+extern "C" {
+
+#if defined(OMC_ASYNC_RESULT)
+
+#define ASYNC_LOAD(X)    __atomic_load_n(&(X), __ATOMIC_SEQ_CST)
+#define ASYNC_STORE(X,V) __atomic_store_n(&(X), (V), __ATOMIC_SEQ_CST)
+
+typedef struct async_result {
+  simulation_result inner;          /* the wrapped result writer */
+  DATA shadowData;                  /* what the wrapped writer sees as data */
+  SIMULATION_INFO shadowInfo;
+  SIMULATION_DATA shadowLocal;
+  SIMULATION_DATA *shadowLocalData[1];
+
+  size_t capacity;                  /* rows in the ring */
+  size_t wakeBatch;                 /* rows queued before a sleeping writer is woken */
+  size_t nReal, nInteger, nBoolean, nString, nSensitivity;
+  size_t realStride;                /* time, solverSteps, reals, sensitivities */
+  modelica_real *reals;
+  modelica_integer *integers;
+  modelica_boolean *booleans;
+  modelica_string *strings;         /* uncollectable, so the GC sees the queued strings */
+
+  size_t head;                      /* written by the solver thread only */
+  size_t tail;                      /* written by the writer thread only */
+  int writerWaiting;
+  int solverWaiting;
+  int flush;
+  int stop;
+  int failed;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t dataCond;
+  pthread_cond_t spaceCond;
+  pthread_t thread;
+  threadData_t *writerThreadData;
+} async_result;
+
+static void async_result_wake(async_result *ar, pthread_cond_t *cond)
+{
+  pthread_mutex_lock(&ar->mutex);
+  pthread_cond_broadcast(cond);
+  pthread_mutex_unlock(&ar->mutex);
+}
+
+/* true if the writer has nothing to do yet */
+static int async_result_writerIdle(async_result *ar, size_t tail)
+{
+  size_t pending = ASYNC_LOAD(ar->head) - tail;
+  if (ASYNC_LOAD(ar->stop))
+    return 0;
+  return 0 == pending || (pending < ar->wakeBatch && !ASYNC_LOAD(ar->flush));
+}
+
+/* make the wrapped writer see the time-point stored in the given slot */
+static void async_result_writeRow(async_result *ar, size_t slot, threadData_t *threadData)
+{
+  modelica_real *reals = ar->reals + slot * ar->realStride;
+
+  ar->shadowLocal.timeValue = reals[0];
+  ar->shadowInfo.solverSteps = reals[1];
+  ar->shadowLocal.realVars = reals + 2;
+  ar->shadowInfo.sensitivityMatrix = reals + 2 + ar->nReal;
+  ar->shadowLocal.integerVars = ar->integers + slot * ar->nInteger;
+  ar->shadowLocal.booleanVars = ar->booleans + slot * ar->nBoolean;
+  ar->shadowLocal.stringVars = ar->strings + slot * ar->nString;
+
+  ar->inner.emit(&ar->inner, &ar->shadowData, threadData);
+}
+
+static void* async_result_writer(void *arg)
+{
+  async_result *ar = (async_result*) arg;
+  threadData_t *threadData = ar->writerThreadData;
+  size_t tail = ar->tail;
+  volatile int done = 0;
+
+  pthread_setspecific(mmc_thread_data_key, threadData);
+  MMC_TRY_INTERNAL(mmc_jumper)
+  for (;;) {
+    if (async_result_writerIdle(ar, tail)) {
+      pthread_mutex_lock(&ar->mutex);
+      ASYNC_STORE(ar->writerWaiting, 1);
+      while (async_result_writerIdle(ar, tail))
+        pthread_cond_wait(&ar->dataCond, &ar->mutex);
+      ASYNC_STORE(ar->writerWaiting, 0);
+      pthread_mutex_unlock(&ar->mutex);
+    }
+    /* only an empty ring after stop gets here */
+    if (ASYNC_LOAD(ar->head) == tail)
+      break;
+
+    async_result_writeRow(ar, tail % ar->capacity, threadData);
+    ASYNC_STORE(ar->tail, ++tail);
+    if (ASYNC_LOAD(ar->solverWaiting))
+      async_result_wake(ar, &ar->spaceCond);
+  }
+  done = 1;
+  MMC_CATCH_INTERNAL(mmc_jumper)
+
+  if (!done) {
+    ASYNC_STORE(ar->failed, 1);
+    async_result_wake(ar, &ar->spaceCond);
+  }
+  return NULL;
+}
+
+/* block the solver thread until at most maxPending rows are queued */
+static void async_result_waitFor(async_result *ar, size_t maxPending)
+{
+  if (ar->head - ASYNC_LOAD(ar->tail) <= maxPending || ASYNC_LOAD(ar->failed))
+    return;
+
+  pthread_mutex_lock(&ar->mutex);
+  ASYNC_STORE(ar->solverWaiting, 1);
+  while (ar->head - ASYNC_LOAD(ar->tail) > maxPending && !ASYNC_LOAD(ar->failed))
+    pthread_cond_wait(&ar->spaceCond, &ar->mutex);
+  ASYNC_STORE(ar->solverWaiting, 0);
+  pthread_mutex_unlock(&ar->mutex);
+}
+
+/* write everything queued so far */
+static void async_result_drain(async_result *ar)
+{
+  ASYNC_STORE(ar->flush, 1);
+  async_result_wake(ar, &ar->dataCond);
+  async_result_waitFor(ar, 0);
+  ASYNC_STORE(ar->flush, 0);
+}
+
+static void async_result_emit(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  async_result *ar = (async_result*) self->storage;
+  const SIMULATION_DATA *sData = data->localData[0];
+  size_t slot;
+  modelica_real *reals;
+
+  /* the output time of the solver thread is queueing the row; the writer
+   * thread does not touch the timers */
+  rt_tick(SIM_TIMER_OUTPUT);
+  async_result_waitFor(ar, ar->capacity - 1);
+  if (ASYNC_LOAD(ar->failed))
+    throwStreamPrint(threadData, "The asynchronous result writer for %s failed.", self->filename);
+
+  slot = ar->head % ar->capacity;
+  reals = ar->reals + slot * ar->realStride;
+  reals[0] = sData->timeValue;
+  reals[1] = data->simulationInfo->solverSteps;
+  memcpy(reals + 2, sData->realVars, ar->nReal * sizeof(modelica_real));
+  if (ar->nSensitivity)
+    memcpy(reals + 2 + ar->nReal, data->simulationInfo->sensitivityMatrix, ar->nSensitivity * sizeof(modelica_real));
+  memcpy(ar->integers + slot * ar->nInteger, sData->integerVars, ar->nInteger * sizeof(modelica_integer));
+  memcpy(ar->booleans + slot * ar->nBoolean, sData->booleanVars, ar->nBoolean * sizeof(modelica_boolean));
+  memcpy(ar->strings + slot * ar->nString, sData->stringVars, ar->nString * sizeof(modelica_string));
+
+  ASYNC_STORE(ar->head, ar->head + 1);
+  if (ASYNC_LOAD(ar->writerWaiting) && ar->head - ASYNC_LOAD(ar->tail) >= ar->wakeBatch)
+    async_result_wake(ar, &ar->dataCond);
+  rt_accumulate(SIM_TIMER_OUTPUT);
+}
+
+static void async_result_writeParameterData(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  async_result *ar = (async_result*) self->storage;
+
+  /* the writer thread is idle until the next emit */
+  async_result_drain(ar);
+  ar->inner.writeParameterData(&ar->inner, data, threadData);
+}
+
+static void async_result_destroy(async_result *ar)
+{
+  pthread_mutex_destroy(&ar->mutex);
+  pthread_cond_destroy(&ar->dataCond);
+  pthread_cond_destroy(&ar->spaceCond);
+  free(ar->reals);
+  free(ar->integers);
+  free(ar->booleans);
+  if (ar->strings)
+    omc_alloc_interface.free_uncollectable(ar->strings);
+  free(ar->writerThreadData);
+  free(ar);
+}
+
+static void async_result_free(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  async_result *ar = (async_result*) self->storage;
+  simulation_result inner;
+
+  ASYNC_STORE(ar->stop, 1);
+  async_result_wake(ar, &ar->dataCond);
+  GC_pthread_join(ar->thread, NULL);
+
+  inner = ar->inner;
+  async_result_destroy(ar);
+  inner.free(&inner, data, threadData);
+  *self = inner;
+}
+
+int async_result_start(simulation_result *self, DATA *data, threadData_t *threadData, long capacity)
+{
+  const MODEL_DATA *mData = data->modelData;
+  async_result *ar;
+
+  if (capacity <= 0)
+    return 0;
+  if (self->cpuTime) {
+    /* the cpu-time of a row has to be taken on the solver thread */
+    warningStreamPrint(LOG_STDOUT, 0, "-cpu requires synchronous result output, ignoring -asyncOutput");
+    return 0;
+  }
+
+  ar = (async_result*) calloc(1, sizeof(async_result));
+  assertStreamPrint(threadData, 0 != ar, "Out of memory");
+  ar->inner = *self;
+  ar->inner.writerThread = 1;
+  ar->shadowData = *data;
+  ar->shadowInfo = *data->simulationInfo;
+  ar->shadowLocal = *data->localData[0];
+  ar->shadowLocalData[0] = &ar->shadowLocal;
+  ar->shadowData.localData = ar->shadowLocalData;
+  ar->shadowData.simulationInfo = &ar->shadowInfo;
+
+  ar->capacity = capacity;
+  ar->wakeBatch = capacity > 8 ? capacity / 8 : 1;
+  ar->nReal = mData->nVariablesReal;
+  ar->nInteger = mData->nVariablesInteger;
+  ar->nBoolean = mData->nVariablesBoolean;
+  ar->nString = mData->nVariablesString;
+  ar->nSensitivity = omc_flag[FLAG_IDAS] ? mData->nSensitivityVars : 0;
+  ar->realStride = 2 + ar->nReal + ar->nSensitivity;
+
+  ar->reals = (modelica_real*) malloc(ar->capacity * ar->realStride * sizeof(modelica_real));
+  ar->integers = (modelica_integer*) malloc(ar->capacity * ar->nInteger * sizeof(modelica_integer) + 1);
+  ar->booleans = (modelica_boolean*) malloc(ar->capacity * ar->nBoolean * sizeof(modelica_boolean) + 1);
+  if (ar->nString)
+    ar->strings = (modelica_string*) omc_alloc_interface.malloc_uncollectable(ar->capacity * ar->nString * sizeof(modelica_string));
+  ar->writerThreadData = (threadData_t*) calloc(1, sizeof(threadData_t));
+  assertStreamPrint(threadData, ar->reals && ar->integers && ar->booleans && ar->writerThreadData && (ar->strings || !ar->nString),
+                    "Not enough memory for %ld rows of asynchronous result output", capacity);
+
+  pthread_mutex_init(&ar->mutex, NULL);
+  pthread_cond_init(&ar->dataCond, NULL);
+  pthread_cond_init(&ar->spaceCond, NULL);
+
+  if (GC_pthread_create(&ar->thread, NULL, async_result_writer, ar)) {
+    warningStreamPrint(LOG_STDOUT, 0, "Could not start the result writer thread, using synchronous result output");
+    async_result_destroy(ar);
+    return 0;
+  }
+
+  self->storage = ar;
+  self->emit = async_result_emit;
+  self->writeParameterData = async_result_writeParameterData;
+  self->free = async_result_free;
+  infoStreamPrint(LOG_SOLVER, 0, "Writing %s from a separate thread (%ld buffered time-points)", self->filename, capacity);
+  return 1;
+}
+
+#else
+
+int async_result_start(simulation_result *self, DATA *data, threadData_t *threadData, long capacity)
+{
+  if (capacity > 0)
+    warningStreamPrint(LOG_STDOUT, 0, "Asynchronous result output is not available in this runtime, ignoring -asyncOutput");
+  return 0;
+}
+
+#endif /* OMC_ASYNC_RESULT */
+
+}
@@ -0,0 +1,507 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * Chunked, compressed columnar result file (outputFormat=col).
+ *
+ * Rows are gathered into a buffer of chunkRows rows; a full buffer is written
+ * as one block per column, each compressed on its own with the cheapest of
+ * the codecs in util/read_col.h. The footer with the signal table, the
+ * parameter values and the chunk index is written when the file is closed,
+ * so a reader can fetch single columns or time windows without scanning the
+ * whole file. See util/read_col.h for the layout.
+ */
+
+#include "util/omc_error.h"
+#include "util/rtclock.h"
+#include "util/read_col.h"
+#include "simulation/options.h"
+#include "simulation_result_col.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <stdint.h>
+
+typedef struct col_signal {
+  std::string name, descr;
+  int32_t isParam;
+  int32_t index;   /* 1-based column or parameter, negative for negated aliases */
+} col_signal;
+
+typedef struct col_chunk {
+  uint32_t nrows;
+  double startTime, stopTime;
+} col_chunk;
+
+typedef struct col_writer {
+  FILE *fout;
+  uint64_t pos;   /* current file offset */
+  size_t ncols;
+  size_t chunkRows;
+  size_t nrows;   /* rows buffered for the current chunk */
+  std::vector<double> rows;   /* chunkRows rows of ncols values */
+  std::vector<double> column;
+  std::vector<unsigned char> block, scratch;
+
+  /* emit plan, computed once in col_init */
+  std::vector<int> realIndex, integerIndex, booleanIndex, negatedBooleanIndex;
+  std::vector<int> realParameterIndex, integerParameterIndex, booleanParameterIndex, negatedBooleanParameterIndex;
+
+  std::vector<col_signal> signals;
+  std::vector<double> params;
+  std::vector<col_chunk> chunks;
+  std::vector<uint64_t> offsets;   /* ncols block offsets per chunk */
+  std::vector<uint32_t> sizes;
+} col_writer;
+
+/* approximate size of the row buffer; bounds the size of one chunk */
+#define COL_CHUNK_BUFFER_SIZE (1<<20)
+#define COL_MIN_CHUNK_ROWS 64
+#define COL_MAX_CHUNK_ROWS 65536
+
+static const char timeName[] = "time";
+static const char timeDesc[] = "Simulation time [s]";
+static const char cpuTimeName[] = "$cpuTime";
+static const char cpuTimeDesc[] = "cpu time [s]";
+static const char solverStepsName[] = "$solverSteps";
+static const char solverStepsDesc[] = "number of steps taken by the integrator";
+
+/* bit stream read by col_get_bits in util/read_col.c */
+typedef struct col_bit_writer {
+  unsigned char *buf;
+  size_t pos;
+  uint64_t acc;
+  int nacc;
+} col_bit_writer;
+
+static void col_put_bits(col_bit_writer *w, uint64_t value, int n)
+{
+  if (n > 32) {
+    col_put_bits(w, value >> 32, n-32);
+    col_put_bits(w, value & 0xffffffffu, 32);
+    return;
+  }
+  w->acc = (w->acc << n) | (value & ((((uint64_t)1) << n) - 1));
+  w->nacc += n;
+  while (w->nacc >= 8) {
+    w->nacc -= 8;
+    w->buf[w->pos++] = (unsigned char) (w->acc >> w->nacc);
+  }
+}
+
+static int col_clz(uint64_t x)
+{
+#if defined(__GNUC__)
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  while (!(x & (((uint64_t)1) << 63))) { x <<= 1; n++; }
+  return n;
+#endif
+}
+
+static int col_ctz(uint64_t x)
+{
+#if defined(__GNUC__)
+  return __builtin_ctzll(x);
+#else
+  int n = 0;
+  while (!(x & 1)) { x >>= 1; n++; }
+  return n;
+#endif
+}
+
+/* XOR every value with its prediction and store only the bits in between the
+ * leading and trailing zeros of the difference. The linear predictor
+ * extrapolates the bit patterns as integers, which is exact for smooth signals
+ * within one binade and does not depend on the floating-point environment. */
+static size_t col_encode_xor(const double *vals, size_t n, int linear, unsigned char *out)
+{
+  col_bit_writer w = {out+1, 0, 0, 0};
+  uint64_t prev, prev2, cur, pred, x;
+  int lead = -1, trail = 0, sig = 0;
+
+  out[0] = linear ? OMC_COL_XOR_LINEAR : OMC_COL_XOR;
+  memcpy(&prev, vals, sizeof(double));
+  prev2 = prev;
+  col_put_bits(&w, prev, 64);
+  for (size_t i=1; i < n; i++) {
+    memcpy(&cur, vals+i, sizeof(double));
+    pred = (linear && i >= 2) ? 2*prev - prev2 : prev;
+    x = cur ^ pred;
+    if (x == 0) {
+      col_put_bits(&w, 0, 1);
+    } else {
+      int l = col_clz(x), t = col_ctz(x);
+      if (l > 31) l = 31;
+      if (lead >= 0 && l >= lead && t >= trail) {
+        col_put_bits(&w, 2, 2);
+      } else {
+        lead = l;
+        trail = t;
+        sig = 64 - l - t;
+        col_put_bits(&w, 3, 2);
+        col_put_bits(&w, lead, 5);
+        col_put_bits(&w, sig-1, 6);
+      }
+      col_put_bits(&w, x >> trail, sig);
+    }
+    prev2 = prev;
+    prev = cur;
+  }
+  if (w.nacc > 0)
+    w.buf[w.pos++] = (unsigned char) (w.acc << (8 - w.nacc));
+  return 1 + w.pos;
+}
+
+/* encode n values into out with the smallest codec; out and scratch hold
+ * at least col_block_size(n) bytes */
+static size_t col_block_size(size_t n)
+{
+  /* a value takes at most 2+5+6+64 bits */
+  return 1 + 10*n + 8;
+}
+
+static size_t col_encode(const double *vals, size_t n, unsigned char *out, unsigned char *scratch)
+{
+  size_t size, sizeLinear;
+
+  if (memcmp(vals, vals+1, (n-1)*sizeof(double)) == 0) {
+    out[0] = OMC_COL_CONSTANT;
+    memcpy(out+1, vals, sizeof(double));
+    return 1 + sizeof(double);
+  }
+  size = col_encode_xor(vals, n, 0, out);
+  sizeLinear = col_encode_xor(vals, n, 1, scratch);
+  if (sizeLinear < size) {
+    memcpy(out, scratch, sizeLinear);
+    size = sizeLinear;
+  }
+  if (size >= 1 + n*sizeof(double)) {
+    out[0] = OMC_COL_RAW;
+    memcpy(out+1, vals, n*sizeof(double));
+    size = 1 + n*sizeof(double);
+  }
+  return size;
+}
+
+static void col_write(col_writer *writer, const void *ptr, size_t size)
+{
+  fwrite(ptr, 1, size, writer->fout);
+  writer->pos += size;
+}
+
+static void col_write_uint32(col_writer *writer, uint32_t value)
+{
+  col_write(writer, &value, sizeof(uint32_t));
+}
+
+static void col_write_string(col_writer *writer, const std::string &str)
+{
+  col_write_uint32(writer, (uint32_t) str.size());
+  col_write(writer, str.data(), str.size());
+}
+
+/* write the buffered rows as one chunk */
+static void col_flush(col_writer *writer)
+{
+  col_chunk chunk;
+  size_t size;
+
+  if (writer->nrows == 0)
+    return;
+
+  chunk.nrows = (uint32_t) writer->nrows;
+  chunk.startTime = writer->rows[0];
+  chunk.stopTime = writer->rows[(writer->nrows-1) * writer->ncols];
+  for (size_t j=0; j < writer->ncols; j++) {
+    for (size_t i=0; i < writer->nrows; i++)
+      writer->column[i] = writer->rows[i * writer->ncols + j];
+    size = col_encode(&writer->column[0], writer->nrows, &writer->block[0], &writer->scratch[0]);
+    writer->offsets.push_back(writer->pos);
+    writer->sizes.push_back((uint32_t) size);
+    col_write(writer, &writer->block[0], size);
+  }
+  writer->chunks.push_back(chunk);
+  writer->nrows = 0;
+}
+
+static void col_add_signal(col_writer *writer, const char *name, const char *comment, const char *unit, int isParam, int index)
+{
+  col_signal signal;
+  signal.name = name;
+  signal.descr = comment;
+  if (unit && *unit) {
+    signal.descr += " [";
+    signal.descr += unit;
+    signal.descr += "]";
+  }
+  signal.isParam = isParam;
+  signal.index = index;
+  writer->signals.push_back(signal);
+}
+
+extern "C" {
+
+void col_init(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  const MODEL_DATA *mData = data->modelData;
+  col_writer *writer;
+  int32_t column = 0, param = 0;
+  uint32_t header[2];
+
+  /* columns and parameters of the variables, for the aliases */
+  std::vector<int32_t> realColumn(mData->nVariablesReal), integerColumn(mData->nVariablesInteger), booleanColumn(mData->nVariablesBoolean);
+  std::vector<int32_t> realParam(mData->nParametersReal), integerParam(mData->nParametersInteger), booleanParam(mData->nParametersBoolean);
+
+  rt_tick(SIM_TIMER_OUTPUT);
+  FILE *fout = fopen(self->filename, "wb");
+  assertStreamPrint(threadData, 0!=fout, "Error, couldn't create output file: [%s] because of %s", self->filename, strerror(errno));
+  writer = new col_writer;
+  writer->fout = fout;
+  writer->pos = 0;
+  writer->nrows = 0;
+
+  col_add_signal(writer, timeName, timeDesc, NULL, 0, ++column);
+  if (self->cpuTime)
+    col_add_signal(writer, cpuTimeName, cpuTimeDesc, NULL, 0, ++column);
+  if (omc_flag[FLAG_SOLVER_STEPS])
+    col_add_signal(writer, solverStepsName, solverStepsDesc, NULL, 0, ++column);
+
+  for (int i=0; i < mData->nVariablesReal; i++)
+    if (!mData->realVarsData[i].filterOutput) {
+      realColumn[i] = ++column;
+      col_add_signal(writer, mData->realVarsData[i].info.name, mData->realVarsData[i].info.comment, MMC_STRINGDATA(mData->realVarsData[i].attribute.unit), 0, column);
+      writer->realIndex.push_back(i);
+    }
+
+  if (omc_flag[FLAG_IDAS])
+    for (int i=mData->nSensitivityParamVars; i < mData->nSensitivityVars; i++)
+      col_add_signal(writer, mData->realSensitivityData[i].info.name, mData->realSensitivityData[i].info.comment, NULL, 0, ++column);
+
+  for (int i=0; i < mData->nVariablesInteger; i++)
+    if (!mData->integerVarsData[i].filterOutput) {
+      integerColumn[i] = ++column;
+      col_add_signal(writer, mData->integerVarsData[i].info.name, mData->integerVarsData[i].info.comment, NULL, 0, column);
+      writer->integerIndex.push_back(i);
+    }
+
+  for (int i=0; i < mData->nVariablesBoolean; i++)
+    if (!mData->booleanVarsData[i].filterOutput) {
+      booleanColumn[i] = ++column;
+      col_add_signal(writer, mData->booleanVarsData[i].info.name, mData->booleanVarsData[i].info.comment, NULL, 0, column);
+      writer->booleanIndex.push_back(i);
+    }
+
+  for (int i=0; i < mData->nParametersReal; i++)
+    if (!mData->realParameterData[i].filterOutput) {
+      realParam[i] = ++param;
+      col_add_signal(writer, mData->realParameterData[i].info.name, mData->realParameterData[i].info.comment, MMC_STRINGDATA(mData->realParameterData[i].attribute.unit), 1, param);
+      writer->realParameterIndex.push_back(i);
+    }
+
+  for (int i=0; i < mData->nParametersInteger; i++)
+    if (!mData->integerParameterData[i].filterOutput) {
+      integerParam[i] = ++param;
+      col_add_signal(writer, mData->integerParameterData[i].info.name, mData->integerParameterData[i].info.comment, NULL, 1, param);
+      writer->integerParameterIndex.push_back(i);
+    }
+
+  for (int i=0; i < mData->nParametersBoolean; i++)
+    if (!mData->booleanParameterData[i].filterOutput) {
+      booleanParam[i] = ++param;
+      col_add_signal(writer, mData->booleanParameterData[i].info.name, mData->booleanParameterData[i].info.comment, NULL, 1, param);
+      writer->booleanParameterIndex.push_back(i);
+    }
+
+  /* aliases of filtered out variables have no column to refer to and are left out */
+  for (int i=0; i < mData->nAliasReal; i++)
+    if (!mData->realAlias[i].filterOutput) {
+      const DATA_REAL_ALIAS *alias = mData->realAlias + i;
+      int sign = alias->negate ? -1 : 1;
+      if (alias->aliasType == 0 && realColumn[alias->nameID])
+        col_add_signal(writer, alias->info.name, alias->info.comment, MMC_STRINGDATA(mData->realVarsData[alias->nameID].attribute.unit), 0, sign * realColumn[alias->nameID]);
+      else if (alias->aliasType == 1 && realParam[alias->nameID])
+        col_add_signal(writer, alias->info.name, alias->info.comment, MMC_STRINGDATA(mData->realParameterData[alias->nameID].attribute.unit), 1, sign * realParam[alias->nameID]);
+      else if (alias->aliasType == 2)
+        col_add_signal(writer, alias->info.name, alias->info.comment, "s", 0, sign);
+    }
+
+  for (int i=0; i < mData->nAliasInteger; i++)
+    if (!mData->integerAlias[i].filterOutput) {
+      const DATA_INTEGER_ALIAS *alias = mData->integerAlias + i;
+      int sign = alias->negate ? -1 : 1;
+      if (alias->aliasType == 0 && integerColumn[alias->nameID])
+        col_add_signal(writer, alias->info.name, alias->info.comment, NULL, 0, sign * integerColumn[alias->nameID]);
+      else if (alias->aliasType == 1 && integerParam[alias->nameID])
+        col_add_signal(writer, alias->info.name, alias->info.comment, NULL, 1, sign * integerParam[alias->nameID]);
+    }
+
+  /* negated boolean aliases get values of their own */
+  for (int i=0; i < mData->nAliasBoolean; i++)
+    if (!mData->booleanAlias[i].filterOutput) {
+      const DATA_BOOLEAN_ALIAS *alias = mData->booleanAlias + i;
+      if (alias->aliasType == 0) {
+        if (alias->negate) {
+          col_add_signal(writer, alias->info.name, alias->info.comment, NULL, 0, ++column);
+          writer->negatedBooleanIndex.push_back(alias->nameID);
+        } else if (booleanColumn[alias->nameID]) {
+          col_add_signal(writer, alias->info.name, alias->info.comment, NULL, 0, booleanColumn[alias->nameID]);
+        }
+      } else if (alias->aliasType == 1) {
+        if (alias->negate) {
+          col_add_signal(writer, alias->info.name, alias->info.comment, NULL, 1, ++param);
+          writer->negatedBooleanParameterIndex.push_back(alias->nameID);
+        } else if (booleanParam[alias->nameID]) {
+          col_add_signal(writer, alias->info.name, alias->info.comment, NULL, 1, booleanParam[alias->nameID]);
+        }
+      }
+    }
+
+  writer->ncols = column;
+  writer->params.assign(param, 0.0);
+  writer->chunkRows = COL_CHUNK_BUFFER_SIZE / writer->ncols;
+  if (writer->chunkRows < COL_MIN_CHUNK_ROWS) writer->chunkRows = COL_MIN_CHUNK_ROWS;
+  if (writer->chunkRows > COL_MAX_CHUNK_ROWS) writer->chunkRows = COL_MAX_CHUNK_ROWS;
+  writer->rows.resize(writer->chunkRows * writer->ncols);
+  writer->column.resize(writer->chunkRows);
+  writer->block.resize(col_block_size(writer->chunkRows));
+  writer->scratch.resize(col_block_size(writer->chunkRows));
+
+  header[0] = OMC_COL_ENDIAN_TAG;
+  header[1] = (uint32_t) writer->chunkRows;
+  col_write(writer, OMC_COL_MAGIC, 8);
+  col_write(writer, header, sizeof(header));
+
+  self->storage = writer;
+  rt_accumulate(SIM_TIMER_OUTPUT);
+}
+
+/* the parameter values are stored in the footer */
+void col_writeParameterData(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  col_writer *writer = (col_writer*) self->storage;
+  const SIMULATION_INFO *sInfo = data->simulationInfo;
+  size_t cur = 0;
+
+  for (size_t i=0; i < writer->realParameterIndex.size(); i++)
+    writer->params[cur++] = sInfo->realParameter[writer->realParameterIndex[i]];
+  for (size_t i=0; i < writer->integerParameterIndex.size(); i++)
+    writer->params[cur++] = (double) sInfo->integerParameter[writer->integerParameterIndex[i]];
+  for (size_t i=0; i < writer->booleanParameterIndex.size(); i++)
+    writer->params[cur++] = sInfo->booleanParameter[writer->booleanParameterIndex[i]];
+  for (size_t i=0; i < writer->negatedBooleanParameterIndex.size(); i++)
+    writer->params[cur++] = 1 - sInfo->booleanParameter[writer->negatedBooleanParameterIndex[i]];
+}
+
+void col_emit(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  col_writer *writer = (col_writer*) self->storage;
+  const MODEL_DATA *mData = data->modelData;
+  const SIMULATION_DATA *sData = data->localData[0];
+  double *row;
+  size_t cur = 0;
+  double cpuTimeValue = 0;
+
+  if (!self->writerThread) {
+    rt_tick(SIM_TIMER_OUTPUT);
+    rt_accumulate(SIM_TIMER_TOTAL);
+    cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
+    rt_tick(SIM_TIMER_TOTAL);
+  }
+
+  row = &writer->rows[writer->nrows * writer->ncols];
+  row[cur++] = sData->timeValue;
+  if (self->cpuTime)
+    row[cur++] = cpuTimeValue;
+  if (omc_flag[FLAG_SOLVER_STEPS])
+    row[cur++] = data->simulationInfo->solverSteps;
+  for (size_t i=0; i < writer->realIndex.size(); i++)
+    row[cur++] = sData->realVars[writer->realIndex[i]];
+  if (omc_flag[FLAG_IDAS])
+    for (int i=mData->nSensitivityParamVars; i < mData->nSensitivityVars; i++)
+      row[cur++] = data->simulationInfo->sensitivityMatrix[i];
+  for (size_t i=0; i < writer->integerIndex.size(); i++)
+    row[cur++] = (double) sData->integerVars[writer->integerIndex[i]];
+  for (size_t i=0; i < writer->booleanIndex.size(); i++)
+    row[cur++] = sData->booleanVars[writer->booleanIndex[i]];
+  for (size_t i=0; i < writer->negatedBooleanIndex.size(); i++)
+    row[cur++] = 1 - sData->booleanVars[writer->negatedBooleanIndex[i]];
+
+  if (++writer->nrows == writer->chunkRows)
+    col_flush(writer);
+  if (!self->writerThread)
+    rt_accumulate(SIM_TIMER_OUTPUT);
+}
+
+void col_free(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  col_writer *writer = (col_writer*) self->storage;
+  uint64_t footerOffset;
+
+  rt_tick(SIM_TIMER_OUTPUT);
+  col_flush(writer);
+
+  footerOffset = writer->pos;
+  col_write_uint32(writer, (uint32_t) writer->ncols);
+  col_write_uint32(writer, (uint32_t) writer->params.size());
+  col_write_uint32(writer, (uint32_t) writer->signals.size());
+  if (!writer->params.empty())
+    col_write(writer, &writer->params[0], writer->params.size() * sizeof(double));
+  for (size_t i=0; i < writer->signals.size(); i++) {
+    const col_signal *signal = &writer->signals[i];
+    col_write_string(writer, signal->name);
+    col_write_string(writer, signal->descr);
+    col_write(writer, &signal->isParam, sizeof(int32_t));
+    col_write(writer, &signal->index, sizeof(int32_t));
+  }
+  col_write_uint32(writer, (uint32_t) writer->chunks.size());
+  for (size_t i=0; i < writer->chunks.size(); i++) {
+    const col_chunk *chunk = &writer->chunks[i];
+    col_write_uint32(writer, chunk->nrows);
+    col_write(writer, &chunk->startTime, sizeof(double));
+    col_write(writer, &chunk->stopTime, sizeof(double));
+    for (size_t j=0; j < writer->ncols; j++) {
+      col_write(writer, &writer->offsets[i * writer->ncols + j], sizeof(uint64_t));
+      col_write(writer, &writer->sizes[i * writer->ncols + j], sizeof(uint32_t));
+    }
+  }
+  col_write(writer, &footerOffset, sizeof(uint64_t));
+  col_write(writer, OMC_COL_MAGIC, 8);
+
+  fclose(writer->fout);
+  delete writer;
+  self->storage = NULL;
+  rt_accumulate(SIM_TIMER_OUTPUT);
+}
+
+}
@@ -41,115 +41,155 @@
 #include "util/omc_error.h"
 #include "simulation_result_csv.h"
 #include "util/rtclock.h"
+#include "util/omc_dtoa.h"
 
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
 #include <time.h>
+#include <vector>
+
+typedef struct csv_alias {
+  int index;   /* -1 for time */
+  int negate;
+} csv_alias;
+
+/* the columns of a row, resolved once in omc_csv_init */
+typedef struct csv_writer {
+  FILE *fout;
+  std::vector<int> realIndex, integerIndex, booleanIndex;
+  std::vector<csv_alias> realAlias, integerAlias, booleanAlias;
+  std::vector<char> row;   /* large enough for one formatted row */
+} csv_writer;
 
 extern "C" {
 
 void omc_csv_emit(simulation_result *self, DATA *data, threadData_t *threadData)
 {
-  FILE *fout = (FILE*) self->storage;
-  const char* format = ",%.16g";
-  const char* formatint = ",%i";
-  const char* formatbool = ",%i";
-  const char* formatstring = ",\"%s\"";
-  int i;
-  modelica_real value = 0;
+  csv_writer *writer = (csv_writer*) self->storage;
+  const SIMULATION_DATA *sData = data->localData[0];
+  char *row = &writer->row[0];
+  char *cur = row;
+  modelica_real value;
   double cpuTimeValue = 0;
-  rt_tick(SIM_TIMER_OUTPUT);
+  size_t i;
+  if (!self->writerThread) {
+    rt_tick(SIM_TIMER_OUTPUT);
 
-  rt_accumulate(SIM_TIMER_TOTAL);
-  cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
-  rt_tick(SIM_TIMER_TOTAL);
+    rt_accumulate(SIM_TIMER_TOTAL);
+    cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
+    rt_tick(SIM_TIMER_TOTAL);
+  }
 
-  fprintf(fout, "%.16g", data->localData[0]->timeValue);
-  if(self->cpuTime)
-    fprintf(fout, format, cpuTimeValue);
-  for(i = 0; i < data->modelData->nVariablesReal; i++) if(!data->modelData->realVarsData[i].filterOutput)
-    fprintf(fout, format, (data->localData[0])->realVars[i]);
-  for(i = 0; i < data->modelData->nVariablesInteger; i++) if(!data->modelData->integerVarsData[i].filterOutput)
-    fprintf(fout, formatint, (data->localData[0])->integerVars[i]);
-  for(i = 0; i < data->modelData->nVariablesBoolean; i++) if(!data->modelData->booleanVarsData[i].filterOutput)
-    fprintf(fout, formatbool, (data->localData[0])->booleanVars[i]);
-  //for(i = 0; i < data->modelData->nVariablesString; i++) if(!data->modelData->stringVarsData[i].filterOutput)
-  //  fprintf(fout, formatstring, MMC_STRINGDATA((data->localData[0])->stringVars[i]));
-
-  for(i = 0; i < data->modelData->nAliasReal; i++) if(!data->modelData->realAlias[i].filterOutput && data->modelData->realAlias[i].aliasType != 1) {
-    if (data->modelData->realAlias[i].aliasType == 2) {
-      value = (data->localData[0])->timeValue;
-    } else {
-      value = (data->localData[0])->realVars[data->modelData->realAlias[i].nameID];
-    }
-    if (data->modelData->realAlias[i].negate) {
-      fprintf(fout, format, -value);
-    } else {
-      fprintf(fout, format, value);
-    }
+  cur += omc_dtoa(sData->timeValue, cur);
+  if(self->cpuTime) {
+    *cur++ = ',';
+    cur += omc_dtoa(cpuTimeValue, cur);
   }
-  for(i = 0; i < data->modelData->nAliasInteger; i++) if(!data->modelData->integerAlias[i].filterOutput && data->modelData->integerAlias[i].aliasType != 1) {
-    if (data->modelData->integerAlias[i].negate) {
-      fprintf(fout, formatint, -(data->localData[0])->integerVars[data->modelData->integerAlias[i].nameID]);
-    } else {
-      fprintf(fout, formatint, (data->localData[0])->integerVars[data->modelData->integerAlias[i].nameID]);
-    }
+  for(i = 0; i < writer->realIndex.size(); i++) {
+    *cur++ = ',';
+    cur += omc_dtoa(sData->realVars[writer->realIndex[i]], cur);
   }
-  for(i = 0; i < data->modelData->nAliasBoolean; i++) if(!data->modelData->booleanAlias[i].filterOutput && data->modelData->booleanAlias[i].aliasType != 1) {
-    if (data->modelData->booleanAlias[i].negate) {
-      fprintf(fout, formatbool, (data->localData[0])->booleanVars[data->modelData->booleanAlias[i].nameID]==1?0:1);
-    } else {
-      fprintf(fout, formatbool, (data->localData[0])->booleanVars[data->modelData->booleanAlias[i].nameID]);
-    }
+  for(i = 0; i < writer->integerIndex.size(); i++) {
+    *cur++ = ',';
+    cur += omc_ltoa(sData->integerVars[writer->integerIndex[i]], cur);
   }
-  //for(i = 0; i < data->modelData->nAliasString; i++) if(!data->modelData->stringAlias[i].filterOutput && data->modelData->stringAlias[i].aliasType != 1) {
-  //  /* there would no negation of a string happen */
-  //  fprintf(fout, formatstring, MMC_STRINGDATA((data->localData[0])->stringVars[data->modelData->stringAlias[i].nameID]));
-  //}
-  fprintf(fout, "\n");
-  rt_accumulate(SIM_TIMER_OUTPUT);
+  for(i = 0; i < writer->booleanIndex.size(); i++) {
+    *cur++ = ',';
+    *cur++ = sData->booleanVars[writer->booleanIndex[i]] ? '1' : '0';
+  }
+
+  for(i = 0; i < writer->realAlias.size(); i++) {
+    const csv_alias *alias = &writer->realAlias[i];
+    value = alias->index < 0 ? sData->timeValue : sData->realVars[alias->index];
+    *cur++ = ',';
+    cur += omc_dtoa(alias->negate ? -value : value, cur);
+  }
+  for(i = 0; i < writer->integerAlias.size(); i++) {
+    const csv_alias *alias = &writer->integerAlias[i];
+    *cur++ = ',';
+    cur += omc_ltoa(alias->negate ? -sData->integerVars[alias->index] : sData->integerVars[alias->index], cur);
+  }
+  for(i = 0; i < writer->booleanAlias.size(); i++) {
+    const csv_alias *alias = &writer->booleanAlias[i];
+    *cur++ = ',';
+    *cur++ = (sData->booleanVars[alias->index] == 1) != (alias->negate != 0) ? '1' : '0';
+  }
+  *cur++ = '\n';
+
+  fwrite(row, 1, cur - row, writer->fout);
+  if (!self->writerThread)
+    rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
 void omc_csv_init(simulation_result *self, DATA *data, threadData_t *threadData)
 {
   int i;
   const MODEL_DATA *mData = data->modelData;
+  csv_writer *writer;
+  csv_alias alias;
+  size_t nNumbers;
 
   const char* format = ",\"%s\"";
   FILE *fout = fopen(self->filename, "w");
 
   assertStreamPrint(threadData, 0!=fout, "Error, couldn't create output file: [%s] because of %s", self->filename, strerror(errno));
+  writer = new csv_writer;
+  writer->fout = fout;
 
   fprintf(fout, "\"time\"");
   if(self->cpuTime)
     fprintf(fout, format, "$cpuTime");
-  for(i = 0; i < mData->nVariablesReal; i++) if(!mData->realVarsData[i].filterOutput)
+  for(i = 0; i < mData->nVariablesReal; i++) if(!mData->realVarsData[i].filterOutput) {
     fprintf(fout, format, mData->realVarsData[i].info.name);
-  for(i = 0; i < mData->nVariablesInteger; i++) if(!mData->integerVarsData[i].filterOutput)
+    writer->realIndex.push_back(i);
+  }
+  for(i = 0; i < mData->nVariablesInteger; i++) if(!mData->integerVarsData[i].filterOutput) {
     fprintf(fout, format, mData->integerVarsData[i].info.name);
-  for(i = 0; i < mData->nVariablesBoolean; i++) if(!mData->booleanVarsData[i].filterOutput)
+    writer->integerIndex.push_back(i);
+  }
+  for(i = 0; i < mData->nVariablesBoolean; i++) if(!mData->booleanVarsData[i].filterOutput) {
     fprintf(fout, format, mData->booleanVarsData[i].info.name);
+    writer->booleanIndex.push_back(i);
+  }
   //for(i = 0; i < mData->nVariablesString; i++) if(!mData->stringVarsData[i].filterOutput)
   //  fprintf(fout, format, mData->stringVarsData[i].info.name);
 
-  for(i = 0; i < mData->nAliasReal; i++) if(!mData->realAlias[i].filterOutput && data->modelData->realAlias[i].aliasType != 1)
+  for(i = 0; i < mData->nAliasReal; i++) if(!mData->realAlias[i].filterOutput && data->modelData->realAlias[i].aliasType != 1) {
     fprintf(fout, format, mData->realAlias[i].info.name);
-  for(i = 0; i < mData->nAliasInteger; i++) if(!mData->integerAlias[i].filterOutput && data->modelData->integerAlias[i].aliasType != 1)
+    alias.index = mData->realAlias[i].aliasType == 2 ? -1 : mData->realAlias[i].nameID;
+    alias.negate = mData->realAlias[i].negate;
+    writer->realAlias.push_back(alias);
+  }
+  for(i = 0; i < mData->nAliasInteger; i++) if(!mData->integerAlias[i].filterOutput && data->modelData->integerAlias[i].aliasType != 1) {
     fprintf(fout, format, mData->integerAlias[i].info.name);
-  for(i = 0; i < mData->nAliasBoolean; i++) if(!mData->booleanAlias[i].filterOutput && data->modelData->booleanAlias[i].aliasType != 1)
+    alias.index = mData->integerAlias[i].nameID;
+    alias.negate = mData->integerAlias[i].negate;
+    writer->integerAlias.push_back(alias);
+  }
+  for(i = 0; i < mData->nAliasBoolean; i++) if(!mData->booleanAlias[i].filterOutput && data->modelData->booleanAlias[i].aliasType != 1) {
     fprintf(fout, format, mData->booleanAlias[i].info.name);
+    alias.index = mData->booleanAlias[i].nameID;
+    alias.negate = mData->booleanAlias[i].negate;
+    writer->booleanAlias.push_back(alias);
+  }
   //for(i = 0; i < mData->nAliasString; i++) if(!mData->stringAlias[i].filterOutput && data->modelData->stringAlias[i].aliasType != 1)
   //  fprintf(fout, format, mData->stringAlias[i].info.name);
   fprintf(fout, "\n");
-  self->storage = fout;
+
+  /* every number is preceded by a separator, booleans take two characters */
+  nNumbers = 2 + writer->realIndex.size() + writer->integerIndex.size() + writer->realAlias.size() + writer->integerAlias.size();
+  writer->row.resize(nNumbers * (OMC_DTOA_BUFFER_SIZE + 1) + 2 * (writer->booleanIndex.size() + writer->booleanAlias.size()) + 1);
+  self->storage = writer;
 }
 
 void omc_csv_free(simulation_result *self, DATA *data, threadData_t *threadData)
 {
-  FILE *fout = (FILE*) self->storage;
+  csv_writer *writer = (csv_writer*) self->storage;
   rt_tick(SIM_TIMER_OUTPUT);
-  fclose(fout);
+  fclose(writer->fout);
+  delete writer;
+  self->storage = NULL;
   rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
@@ -39,6 +39,7 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 #include <cstring>
 #include <cstdlib>
 #include <stdint.h>
@@ -55,10 +56,21 @@ typedef struct mat_data {
   size_t nSignals;
   size_t nEmits;
   size_t sync;
-  void* data_2;
+  void* data_2;      /* buffer of bufRows rows of data_2 */
+  size_t bufRows;
+  size_t nBuffered;  /* rows in data_2 not yet written to the file */
   MatVer4Type_t type;
+
+  /* emit plan: indices of the values that go into data_2, computed once in mat4_init4 */
+  std::vector<int> realIndex;
+  std::vector<int> integerIndex;
+  std::vector<int> booleanIndex;
+  std::vector<int> negatedBooleanIndex;
 } mat_data;
 
+/* approximate size of the buffer for rows of data_2 */
+#define MAT4_WRITE_BUFFER_SIZE (1<<20)
+
 static const char timeName[] = "time";
 static const char timeDesc[] = "Simulation time [s]";
 static const char cpuTimeName[] = "$cpuTime";
@@ -385,6 +397,24 @@ void mat4_init4(simulation_result *self, DATA *data, threadData_t *threadData)
   writeMatrix_matVer4(matData->pFile, "description", maxLengthDesc, matData->nSignals, description, MatVer4Type_CHAR);
   free(description);
   description = NULL;
+
+  /* emit plan */
+  for (int i=0; i < mData->nVariablesReal; i++)
+    if (!mData->realVarsData[i].filterOutput && !mData->realVarsData[i].time_unvarying)
+      matData->realIndex.push_back(i);
+
+  for (int i=0; i < mData->nVariablesInteger; i++)
+    if (!mData->integerVarsData[i].filterOutput && !mData->integerVarsData[i].time_unvarying)
+      matData->integerIndex.push_back(i);
+
+  for (int i=0; i < mData->nVariablesBoolean; i++)
+    if (!mData->booleanVarsData[i].filterOutput && !mData->booleanVarsData[i].time_unvarying)
+      matData->booleanIndex.push_back(i);
+
+  for (int i=0; i < mData->nAliasBoolean; i++)
+    if (!mData->booleanAlias[i].filterOutput && mData->booleanAlias[i].aliasType == 0 && mData->booleanAlias[i].negate)
+      matData->negatedBooleanIndex.push_back(mData->booleanAlias[i].nameID);
+
   rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
@@ -705,67 +735,101 @@ void mat4_writeParameterData4(simulation_result *self, DATA *data, threadData_t
   // Class Type: Double Precision Array
   //  Data Type: IEEE 754 double-precision
   matData->data2HdrPos = ftell(matData->pFile);
-  matData->data_2 = malloc(size * matData->nData2);
+  matData->bufRows = MAT4_WRITE_BUFFER_SIZE / (size * matData->nData2);
+  if (matData->bufRows < 1)
+    matData->bufRows = 1;
+  matData->nBuffered = 0;
+  matData->data_2 = malloc(size * matData->nData2 * matData->bufRows);
   writeMatrix_matVer4(matData->pFile, "data_2", matData->nData2, 0, NULL, matData->type);
   rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
-void mat4_emit4(simulation_result *self, DATA *data, threadData_t *threadData)
-{
-  mat_data *matData = (mat_data*) self->storage;
-  const SIMULATION_INFO *sInfo = data->simulationInfo;
-  const MODEL_DATA      *mData = data->modelData;
-
-  if (!matData->pFile)
-    return;
-
-  rt_tick(SIM_TIMER_OUTPUT);
-  rt_accumulate(SIM_TIMER_TOTAL);
-  double cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
-  rt_tick(SIM_TIMER_TOTAL);
+}
 
+/* gather one row of data_2 according to the emit plan */
+template <typename T>
+static void mat4_gatherRow(const mat_data *matData, const simulation_result *self, DATA *data, double cpuTimeValue, T *row)
+{
+  const MODEL_DATA *mData = data->modelData;
+  const modelica_real *realVars = data->localData[0]->realVars;
+  const modelica_integer *integerVars = data->localData[0]->integerVars;
+  const modelica_boolean *booleanVars = data->localData[0]->booleanVars;
   size_t cur = 0;
+
   /* time */
-  WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->timeValue);
+  row[cur++] = (T) data->localData[0]->timeValue;
 
   if (self->cpuTime)
-    WRITE_REAL_VALUE(matData->data_2, cur++, cpuTimeValue);
+    row[cur++] = (T) cpuTimeValue;
 
   if (omc_flag[FLAG_SOLVER_STEPS])
-    WRITE_REAL_VALUE(matData->data_2, cur++, data->simulationInfo->solverSteps);
+    row[cur++] = (T) data->simulationInfo->solverSteps;
 
-  for (int i=0; i < mData->nVariablesReal; i++)
-    if (!mData->realVarsData[i].filterOutput && !mData->realVarsData[i].time_unvarying)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->realVars[i]);
+  for (size_t i=0; i < matData->realIndex.size(); i++)
+    row[cur++] = (T) realVars[matData->realIndex[i]];
 
   if (omc_flag[FLAG_IDAS])
     for (int i=mData->nSensitivityParamVars; i < mData->nSensitivityVars; i++)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->simulationInfo->sensitivityMatrix[i]);
+      row[cur++] = (T) data->simulationInfo->sensitivityMatrix[i];
 
-  for (int i=0; i < mData->nVariablesInteger; i++)
-    if (!mData->integerVarsData[i].filterOutput && !mData->integerVarsData[i].time_unvarying)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->integerVars[i]);
+  for (size_t i=0; i < matData->integerIndex.size(); i++)
+    row[cur++] = (T) integerVars[matData->integerIndex[i]];
 
-  for (int i=0; i < mData->nVariablesBoolean; i++)
-    if (!mData->booleanVarsData[i].filterOutput && !mData->booleanVarsData[i].time_unvarying)
-      WRITE_REAL_VALUE(matData->data_2, cur++, data->localData[0]->booleanVars[i]);
+  for (size_t i=0; i < matData->booleanIndex.size(); i++)
+    row[cur++] = (T) booleanVars[matData->booleanIndex[i]];
 
-  for (int i=0; i < mData->nAliasBoolean; i++)
-    if (!mData->booleanAlias[i].filterOutput)
-      if (mData->booleanAlias[i].aliasType == 0)
-        if (mData->booleanAlias[i].negate)
-          WRITE_REAL_VALUE(matData->data_2, cur++, (1-data->localData[0]->booleanVars[mData->booleanAlias[i].nameID]));
+  for (size_t i=0; i < matData->negatedBooleanIndex.size(); i++)
+    row[cur++] = (T) (1-booleanVars[matData->negatedBooleanIndex[i]]);
+
+  assert(cur == matData->nData2);
+}
+
+extern "C" {
+
+/* write the buffered rows of data_2 to the file */
+static void mat4_flush4(mat_data *matData)
+{
+  if (matData->nBuffered > 0) {
+    fwrite(matData->data_2, sizeofMatVer4Type(matData->type), matData->nData2 * matData->nBuffered, matData->pFile);
+    matData->nBuffered = 0;
+  }
+}
 
-  fwrite(matData->data_2, sizeofMatVer4Type(matData->type), matData->nData2, matData->pFile);
+void mat4_emit4(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  mat_data *matData = (mat_data*) self->storage;
+
+  if (!matData->pFile)
+    return;
+
+  double cpuTimeValue = 0;
+  if (!self->writerThread)
+  {
+    rt_tick(SIM_TIMER_OUTPUT);
+    rt_accumulate(SIM_TIMER_TOTAL);
+    cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
+    rt_tick(SIM_TIMER_TOTAL);
+  }
+
+  if (matData->type == MatVer4Type_SINGLE)
+    mat4_gatherRow(matData, self, data, cpuTimeValue, (float*) matData->data_2 + matData->nBuffered * matData->nData2);
+  else
+    mat4_gatherRow(matData, self, data, cpuTimeValue, (double*) matData->data_2 + matData->nBuffered * matData->nData2);
+  matData->nBuffered++;
   matData->nEmits++;
 
+  if (matData->nBuffered == matData->bufRows)
+    mat4_flush4(matData);
+
   if (matData->sync > 0 && matData->nEmits > matData->sync)
   {
+    mat4_flush4(matData);
     updateHeader_matVer4(matData->pFile, matData->data2HdrPos, "data_2", matData->nData2, matData->nEmits, matData->type);
     matData->nEmits = 0;
   }
 
-  rt_accumulate(SIM_TIMER_OUTPUT);
+  if (!self->writerThread)
+    rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
 void mat4_free4(simulation_result *self, DATA *data, threadData_t *threadData)
@@ -775,10 +839,14 @@ void mat4_free4(simulation_result *self, DATA *data, threadData_t *threadData)
   rt_tick(SIM_TIMER_OUTPUT);
 
   if (!matData->pFile) {
+    delete matData;
+    self->storage = NULL;
     rt_accumulate(SIM_TIMER_OUTPUT);
     return;
   }
 
+  mat4_flush4(matData);
+
   if (matData->nEmits > 0) {
     updateHeader_matVer4(matData->pFile, matData->data2HdrPos, "data_2", matData->nData2, matData->nEmits, matData->type);
     matData->nEmits = 0;
@@ -791,6 +859,8 @@ void mat4_free4(simulation_result *self, DATA *data, threadData_t *threadData)
 
   fclose(matData->pFile);
   matData->pFile = NULL;
+  delete matData;
+  self->storage = NULL;
 
   rt_accumulate(SIM_TIMER_OUTPUT);
 }
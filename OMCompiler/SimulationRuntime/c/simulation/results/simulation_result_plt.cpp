@@ -83,7 +83,8 @@ static int calcDataSize(simulation_result *self,const MODEL_DATA *modelData)
 void plt_emit(simulation_result *self,DATA *data, threadData_t *threadData)
 {
   plt_data *pltData = (plt_data*) self->storage;
-  rt_tick(SIM_TIMER_OUTPUT);
+  if(!self->writerThread)
+    rt_tick(SIM_TIMER_OUTPUT);
   if(pltData->actualPoints < pltData->maxPoints) {
       add_result(self,data,pltData->simulationResultData,&pltData->actualPoints); /*used for non-interactive simulation */
   } else {
@@ -95,7 +96,8 @@ void plt_emit(simulation_result *self,DATA *data, threadData_t *threadData)
     }
     add_result(self,data,pltData->simulationResultData,&pltData->actualPoints);
   }
-  rt_accumulate(SIM_TIMER_OUTPUT);
+  if(!self->writerThread)
+    rt_accumulate(SIM_TIMER_OUTPUT);
 }
 
 /*
@@ -109,9 +111,11 @@ static void add_result(simulation_result *self,DATA *data,double *data_, long *a
   int i;
   double cpuTimeValue = 0;
 
-  rt_accumulate(SIM_TIMER_TOTAL);
-  cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
-  rt_tick(SIM_TIMER_TOTAL);
+  if(!self->writerThread) {
+    rt_accumulate(SIM_TIMER_TOTAL);
+    cpuTimeValue = rt_accumulated(SIM_TIMER_TOTAL);
+    rt_tick(SIM_TIMER_TOTAL);
+  }
 
   {
     data_[pltData->currentPos++] = simData->localData[0]->timeValue;
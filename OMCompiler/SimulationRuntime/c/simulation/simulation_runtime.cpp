@@ -73,6 +73,8 @@
 #include "simulation/results/simulation_result_mat4.h"
 #include "simulation/results/simulation_result_wall.h"
 #include "simulation/results/simulation_result_ia.h"
+#include "simulation/results/simulation_result_async.h"
+#include "simulation/results/simulation_result_col.h"
 #include "simulation/solver/solver_main.h"
 #include "simulation_info_json.h"
 #include "modelinfo.h"
@@ -99,6 +101,170 @@ using namespace std;
   static int isXMLTCP=0;
 #endif
 
+#if !defined(NO_INTERACTIVE_DEPENDENCY) && !defined(OMC_MINIMAL_RUNTIME) && !defined(OMC_NO_THREADS) && defined(__GNUC__)
+#define OMC_STATUS_THREAD
+#endif
+
+#ifndef NO_INTERACTIVE_DEPENDENCY
+/* minimum wall-clock time between two progress updates, see -portStatusInterval */
+static double statusInterval = 0.1;
+static const char *statusLastPhase = NULL;
+
+static void sendStatus(const char *phase, double completionPercent, double currentTime, double currentStepSize);
+
+#if defined(OMC_STATUS_THREAD)
+/* The status messages are sent from a separate thread, and the log messages
+ * from the simulation thread; this keeps them from interleaving on the socket.
+ */
+static pthread_mutex_t sim_communication_port_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_PORT()   pthread_mutex_lock(&sim_communication_port_mutex)
+#define UNLOCK_PORT() pthread_mutex_unlock(&sim_communication_port_mutex)
+
+#define STATUS_DIRTY 4
+
+typedef struct status_update {
+  const char *phase;        /* the phases are string literals */
+  double completionPercent;
+  double currentTime;
+  double currentStepSize;
+  unsigned long seq;
+} status_update;
+
+/*
+ * Progress publisher: the simulation thread overwrites the latest status in a
+ * triple buffer and the sender thread picks it up at most once per
+ * statusInterval. A buffer is handed over by exchanging its index with the
+ * one in middle, so neither side ever waits for the other. Only phase changes
+ * and the final status make the simulation thread wait until they are sent.
+ */
+static struct {
+  status_update slots[3];
+  int back;                 /* written by the simulation thread only */
+  int middle;               /* index of the latest status, | STATUS_DIRTY if not sent yet */
+  int front;                /* written by the sender thread only */
+  unsigned long published;  /* written by the simulation thread only */
+  unsigned long sent;       /* written by the sender thread only */
+  int running;
+  int stop;
+  int urgent;
+  pthread_mutex_t mutex;
+  pthread_cond_t wakeCond;
+  pthread_cond_t sentCond;
+  pthread_t thread;
+} statusPublisher;
+
+/* send the latest status, if it was not sent yet */
+static void statusPublisher_sendLatest()
+{
+  status_update *update;
+  if (!(__atomic_load_n(&statusPublisher.middle, __ATOMIC_ACQUIRE) & STATUS_DIRTY))
+    return;
+  statusPublisher.front = __atomic_exchange_n(&statusPublisher.middle, statusPublisher.front, __ATOMIC_ACQ_REL) & ~STATUS_DIRTY;
+  update = statusPublisher.slots + statusPublisher.front;
+  sendStatus(update->phase, update->completionPercent, update->currentTime, update->currentStepSize);
+  __atomic_store_n(&statusPublisher.sent, update->seq, __ATOMIC_RELEASE);
+}
+
+static void* statusPublisher_run(void *arg)
+{
+  struct timespec deadline;
+  long nsec;
+
+  pthread_mutex_lock(&statusPublisher.mutex);
+  while (!statusPublisher.stop) {
+    if (!statusPublisher.urgent) {
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      nsec = deadline.tv_nsec + (long)(statusInterval * 1e9);
+      deadline.tv_sec += nsec / 1000000000L;
+      deadline.tv_nsec = nsec % 1000000000L;
+      pthread_cond_timedwait(&statusPublisher.wakeCond, &statusPublisher.mutex, &deadline);
+    }
+    statusPublisher.urgent = 0;
+    pthread_mutex_unlock(&statusPublisher.mutex);
+
+    statusPublisher_sendLatest();
+
+    pthread_mutex_lock(&statusPublisher.mutex);
+    pthread_cond_broadcast(&statusPublisher.sentCond);
+  }
+  pthread_mutex_unlock(&statusPublisher.mutex);
+
+  /* the final status */
+  statusPublisher_sendLatest();
+  return NULL;
+}
+
+static void statusPublisher_start()
+{
+  memset(&statusPublisher, 0, sizeof(statusPublisher));
+  statusPublisher.back = 0;
+  statusPublisher.middle = 1;
+  statusPublisher.front = 2;
+  pthread_mutex_init(&statusPublisher.mutex, NULL);
+  pthread_cond_init(&statusPublisher.wakeCond, NULL);
+  pthread_cond_init(&statusPublisher.sentCond, NULL);
+  if (GC_pthread_create(&statusPublisher.thread, NULL, statusPublisher_run, NULL)) {
+    warningStreamPrint(LOG_STDOUT, 0, "Could not start the status thread, sending the simulation status synchronously");
+    return;
+  }
+  statusPublisher.running = 1;
+}
+
+static void statusPublisher_publish(const char *phase, double completionPercent, double currentTime, double currentStepSize, int urgent)
+{
+  status_update *update = statusPublisher.slots + statusPublisher.back;
+  update->phase = phase;
+  update->completionPercent = completionPercent;
+  update->currentTime = currentTime;
+  update->currentStepSize = currentStepSize;
+  update->seq = ++statusPublisher.published;
+  statusPublisher.back = __atomic_exchange_n(&statusPublisher.middle, statusPublisher.back | STATUS_DIRTY, __ATOMIC_ACQ_REL) & ~STATUS_DIRTY;
+
+  if (urgent) {
+    pthread_mutex_lock(&statusPublisher.mutex);
+    statusPublisher.urgent = 1;
+    pthread_cond_signal(&statusPublisher.wakeCond);
+    while (__atomic_load_n(&statusPublisher.sent, __ATOMIC_ACQUIRE) < statusPublisher.published)
+      pthread_cond_wait(&statusPublisher.sentCond, &statusPublisher.mutex);
+    pthread_mutex_unlock(&statusPublisher.mutex);
+  }
+}
+
+/* sends the pending status and stops the sender thread */
+static void statusPublisher_stop()
+{
+  if (!statusPublisher.running)
+    return;
+  pthread_mutex_lock(&statusPublisher.mutex);
+  statusPublisher.stop = 1;
+  pthread_cond_signal(&statusPublisher.wakeCond);
+  pthread_mutex_unlock(&statusPublisher.mutex);
+  GC_pthread_join(statusPublisher.thread, NULL);
+  statusPublisher.running = 0;
+  pthread_mutex_destroy(&statusPublisher.mutex);
+  pthread_cond_destroy(&statusPublisher.wakeCond);
+  pthread_cond_destroy(&statusPublisher.sentCond);
+}
+#else
+#define LOCK_PORT()
+#define UNLOCK_PORT()
+#endif
+
+static void sendStatus(const char *phase, double completionPercent, double currentTime, double currentStepSize)
+{
+  std::stringstream s;
+  if (isXMLTCP) {
+    s << "<status phase=\"" << phase << "\" currentStepSize=\"" << currentStepSize << "\" time=\"" << currentTime << "\" progress=\"" << (int)(completionPercent*10000) << "\" />" << std::endl;
+  } else {
+    s << (int)(completionPercent*10000) << " " << phase << endl;
+  }
+  std::string str(s.str());
+  LOCK_PORT();
+  sim_communication_port.send(str);
+  UNLOCK_PORT();
+}
+#endif
+
 extern "C" {
 
 int sim_noemit = 0;           /* Flag for not emitting data */
@@ -596,6 +762,12 @@ int initializeResultData(DATA* simData, threadData_t *threadData, int cpuTime)
     sim_result.emit = plt_emit;
     /* sim_result.writeParameterData = plt_writeParameterData; */
     sim_result.free = plt_free;
+  } else if(0 == strcmp("col", simData->simulationInfo->outputFormat)) {
+    sim_result.init = col_init;
+    sim_result.emit = col_emit;
+    sim_result.writeParameterData = col_writeParameterData;
+    sim_result.free = col_free;
+    resultFormatHasCheapAliasesAndParameters = 1;
   }
   //NEW interactive
   else if(0 == strcmp("ia", simData->simulationInfo->outputFormat)) {
@@ -610,6 +782,12 @@ int initializeResultData(DATA* simData, threadData_t *threadData, int cpuTime)
   }
   initializeOutputFilter(simData->modelData, simData->simulationInfo->variableFilter, resultFormatHasCheapAliasesAndParameters);
   sim_result.init(&sim_result, simData, threadData);
+#if !defined(OMC_MINIMAL_RUNTIME)
+  /* interactive output has to stay in step with the solver */
+  if (omc_flag[FLAG_ASYNC_OUTPUT] && !sim_noemit && 0 != strcmp("empty", simData->simulationInfo->outputFormat) && 0 != strcmp("ia", simData->simulationInfo->outputFormat)) {
+    async_result_start(&sim_result, simData, threadData, atol(omc_flagValue[FLAG_ASYNC_OUTPUT]));
+  }
+#endif
   infoStreamPrint(LOG_SOLVER, 0, "Allocated simulation result data storage for method '%s' and file='%s'", (char*) simData->simulationInfo->outputFormat, sim_result.filename);
   return 0;
 }
@@ -832,6 +1010,7 @@ int initRuntimeAndSimulation(int argc, char**argv, DATA *data, threadData_t *thr
   readFlag(&homBacktraceStrategy, HOM_BACK_STRAT_MAX, omc_flagValue[FLAG_HOMOTOPY_BACKTRACE_STRATEGY], "-homBacktraceStrategy", HOM_BACK_STRAT_NAME, HOM_BACK_STRAT_DESC);
   readFlag(&data->simulationInfo->newtonStrategy, NEWTON_MAX, omc_flagValue[FLAG_NEWTON_STRATEGY], "-newton", NEWTONSTRATEGY_NAME, NEWTONSTRATEGY_DESC);
   data->simulationInfo->nlsCsvInfomation = omc_flag[FLAG_NLS_INFO];
+  memory_pool_set_zero_atomic(!omc_flag[FLAG_NO_POOL_ZERO]);
   readFlag(&data->simulationInfo->nlsLinearSolver, NLS_LS_MAX, omc_flagValue[FLAG_NLS_LS], "-nlsLS", NLS_LS_METHOD, NLS_LS_METHOD_DESC);
 
   if(omc_flag[FLAG_HOMOTOPY_ADAPT_BEND]) {
@@ -955,6 +1134,15 @@ int initRuntimeAndSimulation(int argc, char**argv, DATA *data, threadData_t *thr
     sim_communication_port_open &= sim_communication_port.create();
     sim_communication_port_open &= sim_communication_port.connect("127.0.0.1", port);
 
+    if (omc_flag[FLAG_PORT_STATUS_INTERVAL]) {
+      statusInterval = atof(omc_flagValue[FLAG_PORT_STATUS_INTERVAL]);
+    }
+#if defined(OMC_STATUS_THREAD)
+    if (sim_communication_port_open && statusInterval > 0) {
+      statusPublisher_start();
+    }
+#endif
+
     if(0 != strcmp("ia", data->simulationInfo->outputFormat)) {
       communicateStatus("Starting", 0.0, data->simulationInfo->startTime, 0);
     }
@@ -996,7 +1184,9 @@ void communicateMsg(char id, unsigned int size, const char *data)
     memcpy(msg+0, &id, sizeof(char));
     memcpy(msg+sizeof(char), &size, sizeof(unsigned int));
     memcpy(msg+sizeof(char)+sizeof(unsigned int), data, size);
+    LOCK_PORT();
     sim_communication_port.sendBytes(msg, msgSize);
+    UNLOCK_PORT();
     delete[] msg;
   }
 #endif
@@ -1039,6 +1229,9 @@ int _main_SimulationRuntime(int argc, char**argv, DATA *data, threadData_t *thre
 #ifndef NO_INTERACTIVE_DEPENDENCY
   if(sim_communication_port_open)
   {
+#if defined(OMC_STATUS_THREAD)
+    statusPublisher_stop();
+#endif
     sim_communication_port.close();
   }
 #endif
@@ -1090,7 +1283,9 @@ static void printEscapedXMLTCP(std::stringstream *s, const char *msg)
 static inline void sendXMLTCPIfClosed()
 {
   if (numOpenTags==0) {
+    LOCK_PORT();
     sim_communication_port.send(xmlTcpStream.str());
+    UNLOCK_PORT();
     xmlTcpStream.str("");
   }
 }
@@ -1205,19 +1400,32 @@ void setStreamPrintXML(int isXML)
   }
 }
 
+/* Sends the simulation status to the port, at most once per -portStatusInterval.
+ * The updates in between are dropped, but a phase change or the final status
+ * is always sent.
+ */
 void communicateStatus(const char *phase, double completionPercent /*0.0 to 1.0*/, double currentTime, double currentStepSize)
 {
 #ifndef NO_INTERACTIVE_DEPENDENCY
-  if (sim_communication_port_open && isXMLTCP) {
-    std::stringstream s;
-    s << "<status phase=\"" << phase << "\" currentStepSize=\"" << currentStepSize << "\" time=\"" << currentTime << "\" progress=\"" << (int)(completionPercent*10000) << "\" />" << std::endl;
-    std::string str(s.str());
-    sim_communication_port.send(str);
-  } else if (sim_communication_port_open) {
-    std::stringstream s;
-    s << (int)(completionPercent*10000) << " " << phase << endl;
-    std::string str(s.str());
-    sim_communication_port.send(str);
+  static rtclock_t lastSent;
+  int urgent;
+
+  if (!sim_communication_port_open)
+    return;
+
+  urgent = !statusLastPhase || strcmp(phase, statusLastPhase) || completionPercent >= 1.0;
+  statusLastPhase = phase;
+
+#if defined(OMC_STATUS_THREAD)
+  if (statusPublisher.running) {
+    statusPublisher_publish(phase, completionPercent, currentTime, currentStepSize, urgent);
+    return;
+  }
+#endif
+
+  if (urgent || rt_ext_tp_tock(&lastSent) >= statusInterval) {
+    sendStatus(phase, completionPercent, currentTime, currentStepSize);
+    rt_ext_tp_tick(&lastSent);
   }
 #endif
 }
@@ -161,6 +161,10 @@ int dassl_initial(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo,
   dasslData->newdelta = (double*) malloc(N*sizeof(double));
   dasslData->stateDer = (double*) calloc(N, sizeof(double));
   dasslData->states = (double*) malloc(N*sizeof(double));
+  dasslData->jacobianColors.nColors = 0;
+  dasslData->jacobianColors.colorStart = NULL;
+  dasslData->jacobianColors.columns = NULL;
+  dasslData->jacobianThreads = NULL;
 
   data->simulationInfo->currentContext = CONTEXT_ALGEBRAIC;
 
@@ -317,6 +321,11 @@ int dassl_initial(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo,
       infoStreamPrint(LOG_SIMULATION, 0, "columns: %d rows: %d", jac->sizeCols, jac->sizeRows);
       infoStreamPrint(LOG_SIMULATION, 0, "NNZ:  %d colors: %d", jac->sparsePattern.numberOfNoneZeros, jac->sparsePattern.maxColors);
       messageClose(LOG_SIMULATION);
+      initJacobianColors(&dasslData->jacobianColors, &jac->sparsePattern, jac->sizeCols);
+      if (dasslData->dasslJacobian == COLOREDSYMJAC && omc_flag[FLAG_JACOBIAN_THREADS])
+      {
+        dasslData->jacobianThreads = initJacobianThreads(data, threadData, jac, atoi(omc_flagValue[FLAG_JACOBIAN_THREADS]));
+      }
     }
   }
   /* default use a user sub-routine for JAC */
@@ -404,6 +413,8 @@ int dassl_deinitial(DASSL_DATA *dasslData)
   free(dasslData->newdelta);
   free(dasslData->states);
   free(dasslData->stateDer);
+  freeJacobianColors(&dasslData->jacobianColors);
+  freeJacobianThreads(dasslData->jacobianThreads);
 
   free(dasslData);
 
@@ -858,6 +869,24 @@ int function_ZeroCrossingsDASSL(int *neqm, double *t, double *y, double *yp,
   return 0;
 }
 
+/* \fn storeSymColoredColumn(void *userData, unsigned int column, const ANALYTIC_JACOBIAN *jacobian)
+ *
+ * Copies one column of the symbolic jacobian into the dense dassl matrix.
+ * It's called concurrently for different columns if the colors are
+ * evaluated in parallel.
+ */
+static void storeSymColoredColumn(void *userData, unsigned int column, const ANALYTIC_JACOBIAN *jacobian)
+{
+  double *matrixA = (double*) userData;
+  unsigned int ii, l;
+
+  for(ii = jacobian->sparsePattern.leadindex[column]; ii < jacobian->sparsePattern.leadindex[column+1]; ii++)
+  {
+    l = jacobian->sparsePattern.index[ii];
+    matrixA[column*jacobian->sizeRows + l] = jacobian->resultVars[l];
+  }
+}
+
 /* \fn jacA_symColored(double *t, double *y, double *yprime, double *deltaD, double *pd, double *cj, double *h, double *wt,
    double *rpar, int* ipar)
  *
@@ -874,40 +903,12 @@ int jacA_symColored(double *t, double *y, double *yprime, double *delta, double
   const int index = data->callback->INDEX_JAC_A;
   ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[index]);
 
-  unsigned int i,j,l,k,ii;
-
   /* set symbolical jacobian to reuse the matrix A and the factorization
    * in the Linear loops of  functionJacA_column */
   setContext(data, t, CONTEXT_SYM_JACOBIAN);
 
-  for(i=0; i < jacobian->sparsePattern.maxColors; i++)
-  {
-    for(ii=0; ii < jacobian->sizeCols; ii++)
-      if(jacobian->sparsePattern.colorCols[ii]-1 == i)
-        jacobian->seedVars[ii] = 1;
-
-    data->callback->functionJacA_column(data, threadData, jacobian, NULL);
-
-    increaseJacContext(data);
-
-    for(j = 0; j < jacobian->sizeCols; j++)
-    {
-      if(jacobian->seedVars[j] == 1)
-      {
-        ii = jacobian->sparsePattern.leadindex[j];
-        while(ii < jacobian->sparsePattern.leadindex[j+1])
-        {
-          l  = jacobian->sparsePattern.index[ii];
-          k  = j*jacobian->sizeRows + l;
-          matrixA[k] = jacobian->resultVars[l];
-          ii++;
-        };
-      }
-    }
-    for(ii=0; ii < jacobian->sizeCols; ii++)
-      if(jacobian->sparsePattern.colorCols[ii]-1 == i) jacobian->seedVars[ii] = 0;
-
-  }
+  evalJacobianColors(data, threadData, jacobian, &dasslData->jacobianColors, dasslData->jacobianThreads,
+                     data->callback->functionJacA_column, storeSymColoredColumn, matrixA);
 
   TRACE_POP
   return 0;
@@ -1036,47 +1037,44 @@ int jacA_numColored(double *t, double *y, double *yprime, double *delta, double
   double* ysave = dasslData->ysave;
   double* ypsave = dasslData->ypsave;
 
-  unsigned int i,j,l,k,ii;
+  const JACOBIAN_COLORS* colors = &dasslData->jacobianColors;
+  unsigned int i,j,l,k,ii,c;
 
   /* set context for the start values extrapolation of non-linear algebraic loops */
   setContext(data, t, CONTEXT_JACOBIAN);
 
-  for(i = 0; i < jacobian->sparsePattern.maxColors; i++)
+  for(i = 0; i < colors->nColors; i++)
   {
-    for(ii=0; ii < jacobian->sizeCols; ii++)
+    for(c = colors->colorStart[i]; c < colors->colorStart[i+1]; c++)
     {
-      if(jacobian->sparsePattern.colorCols[ii]-1 == i)
-      {
-        delta_hhh = *h * yprime[ii];
-        delta_hh[ii] = delta_h * fmax(fmax(fabs(y[ii]),fabs(delta_hhh)),fabs(1./wt[ii]));
-        delta_hh[ii] = (delta_hhh >= 0 ? delta_hh[ii] : -delta_hh[ii]);
-        delta_hh[ii] = y[ii] + delta_hh[ii] - y[ii];
+      ii = colors->columns[c];
+      delta_hhh = *h * yprime[ii];
+      delta_hh[ii] = delta_h * fmax(fmax(fabs(y[ii]),fabs(delta_hhh)),fabs(1./wt[ii]));
+      delta_hh[ii] = (delta_hhh >= 0 ? delta_hh[ii] : -delta_hh[ii]);
+      delta_hh[ii] = y[ii] + delta_hh[ii] - y[ii];
 
-        ysave[ii] = y[ii];
-        y[ii] += delta_hh[ii];
+      ysave[ii] = y[ii];
+      y[ii] += delta_hh[ii];
 
-        delta_hh[ii] = 1. / delta_hh[ii];
-      }
+      delta_hh[ii] = 1. / delta_hh[ii];
     }
 
     (*dasslData->residualFunction)(t, y, yprime, cj, dasslData->newdelta, &ires, rpar, ipar);
 
     increaseJacContext(data);
 
-    for(ii = 0; ii < jacobian->sizeCols; ii++)
+    for(c = colors->colorStart[i]; c < colors->colorStart[i+1]; c++)
     {
-      if(jacobian->sparsePattern.colorCols[ii]-1 == i)
+      ii = colors->columns[c];
+      j = jacobian->sparsePattern.leadindex[ii];
+      while(j < jacobian->sparsePattern.leadindex[ii+1])
       {
-        j = jacobian->sparsePattern.leadindex[ii];
-        while(j < jacobian->sparsePattern.leadindex[ii+1])
-        {
-          l  =  jacobian->sparsePattern.index[j];
-          k  = l + ii*jacobian->sizeRows;
-          matrixA[k] = (dasslData->newdelta[l] - delta[l]) * delta_hh[ii];
-          j++;
-        };
-        y[ii] = ysave[ii];
-      }
+        l  =  jacobian->sparsePattern.index[j];
+        k  = l + ii*jacobian->sizeRows;
+        matrixA[k] = (dasslData->newdelta[l] - delta[l]) * delta_hh[ii];
+        j++;
+      };
+      y[ii] = ysave[ii];
     }
   }
 
@@ -32,6 +32,7 @@
 #define DASSL_H
 
 #include "solver_main.h"
+#include "jacobianColors.h"
 
 #define DDASKR _daskr_ddaskr_
 
@@ -72,6 +73,8 @@ typedef struct DASSL_DATA{
   double *newdelta;
   double *stateDer;
   double *states;
+  JACOBIAN_COLORS jacobianColors;     /* columns of the colored jacobian grouped by color */
+  JACOBIAN_THREADS *jacobianThreads;  /* workers for the colors of the symbolic jacobian, or NULL */
 
   /* function pointer of provided functions */
   int (*residualFunction)(double *t, double *x, double *xprime, double *cj, double *delta, int *ires, double *rpar, int* ipar);
@@ -35,15 +35,98 @@
 
 #include "delay.h"
 #include "../../util/omc_error.h"
-#include "../../util/ringbuffer.h"
 #include "../../openmodelica.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
-/* the delayStructure looks like a matrix (rows = expressionNumber+currentColumnIndex, columns={time, value}) */
+/* Each delay expression stores its accepted (time, value) pairs in a DELAY_LINE:
+ * two contiguous arrays, sorted by time. New pairs are appended at the end and
+ * old ones are dropped at the front by moving 'start'; the arrays are only
+ * compacted or grown when the end is reached, so both are amortized O(1).
+ * Lookups start at the position of the previous one, since time is monotonic.
+ */
+
+void allocDelayLine(DELAY_LINE *line, long capacity)
+{
+  line->time = (double*) malloc(capacity * sizeof(double));
+  line->value = (double*) malloc(capacity * sizeof(double));
+  assertStreamPrint(NULL, 0 != line->time && 0 != line->value, "out of memory");
+  line->start = 0;
+  line->length = 0;
+  line->capacity = capacity;
+  line->cursor = 0;
+}
+
+void freeDelayLine(DELAY_LINE *line)
+{
+  free(line->time);
+  free(line->value);
+  line->time = NULL;
+  line->value = NULL;
+  line->start = line->length = line->capacity = line->cursor = 0;
+}
+
+/* empties a delay line and makes room for length entries at the front of
+ * its arrays, which the caller fills in, e.g. when a saved state is restored */
+void resetDelayLine(DELAY_LINE *line, long length)
+{
+  if(length > line->capacity)
+  {
+    long capacity = line->capacity > 0 ? line->capacity : 1024;
+    while(capacity < length)
+      capacity *= 2;
+    freeDelayLine(line);
+    allocDelayLine(line, capacity);
+  }
+  line->start = 0;
+  line->length = length;
+  line->cursor = 0;
+}
+
+static void appendDelayLine(DELAY_LINE *line, double time, double value)
+{
+  /* keep the entries sorted if time went back */
+  while(line->length > 0 && line->time[line->start + line->length - 1] > time)
+    line->length--;
+
+  if(line->start + line->length == line->capacity)
+  {
+    if(line->start >= line->capacity / 2)
+    {
+      /* at least half of the arrays are dropped entries */
+      memmove(line->time, line->time + line->start, line->length * sizeof(double));
+      memmove(line->value, line->value + line->start, line->length * sizeof(double));
+    }
+    else
+    {
+      double *newTime = (double*) malloc(2 * line->capacity * sizeof(double));
+      double *newValue = (double*) malloc(2 * line->capacity * sizeof(double));
+      assertStreamPrint(NULL, 0 != newTime && 0 != newValue, "out of memory");
+      memcpy(newTime, line->time + line->start, line->length * sizeof(double));
+      memcpy(newValue, line->value + line->start, line->length * sizeof(double));
+      free(line->time);
+      free(line->value);
+      line->time = newTime;
+      line->value = newValue;
+      line->capacity *= 2;
+    }
+    line->start = 0;
+  }
+
+  line->time[line->start + line->length] = time;
+  line->value[line->start + line->length] = value;
+  line->length++;
+}
 
+static void dropFirstDelayLine(DELAY_LINE *line, long n)
+{
+  line->start += n;
+  line->length -= n;
+  line->cursor = line->cursor > n ? line->cursor - n : 0;
+}
 
 void initDelay(DATA* data, double startTime)
 {
@@ -52,72 +135,102 @@ void initDelay(DATA* data, double startTime)
 }
 
 /*
- * Find row with greatest time that is smaller than or equal to 'time'
+ * Find row with greatest time that is smaller than or equal to 'time',
+ * 0 if there is none. The search starts at row 'hint'.
  * Conditions:
- *  the buffer in 'delayStruct' is not empty
- *  'time' is smaller than the last entry in 'delayStruct'
+ *  the buffer in 'line' is not empty
  */
-static int findTime(double time, RINGBUFFER *delayStruct)
+static long findTime(double time, DELAY_LINE *line, long hint)
 {
-  int start = 0;
-  int end = ringBufferLength(delayStruct);
-  double t;
+  const double *t = line->time + line->start;
+  long n = line->length;
+  long lo, hi;
 
+  if(hint >= n)
+    hint = n - 1;
+  if(hint < 0)
+    hint = 0;
 
-  infoStreamPrint(LOG_EVENTS_V, 0, "findTime %e", time);
-  do
+  if(t[hint] <= time)
+  {
+    /* usually the result is the hint or one of the next rows */
+    if(hint + 1 == n || t[hint + 1] > time)
+      return hint;
+    if(hint + 2 == n || t[hint + 2] > time)
+      return hint + 1;
+    lo = hint + 2;
+    hi = n;
+  }
+  else
   {
-    int i = (start + end) / 2;
-    t = ((TIME_AND_VALUE*)getRingData(delayStruct, i))->t;
-    infoStreamPrint(LOG_EVENTS_V, 0, "time(%d, %d)[%d] = %e", start, end, i, t);
-    if(t > time)
-      end = i;
+    if(hint == 0 || t[hint - 1] <= time)
+      return hint == 0 ? 0 : hint - 1;
+    lo = 0;
+    hi = hint - 1;
+  }
+
+  /* t[lo] <= time (unless lo == 0) and t[hi] > time (unless hi == n) */
+  while(hi - lo > 1)
+  {
+    long i = (lo + hi) / 2;
+    if(t[i] > time)
+      hi = i;
     else
-      start = i;
-  }while(t != time && end > start + 1);
-  infoStreamPrint(LOG_EVENTS_V, 0, "return time[%d, %d] = %e", start, end, t);
-  return (start);
+      lo = i;
+  }
+  if(ACTIVE_STREAM(LOG_EVENTS_V))
+    infoStreamPrint(LOG_EVENTS_V, 0, "findTime %e: time[%ld] = %e", time, lo, t[lo]);
+  return lo;
 }
 
 void storeDelayedExpression(DATA* data, threadData_t *threadData, int exprNumber, double exprValue, double time, double delayTime, double delayMax)
 {
-  int i;
-  TIME_AND_VALUE tpl;
+  DELAY_LINE *line;
+  long i;
 
   /* Allocate more space for expressions */
   assertStreamPrint(threadData, exprNumber < data->modelData->nDelayExpressions, "storeDelayedExpression: invalid expression number %d", exprNumber);
   assertStreamPrint(threadData, 0 <= exprNumber, "storeDelayedExpression: invalid expression number %d", exprNumber);
   assertStreamPrint(threadData, data->simulationInfo->tStart <= time, "storeDelayedExpression: time is smaller than starting time. Value ignored");
 
-  tpl.t = time;
-  tpl.value = exprValue;
-  appendRingData(data->simulationInfo->delayStructure[exprNumber], &tpl);
-  infoStreamPrint(LOG_EVENTS_V, 0, "storeDelayed[%d] %g:%g position=%d", exprNumber, time, exprValue,ringBufferLength(data->simulationInfo->delayStructure[exprNumber]));
+  line = &data->simulationInfo->delayStructure[exprNumber];
+  appendDelayLine(line, time, exprValue);
+  if(ACTIVE_STREAM(LOG_EVENTS_V))
+    infoStreamPrint(LOG_EVENTS_V, 0, "storeDelayed[%d] %g:%g position=%ld", exprNumber, time, exprValue, line->length);
 
-  /* dequeue not longer needed values */
-  i = findTime(time-delayMax+DBL_EPSILON,data->simulationInfo->delayStructure[exprNumber]);
-  if(i > 0){
-    dequeueNFirstRingDatas(data->simulationInfo->delayStructure[exprNumber], i-1);
-    infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: dequeueNFirstRingDatas[%d] %g = %g", i, time-delayMax+DBL_EPSILON, delayTime);
+  /* dequeue not longer needed values; the boundary is always close to the front */
+  i = findTime(time-delayMax+DBL_EPSILON, line, 0);
+  if(i > 1){
+    dropFirstDelayLine(line, i-1);
+    if(ACTIVE_STREAM(LOG_EVENTS_V))
+      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: dequeueNFirstRingDatas[%ld] %g = %g", i, time-delayMax+DBL_EPSILON, delayTime);
   }
 }
 
 
 double delayImpl(DATA* data, threadData_t *threadData, int exprNumber, double exprValue, double time, double delayTime, double delayMax)
 {
-  RINGBUFFER* delayStruct = data->simulationInfo->delayStructure[exprNumber];
-  int length = ringBufferLength(delayStruct);
+  DELAY_LINE* line;
+  const double *times, *values;
+  long length;
 
-  infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: exprNumber = %d, exprValue = %g, time = %g, delayTime = %g", exprNumber, exprValue, time, delayTime);
+  if(ACTIVE_STREAM(LOG_EVENTS_V))
+    infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: exprNumber = %d, exprValue = %g, time = %g, delayTime = %g", exprNumber, exprValue, time, delayTime);
 
   /* Check for errors */
 
   assertStreamPrint(threadData, 0 <= exprNumber, "invalid exprNumber = %d", exprNumber);
   assertStreamPrint(threadData, exprNumber < data->modelData->nDelayExpressions, "invalid exprNumber = %d", exprNumber);
 
+  line = &data->simulationInfo->delayStructure[exprNumber];
+  length = line->length;
+  times = line->time + line->start;
+  values = line->value + line->start;
+
   if(time <= data->simulationInfo->tStart)
   {
-    infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Entered at time < starting time: %g.", exprValue);
+    if(ACTIVE_STREAM(LOG_EVENTS_V))
+      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Entered at time < starting time: %g.", exprValue);
     return (exprValue);
   }
 
@@ -145,8 +258,9 @@ double delayImpl(DATA* data, threadData_t *threadData, int exprNumber, double ex
    */
   if(time <= data->simulationInfo->tStart + delayTime)
   {
-    double res = ((TIME_AND_VALUE*)getRingData(delayStruct, 0))->value;
-    infoStreamPrint(LOG_EVENTS_V, 0, "findTime: time <= tStart + delayTime: [%d] = %g",exprNumber, res);
+    double res = values[0];
+    if(ACTIVE_STREAM(LOG_EVENTS_V))
+      infoStreamPrint(LOG_EVENTS_V, 0, "findTime: time <= tStart + delayTime: [%d] = %g",exprNumber, res);
     return res;
   }
   else
@@ -154,44 +268,50 @@ double delayImpl(DATA* data, threadData_t *threadData, int exprNumber, double ex
     /* return expr(time-delayTime) */
     double timeStamp = time - delayTime;
     double time0, time1, value0, value1;
-    int i;
+    long i;
 
     assertStreamPrint(threadData, 0.0 <= delayTime, "Negative delay requested: delayTime = %g", delayTime);
 
     /* find the row for the lower limit */
-    if(timeStamp > ((TIME_AND_VALUE*)getRingData(delayStruct, length - 1))->t)
+    if(timeStamp > times[length - 1])
     {
-      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: find the row  %g = %g", timeStamp, ((TIME_AND_VALUE*)getRingData(delayStruct, length - 1))->t);
       /* delay between the last accepted time step and the current time */
-      time0 = ((TIME_AND_VALUE*)getRingData(delayStruct, length - 1))->t;
-      value0 = ((TIME_AND_VALUE*)getRingData(delayStruct, length - 1))->value;
+      time0 = times[length - 1];
+      value0 = values[length - 1];
       time1 = time;
       value1 = exprValue;
-      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: times %g and %g", time0, time1);
-      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: values %g and  %g", value0, value1);
+      if(ACTIVE_STREAM(LOG_EVENTS_V))
+      {
+        infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: find the row  %g = %g", timeStamp, time0);
+        infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: times %g and %g", time0, time1);
+        infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: values %g and  %g", value0, value1);
+      }
     }
     else
     {
-      i = findTime(timeStamp, delayStruct);
-      assertStreamPrint(threadData, i < length, "%d = i < length = %d", i, length);
-      time0 = ((TIME_AND_VALUE*)getRingData(delayStruct, i))->t;
-      value0 = ((TIME_AND_VALUE*)getRingData(delayStruct, i))->value;
+      i = findTime(timeStamp, line, line->cursor);
+      line->cursor = i;
+      assertStreamPrint(threadData, i < length, "%ld = i < length = %ld", i, length);
+      time0 = times[i];
+      value0 = values[i];
 
       /* was it the last value? */
       if(i+1 == length)
       {
         return value0;
       }
-      time1 = ((TIME_AND_VALUE*)getRingData(delayStruct, i+1))->t;
-      value1 = ((TIME_AND_VALUE*)getRingData(delayStruct, i+1))->value;
+      time1 = times[i+1];
+      value1 = values[i+1];
     }
     /* was it an exact match?*/
     if(time0 == timeStamp){
-      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Exact match at %g = %g", timeStamp, value0);
+      if(ACTIVE_STREAM(LOG_EVENTS_V))
+        infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Exact match at %g = %g", timeStamp, value0);
 
       return value0;
     } else if(time1 == timeStamp) {
-      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Exact match at %g = %g", timeStamp, value1);
+      if(ACTIVE_STREAM(LOG_EVENTS_V))
+        infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Exact match at %g = %g", timeStamp, value1);
 
       return value1;
     } else {
@@ -200,8 +320,11 @@ double delayImpl(DATA* data, threadData_t *threadData, int exprNumber, double ex
       double dt0 = time1 - timeStamp;
       double dt1 = timeStamp - time0;
       double retVal = (value0 * dt0 + value1 * dt1) / timedif;
-      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Linear interpolation of %g between %g and %g", timeStamp, time0, time1);
-      infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Linear interpolation of %g value: %g and %g = %g", timeStamp, value0, value1, retVal);
+      if(ACTIVE_STREAM(LOG_EVENTS_V))
+      {
+        infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Linear interpolation of %g between %g and %g", timeStamp, time0, time1);
+        infoStreamPrint(LOG_EVENTS_V, 0, "delayImpl: Linear interpolation of %g value: %g and %g = %g", timeStamp, value0, value1, retVal);
+      }
       return retVal;
     }
   }
@@ -53,6 +53,9 @@ typedef struct EXPRESSION_DELAY_BUFFER
   extern "C" {
 #endif
 
+  void allocDelayLine(DELAY_LINE *line, long capacity);
+  void freeDelayLine(DELAY_LINE *line);
+  void resetDelayLine(DELAY_LINE *line, long length);
   void initDelay(DATA* data, double startTime);
   double delayImpl(DATA* data, threadData_t *threadData, int exprNumber, double exprValue, double t, double delayTime, double maxDelay);
   void storeDelayedExpression(DATA* data, threadData_t *threadData, int exprNumber, double exprValue, double t, double delayTime, double delayMax);
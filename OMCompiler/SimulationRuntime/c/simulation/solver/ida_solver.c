@@ -466,6 +466,27 @@ ida_solver_initial(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo
     }
 
   }
+
+  /* group the columns of the sparse pattern by color */
+  idaData->jacobianColors.nColors = 0;
+  idaData->jacobianColors.colorStart = NULL;
+  idaData->jacobianColors.columns = NULL;
+  idaData->jacobianThreads = NULL;
+  if (idaData->daeMode)
+  {
+    initJacobianColors(&idaData->jacobianColors, data->simulationInfo->daeModeData->sparsePattern, idaData->N);
+  }
+  else if (idaData->jacobianMethod == COLOREDNUMJAC ||
+           idaData->jacobianMethod == COLOREDSYMJAC ||
+           idaData->jacobianMethod == SYMJAC)
+  {
+    ANALYTIC_JACOBIAN* jac = &data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A];
+    initJacobianColors(&idaData->jacobianColors, &jac->sparsePattern, jac->sizeCols);
+    if (idaData->jacobianMethod != COLOREDNUMJAC && omc_flag[FLAG_JACOBIAN_THREADS])
+    {
+      idaData->jacobianThreads = initJacobianThreads(data, threadData, jac, atoi(omc_flagValue[FLAG_JACOBIAN_THREADS]));
+    }
+  }
   /* set up the appropriate function pointer */
   if (idaData->linearSolverMethod == IDA_LS_KLU)
   {
@@ -678,6 +699,8 @@ ida_solver_deinitial(IDA_SOLVER *idaData){
   free(idaData->ysave);
   free(idaData->ypsave);
   free(idaData->delta_hh);
+  freeJacobianColors(&idaData->jacobianColors);
+  freeJacobianThreads(idaData->jacobianThreads);
   if (!idaData->daeMode && idaData->linearSolverMethod == IDA_LS_KLU){
     DestroySparseMat(idaData->tmpJac);
   }
@@ -1364,9 +1387,10 @@ int jacColoredNumericalDense(double tt, N_Vector yy, N_Vector yp, N_Vector rr, D
   double *ysave = idaData->ysave;
   double *ypsave = idaData->ypsave;
 
+  const JACOBIAN_COLORS* colors = &idaData->jacobianColors;
   double delta_h = numericalDifferentiationDeltaXsolver;
   double delta_hhh;
-  long int i,j,l,ii;
+  long int i,j,l,ii,c;
 
   double currentStep;
 
@@ -1390,48 +1414,44 @@ int jacColoredNumericalDense(double tt, N_Vector yy, N_Vector yp, N_Vector rr, D
 
   setContext(data, &tt, CONTEXT_JACOBIAN);
 
-  for(i = 0; i < sparsePattern->maxColors; i++)
+  for(i = 0; i < colors->nColors; i++)
   {
-    for(ii=0; ii < idaData->N; ii++)
+    for(c = colors->colorStart[i]; c < colors->colorStart[i+1]; c++)
     {
-      if(sparsePattern->colorCols[ii]-1 == i)
-      {
-        delta_hhh = currentStep * yprime[ii];
-        delta_hh[ii] = delta_h * fmax(fmax(fabs(states[ii]),fabs(delta_hhh)),fabs(1./errwgt[ii]));
-        delta_hh[ii] = (delta_hhh >= 0 ? delta_hh[ii] : -delta_hh[ii]);
-        delta_hh[ii] = (states[ii] + delta_hh[ii]) - states[ii];
-        ysave[ii] = states[ii];
-        states[ii] += delta_hh[ii];
-
-        if (idaData->daeMode){
-          ypsave[ii] = yprime[ii];
-          yprime[ii] += cj * delta_hh[ii];
-        }
-
-        delta_hh[ii] = 1. / delta_hh[ii];
+      ii = colors->columns[c];
+      delta_hhh = currentStep * yprime[ii];
+      delta_hh[ii] = delta_h * fmax(fmax(fabs(states[ii]),fabs(delta_hhh)),fabs(1./errwgt[ii]));
+      delta_hh[ii] = (delta_hhh >= 0 ? delta_hh[ii] : -delta_hh[ii]);
+      delta_hh[ii] = (states[ii] + delta_hh[ii]) - states[ii];
+      ysave[ii] = states[ii];
+      states[ii] += delta_hh[ii];
+
+      if (idaData->daeMode){
+        ypsave[ii] = yprime[ii];
+        yprime[ii] += cj * delta_hh[ii];
       }
+
+      delta_hh[ii] = 1. / delta_hh[ii];
     }
 
     (*idaData->residualFunction)(tt, yy, yp, idaData->newdelta, userData);
 
     increaseJacContext(data);
 
-    for(ii = 0; ii < idaData->N; ii++)
+    for(c = colors->colorStart[i]; c < colors->colorStart[i+1]; c++)
     {
-      if(sparsePattern->colorCols[ii]-1 == i)
+      ii = colors->columns[c];
+      j = sparsePattern->leadindex[ii];
+      while(j < sparsePattern->leadindex[ii+1])
       {
-        j = sparsePattern->leadindex[ii];
-        while(j < sparsePattern->leadindex[ii+1])
-        {
-          l  =  sparsePattern->index[j];
-          DENSE_ELEM(Jac, l, ii) = (newdelta[l] - delta[l]) * delta_hh[ii];
-          j++;
-        };
-        states[ii] = ysave[ii];
-        if (idaData->daeMode)
-        {
-          yprime[ii] = ypsave[ii];
-        }
+        l  =  sparsePattern->index[j];
+        DENSE_ELEM(Jac, l, ii) = (newdelta[l] - delta[l]) * delta_hh[ii];
+        j++;
+      };
+      states[ii] = ysave[ii];
+      if (idaData->daeMode)
+      {
+        yprime[ii] = ypsave[ii];
       }
     }
   }
@@ -1441,6 +1461,19 @@ int jacColoredNumericalDense(double tt, N_Vector yy, N_Vector yp, N_Vector rr, D
   return 0;
 }
 
+/* copies one column of the symbolic Jacobian into a dense DlsMat matrix */
+static void storeDenseColumn(void *userData, unsigned int column, const ANALYTIC_JACOBIAN *jacData)
+{
+  DlsMat Jac = (DlsMat) userData;
+  unsigned int j, nth;
+
+  for(nth = jacData->sparsePattern.leadindex[column]; nth < jacData->sparsePattern.leadindex[column+1]; nth++)
+  {
+    j = jacData->sparsePattern.index[nth];
+    DENSE_ELEM(Jac, j, column) = jacData->resultVars[j];
+  }
+}
+
 /*
  *  function calculates the Jacobian matrix symbolical
  *  with considering also the coloring and pass it in a
@@ -1453,51 +1486,29 @@ int jacColoredSymbolicalDense(double tt, N_Vector yy, N_Vector yp, N_Vector rr,
   IDA_SOLVER* idaData = (IDA_SOLVER*)userData;
   DATA* data = (DATA*)(((IDA_USERDATA*)idaData->simData)->data);
   threadData_t* threadData = (threadData_t*)(((IDA_USERDATA*)idaData->simData)->threadData);
-  void* ida_mem = idaData->ida_mem;
   const int index = data->callback->INDEX_JAC_A;
-  unsigned int i,ii,j, nth;
   ANALYTIC_JACOBIAN* jacData = &(data->simulationInfo->analyticJacobians[index]);
   SPARSE_PATTERN* sparsePattern = &(jacData->sparsePattern);
-
-  /* prepare variables */
-  double *states = N_VGetArrayPointer(yy);
-  double *yprime = N_VGetArrayPointer(yp);
+  unsigned int ii, j, nth;
 
   setContext(data, &tt, CONTEXT_SYM_JACOBIAN);
 
-  for(i = 0; i < sparsePattern->maxColors; i++)
-  {
-    for(ii=0; ii < idaData->N; ii++)
-    {
-      if(sparsePattern->colorCols[ii]-1 == i)
-      {
-        jacData->seedVars[ii] = 1;
-      }
-    }
-
-    data->callback->functionJacA_column(data, threadData, jacData, NULL);
-    increaseJacContext(data);
+  evalJacobianColors(data, threadData, jacData, &idaData->jacobianColors, idaData->jacobianThreads,
+                     data->callback->functionJacA_column, storeDenseColumn, Jac);
 
+  /* the columns may have been stored by worker threads, dump them here */
+  if (ACTIVE_STREAM(LOG_JAC))
+  {
     for(ii = 0; ii < idaData->N; ii++)
     {
-      if(sparsePattern->colorCols[ii]-1 == i)
+      for(nth = sparsePattern->leadindex[ii]; nth < sparsePattern->leadindex[ii+1]; nth++)
       {
-        nth = sparsePattern->leadindex[ii];
-        while(nth < sparsePattern->leadindex[ii+1])
-        {
-          j  =  sparsePattern->index[nth];
-          infoStreamPrint(LOG_JAC, 0, "### symbolical jacobian  at [%d,%d] = %f ###", j, ii, jacData->resultVars[j]);
-          DENSE_ELEM(Jac, j, ii) = jacData->resultVars[j];
-          nth++;
-        };
+        j = sparsePattern->index[nth];
+        infoStreamPrint(LOG_JAC, 0, "### symbolical jacobian  at [%d,%d] = %f ###", j, ii, DENSE_ELEM(Jac, j, ii));
       }
     }
-
-    for(ii=0; ii < idaData->N; ii++)
-    {
-      jacData->seedVars[ii] = 0;
-    }
   }
+
   unsetContext(data);
 
   TRACE_POP
@@ -1613,7 +1624,8 @@ int jacoColoredNumericalSparse(double tt, N_Vector yy, N_Vector yp, N_Vector rr,
   double delta_hhh;
   double deltaInv;
 
-  long int i,j,ii;
+  const JACOBIAN_COLORS* colors = &idaData->jacobianColors;
+  long int i,j,ii,c;
   int nth = 0;
   int disBackup = idaData->disableScaling;
 
@@ -1651,26 +1663,24 @@ int jacoColoredNumericalSparse(double tt, N_Vector yy, N_Vector yp, N_Vector rr,
     idaReScaleData(idaData);
   }
 
-  for(i = 0; i < sparsePattern->maxColors; i++)
+  for(i = 0; i < colors->nColors; i++)
   {
-    for(ii=0; ii < idaData->N; ii++)
+    for(c = colors->colorStart[i]; c < colors->colorStart[i+1]; c++)
     {
-      if(sparsePattern->colorCols[ii]-1 == i)
-      {
-        delta_hhh = currentStep * yprime[ii];
-        delta_hh[ii] = delta_h * fmax(fmax(fabs(states[ii]),fabs(delta_hhh)),fabs(1./errwgt[ii]));
-        delta_hh[ii] = (delta_hhh >= 0 ? delta_hh[ii] : -delta_hh[ii]);
-        delta_hh[ii] = (states[ii] + delta_hh[ii]) - states[ii];
-        ysave[ii] = states[ii];
-        states[ii] += delta_hh[ii];
-
-        if (idaData->daeMode){
-          ypsave[ii] = yprime[ii];
-          yprime[ii] += cj * delta_hh[ii];
-        }
-
-        delta_hh[ii] = 1. / delta_hh[ii];
+      ii = colors->columns[c];
+      delta_hhh = currentStep * yprime[ii];
+      delta_hh[ii] = delta_h * fmax(fmax(fabs(states[ii]),fabs(delta_hhh)),fabs(1./errwgt[ii]));
+      delta_hh[ii] = (delta_hhh >= 0 ? delta_hh[ii] : -delta_hh[ii]);
+      delta_hh[ii] = (states[ii] + delta_hh[ii]) - states[ii];
+      ysave[ii] = states[ii];
+      states[ii] += delta_hh[ii];
+
+      if (idaData->daeMode){
+        ypsave[ii] = yprime[ii];
+        yprime[ii] += cj * delta_hh[ii];
       }
+
+      delta_hh[ii] = 1. / delta_hh[ii];
     }
     idaData->disableScaling = 1;
     (*idaData->residualFunction)(tt, yy, yp, idaData->newdelta, userData);
@@ -1678,28 +1688,26 @@ int jacoColoredNumericalSparse(double tt, N_Vector yy, N_Vector yp, N_Vector rr,
 
     increaseJacContext(data);
 
-    for(ii = 0; ii < idaData->N; ii++)
+    for(c = colors->colorStart[i]; c < colors->colorStart[i+1]; c++)
     {
-      if(sparsePattern->colorCols[ii]-1 == i)
+      ii = colors->columns[c];
+      nth = sparsePattern->leadindex[ii];
+      while(nth < sparsePattern->leadindex[ii+1])
       {
-        nth = sparsePattern->leadindex[ii];
-        while(nth < sparsePattern->leadindex[ii+1])
-        {
-          j  =  sparsePattern->index[nth];
-          //setJacElementKluSparse(j, ii, (newdelta[j] - delta[j]) * delta_hh[ii], nth, Jac);
-          /* use row scaling for jacobian elements */
-          if (idaData->disableScaling == 1 || !omc_flag[FLAG_IDA_SCALING]){
-            setJacElementKluSparse(j, ii, (newdelta[j] - delta[j]) * delta_hh[ii], nth, Jac);
-          }else{
-            setJacElementKluSparse(j, ii, ((newdelta[j] - delta[j]) * delta_hh[ii]) / idaData->resScale[j] * idaData->yScale[ii], nth, Jac);
-          }
-          nth++;
-        };
-        states[ii] = ysave[ii];
-        if (idaData->daeMode)
-        {
-          yprime[ii] = ypsave[ii];
+        j  =  sparsePattern->index[nth];
+        //setJacElementKluSparse(j, ii, (newdelta[j] - delta[j]) * delta_hh[ii], nth, Jac);
+        /* use row scaling for jacobian elements */
+        if (idaData->disableScaling == 1 || !omc_flag[FLAG_IDA_SCALING]){
+          setJacElementKluSparse(j, ii, (newdelta[j] - delta[j]) * delta_hh[ii], nth, Jac);
+        }else{
+          setJacElementKluSparse(j, ii, ((newdelta[j] - delta[j]) * delta_hh[ii]) / idaData->resScale[j] * idaData->yScale[ii], nth, Jac);
         }
+        nth++;
+      };
+      states[ii] = ysave[ii];
+      if (idaData->daeMode)
+      {
+        yprime[ii] = ypsave[ii];
       }
     }
   }
@@ -1719,6 +1727,18 @@ int jacoColoredNumericalSparse(double tt, N_Vector yy, N_Vector yp, N_Vector rr,
   return 0;
 }
 
+/* copies one column of the symbolic Jacobian into a sparse SlsMat matrix */
+static void storeSparseColumn(void *userData, unsigned int column, const ANALYTIC_JACOBIAN *jacData)
+{
+  SlsMat Jac = (SlsMat) userData;
+  unsigned int nth;
+
+  for(nth = jacData->sparsePattern.leadindex[column]; nth < jacData->sparsePattern.leadindex[column+1]; nth++)
+  {
+    setJacElementKluSparse(jacData->sparsePattern.index[nth], column, jacData->resultVars[jacData->sparsePattern.index[nth]], nth, Jac);
+  }
+}
+
 /* \fn jacColoredSymbolicalSparse(double tt, N_Vector yy, N_Vector yp, N_Vector rr, SlsMat Jac, double cj, void *userData)
  *
  *
@@ -1731,55 +1751,19 @@ jacColoredSymbolicalSparse(double tt, N_Vector yy, N_Vector yp, N_Vector rr, Sls
   IDA_SOLVER* idaData = (IDA_SOLVER*)userData;
   DATA* data = (DATA*)(((IDA_USERDATA*)idaData->simData)->data);
   threadData_t* threadData = (threadData_t*)(((IDA_USERDATA*)idaData->simData)->threadData);
-  void* ida_mem = idaData->ida_mem;
   const int index = data->callback->INDEX_JAC_A;
-  unsigned int i,ii,j,nth;
-
-  /* prepare variables */
-  double *states = N_VGetArrayPointer(yy);
-  double *yprime = N_VGetArrayPointer(yp);
 
   ANALYTIC_JACOBIAN* jacData = &(data->simulationInfo->analyticJacobians[index]);
-  SPARSE_PATTERN* sparsePattern = &(jacData->sparsePattern);
 
   /* it's needed to clear the matrix */
   SlsSetToZero(Jac);
 
   setContext(data, &tt, CONTEXT_SYM_JACOBIAN);
 
-  for(i = 0; i < sparsePattern->maxColors; i++)
-  {
-    for(ii=0; ii < idaData->N; ii++)
-    {
-      if(sparsePattern->colorCols[ii]-1 == i)
-      {
-        jacData->seedVars[ii] = 1;
-      }
-    }
-
-    data->callback->functionJacA_column(data, threadData, jacData, NULL);
-    increaseJacContext(data);
+  evalJacobianColors(data, threadData, jacData, &idaData->jacobianColors, idaData->jacobianThreads,
+                     data->callback->functionJacA_column, storeSparseColumn, Jac);
 
-    for(ii = 0; ii < idaData->N; ii++)
-    {
-      if(sparsePattern->colorCols[ii]-1 == i)
-      {
-        nth = sparsePattern->leadindex[ii];
-        while(nth < sparsePattern->leadindex[ii+1])
-        {
-          j  =  sparsePattern->index[nth];
-          setJacElementKluSparse(j, ii, jacData->resultVars[j], nth, Jac);
-          nth++;
-        };
-      }
-    }
-
-    for(ii=0; ii < idaData->N; ii++)
-    {
-      jacData->seedVars[ii] = 0;
-    }
-  }
-  finishSparseColPtr(Jac, sparsePattern->numberOfNoneZeros);
+  finishSparseColPtr(Jac, jacData->sparsePattern.numberOfNoneZeros);
   unsetContext(data);
 
   TRACE_POP
@@ -38,6 +38,7 @@
 #include "simulation_data.h"
 #include "util/simulation_options.h"
 #include "simulation/solver/solver_main.h"
+#include "simulation/solver/jacobianColors.h"
 
 #ifdef WITH_SUNDIALS
 
@@ -85,6 +86,8 @@ typedef struct IDA_SOLVER
   double *delta_hh;
   N_Vector errwgt;
   N_Vector newdelta;
+  JACOBIAN_COLORS jacobianColors;     /* columns of the sparse pattern grouped by color */
+  JACOBIAN_THREADS *jacobianThreads;  /* workers for the colors of the symbolic jacobian, or NULL */
 
   /* ### ida internal data */
   void* ida_mem;
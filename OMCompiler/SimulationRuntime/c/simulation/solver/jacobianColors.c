@@ -0,0 +1,428 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linköping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THIS OSMC PUBLIC
+ * LICENSE (OSMC-PL). ANY USE, REPRODUCTION OR DISTRIBUTION OF
+ * THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE OF THE OSMC
+ * PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköping University, either from the above address,
+ * from the URL: http://www.ida.liu.se/projects/OpenModelica
+ * and in the OpenModelica distribution.
+ *
+ * This program is distributed  WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+/*! \file jacobianColors.c
+ * Description: Evaluation of a colored symbolic Jacobian, one color at a time
+ *              or with the colors spread over worker threads.
+ *
+ * The columns of one color are independent, and so are the colors: every
+ * thread works on its own copy of seedVars, tmpVars and resultVars and only
+ * reads the model variables. This does not hold if the Jacobian contains a
+ * torn linear system, because such a system is solved in the shared
+ * LINEAR_SYSTEM_DATA (its parentJacobian points to the Jacobian being
+ * evaluated). The first color is therefore always evaluated serially; every
+ * column evaluation runs all equations of the Jacobian, so the workers are
+ * used for the remaining colors if no linear system was solved on behalf of
+ * the Jacobian.
+ */
+
+#include "jacobianColors.h"
+
+#include "openmodelica_func.h"
+#include "util/omc_error.h"
+#include "gc/omc_gc.h"
+#include "simulation/solver/model_help.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#if !defined(OMC_NO_THREADS)
+
+typedef enum {
+  JACOBIAN_THREADS_PROBE,      /* the first color of the next evaluation is serial and decides */
+  JACOBIAN_THREADS_ON,
+  JACOBIAN_THREADS_OFF
+} JACOBIAN_THREADS_STATE;
+
+typedef struct JACOBIAN_WORKER
+{
+  JACOBIAN_THREADS *pool;
+  ANALYTIC_JACOBIAN jacobian;    /* private seedVars, tmpVars and resultVars */
+  threadData_t *threadData;
+  pthread_t thread;
+  int started;
+} JACOBIAN_WORKER;
+
+struct JACOBIAN_THREADS
+{
+  JACOBIAN_THREADS_STATE state;
+  int nThreads;                  /* running workers */
+  int nWorkers;                  /* allocated workers */
+  JACOBIAN_WORKER *workers;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t startCond;
+  pthread_cond_t doneCond;
+  unsigned long generation;      /* incremented for every parallel evaluation */
+  int stop;
+  int running;                   /* workers still busy with the current generation */
+  int failed;
+
+  /* the current evaluation, valid while running > 0 */
+  DATA *data;
+  errorStage errorStage;
+  int (*jacobianColumn)(void*, threadData_t*, ANALYTIC_JACOBIAN*, ANALYTIC_JACOBIAN*);
+  const JACOBIAN_COLORS *colors;
+  unsigned int nextColor;
+  JACOBIAN_COLUMN_STORE store;
+  void *userData;
+};
+
+#endif /* !OMC_NO_THREADS */
+
+/*! \fn initJacobianColors
+ *
+ *  Groups the columns of the sparse pattern by color, so that a color is
+ *  visited without scanning all columns.
+ */
+void initJacobianColors(JACOBIAN_COLORS *colors, const SPARSE_PATTERN *sparsePattern, unsigned int sizeCols)
+{
+  unsigned int i, color;
+
+  colors->nColors = sparsePattern->colorCols ? sparsePattern->maxColors : 0;
+  colors->colorStart = (unsigned int*) calloc(colors->nColors + 2, sizeof(unsigned int));
+  colors->columns = (unsigned int*) malloc((sizeCols + 1) * sizeof(unsigned int));
+  assertStreamPrint(NULL, colors->colorStart && colors->columns, "Out of memory");
+
+  if (0 == colors->nColors) {
+    return;
+  }
+
+  /* counting sort of the columns by color; colorCols is 1-based */
+  for (i = 0; i < sizeCols; i++) {
+    color = sparsePattern->colorCols[i];
+    assertStreamPrint(NULL, color >= 1 && color <= colors->nColors, "Column %u of the sparse pattern has invalid color %u", i, color);
+    colors->colorStart[color + 1]++;
+  }
+  for (color = 1; color <= colors->nColors + 1; color++) {
+    colors->colorStart[color] += colors->colorStart[color - 1];
+  }
+  /* colorStart[c] is now the start of the 1-based color c, filling moves it to
+   * its end, which is the start of the 0-based color c */
+  for (i = 0; i < sizeCols; i++) {
+    colors->columns[colors->colorStart[sparsePattern->colorCols[i]]++] = i;
+  }
+}
+
+void freeJacobianColors(JACOBIAN_COLORS *colors)
+{
+  free(colors->colorStart);
+  free(colors->columns);
+  colors->colorStart = NULL;
+  colors->columns = NULL;
+  colors->nColors = 0;
+}
+
+/* evaluates one color with the given seed, tmp and result vectors */
+static void evalJacobianColor(DATA *data, threadData_t *threadData, ANALYTIC_JACOBIAN *jacobian, const JACOBIAN_COLORS *colors,
+                              int (*jacobianColumn)(void*, threadData_t*, ANALYTIC_JACOBIAN*, ANALYTIC_JACOBIAN*),
+                              unsigned int color, JACOBIAN_COLUMN_STORE store, void *userData)
+{
+  const unsigned int *first = colors->columns + colors->colorStart[color];
+  const unsigned int *last = colors->columns + colors->colorStart[color + 1];
+  const unsigned int *col;
+
+  for (col = first; col < last; col++) {
+    jacobian->seedVars[*col] = 1.0;
+  }
+
+  jacobianColumn(data, threadData, jacobian, NULL);
+
+  for (col = first; col < last; col++) {
+    store(userData, *col, jacobian);
+    jacobian->seedVars[*col] = 0.0;
+  }
+}
+
+#if !defined(OMC_NO_THREADS)
+
+/* takes the next color of the current evaluation; returns 0 if there is none left */
+static int nextJacobianColor(JACOBIAN_THREADS *pool, unsigned int *color)
+{
+  int ok;
+  pthread_mutex_lock(&pool->mutex);
+  ok = !pool->failed && pool->nextColor < pool->colors->nColors;
+  if (ok) {
+    *color = pool->nextColor++;
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return ok;
+}
+
+static void* jacobianWorker(void *arg)
+{
+  JACOBIAN_WORKER *worker = (JACOBIAN_WORKER*) arg;
+  JACOBIAN_THREADS *pool = worker->pool;
+  threadData_t *threadData = worker->threadData;
+  unsigned long generation = 0;
+  unsigned int color;
+  jmp_buf jumper;
+
+  pthread_setspecific(mmc_thread_data_key, threadData);
+
+  for (;;) {
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->stop && pool->generation == generation) {
+      pthread_cond_wait(&pool->startCond, &pool->mutex);
+    }
+    if (pool->stop) {
+      pthread_mutex_unlock(&pool->mutex);
+      break;
+    }
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->mutex);
+
+    /* asserts in the Jacobian equations jump back to here */
+    threadData->currentErrorStage = pool->errorStage;
+    threadData->mmc_jumper = &jumper;
+    threadData->globalJumpBuffer = &jumper;
+    threadData->simulationJumpBuffer = &jumper;
+    if (0 == setjmp(jumper)) {
+      while (nextJacobianColor(pool, &color)) {
+        evalJacobianColor(pool->data, threadData, &worker->jacobian, pool->colors, pool->jacobianColumn, color, pool->store, pool->userData);
+      }
+    } else {
+      /* leave the seed vector clean for the next evaluation */
+      memset(worker->jacobian.seedVars, 0, worker->jacobian.sizeCols * sizeof(modelica_real));
+      pthread_mutex_lock(&pool->mutex);
+      pool->failed = 1;
+      pthread_mutex_unlock(&pool->mutex);
+    }
+    threadData->mmc_jumper = NULL;
+    threadData->globalJumpBuffer = NULL;
+    threadData->simulationJumpBuffer = NULL;
+    /* temporaries of the Jacobian equations live in the memory pool of this thread */
+    omc_alloc_interface.collect_a_little();
+
+    pthread_mutex_lock(&pool->mutex);
+    if (0 == --pool->running) {
+      pthread_cond_signal(&pool->doneCond);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+  }
+  return NULL;
+}
+
+/* returns 1 if a linear system was solved on behalf of the jacobian */
+static int jacobianHasLinearSystems(DATA *data, const ANALYTIC_JACOBIAN *jacobian)
+{
+#if !defined(OMC_NUM_LINEAR_SYSTEMS) || OMC_NUM_LINEAR_SYSTEMS>0
+  long i;
+  for (i = 0; i < data->modelData->nLinearSystems; i++) {
+    if (data->simulationInfo->linearSystemData[i].parentJacobian == jacobian) {
+      return 1;
+    }
+  }
+#endif
+  return 0;
+}
+
+/*! \fn initJacobianThreads
+ *
+ *  Starts nThreads workers for the colors of the given jacobian. Returns NULL
+ *  (serial evaluation) if nThreads < 2 or the threads could not be set up.
+ */
+JACOBIAN_THREADS* initJacobianThreads(DATA *data, threadData_t *threadData, const ANALYTIC_JACOBIAN *jacobian, int nThreads)
+{
+  JACOBIAN_THREADS *pool;
+  int i;
+
+  if (nThreads < 2 || jacobian->sparsePattern.maxColors < 2) {
+    return NULL;
+  }
+  if (nThreads > (int) jacobian->sparsePattern.maxColors) {
+    nThreads = jacobian->sparsePattern.maxColors;
+  }
+
+  pool = (JACOBIAN_THREADS*) calloc(1, sizeof(JACOBIAN_THREADS));
+  assertStreamPrint(threadData, 0 != pool, "Out of memory");
+  pool->workers = (JACOBIAN_WORKER*) calloc(nThreads, sizeof(JACOBIAN_WORKER));
+  assertStreamPrint(threadData, 0 != pool->workers, "Out of memory");
+  pool->nWorkers = nThreads;
+  pool->state = JACOBIAN_THREADS_PROBE;
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->startCond, NULL);
+  pthread_cond_init(&pool->doneCond, NULL);
+
+  for (i = 0; i < nThreads; i++) {
+    JACOBIAN_WORKER *worker = pool->workers + i;
+    worker->pool = pool;
+    worker->jacobian = *jacobian;
+    worker->jacobian.seedVars = (modelica_real*) calloc(jacobian->sizeCols + 1, sizeof(modelica_real));
+    worker->jacobian.tmpVars = (modelica_real*) calloc(jacobian->sizeTmpVars + 1, sizeof(modelica_real));
+    worker->jacobian.resultVars = (modelica_real*) calloc(jacobian->sizeRows + 1, sizeof(modelica_real));
+    worker->threadData = (threadData_t*) calloc(1, sizeof(threadData_t));
+    assertStreamPrint(threadData, worker->jacobian.seedVars && worker->jacobian.tmpVars && worker->jacobian.resultVars && worker->threadData, "Out of memory");
+    pthread_mutex_init(&worker->threadData->parentMutex, NULL);
+    worker->threadData->parent = threadData;
+
+    if (GC_pthread_create(&worker->thread, NULL, jacobianWorker, worker)) {
+      break;
+    }
+    worker->started = 1;
+    pool->nThreads++;
+  }
+
+  if (pool->nThreads < 2) {
+    warningStreamPrint(LOG_STDOUT, 0, "Could not start the Jacobian worker threads, the Jacobian is evaluated serially");
+    freeJacobianThreads(pool);
+    return NULL;
+  }
+  infoStreamPrint(LOG_SOLVER, 0, "Jacobian colors are evaluated by %d threads", pool->nThreads);
+  return pool;
+}
+
+/* stops and joins the workers; the pool itself stays valid */
+static void stopJacobianWorkers(JACOBIAN_THREADS *pool)
+{
+  int i;
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->startCond);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (i = 0; i < pool->nWorkers; i++) {
+    JACOBIAN_WORKER *worker = pool->workers + i;
+    if (worker->started) {
+      GC_pthread_join(worker->thread, NULL);
+      worker->started = 0;
+    }
+    free(worker->jacobian.seedVars);
+    free(worker->jacobian.tmpVars);
+    free(worker->jacobian.resultVars);
+    free(worker->threadData);
+    memset(worker, 0, sizeof(JACOBIAN_WORKER));
+  }
+  pool->nThreads = 0;
+}
+
+void freeJacobianThreads(JACOBIAN_THREADS *pool)
+{
+  if (NULL == pool) {
+    return;
+  }
+  stopJacobianWorkers(pool);
+  pthread_mutex_destroy(&pool->mutex);
+  pthread_cond_destroy(&pool->startCond);
+  pthread_cond_destroy(&pool->doneCond);
+  free(pool->workers);
+  free(pool);
+}
+
+/* hands the colors from firstColor on to the workers and waits until they are done */
+static void evalJacobianColorsParallel(DATA *data, threadData_t *threadData, const JACOBIAN_COLORS *colors, JACOBIAN_THREADS *pool,
+                                       int (*jacobianColumn)(void*, threadData_t*, ANALYTIC_JACOBIAN*, ANALYTIC_JACOBIAN*),
+                                       unsigned int firstColor, JACOBIAN_COLUMN_STORE store, void *userData)
+{
+  unsigned int color;
+  int failed;
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->data = data;
+  pool->errorStage = threadData->currentErrorStage;
+  pool->jacobianColumn = jacobianColumn;
+  pool->colors = colors;
+  pool->nextColor = firstColor;
+  pool->store = store;
+  pool->userData = userData;
+  pool->failed = 0;
+  pool->running = pool->nThreads;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->startCond);
+  while (pool->running > 0) {
+    pthread_cond_wait(&pool->doneCond, &pool->mutex);
+  }
+  failed = pool->failed;
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (color = firstColor; color < colors->nColors; color++) {
+    increaseJacContext(data);
+  }
+  if (failed) {
+    throwStreamPrint(threadData, "Evaluation of the Jacobian failed in a worker thread.");
+  }
+}
+
+#else
+
+JACOBIAN_THREADS* initJacobianThreads(DATA *data, threadData_t *threadData, const ANALYTIC_JACOBIAN *jacobian, int nThreads)
+{
+  if (nThreads > 1) {
+    warningStreamPrint(LOG_STDOUT, 0, "This runtime has no thread support, the Jacobian is evaluated serially");
+  }
+  return NULL;
+}
+
+void freeJacobianThreads(JACOBIAN_THREADS *threads)
+{
+}
+
+#endif /* !OMC_NO_THREADS */
+
+/*! \fn evalJacobianColors
+ *
+ *  Evaluates all colors of the jacobian with the given column function and
+ *  passes every column of the sparse pattern to store. With threads != NULL
+ *  the colors are distributed over the workers once a serially evaluated color
+ *  has shown that this is safe (see the top of this file).
+ */
+void evalJacobianColors(DATA *data, threadData_t *threadData, ANALYTIC_JACOBIAN *jacobian, const JACOBIAN_COLORS *colors,
+                        JACOBIAN_THREADS *threads,
+                        int (*jacobianColumn)(void*, threadData_t*, ANALYTIC_JACOBIAN*, ANALYTIC_JACOBIAN*),
+                        JACOBIAN_COLUMN_STORE store, void *userData)
+{
+  unsigned int color = 0;
+
+#if !defined(OMC_NO_THREADS)
+  if (threads && JACOBIAN_THREADS_PROBE == threads->state && colors->nColors > 0) {
+    evalJacobianColor(data, threadData, jacobian, colors, jacobianColumn, color, store, userData);
+    increaseJacContext(data);
+    color++;
+    if (jacobianHasLinearSystems(data, jacobian)) {
+      warningStreamPrint(LOG_STDOUT, 0, "The Jacobian contains linear systems, its colors are evaluated serially");
+      stopJacobianWorkers(threads);
+      threads->state = JACOBIAN_THREADS_OFF;
+    } else {
+      threads->state = JACOBIAN_THREADS_ON;
+    }
+  }
+  if (threads && JACOBIAN_THREADS_ON == threads->state) {
+    evalJacobianColorsParallel(data, threadData, colors, threads, jacobianColumn, color, store, userData);
+    return;
+  }
+#endif
+
+  for (; color < colors->nColors; color++) {
+    evalJacobianColor(data, threadData, jacobian, colors, jacobianColumn, color, store, userData);
+    increaseJacContext(data);
+  }
+}
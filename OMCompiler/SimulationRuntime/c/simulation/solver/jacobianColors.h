@@ -0,0 +1,75 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Linköping University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THIS OSMC PUBLIC
+ * LICENSE (OSMC-PL). ANY USE, REPRODUCTION OR DISTRIBUTION OF
+ * THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE OF THE OSMC
+ * PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköping University, either from the above address,
+ * from the URL: http://www.ida.liu.se/projects/OpenModelica
+ * and in the OpenModelica distribution.
+ *
+ * This program is distributed  WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+/*! \file jacobianColors.h
+ * Description: Column groups of a colored sparse pattern and the worker
+ *              threads that evaluate the colors of a symbolic Jacobian
+ *              concurrently.
+ */
+
+#ifndef _OMC_JACOBIAN_COLORS_H
+#define _OMC_JACOBIAN_COLORS_H
+
+#include "simulation_data.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The columns of one color are columns[colorStart[i]] ... columns[colorStart[i+1]-1]. */
+typedef struct JACOBIAN_COLORS
+{
+  unsigned int nColors;
+  unsigned int *colorStart;   /* nColors+1 offsets into columns */
+  unsigned int *columns;      /* all columns, grouped by color */
+} JACOBIAN_COLORS;
+
+/* Copies one evaluated column from jacobian->resultVars into the matrix of the caller.
+ * In parallel mode it is called from the worker threads, each column exactly once. */
+typedef void (*JACOBIAN_COLUMN_STORE)(void *userData, unsigned int column, const ANALYTIC_JACOBIAN *jacobian);
+
+typedef struct JACOBIAN_THREADS JACOBIAN_THREADS;
+
+void initJacobianColors(JACOBIAN_COLORS *colors, const SPARSE_PATTERN *sparsePattern, unsigned int sizeCols);
+void freeJacobianColors(JACOBIAN_COLORS *colors);
+
+JACOBIAN_THREADS* initJacobianThreads(DATA *data, threadData_t *threadData, const ANALYTIC_JACOBIAN *jacobian, int nThreads);
+void freeJacobianThreads(JACOBIAN_THREADS *threads);
+
+void evalJacobianColors(DATA *data, threadData_t *threadData, ANALYTIC_JACOBIAN *jacobian, const JACOBIAN_COLORS *colors,
+                        JACOBIAN_THREADS *threads,
+                        int (*jacobianColumn)(void*, threadData_t*, ANALYTIC_JACOBIAN*, ANALYTIC_JACOBIAN*),
+                        JACOBIAN_COLUMN_STORE store, void *userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
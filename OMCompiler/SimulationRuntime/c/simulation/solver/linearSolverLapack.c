@@ -46,8 +46,8 @@
 #include "linearSolverLapack.h"
 
 
-extern int dgesv_(int *n, int *nrhs, double *a, int *lda,
-                  int *ipiv, double *b, int *ldb, int *info);
+extern int dgetrf_(int *m, int *n, double *a, int *lda,
+                  int *ipiv, int *info);
 
 extern int dgetrs_(char* tran, int *n, int *nrhs, double *a, int *lda,
                   int *ipiv, double *b, int *ldb, int *info);
@@ -68,6 +68,11 @@ int allocateLapackData(int size, void** voiddata)
   data->b = _omc_createVector(size, NULL);
   data->A = _omc_createMatrix(size, size, NULL);
 
+  data->LU = _omc_createMatrix(size, size, (double*) malloc(size*size*sizeof(double)));
+  data->Afactored = (double*) malloc(size*size*sizeof(double));
+  assertStreamPrint(NULL, 0 != data->LU->data && 0 != data->Afactored, "Could not allocate data for linear solver lapack.");
+  data->factored = 0;
+
   *voiddata = (void*)data;
   return 0;
 }
@@ -86,6 +91,10 @@ int freeLapackData(void **voiddata)
   _omc_destroyVector(data->b);
   _omc_destroyMatrix(data->A);
 
+  free(data->LU->data);
+  _omc_destroyMatrix(data->LU);
+  free(data->Afactored);
+
   free(data);
   voiddata[0] = 0;
 
@@ -229,28 +238,41 @@ int solveLapack(DATA *data, threadData_t *threadData, int sysNumber, double* aux
 
   rt_ext_tp_tick(&(solverData->timeClock));
 
-  /* if reuseMatrixJac use also previous factorization */
-  if (!reuseMatrixJac)
+  /* Many systems have a matrix A that only depends on parameters or changes
+   * rarely, so the factors of the last call are reused as long as A is the
+   * same. If reuseMatrixJac is set, A was not updated at all, but it still
+   * has to be factorized if there are no valid factors yet. */
+  solverData->info = 0;
+  if (!solverData->factored || (!reuseMatrixJac &&
+      0 != memcmp(solverData->Afactored, systemData->A, (systemData->size)*(systemData->size)*sizeof(double))))
   {
-    /* Solve system */
-    dgesv_((int*) &systemData->size,
-           (int*) &solverData->nrhs,
-           solverData->A->data,
-           (int*) &systemData->size,
-           solverData->ipiv,
-           solverData->b->data,
-           (int*) &systemData->size,
-           &solverData->info);
-
-  } /* further Jacobian evaluations */
+    memcpy(solverData->Afactored, systemData->A, (systemData->size)*(systemData->size)*sizeof(double));
+    memcpy(solverData->LU->data, systemData->A, (systemData->size)*(systemData->size)*sizeof(double));
+
+    /* factorize A */
+    dgetrf_((int*) &systemData->size,
+            (int*) &systemData->size,
+            solverData->LU->data,
+            (int*) &systemData->size,
+            solverData->ipiv,
+            &solverData->info);
+
+    solverData->factored = (0 == solverData->info);
+    solverData->numberOfFactorizations++;
+  }
   else
+  {
+    solverData->numberOfReusedFactors++;
+  }
+
+  if (0 == solverData->info)
   {
     char trans = 'N';
     /* Solve system */
     dgetrs_(&trans,
             (int*) &systemData->size,
             (int*) &solverData->nrhs,
-            solverData->A->data,
+            solverData->LU->data,
             (int*) &systemData->size,
             solverData->ipiv,
             solverData->b->data,
@@ -258,7 +280,6 @@ int solveLapack(DATA *data, threadData_t *threadData, int sysNumber, double* aux
             &solverData->info);
   }
 
-
   infoStreamPrint(LOG_LS_V, 0, "Solve System: %f", rt_ext_tp_tock(&(solverData->timeClock)));
 
   if(solverData->info < 0)
@@ -276,7 +297,7 @@ int solveLapack(DATA *data, threadData_t *threadData, int sysNumber, double* aux
 
     /* debug output */
     if (ACTIVE_STREAM(LOG_LS)){
-      _omc_printMatrix(solverData->A, "Matrix U", LOG_LS);
+      _omc_printMatrix(solverData->LU, "Matrix U", LOG_LS);
 
       _omc_printVector(solverData->b, "Output vector x", LOG_LS);
     }
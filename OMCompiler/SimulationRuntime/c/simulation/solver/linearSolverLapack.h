@@ -48,8 +48,16 @@ typedef struct DATA_LAPACK
   _omc_vector* b;
   _omc_matrix* A;
 
+  _omc_matrix* LU;                 /* LU factors, reused as long as A does not change */
+  double* Afactored;               /* copy of the matrix A the factors belong to */
+  int factored;                    /* 1 if LU holds valid factors */
+
   rtclock_t timeClock;             /* time clock */
 
+  /* statistics */
+  unsigned long numberOfFactorizations;
+  unsigned long numberOfReusedFactors;
+
 } DATA_LAPACK;
 
 int allocateLapackData(int size, void **data);
@@ -271,10 +271,16 @@ void printLinearSystemSolvingStatistics(DATA *data, int sysNumber, int logLevel)
   infoStreamPrint(logLevel, 1, "Linear system %d with (size = %d, nonZeroElements = %d, density = %.2f %%) solver statistics:",
                                (int)linsys[sysNumber].equationIndex, (int)linsys[sysNumber].size, (int)linsys[sysNumber].nnz,
                                (((double) linsys[sysNumber].nnz) / ((double)(linsys[sysNumber].size*linsys[sysNumber].size)))*100 );
-  infoStreamPrint(logLevel, 0, " number of calls                : %ld", linsys[sysNumber].numberOfCall);
+  infoStreamPrint(logLevel, 0, " number of calls                : %lu", linsys[sysNumber].numberOfCall);
   infoStreamPrint(logLevel, 0, " average time per call          : %g", linsys[sysNumber].totalTime/linsys[sysNumber].numberOfCall);
   infoStreamPrint(logLevel, 0, " time of jacobian evaluations   : %g", linsys[sysNumber].jacobianTime);
   infoStreamPrint(logLevel, 0, " total time                     : %g", linsys[sysNumber].totalTime);
+  if (!linsys[sysNumber].useSparseSolver && (LS_LAPACK == data->simulationInfo->lsMethod || LS_DEFAULT == data->simulationInfo->lsMethod))
+  {
+    DATA_LAPACK* solverData = (DATA_LAPACK*) linsys[sysNumber].solverData[0];
+    infoStreamPrint(logLevel, 0, " number of LU factorizations    : %lu", solverData->numberOfFactorizations);
+    infoStreamPrint(logLevel, 0, " number of reused LU factors    : %lu", solverData->numberOfReusedFactors);
+  }
   messageClose(logLevel);
 }
 
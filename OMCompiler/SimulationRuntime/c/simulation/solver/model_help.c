@@ -1085,11 +1085,11 @@ void initializeDataStruc(DATA *data, threadData_t *threadData)
 
   /* initial delay */
 #if !defined(OMC_NDELAY_EXPRESSIONS) || OMC_NDELAY_EXPRESSIONS>0
-  data->simulationInfo->delayStructure = (RINGBUFFER**)malloc(data->modelData->nDelayExpressions * sizeof(RINGBUFFER*));
+  data->simulationInfo->delayStructure = (DELAY_LINE*)malloc(data->modelData->nDelayExpressions * sizeof(DELAY_LINE));
   assertStreamPrint(threadData, 0 == data->modelData->nDelayExpressions || 0 != data->simulationInfo->delayStructure, "out of memory");
 
   for(i=0; i<data->modelData->nDelayExpressions; i++)
-    data->simulationInfo->delayStructure[i] = allocRingBuffer(1024, sizeof(TIME_AND_VALUE));
+    allocDelayLine(&data->simulationInfo->delayStructure[i], 1024);
 #endif
 
 #if !defined(OMC_NO_STATESELECTION)
@@ -1228,10 +1228,12 @@ void deInitializeDataStruc(DATA *data)
   free(data->simulationInfo->chatteringInfo.lastTimes);
 
   /* free delay structure */
+#if !defined(OMC_NDELAY_EXPRESSIONS) || OMC_NDELAY_EXPRESSIONS>0
   for(i=0; i<data->modelData->nDelayExpressions; i++)
-    freeRingBuffer(data->simulationInfo->delayStructure[i]);
+    freeDelayLine(&data->simulationInfo->delayStructure[i]);
 
   free(data->simulationInfo->delayStructure);
+#endif
 
 #if !defined(OMC_NO_STATESELECTION)
   /* free stateset data */
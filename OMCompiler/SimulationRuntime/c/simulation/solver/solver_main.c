@@ -570,6 +570,13 @@ int finishSimulation(DATA* data, threadData_t *threadData, SOLVER_INFO* solverIn
     infoStreamPrint(LOG_STATS, 0, "%5ld time events", solverInfo->sampleEvents);
     messageClose(LOG_STATS);
 
+    if(memory_pool_high_water() > 0)
+    {
+      infoStreamPrint(LOG_STATS, 1, "memory pool");
+      infoStreamPrint(LOG_STATS, 0, "%12lu bytes high-water mark of a thread", (unsigned long) memory_pool_high_water());
+      messageClose(LOG_STATS);
+    }
+
     if(S_OPTIMIZATION == solverInfo->solverMethod || /* skip solver statistics for optimization */
        S_QSS == solverInfo->solverMethod) /* skip also for qss, since not available*/
     {
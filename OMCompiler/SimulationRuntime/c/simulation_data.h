@@ -90,6 +90,18 @@ typedef struct SAMPLE_INFO
   double interval;
 } SAMPLE_INFO;
 
+/* stored (time, value) pairs of one delay expression, sorted by time;
+ * the valid entries are [start, start+length) of the contiguous arrays */
+typedef struct DELAY_LINE
+{
+  double *time;
+  double *value;
+  long start;
+  long length;
+  long capacity;
+  long cursor;    /* result of the last search, relative to start */
+} DELAY_LINE;
+
 typedef struct CHATTERING_INFO
 {
   int numEventLimit;
@@ -676,7 +688,7 @@ typedef struct SIMULATION_INFO
 
   /* delay vars */
   double tStart;
-  RINGBUFFER **delayStructure;
+  DELAY_LINE *delayStructure;
   const char *OPENMODELICAHOME;
 
   CHATTERING_INFO chatteringInfo;
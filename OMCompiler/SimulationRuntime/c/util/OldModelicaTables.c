@@ -34,6 +34,7 @@
 #include <math.h>
 #include <ctype.h>
 
+#include "OldModelicaTables.h"
 #include "../omc_inline.h"
 #include "../ModelicaUtilities.h"
 #ifdef _MSC_VER
@@ -46,11 +47,26 @@
 /* Definition to make a copy of the arrays */
 #define COPY_ARRAYS
 
+/* Data of a table read from a file. It is shared read-only by all
+ * tables that refer to the same table in the same file. */
+typedef struct TableFileData
+{
+  char *filename;
+  char *tablename;
+  unsigned long hash;
+  double *data;
+  size_t rows;
+  size_t cols;
+  int refs;
+} TableFileData;
+
 typedef struct InterpolationTable
 {
   char *filename;
   char *tablename;
+  unsigned long hash;
   char own_data;
+  TableFileData *fileData;
   double* data;
   size_t rows;
   size_t cols;
@@ -58,13 +74,16 @@ typedef struct InterpolationTable
   int ipoType;
   int expoType;
   double startTime;
+  size_t lastRow; /* interval found by the previous search */
 } InterpolationTable;
 
 typedef struct InterpolationTable2D
 {
   char *filename;
   char *tablename;
+  unsigned long hash;
   char own_data;
+  TableFileData *fileData;
   double *data;
   size_t rows;
   size_t cols;
@@ -72,12 +91,20 @@ typedef struct InterpolationTable2D
   char colWise;
   int ipoType;
   int expoType;
+  size_t lastRow; /* intervals found by the previous search */
+  size_t lastCol;
 } InterpolationTable2D;
 
 static InterpolationTable** interpolationTables=NULL;
 static int ninterpolationTables=0;
 static InterpolationTable2D** interpolationTables2D=NULL;
 static int ninterpolationTables2D=0;
+static TableFileData** tableFileData=NULL;
+static int ntableFileData=0;
+
+static unsigned long hashTableName(const char* fileName, const char* tableName);
+static char isMemoryTable(const char* fileName, const char* tableName);
+static size_t findIndex(const double *x, size_t stride, size_t lo, size_t hi, double value, char strict, size_t *hint);
 
 static InterpolationTable *InterpolationTable_init(double time,double startTime, int ipoType, int expoType,
          const char* tableName, const char* fileName,
@@ -86,9 +113,12 @@ static InterpolationTable *InterpolationTable_init(double time,double startTime,
 /* InterpolationTable *InterpolationTable_Copy(InterpolationTable *orig); */
 static void InterpolationTable_deinit(InterpolationTable *tpl);
 static double InterpolationTable_interpolate(InterpolationTable *tpl, double time, size_t col);
+static size_t InterpolationTable_findRow(InterpolationTable *tpl, double time);
+static double InterpolationTable_interpolateRow(InterpolationTable *tpl, double time, size_t i, size_t col);
 static double InterpolationTable_maxTime(InterpolationTable *tpl);
 static double InterpolationTable_minTime(InterpolationTable *tpl);
-static char InterpolationTable_compare(InterpolationTable *tpl, const char* fname, const char* tname, const double* table);
+static char InterpolationTable_compare(InterpolationTable *tpl, const char* fname, const char* tname, const double* table,
+         unsigned long hash, int ipoType, int expoType, double startTime, int colWise);
 
 static double InterpolationTable_extrapolate(InterpolationTable *tpl, double time, size_t col, char beforeData);
 static inline double InterpolationTable_interpolateLin(InterpolationTable *tpl, double time, size_t i, size_t j);
@@ -102,7 +132,8 @@ static InterpolationTable2D *InterpolationTable2D_init(int ipoType, const char*
            int tableDim1, int tableDim2, int colWise);
 static void InterpolationTable2D_deinit(InterpolationTable2D *table);
 static double InterpolationTable2D_interpolate(InterpolationTable2D *tpl, double x1, double x2);
-static char InterpolationTable2D_compare(InterpolationTable2D *tpl, const char* fname, const char* tname, const double* table);
+static char InterpolationTable2D_compare(InterpolationTable2D *tpl, const char* fname, const char* tname, const double* table,
+         unsigned long hash, int ipoType, int colWise);
 static double InterpolationTable2D_linInterpolate(double x, double x_1, double x_2, double f_1, double f_2);
 static const double InterpolationTable2D_getElt(InterpolationTable2D *tpl, size_t row, size_t col);
 static void InterpolationTable2D_checkValidityOfData(InterpolationTable2D *tpl);
@@ -134,12 +165,14 @@ int omcTableTimeIni(double timeIn, double startTime,int ipoType,int expoType,
 {
   int i = 0;
   InterpolationTable** tmp = NULL;
+  unsigned long hash = hashTableName(fileName,tableName);
 #ifdef INFOS
   INFO10("Init Table \n timeIn %f \n startTime %f \n ipoType %d \n expoType %d \n tableName %s \n fileName %s \n table %p \n tableDim1 %d \n tableDim2 %d \n colWise %d", timeIn, startTime, ipoType, expoType, tableName, fileName, table, tableDim1, tableDim2, colWise);
 #endif
   /* if table is already initialized, find it */
   for(i = 0; i < ninterpolationTables; ++i)
-    if(InterpolationTable_compare(interpolationTables[i],fileName,tableName,table))
+    if(interpolationTables[i] && InterpolationTable_compare(interpolationTables[i],fileName,tableName,table,
+                                                            hash,ipoType,expoType,startTime,colWise))
     {
 #ifdef INFOS
       infoStreamPrint("Table id = %d",i);
@@ -183,21 +216,42 @@ void omcTableTimeIpoClose(int tableID)
     ninterpolationTables--;
   }
   if(ninterpolationTables <=0)
+  {
     free(interpolationTables);
+    interpolationTables = NULL;
+  }
 }
 
 
 double omcTableTimeIpo(int tableID, int icol, double timeIn)
 {
+  double value;
 #ifdef INFOS
   infoStreamPrint("Interpolate Table[%d][%d] add Time %f",tableID,icol,timeIn);
+#endif
+  omcTableTimeIpoColumns(tableID,1,&icol,timeIn,&value);
+  return value;
+}
+
+
+void omcTableTimeIpoColumns(int tableID, int ncols, const int *icols, double timeIn, double *values)
+{
+  int k;
+#ifdef INFOS
+  infoStreamPrint("Interpolate %d columns of Table[%d] add Time %f",ncols,tableID,timeIn);
 #endif
   if(tableID >= 0 && tableID < (int)ninterpolationTables)
   {
-    return InterpolationTable_interpolate(interpolationTables[tableID],timeIn,icol-1);
+    InterpolationTable *tpl = interpolationTables[tableID];
+    size_t i = InterpolationTable_findRow(tpl,timeIn);
+    for(k = 0; k < ncols; ++k)
+      values[k] = InterpolationTable_interpolateRow(tpl,timeIn,i,icols[k]-1);
   }
   else
-    return 0.0;
+  {
+    for(k = 0; k < ncols; ++k)
+      values[k] = 0.0;
+  }
 }
 
 
@@ -230,12 +284,14 @@ int omcTable2DIni(int ipoType, const char *tableName, const char* fileName,
 {
   int i=0;
   InterpolationTable2D** tmp = NULL;
+  unsigned long hash = hashTableName(fileName,tableName);
 #ifdef INFOS
   infoStreamPrint("Init Table \n ipoType %f \n tableName %f \n fileName %d \n table %p \n tableDim1 %d \n tableDim2 %d \n colWise %d", ipoType, tableName, fileName, table, tableDim1, tableDim2, colWise);
 #endif
   /* if table is already initialized, find it */
   for(i = 0; i < ninterpolationTables2D; ++i)
-    if(InterpolationTable2D_compare(interpolationTables2D[i],fileName,tableName,table))
+    if(interpolationTables2D[i] && InterpolationTable2D_compare(interpolationTables2D[i],fileName,tableName,table,
+                                                                hash,ipoType,colWise))
     {
 #ifdef INFOS
       infoStreamPrint("Table id = %d",i);
@@ -276,7 +332,10 @@ void omcTable2DIpoClose(int tableID)
     ninterpolationTables2D--;
   }
   if(ninterpolationTables2D <=0)
+  {
     free(interpolationTables2D);
+    interpolationTables2D = NULL;
+  }
 }
 
 
@@ -1029,6 +1088,111 @@ static char *copyTableNameFile(const char *name)
   return dst;
 }
 
+static char isMemoryTable(const char* fileName, const char* tableName)
+{
+  return (fileName == NULL || tableName == NULL) || ((strncmp("NoName",fileName,6) == 0 && strncmp("NoName",tableName,6) == 0));
+}
+
+static unsigned long hashTableName(const char* fileName, const char* tableName)
+{
+  unsigned long hash = 5381;
+  if(fileName)
+    for(; *fileName; ++fileName)
+      hash = hash*33 + (unsigned char)*fileName;
+  hash = hash*33;
+  if(tableName)
+    for(; *tableName; ++tableName)
+      hash = hash*33 + (unsigned char)*tableName;
+  return hash;
+}
+
+/* Returns the first index i in [lo,hi) with x[i*stride] > value (>= value if
+ * strict is 0), or hi if there is none. x has to be monotonous. Successive
+ * calls mostly hit the same or the next interval, so the result of the
+ * previous search in *hint is checked before bisecting.
+ */
+static size_t findIndex(const double *x, size_t stride, size_t lo, size_t hi, double value, char strict, size_t *hint)
+{
+  size_t i = *hint;
+#define ABOVE(k) (strict ? x[(k)*stride] > value : x[(k)*stride] >= value)
+  if(i >= lo && i <= hi)
+  {
+    if(i == lo || !ABOVE(i-1))
+    {
+      if(i == hi || ABOVE(i))
+        return i;
+      if(++i == hi || ABOVE(i))
+        return (*hint = i);
+      lo = i+1;
+    }
+    else
+      hi = i-1;
+  }
+  while(lo < hi)
+  {
+    i = lo + (hi-lo)/2;
+    if(ABOVE(i))
+      hi = i;
+    else
+      lo = i+1;
+  }
+#undef ABOVE
+  return (*hint = lo);
+}
+
+/* Returns the data of a table in a file, reading it only if no other table
+ * uses it yet. */
+static TableFileData* TableFileData_acquire(const char* fileName, const char* tableName, unsigned long hash)
+{
+  int i;
+  TableFileData *fd = NULL;
+  TableFileData **tmp = NULL;
+  for(i = 0; i < ntableFileData; ++i)
+  {
+    fd = tableFileData[i];
+    if(fd->hash == hash && !strcmp(fd->filename,fileName) && !strcmp(fd->tablename,tableName))
+    {
+      fd->refs++;
+      return fd;
+    }
+  }
+  fd = (TableFileData*)calloc(1,sizeof(TableFileData));
+  tmp = (TableFileData**)realloc(tableFileData,(ntableFileData+1)*sizeof(TableFileData*));
+  if (!fd || !tmp) {
+    ModelicaFormatError("Not enough memory for Table: %s",tableName);
+  }
+  tableFileData = tmp;
+  openFile(fileName,tableName,&(fd->rows),&(fd->cols),&(fd->data));
+  fd->filename = copyTableNameFile(fileName);
+  fd->tablename = copyTableNameFile(tableName);
+  fd->hash = hash;
+  fd->refs = 1;
+  tableFileData[ntableFileData++] = fd;
+  return fd;
+}
+
+static void TableFileData_release(TableFileData *fd)
+{
+  int i;
+  if(!fd || --fd->refs > 0)
+    return;
+  for(i = 0; i < ntableFileData; ++i)
+    if(tableFileData[i] == fd)
+    {
+      tableFileData[i] = tableFileData[--ntableFileData];
+      break;
+    }
+  if(ntableFileData == 0)
+  {
+    free(tableFileData);
+    tableFileData = NULL;
+  }
+  free(fd->data);
+  free(fd->filename);
+  free(fd->tablename);
+  free(fd);
+}
+
 static InterpolationTable* InterpolationTable_init(double time, double startTime,
                int ipoType, int expoType,
                const char* tableName, const char* fileName,
@@ -1052,11 +1216,14 @@ static InterpolationTable* InterpolationTable_init(double time, double startTime
 
     tpl->tablename = copyTableNameFile(tableName);
     tpl->filename = copyTableNameFile(fileName);
+    tpl->hash = hashTableName(fileName,tableName);
 
     if(fileName && strncmp("NoName",fileName,6) != 0)
     {
-      openFile(fileName,tableName,&(tpl->rows),&(tpl->cols),&(tpl->data));
-      tpl->own_data = 1;
+      tpl->fileData = TableFileData_acquire(fileName,tableName,tpl->hash);
+      tpl->data = tpl->fileData->data;
+      tpl->rows = tpl->fileData->rows;
+      tpl->cols = tpl->fileData->cols;
     } else
     {
 #ifndef COPY_ARRAYS
@@ -1091,13 +1258,32 @@ static void InterpolationTable_deinit(InterpolationTable *tpl)
   {
     if(tpl->own_data)
       free(tpl->data);
+    TableFileData_release(tpl->fileData);
+    free(tpl->filename);
+    free(tpl->tablename);
     free(tpl);
   }
 }
 
 static double InterpolationTable_interpolate(InterpolationTable *tpl, double time, size_t col)
 {
-  size_t i = 0;
+  return InterpolationTable_interpolateRow(tpl,time,InterpolationTable_findRow(tpl,time),col);
+}
+
+/* Returns the first row with a time greater than time, 0 if time is before
+ * the table and the number of rows if it is after the table. */
+static size_t InterpolationTable_findRow(InterpolationTable *tpl, double time)
+{
+  size_t lastIdx = tpl->colWise ? tpl->cols : tpl->rows;
+
+  if(!tpl->data || lastIdx == 1 || time < InterpolationTable_minTime(tpl))
+    return 0;
+  return findIndex(tpl->data,tpl->colWise ? 1 : tpl->cols,1,lastIdx,time,1,&tpl->lastRow);
+}
+
+/* Interpolate column col in the interval found by InterpolationTable_findRow */
+static double InterpolationTable_interpolateRow(InterpolationTable *tpl, double time, size_t i, size_t col)
+{
   size_t lastIdx = tpl->colWise ? tpl->cols : tpl->rows;
 
   if(!tpl->data) return 0.0;
@@ -1112,13 +1298,11 @@ static double InterpolationTable_interpolate(InterpolationTable *tpl, double tim
   if(time < InterpolationTable_minTime(tpl))
     return InterpolationTable_extrapolate(tpl,time,col,time <= InterpolationTable_minTime(tpl));
 
-  for(i = 0; i < lastIdx; ++i) {
-    if(InterpolationTable_getElt(tpl,i,0) > time) {
-      if(tpl->ipoType == 1 || lastIdx==2)
-        return InterpolationTable_interpolateLin(tpl,time, i-1,col);
-      else if(tpl->ipoType == 2){
-        return InterpolationTable_interpolateSpline(tpl,time, i-1,col);
-      }
+  if(i < lastIdx) {
+    if(tpl->ipoType == 1 || lastIdx==2)
+      return InterpolationTable_interpolateLin(tpl,time, i-1,col);
+    else if(tpl->ipoType == 2){
+      return InterpolationTable_interpolateSpline(tpl,time, i-1,col);
     }
   }
   return InterpolationTable_extrapolate(tpl,time,col,time <= InterpolationTable_minTime(tpl));
@@ -1134,17 +1318,19 @@ static double InterpolationTable_minTime(InterpolationTable *tpl)
 }
 
 static char InterpolationTable_compare(InterpolationTable *tpl, const char* fname, const char* tname,
-         const double* table)
+         const double* table, unsigned long hash, int ipoType, int expoType, double startTime, int colWise)
 {
-  if( (fname == NULL || tname == NULL) || ((strncmp("NoName",fname,6) == 0 && strncmp("NoName",tname,6) == 0)) )
+  if(isMemoryTable(fname,tname))
   {
     /* table passed as memory location */
     return (tpl->data == table);
   }
   else
   {
-    /* table loaded from file */
-    return ((!strncmp(tpl->filename,fname,6)) && (!strncmp(tpl->tablename,tname,6)));
+    /* table loaded from file, the data is shared by tables with other settings */
+    return (tpl->hash == hash && !strcmp(tpl->filename,fname) && !strcmp(tpl->tablename,tname) &&
+            tpl->ipoType == ipoType && tpl->expoType == expoType && tpl->startTime == startTime &&
+            tpl->colWise == colWise);
   }
 }
 
@@ -1321,11 +1507,14 @@ static InterpolationTable2D* InterpolationTable2D_init(int ipoType, const char*
 
     tpl->tablename = copyTableNameFile(tableName);
     tpl->filename = copyTableNameFile(fileName);
+    tpl->hash = hashTableName(fileName,tableName);
 
     if(fileName && strncmp("NoName",fileName,6) != 0)
     {
-      openFile(fileName,tableName,&(tpl->rows),&(tpl->cols),&(tpl->data));
-      tpl->own_data = 1;
+      tpl->fileData = TableFileData_acquire(fileName,tableName,tpl->hash);
+      tpl->data = tpl->fileData->data;
+      tpl->rows = tpl->fileData->rows;
+      tpl->cols = tpl->fileData->cols;
     } else {
 #ifndef COPY_ARRAYS
       if (!table) {
@@ -1358,6 +1547,9 @@ static void InterpolationTable2D_deinit(InterpolationTable2D *table)
   {
     if(table->own_data)
       free(table->data);
+    TableFileData_release(table->fileData);
+    free(table->filename);
+    free(table->tablename);
     free(table);
   }
 }
@@ -1539,8 +1731,7 @@ static double InterpolationTable2D_interpolate(InterpolationTable2D *table, doub
       return InterpolationTable2D_getElt(table,1,1);
     }
     /* find interval corresponding x1 */
-    for(i = 2; i < table->rows; ++i)
-      if(InterpolationTable2D_getElt(table,i,0) >= x1) break;
+    i = findIndex(table->data,table->cols,2,table->rows,x1,0,&table->lastRow);
     if((table->ipoType == 2) && (table->rows > 3))
     {
       /* smooth interpolation with Akima Splines such that der(y) is continuous */
@@ -1564,8 +1755,7 @@ static double InterpolationTable2D_interpolate(InterpolationTable2D *table, doub
   if(table->rows == 2)
   {
     /* find interval corresponding x2 */
-    for(j = 2; j < table->cols; ++j)
-      if(InterpolationTable2D_getElt(table,0,j) >= x2) break;
+    j = findIndex(table->data,1,2,table->cols,x2,0,&table->lastCol);
 
     if((table->ipoType == 2) && (table->cols > 3))
     {
@@ -1588,10 +1778,8 @@ static double InterpolationTable2D_interpolate(InterpolationTable2D *table, doub
   }
 
   /* find intervals corresponding x1 and x2 */
-  for(i = 2; i < table->rows-1; ++i)
-    if(InterpolationTable2D_getElt(table,i,0) >= x1) break;
-  for(j = 2; j < table->cols-1; ++j)
-    if(InterpolationTable2D_getElt(table,0,j) >= x2) break;
+  i = findIndex(table->data,table->cols,2,table->rows-1,x1,0,&table->lastRow);
+  j = findIndex(table->data,1,2,table->cols-1,x2,0,&table->lastCol);
 
   if((table->ipoType == 2) && (table->rows != 3) && (table->cols != 3)  )
   {
@@ -1641,17 +1829,19 @@ static double InterpolationTable2D_interpolate(InterpolationTable2D *table, doub
   return InterpolationTable2D_linInterpolate(x2,InterpolationTable2D_getElt(table,0,j-1),InterpolationTable2D_getElt(table,0,j),f_1,f_2);
 }
 
-static char InterpolationTable2D_compare(InterpolationTable2D *tpl, const char* fname, const char* tname, const double* table)
+static char InterpolationTable2D_compare(InterpolationTable2D *tpl, const char* fname, const char* tname, const double* table,
+         unsigned long hash, int ipoType, int colWise)
 {
-  if( (fname == NULL || tname == NULL) || ((strncmp("NoName",fname,6) == 0 && strncmp("NoName",tname,6) == 0)) )
+  if(isMemoryTable(fname,tname))
   {
     /* table passed as memory location */
     return (tpl->data == table);
   }
   else
   {
-    /* table loaded from file */
-    return ((!strncmp(tpl->filename,fname,6)) && (!strncmp(tpl->tablename,tname,6)));
+    /* table loaded from file, the data is shared by tables with other settings */
+    return (tpl->hash == hash && !strcmp(tpl->filename,fname) && !strcmp(tpl->tablename,tname) &&
+            tpl->ipoType == ipoType && tpl->colWise == colWise);
   }
   return 0;
 }
@@ -0,0 +1,61 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Tables of the Modelica Standard Library 2.x, called as external functions
+ * of old libraries. The parameters are documented in OldModelicaTables.c */
+
+#ifndef OLD_MODELICA_TABLES_H
+#define OLD_MODELICA_TABLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int omcTableTimeIni(double timeIn, double startTime, int ipoType, int expoType,
+        const char *tableName, const char* fileName,
+        const double *table, int tableDim1, int tableDim2, int colWise);
+void omcTableTimeIpoClose(int tableID);
+double omcTableTimeIpo(int tableID, int icol, double timeIn);
+/* Interpolates the ncols columns icols (numbered as in omcTableTimeIpo) at
+ * the same time into values; the interval is searched only once */
+void omcTableTimeIpoColumns(int tableID, int ncols, const int *icols, double timeIn, double *values);
+double omcTableTimeTmax(int tableID);
+double omcTableTimeTmin(int tableID);
+
+int omcTable2DIni(int ipoType, const char *tableName, const char* fileName,
+        const double *table, int tableDim1, int tableDim2, int colWise);
+void omcTable2DIpoClose(int tableID);
+double omcTable2DIpo(int tableID, double u1_, double u2_);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
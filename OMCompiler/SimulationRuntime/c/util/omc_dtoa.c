@@ -0,0 +1,361 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * Shortest round-trip formatting of doubles using the Grisu2 algorithm of
+ * Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+ * with Integers" (PLDI 2010). The digits always read back as the same double;
+ * in rare cases they are one digit longer than the shortest possible.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "omc_dtoa.h"
+
+typedef struct {
+  uint64_t f;
+  int e;
+} diy_fp;
+
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_EXPONENT_BIAS    (0x3FF + DP_SIGNIFICAND_SIZE)
+#define DP_MIN_EXPONENT     (-DP_EXPONENT_BIAS)
+#define DP_EXPONENT_MASK    UINT64_C(0x7FF0000000000000)
+#define DP_SIGNIFICAND_MASK UINT64_C(0x000FFFFFFFFFFFFF)
+#define DP_HIDDEN_BIT       UINT64_C(0x0010000000000000)
+
+/* 10^k for k = -348, -340, ..., 340 as normalized f*2^e */
+static const uint64_t cachedPowersF[] = {
+  UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x8b16fb203055ac76),
+  UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+  UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0xbe5691ef416bd60c),
+  UINT64_C(0x8dd01fad907ffc3c), UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+  UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d), UINT64_C(0x823c12795db6ce57),
+  UINT64_C(0xc21094364dfb5637), UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+  UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5), UINT64_C(0xb23867fb2a35b28e),
+  UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+  UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6), UINT64_C(0xf3e2f893dec3f126),
+  UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+  UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd), UINT64_C(0xa6dfbd9fb8e5b88f),
+  UINT64_C(0xf8a95fcf88747d94), UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+  UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac), UINT64_C(0xe45c10c42a2b3b06),
+  UINT64_C(0xaa242499697392d3), UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+  UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c), UINT64_C(0x9c40000000000000),
+  UINT64_C(0xe8d4a51000000000), UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+  UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70), UINT64_C(0xd5d238a4abe98068),
+  UINT64_C(0x9f4f2726179a2245), UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+  UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a), UINT64_C(0x924d692ca61be758),
+  UINT64_C(0xda01ee641a708dea), UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+  UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2), UINT64_C(0xc83553c5c8965d3d),
+  UINT64_C(0x952ab45cfa97a0b3), UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+  UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x88fcf317f22241e2),
+  UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+  UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0xbb764c4ca7a44410),
+  UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+  UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429), UINT64_C(0x80444b5e7aa7cf85),
+  UINT64_C(0xbf21e44003acdd2d), UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+  UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9), UINT64_C(0xaf87023b9bf0ee6b)
+};
+
+static const int16_t cachedPowersE[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+  -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+  -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+  -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+  -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+  109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+  375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+  641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+  907, 933, 960, 986, 1013, 1039, 1066
+};
+
+static const uint64_t pow10Table[] = {
+  UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000),
+  UINT64_C(100000), UINT64_C(1000000), UINT64_C(10000000), UINT64_C(100000000),
+  UINT64_C(1000000000), UINT64_C(10000000000), UINT64_C(100000000000),
+  UINT64_C(1000000000000), UINT64_C(10000000000000), UINT64_C(100000000000000),
+  UINT64_C(1000000000000000), UINT64_C(10000000000000000),
+  UINT64_C(100000000000000000), UINT64_C(1000000000000000000),
+  UINT64_C(10000000000000000000)
+};
+
+static diy_fp diy_fp_make(uint64_t f, int e)
+{
+  diy_fp r;
+  r.f = f;
+  r.e = e;
+  return r;
+}
+
+/* rounded upper 64 bits of the 128 bit product */
+static diy_fp diy_fp_mul(diy_fp x, diy_fp y)
+{
+  const uint64_t M32 = 0xFFFFFFFFu;
+  const uint64_t a = x.f >> 32, b = x.f & M32, c = y.f >> 32, d = y.f & M32;
+  const uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+  tmp += UINT64_C(1) << 31;
+  return diy_fp_make(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+static diy_fp diy_fp_normalize(diy_fp x)
+{
+  while (!(x.f & (UINT64_C(1) << 63))) {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+/* the neighbours m- and m+ halfway to the adjacent doubles, sharing the exponent of m+ */
+static void normalized_boundaries(diy_fp v, diy_fp *minus, diy_fp *plus)
+{
+  diy_fp pl = diy_fp_make((v.f << 1) + 1, v.e - 1);
+  diy_fp mi = (v.f == DP_HIDDEN_BIT) ? diy_fp_make((v.f << 2) - 1, v.e - 2) : diy_fp_make((v.f << 1) - 1, v.e - 1);
+
+  while (!(pl.f & (DP_HIDDEN_BIT << 1))) {
+    pl.f <<= 1;
+    pl.e--;
+  }
+  pl.f <<= 64 - DP_SIGNIFICAND_SIZE - 2;
+  pl.e -= 64 - DP_SIGNIFICAND_SIZE - 2;
+  mi.f <<= mi.e - pl.e;
+  mi.e = pl.e;
+  *minus = mi;
+  *plus = pl;
+}
+
+/* a cached power 10^-K such that the product with 2^e has a binary exponent in [-60,-32] */
+static diy_fp cached_power(int e, int *K)
+{
+  double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int k = (int) dk;
+  unsigned index;
+  if (dk - k > 0.0)
+    k++;
+  index = (unsigned) ((k >> 3) + 1);
+  *K = -(-348 + (int) (index << 3));
+  return diy_fp_make(cachedPowersF[index], cachedPowersE[index]);
+}
+
+static void grisu_round(char *buffer, int len, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t wp_w)
+{
+  while (rest < wp_w && delta - rest >= tenKappa &&
+         (rest + tenKappa < wp_w || wp_w - rest > rest + tenKappa - wp_w)) {
+    buffer[len - 1]--;
+    rest += tenKappa;
+  }
+}
+
+static int count_decimal_digits32(uint32_t n)
+{
+  int digits = 1;
+  while (n >= 10 && digits < 9) {
+    n /= 10;
+    digits++;
+  }
+  return digits;
+}
+
+static void digit_gen(diy_fp W, diy_fp Mp, uint64_t delta, char *buffer, int *len, int *K)
+{
+  const diy_fp one = diy_fp_make(UINT64_C(1) << -Mp.e, Mp.e);
+  const uint64_t wp_w = Mp.f - W.f;
+  uint32_t p1 = (uint32_t) (Mp.f >> -one.e);
+  uint64_t p2 = Mp.f & (one.f - 1);
+  int kappa = count_decimal_digits32(p1);
+
+  *len = 0;
+  while (kappa > 0) {
+    const uint32_t divisor = (uint32_t) pow10Table[kappa - 1];
+    const uint32_t d = p1 / divisor;
+    uint64_t tmp;
+    p1 %= divisor;
+    if (d || *len)
+      buffer[(*len)++] = (char) ('0' + d);
+    kappa--;
+    tmp = ((uint64_t) p1 << -one.e) + p2;
+    if (tmp <= delta) {
+      *K += kappa;
+      grisu_round(buffer, *len, delta, tmp, pow10Table[kappa] << -one.e, wp_w);
+      return;
+    }
+  }
+
+  for (;;) {
+    char d;
+    p2 *= 10;
+    delta *= 10;
+    d = (char) (p2 >> -one.e);
+    if (d || *len)
+      buffer[(*len)++] = (char) ('0' + d);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *K += kappa;
+      grisu_round(buffer, *len, delta, p2, one.f, -kappa < 20 ? wp_w * pow10Table[-kappa] : 0);
+      return;
+    }
+  }
+}
+
+/* digits and decimal exponent K of a finite, positive value: value = digits * 10^K */
+static void grisu2(double value, char *buffer, int *length, int *K)
+{
+  uint64_t u;
+  int biasedE;
+  uint64_t significand;
+  diy_fp v, w_m, w_p, c_mk, W, Wp, Wm;
+
+  memcpy(&u, &value, sizeof(u));
+  biasedE = (int) ((u & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE);
+  significand = u & DP_SIGNIFICAND_MASK;
+  if (biasedE != 0)
+    v = diy_fp_make(significand + DP_HIDDEN_BIT, biasedE - DP_EXPONENT_BIAS);
+  else
+    v = diy_fp_make(significand, DP_MIN_EXPONENT + 1);
+
+  normalized_boundaries(v, &w_m, &w_p);
+  c_mk = cached_power(w_p.e, K);
+  W = diy_fp_mul(diy_fp_normalize(v), c_mk);
+  Wp = diy_fp_mul(w_p, c_mk);
+  Wm = diy_fp_mul(w_m, c_mk);
+  Wm.f++;
+  Wp.f--;
+  digit_gen(W, Wp, Wp.f - Wm.f, buffer, length, K);
+}
+
+static int write_exponent(int K, char *buffer)
+{
+  int n = 0;
+  buffer[n++] = 'e';
+  if (K < 0) {
+    buffer[n++] = '-';
+    K = -K;
+  } else {
+    buffer[n++] = '+';
+  }
+  if (K >= 100) {
+    buffer[n++] = (char) ('0' + K / 100);
+    K %= 100;
+  }
+  buffer[n++] = (char) ('0' + K / 10);
+  buffer[n++] = (char) ('0' + K % 10);
+  return n;
+}
+
+/* lay out the digits like %.16g: positional for exponents in [-4,16), scientific otherwise */
+static int prettify(char *buffer, int length, int k)
+{
+  const int kk = length + k; /* 10^(kk-1) <= v < 10^kk */
+
+  if (kk >= length && kk <= 16) {
+    /* 1234e7 -> 12340000000 */
+    memset(buffer + length, '0', kk - length);
+    return kk;
+  } else if (kk > 0 && kk <= 16) {
+    /* 1234e-2 -> 12.34 */
+    memmove(buffer + kk + 1, buffer + kk, length - kk);
+    buffer[kk] = '.';
+    return length + 1;
+  } else if (kk > -4 && kk <= 0) {
+    /* 1234e-6 -> 0.001234 */
+    const int offset = 2 - kk;
+    memmove(buffer + offset, buffer, length);
+    buffer[0] = '0';
+    buffer[1] = '.';
+    memset(buffer + 2, '0', offset - 2);
+    return length + offset;
+  } else if (length == 1) {
+    /* 1e30 */
+    return 1 + write_exponent(kk - 1, buffer + 1);
+  } else {
+    /* 1234e30 -> 1.234e+33 */
+    memmove(buffer + 2, buffer + 1, length - 1);
+    buffer[1] = '.';
+    return length + 1 + write_exponent(kk - 1, buffer + length + 1);
+  }
+}
+
+int omc_dtoa(double value, char *buffer)
+{
+  int n = 0, length, K;
+
+  if (value != value) {
+    memcpy(buffer, "nan", 3);
+    return 3;
+  }
+  if (value < 0 || (value == 0 && 1 / value < 0)) {
+    buffer[n++] = '-';
+    value = -value;
+  }
+  if (value == 0) {
+    buffer[n++] = '0';
+    return n;
+  }
+  if (value > 1.7976931348623157e308) {
+    memcpy(buffer + n, "inf", 3);
+    return n + 3;
+  }
+  /* integral values are common in result files and need no digit search */
+  if (value < 1e15 && value == (double) (int64_t) value) {
+    uint64_t i = (uint64_t) value;
+    char tmp[20];
+    int len = 0;
+    do {
+      tmp[len++] = (char) ('0' + i % 10);
+      i /= 10;
+    } while (i);
+    while (len)
+      buffer[n++] = tmp[--len];
+    return n;
+  }
+
+  grisu2(value, buffer + n, &length, &K);
+  return n + prettify(buffer + n, length, K);
+}
+
+int omc_ltoa(long value, char *buffer)
+{
+  unsigned long u = value < 0 ? 0UL - (unsigned long) value : (unsigned long) value;
+  char tmp[24];
+  int n = 0, len = 0;
+
+  if (value < 0)
+    buffer[n++] = '-';
+  do {
+    tmp[len++] = (char) ('0' + u % 10);
+    u /= 10;
+  } while (u);
+  while (len)
+    buffer[n++] = tmp[--len];
+  return n;
+}
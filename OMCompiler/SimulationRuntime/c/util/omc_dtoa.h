@@ -0,0 +1,55 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#ifndef OMC_DTOA_H
+#define OMC_DTOA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Large enough for any number written by omc_dtoa or omc_ltoa */
+#define OMC_DTOA_BUFFER_SIZE 32
+
+/* Writes a round-trip exact decimal representation of value, i.e. strtod
+ * reads it back as the same double (Grisu2, mostly but not always the
+ * shortest one). The layout follows printf %.16g. Returns the number of
+ * characters written. buffer is not null-terminated. */
+int omc_dtoa(double value, char *buffer);
+
+/* Writes value in decimal and returns the number of characters written.
+ * buffer is not null-terminated. */
+int omc_ltoa(long value, char *buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
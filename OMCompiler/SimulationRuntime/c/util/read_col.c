@@ -0,0 +1,482 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <math.h>
+#include "read_col.h"
+#if defined(__MINGW32__) || defined(_MSC_VER)
+#include <windows.h>
+#endif
+
+/* Make Visual Studio not complain about deprecated items */
+#ifdef _MSC_VER
+#define strdup _strdup
+#endif
+
+#if defined(__MINGW32__) || defined(_MSC_VER)
+#define omc_col_fseek _fseeki64
+#else
+#define omc_col_fseek fseek
+#endif
+
+typedef struct {
+  const unsigned char *buf;
+  size_t size, pos;
+  uint64_t acc;
+  int nacc;
+} col_bit_reader;
+
+/* Reads n (1..64) bits, most significant first; reading past the end yields
+ * zero bits and is detected by the caller through pos */
+static uint64_t col_get_bits(col_bit_reader *r, int n)
+{
+  if (n > 32) {
+    uint64_t hi = col_get_bits(r, n-32);
+    return (hi << 32) | col_get_bits(r, 32);
+  }
+  while (r->nacc < n) {
+    r->acc = (r->acc << 8) | (r->pos < r->size ? r->buf[r->pos] : 0);
+    r->pos++;
+    r->nacc += 8;
+  }
+  r->nacc -= n;
+  return (r->acc >> r->nacc) & ((((uint64_t)1) << n) - 1);
+}
+
+int omc_col_decode(const unsigned char *block, size_t size, uint32_t n, double *vals)
+{
+  col_bit_reader r;
+  uint64_t prev, prev2, pred, x;
+  int lead = -1, sig = 0, trail = 0;
+  uint32_t i;
+  double d;
+
+  if (size < 1) return 1;
+  switch (block[0]) {
+  case OMC_COL_RAW:
+    if (size != 1 + (size_t)n*sizeof(double)) return 1;
+    memcpy(vals, block+1, (size_t)n*sizeof(double));
+    return 0;
+  case OMC_COL_CONSTANT:
+    if (size != 1 + sizeof(double)) return 1;
+    memcpy(&d, block+1, sizeof(double));
+    for (i=0; i<n; i++) {
+      vals[i] = d;
+    }
+    return 0;
+  case OMC_COL_XOR:
+  case OMC_COL_XOR_LINEAR:
+    if (n == 0) return 0;
+    r.buf = block+1;
+    r.size = size-1;
+    r.pos = 0;
+    r.acc = 0;
+    r.nacc = 0;
+    prev = col_get_bits(&r, 64);
+    prev2 = prev;
+    memcpy(vals, &prev, sizeof(double));
+    for (i=1; i<n; i++) {
+      pred = (block[0] == OMC_COL_XOR_LINEAR && i >= 2) ? 2*prev - prev2 : prev;
+      if (!col_get_bits(&r, 1)) {
+        x = 0;
+      } else if (!col_get_bits(&r, 1)) {
+        /* reuse the window of the previous value */
+        if (lead < 0) return 1;
+        x = col_get_bits(&r, sig) << trail;
+      } else {
+        lead = (int) col_get_bits(&r, 5);
+        sig = (int) col_get_bits(&r, 6) + 1;
+        if (lead + sig > 64) return 1;
+        trail = 64 - lead - sig;
+        x = col_get_bits(&r, sig) << trail;
+      }
+      prev2 = prev;
+      prev = pred ^ x;
+      memcpy(vals+i, &prev, sizeof(double));
+    }
+    return r.pos > r.size ? 1 : 0;
+  default:
+    return 1;
+  }
+}
+
+static int col_read(void *ptr, size_t size, FILE *file)
+{
+  return size != fread(ptr, 1, size, file);
+}
+
+static char* col_read_string(FILE *file)
+{
+  uint32_t len;
+  char *str;
+  if (col_read(&len, sizeof(uint32_t), file)) return NULL;
+  str = (char*) malloc(len+1);
+  if (!str) return NULL;
+  if (col_read(str, len, file)) {
+    free(str);
+    return NULL;
+  }
+  str[len] = '\0';
+  return str;
+}
+
+static const char* col_read_footer(ModelicaColReader *reader)
+{
+  FILE *file = reader->file;
+  uint32_t i, j;
+  int32_t info[2];
+  size_t maxSize = 0;
+  uint32_t maxRows = 0;
+
+  if (col_read(&reader->nvar, sizeof(uint32_t), file) ||
+      col_read(&reader->nparam, sizeof(uint32_t), file) ||
+      col_read(&reader->nall, sizeof(uint32_t), file)) {
+    return "Corrupt footer: sizes";
+  }
+  if (reader->nvar < 1) return "Corrupt footer: no time column";
+
+  reader->params = (double*) malloc((reader->nparam+1)*sizeof(double));
+  reader->allInfo = (ModelicaMatVariable_t*) calloc(reader->nall+1, sizeof(ModelicaMatVariable_t));
+  if (!reader->params || !reader->allInfo) return "Out of memory";
+  if (col_read(reader->params, reader->nparam*sizeof(double), file)) return "Corrupt footer: parameters";
+
+  for (i=0; i<reader->nall; i++) {
+    ModelicaMatVariable_t *var = reader->allInfo+i;
+    if (!(var->name = col_read_string(file)) || !(var->descr = col_read_string(file)) ||
+        col_read(info, sizeof(info), file)) {
+      /* keep nall consistent with the allocated names for omc_free_col_reader */
+      reader->nall = var->name ? i+1 : i;
+      return "Corrupt footer: variables";
+    }
+    var->isParam = info[0];
+    var->index = info[1];
+    if (info[1] == 0 || (uint32_t) abs(info[1]) > (info[0] ? reader->nparam : reader->nvar)) {
+      reader->nall = i+1;
+      return "Corrupt footer: variable index out of bounds";
+    }
+  }
+  qsort(reader->allInfo, reader->nall, sizeof(ModelicaMatVariable_t), omc_matlab4_comp_var);
+
+  if (col_read(&reader->nchunks, sizeof(uint32_t), file)) return "Corrupt footer: chunks";
+  reader->chunks = (ModelicaColChunk*) calloc(reader->nchunks+1, sizeof(ModelicaColChunk));
+  if (!reader->chunks) return "Out of memory";
+  reader->nrows = 0;
+  for (i=0; i<reader->nchunks; i++) {
+    ModelicaColChunk *chunk = reader->chunks+i;
+    chunk->offset = (uint64_t*) malloc(reader->nvar*sizeof(uint64_t));
+    chunk->size = (uint32_t*) malloc(reader->nvar*sizeof(uint32_t));
+    if (!chunk->offset || !chunk->size) return "Out of memory";
+    if (col_read(&chunk->nrows, sizeof(uint32_t), file) ||
+        col_read(&chunk->startTime, sizeof(double), file) ||
+        col_read(&chunk->stopTime, sizeof(double), file) || chunk->nrows == 0) {
+      return "Corrupt footer: chunk";
+    }
+    for (j=0; j<reader->nvar; j++) {
+      if (col_read(chunk->offset+j, sizeof(uint64_t), file) || col_read(chunk->size+j, sizeof(uint32_t), file)) {
+        return "Corrupt footer: chunk";
+      }
+      if (chunk->size[j] > maxSize) maxSize = chunk->size[j];
+    }
+    reader->nrows += chunk->nrows;
+    if (chunk->nrows > maxRows) maxRows = chunk->nrows;
+  }
+
+  reader->vars = (double**) calloc(reader->nvar*2, sizeof(double*));
+  reader->block = (unsigned char*) malloc(maxSize+1);
+  reader->blockSize = maxSize;
+  reader->timeChunk = (double*) malloc((maxRows+1)*sizeof(double));
+  reader->timeChunkIndex = -1;
+  if (!reader->vars || !reader->block || !reader->timeChunk) return "Out of memory";
+  return 0;
+}
+
+const char* omc_new_col_reader(const char *filename, ModelicaColReader *reader)
+{
+  char magic[8];
+  uint32_t header[2];
+  uint64_t footerOffset;
+  const char *msg;
+  memset(reader, 0, sizeof(ModelicaColReader));
+#if defined(__MINGW32__) || defined(_MSC_VER)
+  {
+    int unicodeFilenameLength = MultiByteToWideChar(CP_UTF8, 0, filename, -1, NULL, 0);
+    wchar_t *unicodeFilename = (wchar_t*) malloc(unicodeFilenameLength*sizeof(wchar_t));
+    MultiByteToWideChar(CP_UTF8, 0, filename, -1, unicodeFilename, unicodeFilenameLength);
+    reader->file = _wfopen(unicodeFilename, L"rb");
+    free(unicodeFilename);
+  }
+#else
+  reader->file = fopen(filename, "rb");
+#endif
+  if (!reader->file) return strerror(errno);
+  reader->fileName = strdup(filename);
+
+  if (col_read(magic, 8, reader->file) || col_read(header, sizeof(header), reader->file) ||
+      memcmp(magic, OMC_COL_MAGIC, 8)) {
+    msg = "Not a columnar result file";
+  } else if (header[0] != OMC_COL_ENDIAN_TAG) {
+    msg = "The result file was written with a different byte order";
+  } else if (omc_col_fseek(reader->file, -(long)(sizeof(uint64_t)+8), SEEK_END) ||
+             col_read(&footerOffset, sizeof(uint64_t), reader->file) ||
+             col_read(magic, 8, reader->file) || memcmp(magic, OMC_COL_MAGIC, 8)) {
+    msg = "The result file has no footer (the simulation did not finish)";
+  } else if (omc_col_fseek(reader->file, footerOffset, SEEK_SET)) {
+    msg = "Corrupt footer offset";
+  } else {
+    msg = col_read_footer(reader);
+  }
+  if (msg) {
+    omc_free_col_reader(reader);
+  }
+  return msg;
+}
+
+void omc_free_col_reader(ModelicaColReader *reader)
+{
+  uint32_t i;
+  if (reader->file) {
+    fclose(reader->file);
+    reader->file = NULL;
+  }
+  if (reader->fileName) {
+    free(reader->fileName);
+    reader->fileName = NULL;
+  }
+  if (reader->allInfo) {
+    for (i=0; i<reader->nall; i++) {
+      free(reader->allInfo[i].name);
+      free(reader->allInfo[i].descr);
+    }
+    free(reader->allInfo);
+    reader->allInfo = NULL;
+  }
+  reader->nall = 0;
+  if (reader->params) {
+    free(reader->params);
+    reader->params = NULL;
+  }
+  if (reader->chunks) {
+    for (i=0; i<reader->nchunks; i++) {
+      free(reader->chunks[i].offset);
+      free(reader->chunks[i].size);
+    }
+    free(reader->chunks);
+    reader->chunks = NULL;
+  }
+  reader->nchunks = 0;
+  if (reader->vars) {
+    for (i=0; i<reader->nvar*2; i++) {
+      free(reader->vars[i]);
+    }
+    free(reader->vars);
+    reader->vars = NULL;
+  }
+  if (reader->block) {
+    free(reader->block);
+    reader->block = NULL;
+  }
+  if (reader->timeChunk) {
+    free(reader->timeChunk);
+    reader->timeChunk = NULL;
+  }
+}
+
+ModelicaMatVariable_t *omc_col_find_var(ModelicaColReader *reader, const char *varName)
+{
+  ModelicaMatVariable_t key;
+  ModelicaMatVariable_t *res;
+  char *name;
+
+  key.name = (char*) varName;
+  res = (ModelicaMatVariable_t*) bsearch(&key, reader->allInfo, reader->nall, sizeof(ModelicaMatVariable_t), omc_matlab4_comp_var);
+  if (res == NULL) {
+    if (0==strcmp(varName, "Time")) {
+      key.name = (char*) "time";
+      return (ModelicaMatVariable_t*) bsearch(&key, reader->allInfo, reader->nall, sizeof(ModelicaMatVariable_t), omc_matlab4_comp_var);
+    }
+    name = openmodelicaStyleVariableName(varName);
+    if (name == NULL) {
+      return NULL;
+    }
+    key.name = name;
+    res = (ModelicaMatVariable_t*) bsearch(&key, reader->allInfo, reader->nall, sizeof(ModelicaMatVariable_t), omc_matlab4_comp_var);
+    free(name);
+  }
+  return res;
+}
+
+int omc_col_read_chunk(ModelicaColReader *reader, uint32_t chunk, uint32_t column, double *vals)
+{
+  const ModelicaColChunk *c;
+  if (chunk >= reader->nchunks || column < 1 || column > reader->nvar) return 1;
+  c = reader->chunks + chunk;
+  if (omc_col_fseek(reader->file, c->offset[column-1], SEEK_SET) ||
+      col_read(reader->block, c->size[column-1], reader->file)) {
+    return 1;
+  }
+  return omc_col_decode(reader->block, c->size[column-1], c->nrows, vals);
+}
+
+double* omc_col_read_vals(ModelicaColReader *reader, int varIndex)
+{
+  size_t absVarIndex = abs(varIndex);
+  size_t ix = (varIndex < 0 ? absVarIndex + reader->nvar : absVarIndex) - 1;
+  double *vals;
+  uint32_t i, row;
+
+  if (absVarIndex < 1 || absVarIndex > reader->nvar) return NULL;
+  if (reader->vars[ix]) return reader->vars[ix];
+
+  vals = (double*) malloc((reader->nrows+1)*sizeof(double));
+  if (!vals) return NULL;
+  if (varIndex < 0 && reader->vars[absVarIndex-1]) {
+    memcpy(vals, reader->vars[absVarIndex-1], reader->nrows*sizeof(double));
+  } else {
+    for (i=0, row=0; i<reader->nchunks; i++) {
+      if (omc_col_read_chunk(reader, i, absVarIndex, vals+row)) {
+        free(vals);
+        return NULL;
+      }
+      row += reader->chunks[i].nrows;
+    }
+  }
+  if (varIndex < 0) {
+    for (i=0; i<reader->nrows; i++) {
+      vals[i] = -vals[i];
+    }
+  }
+  reader->vars[ix] = vals;
+  return vals;
+}
+
+double omc_col_startTime(ModelicaColReader *reader)
+{
+  return reader->nchunks ? reader->chunks[0].startTime : NAN;
+}
+
+double omc_col_stopTime(ModelicaColReader *reader)
+{
+  return reader->nchunks ? reader->chunks[reader->nchunks-1].stopTime : NAN;
+}
+
+/* Values of a column in the given chunk, from the cache if the whole column
+ * was read already; buf must hold the rows of the chunk. The time values of
+ * the last chunk are kept since lookups tend to hit the same chunk. */
+static const double* col_chunk_vals(ModelicaColReader *reader, uint32_t chunk, uint32_t column, double *buf)
+{
+  uint32_t i, row = 0;
+  if (reader->vars[column-1]) {
+    for (i=0; i<chunk; i++) {
+      row += reader->chunks[i].nrows;
+    }
+    return reader->vars[column-1] + row;
+  }
+  if (column == 1) {
+    if (reader->timeChunkIndex != (int) chunk) {
+      reader->timeChunkIndex = -1;
+      if (omc_col_read_chunk(reader, chunk, 1, reader->timeChunk)) return NULL;
+      reader->timeChunkIndex = chunk;
+    }
+    return reader->timeChunk;
+  }
+  return omc_col_read_chunk(reader, chunk, column, buf) ? NULL : buf;
+}
+
+int omc_col_val(double *res, ModelicaColReader *reader, ModelicaMatVariable_t *var, double time)
+{
+  uint32_t lo, hi, chunk, n, column;
+  int i1, i2;
+  double *vbuf, w1;
+  const double *t, *v;
+  int ret = 1;
+
+  *res = NAN;
+  if (var->isParam) {
+    *res = var->index < 0 ? -reader->params[-var->index-1] : reader->params[var->index-1];
+    return 0;
+  }
+  if (!reader->nchunks || time < omc_col_startTime(reader) || time > omc_col_stopTime(reader)) {
+    return 1;
+  }
+  /* last chunk starting at or before time; for events the right limit is used */
+  lo = 0;
+  hi = reader->nchunks;
+  while (hi - lo > 1) {
+    uint32_t mid = lo + (hi-lo)/2;
+    if (reader->chunks[mid].startTime <= time) lo = mid; else hi = mid;
+  }
+  chunk = lo;
+  n = reader->chunks[chunk].nrows;
+  column = abs(var->index);
+
+  vbuf = (double*) malloc(n*sizeof(double));
+  if (!vbuf || !(t = col_chunk_vals(reader, chunk, 1, NULL))) {
+    goto done;
+  }
+  /* last row i1 with t[i1] <= time */
+  lo = 0;
+  hi = n;
+  while (hi - lo > 1) {
+    uint32_t mid = lo + (hi-lo)/2;
+    if (t[mid] <= time) lo = mid; else hi = mid;
+  }
+  i1 = lo;
+  if (t[i1] == time || i1+1 == (int)n) {
+    if (t[i1] != time) {
+      /* between the last row of this chunk and the first row of the next one */
+      double tNext = reader->chunks[chunk+1].startTime;
+      double y1, y2;
+      if (!(v = col_chunk_vals(reader, chunk, column, vbuf))) goto done;
+      y1 = v[i1];
+      w1 = (tNext - time) / (tNext - t[i1]);
+      free(vbuf);
+      vbuf = (double*) malloc(reader->chunks[chunk+1].nrows*sizeof(double));
+      if (!vbuf || !(v = col_chunk_vals(reader, chunk+1, column, vbuf))) goto done;
+      y2 = v[0];
+      *res = w1*y1 + (1.0-w1)*y2;
+    } else {
+      if (!(v = col_chunk_vals(reader, chunk, column, vbuf))) goto done;
+      *res = v[i1];
+    }
+  } else {
+    i2 = i1+1;
+    if (!(v = col_chunk_vals(reader, chunk, column, vbuf))) goto done;
+    w1 = (t[i2] - time) / (t[i2] - t[i1]);
+    *res = w1*v[i1] + (1.0-w1)*v[i2];
+  }
+  if (var->index < 0) *res = -*res;
+  ret = 0;
+done:
+  free(vbuf);
+  return ret;
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#ifndef OMC_READ_COL_H
+#define OMC_READ_COL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "read_matlab4.h"
+
+/* Chunked columnar result file (outputFormat=col).
+ *
+ * Layout (native byte order, checked through the endian tag):
+ *   header  : magic[8] "OMCCOL1", uint32 endian tag, uint32 rows per chunk
+ *   chunks  : one compressed block per column and chunk
+ *   footer  : uint32 nvar, nparam, nall; double params[nparam];
+ *             nall x (uint32 len, name, uint32 len, descr, int32 isParam, int32 index);
+ *             uint32 nchunks; nchunks x (uint32 nrows, double start, double stop,
+ *                                         nvar x (uint64 offset, uint32 size))
+ *   trailer : uint64 footer offset, magic[8]
+ *
+ * Column 1 is time. Variables use the ModelicaMatVariable_t conventions of
+ * the MAT v4 reader: index is the 1-based column (or parameter) and negative
+ * for negated aliases.
+ *
+ * Every block starts with one codec byte followed by the encoded values. */
+#define OMC_COL_MAGIC "OMCCOL1"
+#define OMC_COL_ENDIAN_TAG 0x01020304u
+
+enum omc_col_codec {
+  OMC_COL_RAW = 0,      /* nrows doubles */
+  OMC_COL_CONSTANT = 1, /* one double repeated nrows times */
+  OMC_COL_XOR = 2,      /* bit stream of the XOR with the previous value */
+  OMC_COL_XOR_LINEAR = 3 /* bit stream of the XOR with the linear extrapolation of the bit patterns */
+};
+
+typedef struct {
+  uint32_t nrows;
+  double startTime, stopTime;
+  uint64_t *offset; /* nvar block offsets */
+  uint32_t *size; /* nvar block sizes */
+} ModelicaColChunk;
+
+typedef struct {
+  FILE *file;
+  char *fileName;
+  uint32_t nall;
+  ModelicaMatVariable_t *allInfo; /* Sorted array of variables and their associated information */
+  uint32_t nparam;
+  double *params; /* This has size nparam */
+  uint32_t nvar, nrows;
+  uint32_t nchunks;
+  ModelicaColChunk *chunks;
+  double **vars; /* nvar variables followed by their nvar negated aliases; filled on request */
+  unsigned char *block; /* scratch buffer for one compressed block */
+  size_t blockSize;
+  double *timeChunk; /* decoded time values of chunk timeChunkIndex, for omc_col_val */
+  int timeChunkIndex;
+} ModelicaColReader;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns 0 on success; the error message on error.
+ * The internal data is free'd by omc_free_col_reader. */
+const char* omc_new_col_reader(const char *filename, ModelicaColReader *reader);
+
+void omc_free_col_reader(ModelicaColReader *reader);
+
+/* Returns a variable or NULL */
+ModelicaMatVariable_t *omc_col_find_var(ModelicaColReader *reader, const char *varName);
+
+/* Returns all nrows values of a variable (var->index of a non-parameter) or
+ * NULL. The returned data persists until the reader is closed. */
+double* omc_col_read_vals(ModelicaColReader *reader, int varIndex);
+
+/* Decodes the values of one column in one chunk into vals (chunk nrows
+ * values); only this block is read from the file. Returns 0 on success */
+int omc_col_read_chunk(ModelicaColReader *reader, uint32_t chunk, uint32_t column, double *vals);
+
+/* Interpolates a variable at the given time; decodes only the chunks around
+ * the time point unless the columns are already cached. Returns 0 on success */
+int omc_col_val(double *res, ModelicaColReader *reader, ModelicaMatVariable_t *var, double time);
+
+double omc_col_startTime(ModelicaColReader *reader);
+double omc_col_stopTime(ModelicaColReader *reader);
+
+/* Decodes a block of n values produced by the result writer.
+ * Returns 0 on success */
+int omc_col_decode(const unsigned char *block, size_t size, uint32_t n, double *vals);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -108,6 +108,12 @@ int mat_element_length(int type)
   }
 }
 
+/* Variables pointing into allVals are not allocated on their own */
+static int mat4_in_all_vals(ModelicaMatReader *reader, const double *vals)
+{
+  return vals && reader->allVals && !reader->allValsSingle && vals >= (double*)reader->allVals && vals < ((double*)reader->allVals) + (size_t)reader->nvar*reader->nrows;
+}
+
 /* Do not double-free this :) */
 void omc_free_matlab4_reader(ModelicaMatReader *reader)
 {
@@ -125,7 +131,7 @@ void omc_free_matlab4_reader(ModelicaMatReader *reader)
     free(reader->allInfo[i].descr);
   }
   reader->nall = 0;
-  if (reader->file) {
+  if (reader->allInfo) {
     free(reader->allInfo);
     reader->allInfo=NULL;
   }
@@ -133,14 +139,20 @@ void omc_free_matlab4_reader(ModelicaMatReader *reader)
     free(reader->params);
     reader->params=NULL;
   }
-  for(i=0; i<reader->nvar*2; i++) {
-    if (reader->vars[i]) free(reader->vars[i]);
-  }
-  reader->nvar = 0;
   if (reader->vars) {
+    for(i=0; i<reader->nvar*2; i++) {
+      if (!mat4_in_all_vals(reader, reader->vars[i])) {
+        free(reader->vars[i]);
+      }
+    }
     free(reader->vars);
     reader->vars=NULL;
   }
+  reader->nvar = 0;
+  if (reader->allVals) {
+    free(reader->allVals);
+    reader->allVals=NULL;
+  }
 }
 
 void remSpaces(char *ch){
@@ -462,7 +474,7 @@ const char* omc_new_matlab4_reader(const char *filename, ModelicaMatReader *read
         if(-1==fseek(reader->file,matrix_length,SEEK_CUR)) return "Corrupt header: data_2 matrix";
       }
       if(binTrans==0) {
-        unsigned int k,j;
+        unsigned int k;
         reader->nrows = hdr.mrows;
         /* Allow empty matrix; it's not a complete file, but ok... */
         /* if(reader->nrows < 2) return "Too few rows in data_2 matrix"; */
@@ -476,19 +488,12 @@ const char* omc_new_matlab4_reader(const char *filename, ModelicaMatReader *read
         if (read_double(hdr.type, hdr.mrows*hdr.ncols, reader->file, tmp)) {
           return "Corrupt header: data_2 matrix";
         }
+        /* binNormal is already stored variable by variable; keep it as allVals */
+        reader->allVals = tmp;
         for(k=0; k<hdr.ncols; k++) {
-          reader->vars[k] = (double*) malloc(hdr.mrows*sizeof(double));
-          for(j=0; j<hdr.mrows; j++) {
-            reader->vars[k][j] = tmp[j+k*hdr.mrows];
-          }
+          reader->vars[k] = tmp + (size_t)k*hdr.mrows;
         }
-        for(k=reader->nvar; k<reader->nvar*2; k++) {
-          reader->vars[k] = (double*) malloc(hdr.mrows*sizeof(double));
-          for(j=0; j<hdr.mrows; j++) {
-            reader->vars[k][j] = -reader->vars[k-reader->nvar][j];
-          }
-        }
-        free(tmp);
+        reader->readAll = 1;
 
         if(-1==fseek(reader->file,matrix_length,SEEK_CUR)) return "Corrupt header: data_2 matrix";
       }
@@ -580,6 +585,233 @@ ModelicaMatVariable_t *omc_matlab4_find_var(ModelicaMatReader *reader, const cha
   return res;
 }
 
+/* Read data_2 in blocks of roughly this many bytes */
+#define OMC_MAT4_BLOCK_SIZE (1<<22)
+/* If the gap between the requested columns of two consecutive rows is larger
+ * than this, seek to each row instead of streaming over the gap */
+#define OMC_MAT4_SEEK_GAP (1<<16)
+
+static OMC_INLINE double mat4_elem(const char *buf, size_t i, int doublePrecision)
+{
+  return doublePrecision ? ((const double*)buf)[i] : (double) ((const float*)buf)[i];
+}
+
+typedef void (*mat4_rows_fn)(ModelicaMatReader *reader, const char *buf, size_t firstRow, size_t nrows, void *data);
+
+/* Streams over all rows of data_2, many rows per fread, and hands each block
+ * of rows to fn. Returns 0 on success */
+static int mat4_stream_rows(ModelicaMatReader *reader, mat4_rows_fn fn, void *data)
+{
+  size_t elsize = reader->doublePrecision==1 ? sizeof(double) : sizeof(float);
+  size_t nvar = reader->nvar, nrows = reader->nrows;
+  size_t i, rowsPerBlock = OMC_MAT4_BLOCK_SIZE / (nvar*elsize);
+  char *buf;
+  if (rowsPerBlock == 0) {
+    rowsPerBlock = 1;
+  }
+  if (rowsPerBlock > nrows) {
+    rowsPerBlock = nrows;
+  }
+  if (fseek(reader->file, reader->var_offset, SEEK_SET)) {
+    return 1;
+  }
+  buf = (char*) malloc(rowsPerBlock*nvar*elsize);
+  if (!buf) {
+    return 1;
+  }
+  for (i=0; i<nrows; i+=rowsPerBlock) {
+    size_t nread = nrows - i < rowsPerBlock ? nrows - i : rowsPerBlock;
+    if (nread*nvar != fread(buf, elsize, nread*nvar, reader->file)) {
+      free(buf);
+      return 1;
+    }
+    fn(reader, buf, i, nread, data);
+  }
+  free(buf);
+  return 0;
+}
+
+typedef struct {
+  const uint32_t *cols;
+  size_t ncols;
+} mat4_cols_t;
+
+static void mat4_gather_cols(ModelicaMatReader *reader, const char *buf, size_t firstRow, size_t nrows, void *data)
+{
+  const mat4_cols_t *c = (const mat4_cols_t*) data;
+  size_t j, k;
+  for (j=0; j<nrows; j++) {
+    for (k=0; k<c->ncols; k++) {
+      reader->vars[c->cols[k]][firstRow+j] = mat4_elem(buf, j*reader->nvar + c->cols[k], reader->doublePrecision);
+    }
+  }
+}
+
+/* Reads the variables with the given (signed) indices in a single pass over
+ * data_2 and stores them in reader->vars.
+ * Returns 0 on success */
+int omc_matlab4_read_vars(ModelicaMatReader *reader, const int *indices, int n)
+{
+  size_t elsize = reader->doublePrecision==1 ? sizeof(double) : sizeof(float);
+  size_t nvar = reader->nvar, nrows = reader->nrows;
+  size_t i, j, k, ncols = 0, minCol, maxCol, span;
+  uint32_t *cols;
+  int err = 0;
+
+  if (0 == nrows || 0 == n) {
+    return 0;
+  }
+  /* Collect the columns that are not read yet, in file order */
+  cols = (uint32_t*) calloc(nvar, sizeof(uint32_t));
+  for (i=0; i<n; i++) {
+    size_t col = abs(indices[i]) - 1;
+    assert(abs(indices[i]) > 0 && col < nvar);
+    if (!reader->vars[col] && !reader->vars[col+nvar] && !reader->allValsSingle) {
+      cols[col] = 1;
+    }
+  }
+  for (i=0; i<nvar; i++) {
+    if (cols[i]) {
+      cols[ncols++] = i;
+    }
+  }
+  if (ncols) {
+    minCol = cols[0];
+    maxCol = cols[ncols-1];
+    span = maxCol - minCol + 1;
+    for (k=0; k<ncols; k++) {
+      reader->vars[cols[k]] = (double*) malloc(nrows*sizeof(double));
+    }
+    if ((nvar - span)*elsize > OMC_MAT4_SEEK_GAP) {
+      /* Wide rows; read only the span of the requested columns in each row */
+      char *buf = (char*) malloc(span*elsize);
+      for (i=0; i<nrows; i++) {
+        if (fseek(reader->file, reader->var_offset + elsize*(i*nvar + minCol), SEEK_SET) ||
+            1 != fread(buf, span*elsize, 1, reader->file)) {
+          err = 1;
+          break;
+        }
+        for (k=0; k<ncols; k++) {
+          reader->vars[cols[k]][i] = mat4_elem(buf, cols[k]-minCol, reader->doublePrecision);
+        }
+      }
+      free(buf);
+    } else {
+      mat4_cols_t c;
+      c.cols = cols;
+      c.ncols = ncols;
+      err = mat4_stream_rows(reader, mat4_gather_cols, &c);
+    }
+    if (err) {
+      for (k=0; k<ncols; k++) {
+        free(reader->vars[cols[k]]);
+        reader->vars[cols[k]] = NULL;
+      }
+      free(cols);
+      return 1;
+    }
+  }
+  free(cols);
+  /* Derive the requested variables of the other sign from what is loaded */
+  for (i=0; i<n; i++) {
+    size_t col = abs(indices[i]) - 1;
+    size_t ix = indices[i] < 0 ? col + nvar : col;
+    size_t other = indices[i] < 0 ? col : col + nvar;
+    double sign = indices[i] < 0 ? -1.0 : 1.0;
+    if (!reader->vars[ix]) {
+      reader->vars[ix] = (double*) malloc(nrows*sizeof(double));
+      if (reader->vars[other]) {
+        for (j=0; j<nrows; j++) {
+          reader->vars[ix][j] = -reader->vars[other][j];
+        }
+      } else {
+        const float *fvals = ((const float*) reader->allVals) + col*nrows;
+        for (j=0; j<nrows; j++) {
+          reader->vars[ix][j] = sign*fvals[j];
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+/* Frees the cached values of the given variables and their negated aliases.
+ * Values that are part of allVals stay; the others are read again on the
+ * next request */
+void omc_matlab4_release_vars(ModelicaMatReader *reader, const int *indices, int n)
+{
+  size_t nvar = reader->nvar;
+  int i, k;
+  for (i=0; i<n; i++) {
+    size_t col = abs(indices[i]) - 1;
+    assert(abs(indices[i]) > 0 && col < nvar);
+    for (k=0; k<2; k++) {
+      double **vals = reader->vars + col + k*nvar;
+      if (*vals && !mat4_in_all_vals(reader, *vals)) {
+        free(*vals);
+        *vals = NULL;
+        reader->readAll = 0;
+      }
+    }
+  }
+}
+
+int omc_matlab4_var_view(ModelicaMatReader *reader, int varIndex, ModelicaMatVarView *view)
+{
+  int absVarIndex = abs(varIndex);
+  size_t col = absVarIndex - 1;
+  assert(absVarIndex > 0 && col < reader->nvar);
+  view->n = reader->nrows;
+  view->sign = varIndex < 0 ? -1.0 : 1.0;
+  view->vals = NULL;
+  view->fvals = NULL;
+  if (0 == reader->nrows) {
+    return 1;
+  }
+  if (reader->allValsSingle) {
+    view->fvals = ((const float*) reader->allVals) + col*reader->nrows;
+    return 0;
+  }
+  if (!reader->vars[col] && omc_matlab4_read_vars(reader, &absVarIndex, 1)) {
+    return 1;
+  }
+  view->vals = reader->vars[col];
+  return 0;
+}
+
+/* Reads all values of one time point (row of data_2) into row, which must
+ * have room for reader->nvar values.
+ * Returns 0 on success */
+int omc_matlab4_read_row(ModelicaMatReader *reader, int timeIndex, double *row)
+{
+  size_t i;
+  if (timeIndex < 0 || timeIndex >= reader->nrows) {
+    return 1;
+  }
+  /* binNormal files are loaded on opening and data_2 in the file is stored
+   * variable by variable, so take the row from the loaded values */
+  if (reader->readAll) {
+    for (i=0; i<reader->nvar; i++) {
+      row[i] = reader->allValsSingle ? (double) ((const float*) reader->allVals)[i*reader->nrows + timeIndex] : reader->vars[i][timeIndex];
+    }
+    return 0;
+  }
+  if (fseek(reader->file, reader->var_offset + (reader->doublePrecision==1 ? sizeof(double) : sizeof(float))*((size_t)timeIndex*reader->nvar), SEEK_SET)) {
+    return 1;
+  }
+  if (reader->doublePrecision==1) {
+    return reader->nvar != fread(row, sizeof(double), reader->nvar, reader->file);
+  }
+  /* Read the floats into the upper half of row and widen them in place */
+  if (reader->nvar != fread(((float*)row) + reader->nvar, sizeof(float), reader->nvar, reader->file)) {
+    return 1;
+  }
+  for (i=0; i<reader->nvar; i++) {
+    row[i] = ((float*)row)[reader->nvar + i];
+  }
+  return 0;
+}
+
 /* Writes the number of values in the returned array if nvals is non-NULL */
 double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
 {
@@ -589,51 +821,9 @@ double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex)
   if (0 == reader->nrows) {
     return NULL;
   } else if(!reader->vars[ix]) {
-    unsigned int i;
-    double *tmp = (double*) malloc(reader->nrows*sizeof(double));
-    if(reader->doublePrecision==1)
-    {
-      for(i=0; i<reader->nrows; i++) {
-        fseek(reader->file,reader->var_offset + sizeof(double)*(i*reader->nvar + absVarIndex-1), SEEK_SET);
-        if(1 != fread(&tmp[i], sizeof(double), 1, reader->file)) {
-          /* fprintf(stderr, "Corrupt file at %d of %d? nvar %d\n", i, reader->nrows, reader->nvar); */
-          free(tmp);
-          tmp=NULL;
-          return NULL;
-        }
-        if(varIndex < 0) tmp[i] = -tmp[i];
-        /* fprintf(stderr, "tmp[%d]=%g\n", i, tmp[i]); */
-      }
-    }
-    else
-    {
-      float *buffer = (float*) malloc(reader->nrows*sizeof(float));
-      for(i=0; i<reader->nrows; i++) {
-        fseek(reader->file,reader->var_offset + sizeof(float)*(i*reader->nvar + absVarIndex-1), SEEK_SET);
-        if(1 != fread(&buffer[i], sizeof(float), 1, reader->file)) {
-          /* fprintf(stderr, "Corrupt file at %d of %d? nvar %d\n", i, reader->nrows, reader->nvar); */
-          free(buffer);
-          free(tmp);
-          tmp=NULL;
-          return NULL;
-        }
-      }
-      if(varIndex < 0)
-      {
-        for(i=0; i<reader->nrows; i++) {
-          tmp[i] = -buffer[i];
-        }
-      }
-      else
-      {
-          for(i=0; i<reader->nrows; i++) {
-            tmp[i] = buffer[i];
-          }
-      }
-      free(buffer);
-      /* fprintf(stderr, "tmp[%d]=%g\n", i, tmp[i]); */
+    if (omc_matlab4_read_vars(reader, &varIndex, 1)) {
+      return NULL;
     }
-    reader->vars[ix] = tmp;
   }
   return reader->vars[ix];
 }
@@ -682,49 +872,64 @@ void matrix_transpose_uint32(uint32_t *m, int w, int h)
   }
 }
 
+static void mat4_transpose_rows(ModelicaMatReader *reader, const char *buf, size_t firstRow, size_t nrows, void *data)
+{
+  size_t j, k, nvar = reader->nvar;
+  if (reader->allValsSingle) {
+    float *vals = (float*) reader->allVals;
+    for (j=0; j<nrows; j++) {
+      for (k=0; k<nvar; k++) {
+        vals[k*reader->nrows + firstRow + j] = (float) mat4_elem(buf, j*nvar + k, reader->doublePrecision);
+      }
+    }
+  } else {
+    double *vals = (double*) reader->allVals;
+    for (j=0; j<nrows; j++) {
+      for (k=0; k<nvar; k++) {
+        vals[k*reader->nrows + firstRow + j] = mat4_elem(buf, j*nvar + k, reader->doublePrecision);
+      }
+    }
+  }
+}
+
 int omc_matlab4_read_all_vals(ModelicaMatReader *reader)
 {
-  int done = reader->readAll;
-  int i,j;
-  double *tmp;
-  int nrows = reader->nrows, nvar = reader->nvar;
+  size_t i, nrows = reader->nrows, nvar = reader->nvar;
+  int done = 1;
   if (nvar == 0 || nrows == 0) {
     return 1;
   }
-  for (i=0; i<2*nvar; i++) {
+  if (reader->readAll) {
+    return 0;
+  }
+  for (i=0; i<nvar; i++) {
     if (reader->vars[i] == 0) done = 0;
   }
   if (done) {
     reader->readAll = 1;
     return 0;
   }
-  tmp = (double*) malloc(2*nvar*nrows*sizeof(double));
-  if (!tmp) {
+  /* One transposed buffer owned by the reader; the variables point into it.
+   * Negative aliases are only created on request by omc_matlab4_read_vals */
+  reader->allValsSingle = reader->keepSinglePrecision;
+  reader->allVals = malloc(nvar*nrows*(reader->allValsSingle ? sizeof(float) : sizeof(double)));
+  if (!reader->allVals) {
+    reader->allValsSingle = 0;
     return 1;
   }
-  fseek(reader->file, reader->var_offset, SEEK_SET);
-  if (nvar*reader->nrows != fread(tmp, reader->doublePrecision==1 ? sizeof(double) : sizeof(float), nvar*nrows, reader->file)) {
-    free(tmp);
+  if (mat4_stream_rows(reader, mat4_transpose_rows, NULL)) {
+    free(reader->allVals);
+    reader->allVals = NULL;
+    reader->allValsSingle = 0;
     return 1;
   }
-  if(reader->doublePrecision != 1) {
-    for (i=nvar*nrows-1; i>=0; i--) {
-      tmp[i] = ((float*)tmp)[i];
-    }
-  }
-  matrix_transpose(tmp,nvar,nrows);
-  /* Negative aliases */
-  for (i=0; i<nrows*nvar; i++) {
-    tmp[nrows*nvar + i] = -tmp[i];
-  }
-  /* Setup all the pointers */
-  for (i=0; i<2*nvar; i++) {
-    if (!reader->vars[i]) {
-      reader->vars[i] = (double*) malloc(nrows*sizeof(double));
-      memcpy(reader->vars[i], tmp + i*nrows, nrows*sizeof(double));
+  if (!reader->allValsSingle) {
+    for (i=0; i<nvar; i++) {
+      if (!reader->vars[i]) {
+        reader->vars[i] = ((double*) reader->allVals) + i*nrows;
+      }
     }
   }
-  free(tmp);
   reader->readAll = 1;
   return 0;
 }
@@ -738,7 +943,11 @@ double omc_matlab4_read_single_val(double *res, ModelicaMatReader *reader, int v
     *res = reader->vars[ix][timeIndex];
     return 0;
   }
-  if(reader->doublePrecision==1) {
+  if(reader->vars[absVarIndex-1]) {
+    *res = reader->vars[absVarIndex-1][timeIndex];
+  } else if(reader->allValsSingle) {
+    *res = ((float*)reader->allVals)[(absVarIndex-1)*reader->nrows + timeIndex];
+  } else if(reader->doublePrecision==1) {
     fseek(reader->file,reader->var_offset + sizeof(double)*(timeIndex*reader->nvar + absVarIndex-1), SEEK_SET);
     if(1 != fread(res, sizeof(double), 1, reader->file)) {
       *res = 0;
@@ -891,6 +1100,150 @@ int omc_matlab4_read_vars_val(double *res, ModelicaMatReader *reader, ModelicaMa
     return 0;
 }
 
+/* Number of rows the cursor steps linearly before falling back to bisection */
+#define OMC_MAT4_CURSOR_STEPS 8
+
+void omc_matlab4_cursor_init(ModelicaMatCursor *cursor, ModelicaMatReader *reader)
+{
+  memset(cursor, 0, sizeof(ModelicaMatCursor));
+  cursor->reader = reader;
+  cursor->i1 = -1;
+  cursor->i2 = -1;
+  cursor->rowIndex[0] = -1;
+  cursor->rowIndex[1] = -1;
+}
+
+void omc_matlab4_cursor_free(ModelicaMatCursor *cursor)
+{
+  if (cursor->rows[0]) {
+    free(cursor->rows[0]);
+  }
+  if (cursor->rows[1]) {
+    free(cursor->rows[1]);
+  }
+  omc_matlab4_cursor_init(cursor, cursor->reader);
+}
+
+/* Returns the cached row with the given time index, reading it if necessary */
+static double* cursor_row(ModelicaMatCursor *cursor, int timeIndex, int keep)
+{
+  int slot;
+  if (cursor->rowIndex[0] == timeIndex) {
+    return cursor->rows[0];
+  }
+  if (cursor->rowIndex[1] == timeIndex) {
+    return cursor->rows[1];
+  }
+  /* Replace the row that is not needed for the current bracket */
+  slot = cursor->rowIndex[0] == keep ? 1 : 0;
+  if (!cursor->rows[slot]) {
+    cursor->rows[slot] = (double*) malloc(cursor->reader->nvar*sizeof(double));
+  }
+  cursor->rowIndex[slot] = -1;
+  if (omc_matlab4_read_row(cursor->reader, timeIndex, cursor->rows[slot])) {
+    return NULL;
+  }
+  cursor->rowIndex[slot] = timeIndex;
+  return cursor->rows[slot];
+}
+
+int omc_matlab4_cursor_seek(ModelicaMatCursor *cursor, double time)
+{
+  ModelicaMatReader *reader = cursor->reader;
+  const double *t;
+  int lo = cursor->lo, hi, n = reader->nrows, steps = 0;
+  cursor->i1 = -1;
+  if (time > omc_matlab4_stopTime(reader) || time < omc_matlab4_startTime(reader)) {
+    return 1;
+  }
+  if (!(t = omc_matlab4_read_vals(reader, 1))) {
+    return 1;
+  }
+  if (lo < 0 || lo >= n) {
+    lo = 0;
+  }
+  /* Find the last row with t[lo] <= time; starting from the last bracket this
+   * takes a step or two during playback */
+  if (t[lo] <= time) {
+    while (lo+1 < n && t[lo+1] <= time && steps++ < OMC_MAT4_CURSOR_STEPS) {
+      lo++;
+    }
+    if (lo+1 < n && t[lo+1] <= time) {
+      hi = n-1;
+      while (lo < hi) {
+        int mid = hi - (hi-lo)/2;
+        if (t[mid] <= time) {
+          lo = mid;
+        } else {
+          hi = mid-1;
+        }
+      }
+    }
+  } else {
+    while (lo > 0 && t[lo] > time && steps++ < OMC_MAT4_CURSOR_STEPS) {
+      lo--;
+    }
+    if (t[lo] > time) {
+      hi = lo;
+      lo = 0;
+      while (lo < hi) {
+        int mid = hi - (hi-lo)/2;
+        if (t[mid] <= time) {
+          lo = mid;
+        } else {
+          hi = mid-1;
+        }
+      }
+    }
+  }
+  cursor->lo = lo;
+  cursor->time = time;
+  if (t[lo] == time || lo+1 == n) {
+    /* If we have events (multiple identical time stamps), lo is the right limit */
+    cursor->i1 = lo;
+    cursor->w1 = 1.0;
+    cursor->i2 = -1;
+    cursor->w2 = 0.0;
+  } else {
+    cursor->i1 = lo+1;
+    cursor->i2 = lo;
+    cursor->w1 = (time - t[lo]) / (t[lo+1] - t[lo]);
+    cursor->w2 = 1.0 - cursor->w1;
+  }
+  return 0;
+}
+
+int omc_matlab4_cursor_vals(ModelicaMatCursor *cursor, ModelicaMatVariable_t **vars, int N, double *res)
+{
+  ModelicaMatReader *reader = cursor->reader;
+  const double *row1 = NULL, *row2 = NULL;
+  int i;
+  for (i=0; i<N; i++) {
+    int ix = abs(vars[i]->index)-1;
+    double sign = vars[i]->index < 0 ? -1.0 : 1.0;
+    if (vars[i]->isParam) {
+      res[i] = sign*reader->params[ix];
+      continue;
+    }
+    /* parameters do not depend on the position of the cursor */
+    if (cursor->i1 < 0) {
+      return 1;
+    }
+    if (!row1 && !(row1 = cursor_row(cursor, cursor->i1, cursor->i2))) {
+      return 1;
+    }
+    if (cursor->i2 == -1) {
+      res[i] = sign*row1[ix];
+      continue;
+    }
+    if (!row2 && !(row2 = cursor_row(cursor, cursor->i2, cursor->i1))) {
+      return 1;
+    }
+    res[i] = sign*(cursor->w1*row1[ix] + cursor->w2*row2[ix]);
+  }
+  return 0;
+}
+
 void omc_matlab4_print_all_vars(FILE *stream, ModelicaMatReader *reader)
 {
   unsigned int i;
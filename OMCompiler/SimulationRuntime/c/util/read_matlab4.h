@@ -53,10 +53,41 @@ typedef struct {
   uint32_t nvar,nrows;
   size_t var_offset; /* This is the offset in the file */
   int readAll; /* Read all variables already */
-  double **vars;
+  double **vars; /* nvar variables followed by their nvar negated aliases; filled on request */
   char doublePrecision; /* data_1 and data_2 in double ore single precision */
+  char keepSinglePrecision; /* Set to hold data_2 as float in omc_matlab4_read_all_vals; double precision values are rounded */
+  char allValsSingle; /* allVals holds float instead of double values */
+  void *allVals; /* All of data_2 transposed (nvar blocks of nrows values); the variables point into it */
 } ModelicaMatReader;
 
+/* Read-only view of the values of a variable; negated aliases share the
+ * storage of the variable and only carry the sign */
+typedef struct {
+  const double *vals; /* NULL if fvals is used */
+  const float *fvals;
+  double sign;
+  uint32_t n;
+} ModelicaMatVarView;
+
+static OMC_INLINE double omc_matlab4_view_val(const ModelicaMatVarView *view, uint32_t i)
+{
+  return view->sign * (view->vals ? view->vals[i] : (double) view->fvals[i]);
+}
+
+/* Remembers the time bracket of the last lookup and the two surrounding rows
+ * of data_2, so that lookups at increasing (or nearby) time points do not
+ * search the time vector again and values at one time point come from
+ * contiguous row memory */
+typedef struct {
+  ModelicaMatReader *reader;
+  double time; /* time of the last seek */
+  int lo; /* last time index with time[lo] <= time */
+  int i1, i2; /* rows to interpolate between; i2 == -1 for an exact hit on i1 */
+  double w1, w2; /* weights of rows i1 and i2 */
+  double *rows[2]; /* cached rows of nvar values */
+  int rowIndex[2]; /* time index of the cached rows or -1 */
+} ModelicaMatCursor;
+
 /* Returns 0 on success; the error message on error.
  * The internal data is free'd by omc_free_matlab4_reader.
  * The data persists until free'd, and is safe to use in your own data-structures
@@ -78,6 +109,27 @@ ModelicaMatVariable_t *omc_matlab4_find_var(ModelicaMatReader *reader, const cha
  */
 double* omc_matlab4_read_vals(ModelicaMatReader *reader, int varIndex);
 
+/* Reads the values of all given variables (var->index of non-parameters) in
+ * a single streaming pass over the file; afterwards omc_matlab4_read_vals
+ * returns them without touching the file again.
+ * Prefer this over repeated omc_matlab4_read_vals calls when extracting many
+ * variables. Returns 0 on success */
+int omc_matlab4_read_vars(ModelicaMatReader *reader, const int *indices, int n);
+
+/* Frees the values cached by omc_matlab4_read_vars/omc_matlab4_read_vals for
+ * the given variables, to bound the memory used when streaming through many
+ * variables. Pointers returned earlier for them become invalid */
+void omc_matlab4_release_vars(ModelicaMatReader *reader, const int *indices, int n);
+
+/* Reads all nvar values stored for one time index (as in data_2) into row.
+ * Returns 0 on success */
+int omc_matlab4_read_row(ModelicaMatReader *reader, int timeIndex, double *row);
+
+/* Gives access to the values of a variable (var->index of a non-parameter)
+ * without allocating a negated copy for negative aliases.
+ * The view stays valid until the reader is closed. Returns 0 on success */
+int omc_matlab4_var_view(ModelicaMatReader *reader, int varIndex, ModelicaMatVarView *view);
+
 /* Returns 0 on success */
 int omc_matlab4_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t *var, double time);
 
@@ -85,6 +137,18 @@ int omc_matlab4_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_
  * Returns 0 on success */
 int omc_matlab4_read_vars_val(double *res, ModelicaMatReader *reader, ModelicaMatVariable_t **var, int N, double time);
 
+void omc_matlab4_cursor_init(ModelicaMatCursor *cursor, ModelicaMatReader *reader);
+void omc_matlab4_cursor_free(ModelicaMatCursor *cursor);
+
+/* Positions the cursor at the given time; O(1) when time advances
+ * monotonically in small steps. Returns 0 on success */
+int omc_matlab4_cursor_seek(ModelicaMatCursor *cursor, double time);
+
+/* Interpolates N variables at the time of the last seek; parameters are
+ * returned even if the cursor has not been positioned yet.
+ * Returns 0 on success */
+int omc_matlab4_cursor_vals(ModelicaMatCursor *cursor, ModelicaMatVariable_t **vars, int N, double *res);
+
 /* For debugging */
 void omc_matlab4_print_all_vars(FILE *stream, ModelicaMatReader *reader);
 
@@ -93,8 +157,16 @@ double omc_matlab4_stopTime(ModelicaMatReader *reader);
 
 void matrix_transpose(double *m, int w, int h);
 void matrix_transpose_uint32(uint32_t *m, int w, int h);
+/* Reads all of data_2 into a single buffer of about nvar*nrows values owned by
+ * the reader (floats if keepSinglePrecision is set, which rounds the values
+ * of double precision files; binNormal files are loaded as double on opening).
+ * Returns 0 on success */
 int omc_matlab4_read_all_vals(ModelicaMatReader *reader);
 
+/* Compares the names of two ModelicaMatVariable_t ignoring whitespace;
+ * the order of allInfo */
+int omc_matlab4_comp_var(const void *a, const void *b);
+
 /* Fix the placement of a.der(b) -> der(a.b) */
 char* openmodelicaStyleVariableName(const char *varName);
 
@@ -35,6 +35,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
 
   /* FLAG_ABORT_SLOW */                   "abortSlowSimulation",
   /* FLAG_ALARM */                        "alarm",
+  /* FLAG_ASYNC_OUTPUT */                 "asyncOutput",
   /* FLAG_CLOCK */                        "clock",
   /* FLAG_CPU */                          "cpu",
   /* FLAG_CSV_OSTEP */                    "csvOstep",
@@ -88,8 +89,10 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_IPOPT_MAX_ITER */               "ipopt_max_iter",
   /* FLAG_IPOPT_WARM_START */             "ipopt_warm_start",
   /* FLAG_JACOBIAN */                     "jacobian",
+  /* FLAG_JACOBIAN_THREADS */             "jacobianThreads",
   /* FLAG_L */                            "l",
   /* FLAG_L_DATA_RECOVERY */              "l_datarec",
+  /* FLAG_L_FORMAT */                     "l_format",
   /* FLAG_LOG_FORMAT */                   "logFormat",
   /* FLAG_LS */                           "ls",
   /* FLAG_LS_IPOPT */                     "ls_ipopt",
@@ -116,6 +119,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_NOEQUIDISTANT_OUT_FREQ*/        "noEquidistantOutputFrequency",
   /* FLAG_NOEQUIDISTANT_OUT_TIME*/        "noEquidistantOutputTime",
   /* FLAG_NOEVENTEMIT */                  "noEventEmit",
+  /* FLAG_NO_POOL_ZERO */                 "noPoolZero",
   /* FLAG_NO_RESTART */                   "noRestart",
   /* FLAG_NO_ROOTFINDING */               "noRootFinding",
   /* FLAG_NO_SCALING */                   "noScaling",
@@ -128,8 +132,10 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_OVERRIDE */                     "override",
   /* FLAG_OVERRIDE_FILE */                "overrideFile",
   /* FLAG_PORT */                         "port",
+  /* FLAG_PORT_STATUS_INTERVAL */         "portStatusInterval",
   /* FLAG_R */                            "r",
   /* FLAG_DATA_RECONCILE  */              "reconcile",
+  /* FLAG_DATA_RECONCILE_BATCH */         "reconcileBatch",
   /* FLAG_RT */                           "rt",
   /* FLAG_S */                            "s",
   /* FLAG_SINGLE_PRECISION */             "single",
@@ -148,6 +154,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
 
   /* FLAG_ABORT_SLOW */                   "aborts if the simulation chatters",
   /* FLAG_ALARM */                        "aborts after the given number of seconds (0 disables)",
+  /* FLAG_ASYNC_OUTPUT */                 "[int (default 0)] writes the result file from a separate thread, buffering up to N time-points (default disabled)",
   /* FLAG_CLOCK */                        "selects the type of clock to use -clock=RT, -clock=CYC or -clock=CPU",
   /* FLAG_CPU */                          "dumps the cpu-time into the result file",
   /* FLAG_CSV_OSTEP */                    "value specifies csv-files for debug values for optimizer step",
@@ -201,8 +208,10 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_IPOPT_MAX_ITER */               "value specifies the max number of iteration for ipopt",
   /* FLAG_IPOPT_WARM_START */             "value specifies lvl for a warm start in ipopt: 1,2,3,...",
   /* FLAG_JACOBIAN */                     "select the calculation method of the Jacobian used only by ida and dassl solver.",
+  /* FLAG_JACOBIAN_THREADS */             "[int (default 1)] number of threads evaluating the colors of the symbolic Jacobian in ida, dassl and linearization",
   /* FLAG_L */                            "value specifies a time where the linearization of the model should be performed",
   /* FLAG_L_DATA_RECOVERY */              "emit data recovery matrices with model linearization",
+  /* FLAG_L_FORMAT */                     "value specifies the file format of the linearized model: modelica (default) or mat",
   /* FLAG_LOG_FORMAT */                   "value specifies the log format of the executable. -logFormat=text (default), -logFormat=xml or -logFormat=xmltcp",
   /* FLAG_LS */                           "value specifies the linear solver method (default: lapack, totalpivot (fallback))",
   /* FLAG_LS_IPOPT */                     "value specifies the linear solver method for ipopt",
@@ -229,6 +238,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_NOEQUIDISTANT_OUT_FREQ*/        "value controls the output frequency in noEquidistantTimeGrid mode",
   /* FLAG_NOEQUIDISTANT_OUT_TIME*/        "value controls the output time point in noEquidistantOutputTime mode",
   /* FLAG_NOEVENTEMIT */                  "do not emit event points to the result file",
+  /* FLAG_NO_POOL_ZERO */                 "do not clear arrays of reals, integers and booleans allocated from the memory pool",
   /* FLAG_NO_RESTART */                   "disables the restart of the integration method after an event is performed, used by the methods: dassl, ida",
   /* FLAG_NO_ROOTFINDING */               "disables the internal root finding procedure of methods: dassl and ida.",
   /* FLAG_NO_SCALING */                   "disables scaling for the variables and the residuals in the algebraic nonlinear solver KINSOL.",
@@ -241,8 +251,10 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_OVERRIDE */                     "override the variables or the simulation settings in the XML setup file",
   /* FLAG_OVERRIDE_FILE */                "will override the variables or the simulation settings in the XML setup file with the values from the file",
   /* FLAG_PORT */                         "value specifies the port for simulation status (default disabled)",
+  /* FLAG_PORT_STATUS_INTERVAL */         "[double (default 0.1)] minimum wall-clock time in seconds between two progress updates sent to the port",
   /* FLAG_R */                            "value specifies a new result file than the default Model_res.mat",
   /* FLAG_DATA_RECONCILE */               "Run the DataReconciliation algorithm for constrained equation",
+  /* FLAG_DATA_RECONCILE_BATCH */         "value specifies a csv-file with measurement snapshots to be reconciled in one run",
   /* FLAG_RT */                           "value specifies the scaling factor for real-time synchronization (0 disables)",
   /* FLAG_S */                            "value specifies the integration method",
   /* FLAG_SINGLE */                       "output in single precision",
@@ -262,6 +274,11 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Aborts if the simulation chatters.",
   /* FLAG_ALARM */
   "  Aborts after the given number of seconds (default=0 disables the alarm).",
+  /* FLAG_ASYNC_OUTPUT */
+  "  Writes the result file from a separate thread so that the solver does not\n"
+  "  wait for the disk. Emitting a time-point only copies it into a buffer of N\n"
+  "  time-points; the solver waits when the buffer is full. Not used together\n"
+  "  with -cpu.",
   /* FLAG_CLOCK */
   "  Selects the type of clock to use. Valid options include:\n\n"
   "  * RT (monotonic real-time clock)\n"
@@ -385,10 +402,22 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Value specifies lvl for a warm start in ipopt: 1,2,3,...",
   /* FLAG_JACOBIAN */
   "  Select the calculation method for Jacobian used by the integration method:\n",
+  /* FLAG_JACOBIAN_THREADS */
+  "  Number of threads that evaluate the colors of the symbolic Jacobian\n"
+  "  (-jacobian=coloredSymbolical) in ida and dassl, and of the linearization\n"
+  "  Jacobians A, B, C and D, concurrently,\n"
+  "  each with its own seed, temporary and result vectors (default 1, serial).\n"
+  "  The first color of the first Jacobian is always evaluated serially; if it\n"
+  "  solves a linear system, all following colors are evaluated serially, too.",
   /* FLAG_L */
   "  Value specifies a time where the linearization of the model should be performed.",
   /* FLAG_L_DATA_RECOVERY */
   "  Emit data recovery matrices with model linearization.",
+  /* FLAG_L_FORMAT */
+  "  Value specifies the file format of the linearized model:\n\n"
+  "  * modelica (default, linear_<model>.mo)\n"
+  "  * mat (linear_<model>.mat, the matrices in sparse MATLAB v4 format and\n"
+  "    the operating point as dense vectors x0, u0 and z0)",
   /* FLAG_LOG_FORMAT */
   "  Value specifies the log format of the executable:\n\n"
   "  * text (default)\n"
@@ -465,6 +494,9 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  mode and outputs every time>=k*timeValue, where k is an integer",
   /* FLAG_NOEVENTEMIT */
   "  Do not emit event points to the result file.",
+  /* FLAG_NO_POOL_ZERO */
+  "  Do not clear arrays of reals, integers and booleans allocated from the memory pool\n"
+  "  used by FMUs and parallel simulations. Generated code overwrites these arrays anyway.",
   /* FLAG_NO_RESTART */
   "  Disables the restart of the integration method after an event is performed, used by the methods: dassl, ida",
   /* FLAG_NO_ROOTFINDING */
@@ -499,12 +531,24 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  overrideFileName contains lines of the form: var1=start1",
   /* FLAG_PORT */
   "  Value specifies the port for simulation status (default disabled).",
+  /* FLAG_PORT_STATUS_INTERVAL */
+  "  Value specifies the minimum wall-clock time in seconds between two progress\n"
+  "  updates sent to the port given by -port (default 0.1).\n"
+  "  The updates in between are coalesced and sent from a separate thread, so the\n"
+  "  solver never waits for the socket. Phase changes and the final status are\n"
+  "  always sent. 0 sends every update synchronously.",
   /* FLAG_R */
   "  Value specifies the name of the output result file.\n"
   "  The default file-name is based on the model name and output format.\n"
   "  For example: Model_res.mat.",
   /* FLAG_DATA_RECONCILE */
   "  Run the DataReconciliation algorithm for constrained equation",
+  /* FLAG_DATA_RECONCILE_BATCH */
+  "  Value specifies a csv-file with measurement snapshots for DataReconciliation.\n"
+  "  The first line holds the names of the variables to be reconciled, every further\n"
+  "  line one snapshot of measured values. The uncertainties are taken from the -sx\n"
+  "  file and the factorization is reused as long as the Jacobian is unchanged.\n"
+  "  The reconciled values are written to <model>_Batch_Outputs.csv.",
   /* FLAG_RT */
   "  Value specifies the scaling factor for real-time synchronization (0 disables).\n"
   "  A value > 1 means the simulation takes a longer time to simulate.\n",
@@ -533,6 +577,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
 
   /* FLAG_ABORT_SLOW */                   FLAG_TYPE_FLAG,
   /* FLAG_ALARM */                        FLAG_TYPE_OPTION,
+  /* FLAG_ASYNC_OUTPUT */                 FLAG_TYPE_OPTION,
   /* FLAG_CLOCK */                        FLAG_TYPE_OPTION,
   /* FLAG_CPU */                          FLAG_TYPE_FLAG,
   /* FLAG_CSV_OSTEP */                    FLAG_TYPE_OPTION,
@@ -586,8 +631,10 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_IPOPT_MAX_ITER */               FLAG_TYPE_OPTION,
   /* FLAG_IPOPT_WARM_START */             FLAG_TYPE_OPTION,
   /* FLAG_JACOBIAN */                     FLAG_TYPE_OPTION,
+  /* FLAG_JACOBIAN_THREADS */             FLAG_TYPE_OPTION,
   /* FLAG_L */                            FLAG_TYPE_OPTION,
   /* FLAG_L_DATA_RECOVERY */              FLAG_TYPE_FLAG,
+  /* FLAG_L_FORMAT */                     FLAG_TYPE_OPTION,
   /* FLAG_LOG_FORMAT */                   FLAG_TYPE_OPTION,
   /* FLAG_LS */                           FLAG_TYPE_OPTION,
   /* FLAG_LS_IPOPT */                     FLAG_TYPE_OPTION,
@@ -613,6 +660,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_NOEQUIDISTANT_GRID*/            FLAG_TYPE_FLAG,
   /* FLAG_NOEQUIDISTANT_OUT_FREQ*/        FLAG_TYPE_OPTION,
   /* FLAG_NOEQUIDISTANT_OUT_TIME*/        FLAG_TYPE_OPTION,
+  /* FLAG_NO_POOL_ZERO */                 FLAG_TYPE_FLAG,
   /* FLAG_NO_RESTART */                   FLAG_TYPE_FLAG,
   /* FLAG_NO_ROOTFINDING */               FLAG_TYPE_FLAG,
   /* FLAG_NO_SCALING */                   FLAG_TYPE_FLAG,
@@ -626,8 +674,10 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_OVERRIDE */                     FLAG_TYPE_OPTION,
   /* FLAG_OVERRIDE_FILE */                FLAG_TYPE_OPTION,
   /* FLAG_PORT */                         FLAG_TYPE_OPTION,
+  /* FLAG_PORT_STATUS_INTERVAL */         FLAG_TYPE_OPTION,
   /* FLAG_R */                            FLAG_TYPE_OPTION,
   /* FLAG_DATA_RECONCILE */               FLAG_TYPE_FLAG,
+  /* FLAG_DATA_RECONCILE_BATCH */         FLAG_TYPE_OPTION,
   /* FLAG_RT */                           FLAG_TYPE_OPTION,
   /* FLAG_S */                            FLAG_TYPE_OPTION,
   /* FLAG_SINGLE */                       FLAG_TYPE_FLAG,
@@ -43,6 +43,7 @@ enum _FLAG
 
   FLAG_ABORT_SLOW,
   FLAG_ALARM,
+  FLAG_ASYNC_OUTPUT,
   FLAG_CLOCK,
   FLAG_CPU,
   FLAG_CSV_OSTEP,
@@ -96,8 +97,10 @@ enum _FLAG
   FLAG_IPOPT_MAX_ITER,
   FLAG_IPOPT_WARM_START,
   FLAG_JACOBIAN,
+  FLAG_JACOBIAN_THREADS,
   FLAG_L,
   FLAG_L_DATA_RECOVERY,
+  FLAG_L_FORMAT,
   FLAG_LOG_FORMAT,
   FLAG_LS,
   FLAG_LS_IPOPT,
@@ -124,6 +127,7 @@ enum _FLAG
   FLAG_NOEQUIDISTANT_OUT_FREQ,
   FLAG_NOEQUIDISTANT_OUT_TIME,
   FLAG_NOEVENTEMIT,
+  FLAG_NO_POOL_ZERO,
   FLAG_NO_RESTART,
   FLAG_NO_ROOTFINDING,
   FLAG_NO_SCALING,
@@ -136,8 +140,10 @@ enum _FLAG
   FLAG_OVERRIDE,
   FLAG_OVERRIDE_FILE,
   FLAG_PORT,
+  FLAG_PORT_STATUS_INTERVAL,
   FLAG_R,
   FLAG_DATA_RECONCILE,
+  FLAG_DATA_RECONCILE_BATCH,
   FLAG_RT,
   FLAG_S,
   FLAG_SINGLE_PRECISION,
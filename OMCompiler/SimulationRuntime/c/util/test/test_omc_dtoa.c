@@ -0,0 +1,62 @@
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../omc_dtoa.h"
+
+/* forward declarations */
+int test_dtoa(double value, const char *expected);
+
+/* main */
+int main()
+{
+  /* return code */
+  int rc = 0;
+
+  /* layout of %.16g */
+  rc |= test_dtoa(0.0, "0");
+  rc |= test_dtoa(-0.0, "-0");
+  rc |= test_dtoa(1.0, "1");
+  rc |= test_dtoa(-1.5, "-1.5");
+  rc |= test_dtoa(0.1, "0.1");
+  rc |= test_dtoa(1e-4, "0.0001");
+  rc |= test_dtoa(1.25e-5, "1.25e-05");
+  rc |= test_dtoa(123456789012345.0, "123456789012345");
+  rc |= test_dtoa(1234567890123456.0, "1234567890123456");
+  rc |= test_dtoa(1e16, "1e+16");
+  rc |= test_dtoa(1.5e16, "1.5e+16");
+  rc |= test_dtoa(1e100, "1e+100");
+
+  /* round-trip exact values of the extremes */
+  rc |= test_dtoa(5e-324, "5e-324");
+  rc |= test_dtoa(DBL_MIN, "2.2250738585072014e-308");
+  rc |= test_dtoa(DBL_MAX, "1.7976931348623157e+308");
+  rc |= test_dtoa(1.0/3.0, "0.3333333333333333");
+
+  rc |= test_dtoa(HUGE_VAL, "inf");
+  rc |= test_dtoa(-HUGE_VAL, "-inf");
+
+  return rc;
+}
+
+/* Formats value and compares it with expected. Finite values have to be
+ * read back as the same double. */
+int test_dtoa(double value, const char *expected)
+{
+  char buffer[OMC_DTOA_BUFFER_SIZE + 1];
+  double read;
+  int n = omc_dtoa(value, buffer);
+  buffer[n] = '\0';
+  if (strcmp(buffer, expected)) {
+    printf("omc_dtoa(%.17g) = %s, expected %s\n", value, buffer, expected);
+    return 1;
+  }
+  read = strtod(buffer, NULL);
+  if (value - value == 0 && memcmp(&value, &read, sizeof(double))) {
+    printf("omc_dtoa(%.17g) = %s does not read back as the same value\n", value, buffer);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,165 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../read_matlab4.h"
+
+/* Result with the variables time, x, y = -x (alias) and the parameter p,
+ * written in the binTrans layout of OpenModelica and the binNormal layout */
+#define NROWS 4
+#define NVAR 2
+static const double times[NROWS] = {0.0, 0.5, 0.5, 1.0};
+static const double xs[NROWS] = {1.0, 2.0, 3.0, 5.0};
+static const double p = 7.0;
+
+/* forward declarations */
+int write_result(const char *fileName, int binTrans);
+int test_result(const char *fileName);
+
+/* main */
+int main()
+{
+  /* return code */
+  int rc;
+
+  if (write_result("test_read_matlab4_binTrans.mat", 1)) return 1;
+  if ( (rc = test_result("test_read_matlab4_binTrans.mat")) != 0) {
+    printf("binTrans: check %d failed\n", rc);
+    return 1;
+  }
+
+  if (write_result("test_read_matlab4_binNormal.mat", 0)) return 1;
+  if ( (rc = test_result("test_read_matlab4_binNormal.mat")) != 0) {
+    printf("binNormal: check %d failed\n", rc);
+    return 1;
+  }
+
+  /* everything OK */
+  return 0;
+}
+
+static void write_matrix(FILE *file, const char *name, uint32_t type, uint32_t mrows, uint32_t ncols, const void *data, size_t elsize)
+{
+  uint32_t hdr[5];
+  hdr[0] = type;
+  hdr[1] = mrows;
+  hdr[2] = ncols;
+  hdr[3] = 0;
+  hdr[4] = strlen(name)+1;
+  fwrite(hdr, sizeof(uint32_t), 5, file);
+  fwrite(name, 1, hdr[4], file);
+  fwrite(data, elsize, (size_t)mrows*ncols, file);
+}
+
+/* Writes n strings of length len as text matrix, one string per column
+ * (binTrans) or per row (binNormal) */
+static void write_strings(FILE *file, const char *name, const char **strs, int n, int len, int binTrans)
+{
+  char buf[256];
+  int i, j;
+  memset(buf, ' ', sizeof(buf));
+  for (i=0; i<n; i++) {
+    for (j=0; j<len && strs[i][j]; j++) {
+      buf[binTrans ? i*len+j : j*n+i] = strs[i][j];
+    }
+  }
+  write_matrix(file, name, 51, binTrans ? len : n, binTrans ? n : len, buf, 1);
+}
+
+int write_result(const char *fileName, int binTrans)
+{
+  const char *aclass[4] = {"Atrajectory", "1.1", "", binTrans ? "binTrans" : "binNormal"};
+  const char *names[4] = {"time", "x", "y", "p"};
+  const char *descrs[4] = {"Time", "x", "y", "p"};
+  /* isParam/index/interpolation/extrapolation of each variable */
+  const int32_t info[4][4] = {{2,1,0,-1}, {2,2,0,-1}, {2,-2,0,-1}, {1,2,0,0}};
+  int32_t dataInfo[16];
+  double data1[4], data2[NROWS*NVAR];
+  int i, j;
+  FILE *file = fopen(fileName, "wb");
+  if (!file) {
+    return 1;
+  }
+  /* the Aclass matrix is always stored column by column */
+  {
+    char buf[44];
+    memset(buf, ' ', sizeof(buf));
+    for (i=0; i<4; i++) {
+      for (j=0; j<11 && aclass[i][j]; j++) {
+        buf[j*4+i] = aclass[i][j];
+      }
+    }
+    write_matrix(file, "Aclass", 51, 4, 11, buf, 1);
+  }
+  write_strings(file, "name", names, 4, 4, binTrans);
+  write_strings(file, "description", descrs, 4, 4, binTrans);
+  for (i=0; i<4; i++) {
+    for (j=0; j<4; j++) {
+      dataInfo[binTrans ? i*4+j : j*4+i] = info[i][j];
+    }
+  }
+  write_matrix(file, "dataInfo", 20, 4, 4, dataInfo, sizeof(int32_t));
+  /* data_1: time and p at start and stop time */
+  data1[0] = times[0];
+  data1[1] = binTrans ? p : times[NROWS-1];
+  data1[2] = binTrans ? times[NROWS-1] : p;
+  data1[3] = p;
+  write_matrix(file, "data_1", 0, 2, 2, data1, sizeof(double));
+  /* data_2: binTrans stores one time point per column, binNormal one variable per column */
+  for (i=0; i<NROWS; i++) {
+    data2[binTrans ? i*NVAR : i] = times[i];
+    data2[binTrans ? i*NVAR+1 : NROWS+i] = xs[i];
+  }
+  write_matrix(file, "data_2", 0, binTrans ? NVAR : NROWS, binTrans ? NROWS : NVAR, data2, sizeof(double));
+  fclose(file);
+  return 0;
+}
+
+int test_result(const char *fileName)
+{
+  ModelicaMatReader reader;
+  ModelicaMatCursor cursor;
+  ModelicaMatVariable_t *vars[3];
+  double row[NVAR], res[3];
+  int i;
+
+  if (omc_new_matlab4_reader(fileName, &reader)) return 1;
+  vars[0] = omc_matlab4_find_var(&reader, "x");
+  vars[1] = omc_matlab4_find_var(&reader, "y");
+  vars[2] = omc_matlab4_find_var(&reader, "p");
+  if (!vars[0] || !vars[1] || !vars[2]) return 2;
+
+  /* rows of data_2 */
+  for (i=0; i<NROWS; i++) {
+    if (omc_matlab4_read_row(&reader, i, row)) return 10+i;
+    if (row[0] != times[i] || row[1] != xs[i]) return 20+i;
+  }
+  if (!omc_matlab4_read_row(&reader, NROWS, row)) return 30;
+
+  omc_matlab4_cursor_init(&cursor, &reader);
+
+  /* parameters can be read before the cursor is positioned, trajectories not */
+  if (omc_matlab4_cursor_vals(&cursor, vars+2, 1, res) || res[0] != p) return 40;
+  if (!omc_matlab4_cursor_vals(&cursor, vars, 1, res)) return 41;
+
+  /* interpolation, the event at 0.5 and the alias */
+  if (omc_matlab4_cursor_seek(&cursor, 0.25) || omc_matlab4_cursor_vals(&cursor, vars, 3, res)) return 50;
+  if (res[0] != 1.5 || res[1] != -1.5 || res[2] != p) return 51;
+  if (omc_matlab4_cursor_seek(&cursor, 0.5) || omc_matlab4_cursor_vals(&cursor, vars, 1, res)) return 52;
+  if (res[0] != 3.0) return 53;
+  if (omc_matlab4_cursor_seek(&cursor, 0.75) || omc_matlab4_cursor_vals(&cursor, vars, 1, res)) return 54;
+  if (res[0] != 4.0) return 55;
+  if (omc_matlab4_cursor_seek(&cursor, 0.1) || omc_matlab4_cursor_vals(&cursor, vars, 1, res)) return 56;
+  if (fabs(res[0] - 1.2) > 1e-15) return 57;
+  if (!omc_matlab4_cursor_seek(&cursor, 2.0)) return 58;
+  omc_matlab4_cursor_free(&cursor);
+
+  /* the rows are the same after loading all values, as float for binTrans */
+  reader.keepSinglePrecision = 1;
+  if (omc_matlab4_read_all_vals(&reader)) return 60;
+  if (omc_matlab4_read_row(&reader, NROWS-1, row) || row[0] != times[NROWS-1] || row[1] != xs[NROWS-1]) return 61;
+
+  omc_free_matlab4_reader(&reader);
+  return 0;
+}
@@ -90,3 +90,51 @@ int writeMatVer4Matrix(FILE *fout, const char *name, int rows, int cols, const v
   /* write data */
   return !(0==writeMatVer4MatrixHeader(fout, name, rows, cols, size) && 1 == fwrite(matrixData, (size)*rows*cols, 1, fout));
 }
+
+/* Writes the nonzeros of a dense, column major matrix as MAT-file sparse matrix:
+ * an (nnz+1) x 3 double matrix of 1-based row indices, column indices and
+ * values, sorted by column. The last row holds the dimensions of the matrix. */
+int writeMatVer4SparseMatrix(FILE *fout, const char *name, int rows, int cols, const double *matrixData)
+{
+  const int endian_test = 1;
+  MHeader_t hdr;
+  size_t nnz = 0, k, n = (size_t)rows*cols;
+  int i, j, ret;
+  double *triplets;
+
+  for (k = 0; k < n; k++) {
+    if (matrixData[k] != 0) {
+      nnz++;
+    }
+  }
+  triplets = (double*) malloc(3*(nnz+1)*sizeof(double));
+  if (!triplets) {
+    return 1;
+  }
+  k = 0;
+  for (j = 0; j < cols; j++) {
+    for (i = 0; i < rows; i++) {
+      double value = matrixData[i + (size_t)j*rows];
+      if (value != 0) {
+        triplets[k] = i+1;
+        triplets[nnz+1+k] = j+1;
+        triplets[2*(nnz+1)+k] = value;
+        k++;
+      }
+    }
+  }
+  triplets[nnz] = rows;
+  triplets[2*nnz+1] = cols;
+  triplets[3*nnz+2] = 0;
+
+  /* type 2: sparse matrix of doubles */
+  hdr.type = 1000*((*(char*)&endian_test) == 0) + 2;
+  hdr.mrows = nnz+1;
+  hdr.ncols = 3;
+  hdr.imagf = 0;
+  hdr.namelen = strlen(name)+1;
+  ret = !(1 == fwrite(&hdr, sizeof(MHeader_t), 1, fout) && 1 == fwrite(name, sizeof(char)*hdr.namelen, 1, fout)
+          && 1 == fwrite(triplets, 3*(nnz+1)*sizeof(double), 1, fout));
+  free(triplets);
+  return ret;
+}
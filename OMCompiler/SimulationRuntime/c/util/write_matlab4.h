@@ -39,6 +39,7 @@ extern "C" {
 int writeMatVer4AclassNormal(FILE *fout);
 int writeMatVer4MatrixHeader(FILE *fout,const char *name, int rows, int cols, unsigned int size);
 int writeMatVer4Matrix(FILE *fout, const char *name, int rows, int cols, const void *matrixData, unsigned int size);
+int writeMatVer4SparseMatrix(FILE *fout, const char *name, int rows, int cols, const double *matrixData);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -1,12 +1,34 @@
 #include <Core/ModelicaDefine.h>
  #include <Core/Modelica.h>
-#include <Core/Math/matrix_t.h>
+#include <Core/Math/SparseMatrix.h>
 #ifdef USE_UMFPACK
 #include "umfpack.h"
 #endif
 
 #ifdef USE_UMFPACK
+sparse_matrix::~sparse_matrix() {
+    freeNumeric();
+    freeSymbolic();
+}
+
+void sparse_matrix::freeNumeric() {
+    if(_numeric) {
+        umfpack_di_free_numeric(&_numeric);
+        _numeric=NULL;
+    }
+}
+
+void sparse_matrix::freeSymbolic() {
+    if(_symbolic) {
+        umfpack_di_free_symbolic(&_symbolic);
+        _symbolic=NULL;
+    }
+}
+
 void sparse_matrix::build(sparse_inserter& ins) {
+        if(ins.content.empty()) {
+            throw ModelicaSimulationError(MATH_FUNCTION,"empty sparse matrix");
+        }
         if(n==-1) {
             n=ins.content.rbegin()->first.first+1;
         } else {
@@ -14,42 +36,122 @@ void sparse_matrix::build(sparse_inserter& ins) {
                 throw ModelicaSimulationError(MATH_FUNCTION,"size doesn't match");
             }
         }
-        size_t n=ins.content.size();
-        Ap.assign(this->n+1,0);
-        Ai.resize(n);
-        Ax.resize(n);
-        unsigned int j=0;
-        int rowold=1;
-        for(map< pair<int,int>, double>::iterator it=ins.content.begin(); it!=ins.content.end(); it++) {
-            if(it->first.first+1==rowold) {
-                ++Ap[rowold];
-            } else {
-                Ap[it->first.first+1]=Ap[rowold]+1;
-                rowold=it->first.first+1;
+        size_t nnz=ins.content.size();
+        map< pair<int,int>, double>::const_iterator it;
+        unsigned int j;
+
+        // the map is ordered by column and row, which is the compressed column order
+        bool samePattern=_symbolic && Ai.size()==nnz;
+        for(it=ins.content.begin(), j=0; samePattern && it!=ins.content.end(); ++it, ++j) {
+            samePattern=Ai[j]==it->first.second && j>=(unsigned int)Ap[it->first.first] && j<(unsigned int)Ap[it->first.first+1];
+        }
+
+        if(!samePattern) {
+            freeNumeric();
+            freeSymbolic();
+            Ap.assign(n+1,0);
+            Ai.resize(nnz);
+            for(it=ins.content.begin(), j=0; it!=ins.content.end(); ++it, ++j) {
+                ++Ap[it->first.first+1];
+                Ai[j]=it->first.second;
+            }
+            for(int col=0; col<n; ++col) {
+                Ap[col+1]+=Ap[col];
             }
-            Ai[j]=it->first.second;
+        }
+
+        Ax.resize(nnz);
+        for(it=ins.content.begin(), j=0; it!=ins.content.end(); ++it, ++j) {
             Ax[j]=it->second;
-            ++j;
         }
+        freeNumeric();
+    }
+
+int sparse_matrix::index(int i, int j) const {
+    if(j<0 || j>=n) {
+        return -1;
+    }
+    std::vector<int>::const_iterator first=Ai.begin()+Ap[j];
+    std::vector<int>::const_iterator last=Ai.begin()+Ap[j+1];
+    std::vector<int>::const_iterator pos=std::lower_bound(first,last,i);
+    if(pos==last || *pos!=i) {
+        return -1;
+    }
+    return (int)(pos-Ai.begin());
+}
+
+void sparse_matrix::setValue(int i, int j, double value) {
+    int k=index(i,j);
+    if(k<0) {
+        throw ModelicaSimulationError(MATH_FUNCTION,"element is not in the sparse pattern");
     }
+    Ax[k]=value;
+    freeNumeric();
+}
+
+double* sparse_matrix::values() {
+    freeNumeric();
+    return Ax.empty() ? NULL : &Ax[0];
+}
+
+void sparse_matrix::valuesChanged() {
+    freeNumeric();
+}
 
 int sparse_matrix::solve(const double* b, double * x) {
     int status, sys=0;
     double Control [UMFPACK_CONTROL], Info [UMFPACK_INFO] ;
-    void *Symbolic, *Numeric ;
     umfpack_di_defaults (Control) ;
-    status = umfpack_di_symbolic (sparse_matrix::n, sparse_matrix::n, &sparse_matrix::Ap[0], &sparse_matrix::Ai[0], &sparse_matrix::Ax[0], &Symbolic, Control, Info) ;
-    status = umfpack_di_numeric (&sparse_matrix::Ap[0], &sparse_matrix::Ai[0], &sparse_matrix::Ax[0], Symbolic, &Numeric, Control, Info);
-    status = umfpack_di_solve (sys, &sparse_matrix::Ap[0], &sparse_matrix::Ai[0], &sparse_matrix::Ax[0], x, b, Numeric, Control, Info);
-    umfpack_di_free_symbolic (&Symbolic);
-    umfpack_di_free_numeric (&Numeric);
+    if(!_symbolic) {
+        status = umfpack_di_symbolic (sparse_matrix::n, sparse_matrix::n, &sparse_matrix::Ap[0], &sparse_matrix::Ai[0], &sparse_matrix::Ax[0], &_symbolic, Control, Info) ;
+        if(status!=UMFPACK_OK) {
+            freeSymbolic();
+            return status;
+        }
+    }
+    if(!_numeric) {
+        status = umfpack_di_numeric (&sparse_matrix::Ap[0], &sparse_matrix::Ai[0], &sparse_matrix::Ax[0], _symbolic, &_numeric, Control, Info);
+        if(status!=UMFPACK_OK) {
+            // a singular matrix still gets a factorization; anything else does not
+            if(status!=UMFPACK_WARNING_singular_matrix) {
+                freeNumeric();
+            }
+            return status;
+        }
+    }
+    status = umfpack_di_solve (sys, &sparse_matrix::Ap[0], &sparse_matrix::Ai[0], &sparse_matrix::Ax[0], x, b, _numeric, Control, Info);
     return status;
 }
 #else
+sparse_matrix::~sparse_matrix() {
+}
+
+void sparse_matrix::freeNumeric() {
+}
+
+void sparse_matrix::freeSymbolic() {
+}
+
 void sparse_matrix::build(sparse_inserter& ins) {
         throw ModelicaSimulationError(MATH_FUNCTION,"no umfpack");
     }
 
+int sparse_matrix::index(int i, int j) const {
+        throw ModelicaSimulationError(MATH_FUNCTION,"no umfpack");
+}
+
+void sparse_matrix::setValue(int i, int j, double value) {
+        throw ModelicaSimulationError(MATH_FUNCTION,"no umfpack");
+}
+
+double* sparse_matrix::values() {
+        throw ModelicaSimulationError(MATH_FUNCTION,"no umfpack");
+}
+
+void sparse_matrix::valuesChanged() {
+        throw ModelicaSimulationError(MATH_FUNCTION,"no umfpack");
+}
+
 int sparse_matrix::solve(const double* b, double * x) {
         throw ModelicaSimulationError(MATH_FUNCTION,"no umfpack");
 }
@@ -0,0 +1,312 @@
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/ReduceDAE/IReduceDAESettings.h>
+#include <Core/SimController/ISimController.h>
+#include <Core/ReduceDAE/IReduceDAE.h>
+#include <Core/ReduceDAE/Reduction.h>
+#include <Core/ReduceDAE/LabelEvaluator.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LABEL_EVALUATOR_FORK
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+LabelEvaluator::LabelEvaluator(label_list_type& labels, ublas::matrix<double>& Ro, shared_ptr<IMixedSystem> system, IReduceDAESettings* settings,
+                               SimSettings simsettings, string modelKey, vector<string> output_names, double timeout, ISimController* sim_controller)
+	:_labels(labels)
+	, _Ro(Ro)
+	, _system(system)
+	, _settings(settings)
+	, _simsettings(simsettings)
+	, _modelKey(modelKey)
+	, _output_names(output_names)
+	, _timeout(timeout)
+	, _sim_controller(sim_controller)
+	, _num_workers(1)
+	, _time_limit(0)
+{
+#ifdef LABEL_EVALUATOR_FORK
+	_num_workers = settings->getNumWorkers();
+	if (_num_workers == 0)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		_num_workers = cores > 0 ? (unsigned int)cores : 1;
+	}
+#endif
+	if (timeout > 0 && settings->getTimeoutFactor() > 0)
+		_time_limit = timeout * settings->getTimeoutFactor();
+}
+
+LabelEvaluator::~LabelEvaluator()
+{
+}
+
+//simulation with the given labels removed, as done before for every single label
+LabelResult LabelEvaluator::simulate(const vector<unsigned int>& removed)
+{
+	LabelResult result;
+	shared_ptr<IReduceDAE> reduce_dae = dynamic_pointer_cast<IReduceDAE>(_system);
+	try
+	{
+		//by initialization all labels becomes 1
+		_sim_controller->initialize(_simsettings, _modelKey, _timeout);
+		for (size_t i = 0; i < removed.size(); i++)
+		{
+			*(get<1>(_labels[removed[i]])) = 0;
+			*(get<2>(_labels[removed[i]])) = 1;
+		}
+
+		_sim_controller->runReducedSimulation();
+
+		//query simulation result outputs
+		ublas::matrix<double> Rc;
+		reduce_dae->getHistory()->getOutputResults(Rc);
+
+		Reduction reduction(_system, _settings);
+		result.error = reduction.getError(Rc, _Ro, _output_names);
+	}
+	catch (ModelicaSimulationError& ex)
+	{
+		result.status = LabelResult::SIMULATION_ERROR;
+		result.suppressed = ex.isSuppressed();
+		result.message = ex.what();
+	}
+	catch (std::invalid_argument& ex)
+	{
+		result.status = LabelResult::DIVISION_BY_ZERO;
+		result.message = ex.what();
+	}
+
+	//reset label values
+	for (size_t i = 0; i < removed.size(); i++)
+	{
+		*(get<1>(_labels[removed[i]])) = 1;
+		*(get<2>(_labels[removed[i]])) = 0;
+	}
+	return result;
+}
+
+void LabelEvaluator::evaluate(const vector<vector<unsigned int> >& jobs, ILabelResultHandler& handler)
+{
+	if (_num_workers > 1 && jobs.size() > 1)
+		evaluateParallel(jobs, handler);
+	else
+		evaluateSerial(jobs, handler);
+}
+
+void LabelEvaluator::evaluateSerial(const vector<vector<unsigned int> >& jobs, ILabelResultHandler& handler)
+{
+	for (size_t i = 0; i < jobs.size(); i++)
+	{
+		LabelResult result = simulate(jobs[i]);
+		if (!handler.handle(i, result))
+			break;
+	}
+}
+
+#ifdef LABEL_EVALUATOR_FORK
+namespace
+{
+	struct Worker
+	{
+		pid_t pid;
+		int fd;
+		size_t job;
+		string data;
+		high_resolution_clock::time_point start;
+	};
+
+	template<typename T> void appendRaw(string& buffer, const T& value)
+	{
+		buffer.append((const char*)&value, sizeof(T));
+	}
+
+	template<typename T> bool readRaw(const string& buffer, size_t& pos, T& value)
+	{
+		if (pos + sizeof(T) > buffer.size())
+			return false;
+		memcpy(&value, buffer.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	string encodeResult(const LabelResult& result)
+	{
+		string buffer;
+		appendRaw(buffer, result.status);
+		appendRaw(buffer, (unsigned char)result.suppressed);
+		appendRaw(buffer, (size_t)result.message.size());
+		buffer.append(result.message);
+		appendRaw(buffer, (size_t)result.error.size());
+		for (size_t i = 0; i < result.error.size(); i++)
+			appendRaw(buffer, result.error(i));
+		return buffer;
+	}
+
+	//a worker that died without a complete result counts as failed simulation
+	LabelResult decodeResult(const string& buffer)
+	{
+		LabelResult result;
+		size_t pos = 0, size;
+		unsigned char suppressed;
+		if (!readRaw(buffer, pos, result.status) || !readRaw(buffer, pos, suppressed) || !readRaw(buffer, pos, size)
+			|| pos + size > buffer.size())
+		{
+			result.status = LabelResult::SIMULATION_ERROR;
+			result.message = "worker process terminated";
+			return result;
+		}
+		result.suppressed = suppressed != 0;
+		result.message = buffer.substr(pos, size);
+		pos += size;
+		if (!readRaw(buffer, pos, size) || pos + size * sizeof(double) != buffer.size())
+		{
+			result.status = LabelResult::SIMULATION_ERROR;
+			result.message = "worker process terminated";
+			return result;
+		}
+		result.error.resize(size);
+		for (size_t i = 0; i < size; i++)
+			readRaw(buffer, pos, result.error(i));
+		return result;
+	}
+
+	void writeAll(int fd, const string& buffer)
+	{
+		size_t pos = 0;
+		while (pos < buffer.size())
+		{
+			ssize_t n = write(fd, buffer.data() + pos, buffer.size() - pos);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				return;
+			pos += n;
+		}
+	}
+
+	void stopWorker(Worker& worker, bool kill_process)
+	{
+		if (kill_process)
+			kill(worker.pid, SIGKILL);
+		close(worker.fd);
+		while (waitpid(worker.pid, NULL, 0) < 0 && errno == EINTR)
+			;
+	}
+}
+
+void LabelEvaluator::evaluateParallel(const vector<vector<unsigned int> >& jobs, ILabelResultHandler& handler)
+{
+	vector<Worker> workers;
+	vector<LabelResult> results(jobs.size());
+	vector<bool> finished(jobs.size(), false);
+	size_t next_job = 0, next_result = 0;
+	bool abort = false;
+
+	while (!abort && next_result < jobs.size())
+	{
+		//start workers for the next jobs
+		while (workers.size() < _num_workers && next_job < jobs.size())
+		{
+			int fds[2];
+			std::cout.flush();
+			std::cerr.flush();
+			if (pipe(fds) != 0)
+				break;
+			pid_t pid = fork();
+			if (pid < 0)
+			{
+				close(fds[0]);
+				close(fds[1]);
+				break;
+			}
+			if (pid == 0)
+			{
+				close(fds[0]);
+				LabelResult result = simulate(jobs[next_job]);
+				writeAll(fds[1], encodeResult(result));
+				close(fds[1]);
+				std::cout.flush();
+				_exit(0);
+			}
+			close(fds[1]);
+			Worker worker;
+			worker.pid = pid;
+			worker.fd = fds[0];
+			worker.job = next_job++;
+			worker.start = high_resolution_clock::now();
+			workers.push_back(worker);
+		}
+
+		if (workers.empty())
+		{
+			//no process could be started, continue in this process
+			results[next_job] = simulate(jobs[next_job]);
+			finished[next_job++] = true;
+		}
+		else
+		{
+			vector<struct pollfd> fds(workers.size());
+			for (size_t i = 0; i < workers.size(); i++)
+			{
+				fds[i].fd = workers[i].fd;
+				fds[i].events = POLLIN;
+				fds[i].revents = 0;
+			}
+			poll(&fds[0], fds.size(), 100);
+
+			high_resolution_clock::time_point now = high_resolution_clock::now();
+			for (size_t i = workers.size(); i-- > 0;)
+			{
+				Worker& worker = workers[i];
+				bool done = false;
+				if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+				{
+					char buffer[4096];
+					ssize_t n = read(worker.fd, buffer, sizeof(buffer));
+					if (n > 0)
+						worker.data.append(buffer, n);
+					else if (n == 0 || errno != EINTR)
+					{
+						stopWorker(worker, false);
+						results[worker.job] = decodeResult(worker.data);
+						done = true;
+					}
+				}
+				if (!done && _time_limit > 0 && duration_cast<duration<double> >(now - worker.start).count() > _time_limit)
+				{
+					stopWorker(worker, true);
+					results[worker.job].status = LabelResult::TIMEOUT;
+					results[worker.job].message = "simulation exceeded " + to_string(_time_limit) + " seconds";
+					done = true;
+				}
+				if (done)
+				{
+					finished[worker.job] = true;
+					workers.erase(workers.begin() + i);
+				}
+			}
+		}
+
+		//hand over the results in job order
+		while (!abort && next_result < jobs.size() && finished[next_result])
+		{
+			abort = !handler.handle(next_result, results[next_result]);
+			next_result++;
+		}
+	}
+
+	for (size_t i = 0; i < workers.size(); i++)
+		stopWorker(workers[i], true);
+}
+#else
+void LabelEvaluator::evaluateParallel(const vector<vector<unsigned int> >& jobs, ILabelResultHandler& handler)
+{
+	evaluateSerial(jobs, handler);
+}
+#endif
@@ -6,6 +6,7 @@
 #include <Core/ReduceDAE/Ranking.h>
 #include <Core/ReduceDAE/IReduceDAESettings.h>
 #include <Core/ReduceDAE/Reduction.h>
+#include <Core/ReduceDAE/LabelEvaluator.h>
 #include <ctime>
 Ranking::Ranking(shared_ptr<IMixedSystem> system, IReduceDAESettings* settings)
 	:_system(system)
@@ -198,6 +199,47 @@ label_list_type Ranking::residuenRanking(ublas::matrix<double>& R, ublas::matrix
 	else
 		throw std::runtime_error("Modelica system is not of type IReduceDAE");
 }
+namespace
+{
+	//stores the rank of each label in the order of the labels
+	class PerfectRankingHandler : public ILabelResultHandler
+	{
+	public:
+		PerfectRankingHandler(label_list_type& labels, vector<double>& rank_vector)
+			:_labels(labels)
+			, _rank_vector(rank_vector)
+		{
+		}
+
+		virtual bool handle(size_t job, LabelResult& result)
+		{
+			label_type& label = _labels[job];
+			double rank_value;
+#undef max
+			if (result.status == LabelResult::OK)
+			{
+				//rank norm_inf (x)= max |xi|
+				rank_value = ublas::norm_inf(result.error);
+			}
+			else
+			{
+				rank_value = std::numeric_limits<double>::max();
+				if (result.status == LabelResult::DIVISION_BY_ZERO)
+					cout << "division by zero for label " << (get<0>(label)) << std::endl;
+				else if (!result.suppressed)
+					cout << "removing label " << (get<0>(label)) << "causes error " << result.message << std::endl;
+			}
+			_rank_vector[job] = rank_value;
+			cout << "rank value for label " << (get<0>(label)) << ": " << rank_value << std::endl;
+			return true;
+		}
+
+	private:
+		label_list_type& _labels;
+		vector<double>& _rank_vector;
+	};
+}
+
 label_list_type Ranking::perfectRanking(ublas::matrix<double>& Ro, shared_ptr<IMixedSystem> _system, IReduceDAESettings* _settings, SimSettings simsettings,
                                         string modelKey, vector<string> output_names, double timeout,ISimController* sim_controller)
 {
@@ -209,9 +251,6 @@ label_list_type Ranking::perfectRanking(ublas::matrix<double>& Ro, shared_ptr<IM
 	//cast modelica system to reduce dae object
 	shared_ptr<IReduceDAE> reduce_dae = dynamic_pointer_cast<IReduceDAE>(_system);
 
-	IHistory* history;
-	ublas::matrix<double> Rc; //current result
-
 	if (reduce_dae)
 	{
 
@@ -222,60 +261,13 @@ label_list_type Ranking::perfectRanking(ublas::matrix<double>& Ro, shared_ptr<IM
 		int kDim = labels.size();
 		//vector for ranks
 		vector<double> rank_vector(kDim);
-		double rank_value;
-		//index for current ranking
-		unsigned int k = 0;
-		//loop over labels
-		FOREACH(label_type  label, labels)
-		{
-			try{
-
-				sim_controller->initialize(simsettings, modelKey, timeout);
-				//set label_1 to 0 and label_2 to 1
-				*(get<1>(label)) = 0;
-				*(get<2>(label)) = 1;
-				//vector for errors
-				ublas::vector<double> e(n);
-
-				sim_controller->runReducedSimulation();
-				history = reduce_dae->getHistory();
-				//query simulation result outputs
-				Rc.clear();
-				history->getOutputResults(Rc);
-
-
-				Reduction reduction(_system, _settings);
-				e = reduction.getError(Rc, Ro, output_names);;
-
-				//rank norm_inf (x)= max |xi|
-				rank_value = ublas::norm_inf(e);
-
-			}
-			catch (ModelicaSimulationError& ex)
-			{
-#undef max
-				rank_value = std::numeric_limits<double>::max();
-				if (!ex.isSuppressed())
-					cout << "removing label " << (get<0>(label)) << "causes error " << ex.what() << std::endl;
-				// std::cerr << "Simulation stopped with error in " << error_id_string(ex.getErrorID()) << ": "  << ex.what();
-
-			}
-			catch (std::invalid_argument& ex) // division by zero
-			{
-#undef max
-				rank_value = std::numeric_limits<double>::max();
-				cout << "division by zero for label " << (get<0>(label)) << std::endl;
-			}
-
-
-
-			rank_vector[k++] = rank_value;
-			cout << "rank value for label " << (get<0>(label)) << ": " << rank_value << std::endl;
-
-			//reset current label values
-			*(get<1>(label)) = 1;
-			*(get<2>(label)) = 0;
-		}
+		//one simulation for each label, run on the workers of the evaluator
+		vector<vector<unsigned int> > jobs(kDim);
+		for (int k = 0; k < kDim; k++)
+			jobs[k].push_back(k);
+		LabelEvaluator evaluator(labels, Ro, _system, _settings, simsettings, modelKey, output_names, timeout, sim_controller);
+		PerfectRankingHandler handler(labels, rank_vector);
+		evaluator.evaluate(jobs, handler);
 		//sort the label list in the order of the sorted ranking vector
 		sort(labels.begin(), labels.end(),
 			boost::lambda::var(rank_vector)[boost::lambda::bind(Li(), boost::lambda::_1)] <
@@ -9,7 +9,9 @@
 ReduceDAESettings::ReduceDAESettings(IGlobalSettings*	globalSettings)
 	:_globalSettings(globalSettings),
 	_ranking_method(RESIDUEN),
-	_reduction_method(CANCEL_TERMS)
+	_reduction_method(CANCEL_TERMS),
+	_num_workers(0),
+	_timeout_factor(10.0)
 
 {
 	//initialize max errro vector with default size
@@ -67,6 +69,26 @@ vector<string> ReduceDAESettings::getOutputNames()
 	return _output_names;
 }
 
+unsigned int ReduceDAESettings::getNumWorkers()
+{
+	return _num_workers;
+}
+
+void ReduceDAESettings::setNumWorkers(unsigned int workers)
+{
+	_num_workers = workers;
+}
+
+double ReduceDAESettings::getTimeoutFactor()
+{
+	return _timeout_factor;
+}
+
+void ReduceDAESettings::setTimeoutFactor(double factor)
+{
+	_timeout_factor = factor;
+}
+
 /**
 initializes settings object by an xml file
 */
@@ -105,6 +127,16 @@ void ReduceDAESettings::load(std::string xml_file)
 
 				}
 
+				if (vars.first == "NumWorkers")
+				{
+					_num_workers = vars.second.get<int>("<xmlattr>.value");
+				}
+
+				if (vars.first == "TimeoutFactor")
+				{
+					_timeout_factor = vars.second.get<double>("<xmlattr>.value");
+				}
+
 				if (vars.first == "MaximumError")
 				{
 					ublas::vector<double>::size_type  i = 0;
@@ -3,6 +3,7 @@
 #include <Core/ReduceDAE/IReduceDAESettings.h>
 #include <Core/ReduceDAE/IReduceDAE.h>
 #include <Core/ReduceDAE/Reduction.h>
+#include <Core/ReduceDAE/LabelEvaluator.h>
 #include <boost/math/special_functions/fpclassify.hpp>
 
 Reduction::Reduction( shared_ptr<IMixedSystem> system, IReduceDAESettings* settings)
@@ -60,6 +61,88 @@ ublas::vector<double> Reduction::getError(ublas::matrix<double>& R, ublas::matri
 	return error;
 
 }
+namespace
+{
+	//decides about the labels in job order; stops at the first deleted label, since the
+	//results of the following jobs were computed without it
+	class CancelTermsHandler : public ILabelResultHandler
+	{
+	public:
+		CancelTermsHandler(Reduction& reduction, IReduceDAESettings* settings, label_list_type& labels, size_t first_label,
+		                   ublas::vector<double>& sorted_max_error, vector<int>& indexes, vector<string>& output_names,
+		                   std::vector<unsigned int>& canceled_labels, std::vector<unsigned int>& help_canceled_labels, unsigned int& nfail)
+			:handled(0)
+			, stop(false)
+			, _reduction(reduction)
+			, _settings(settings)
+			, _labels(labels)
+			, _first_label(first_label)
+			, _sorted_max_error(sorted_max_error)
+			, _indexes(indexes)
+			, _output_names(output_names)
+			, _canceled_labels(canceled_labels)
+			, _help_canceled_labels(help_canceled_labels)
+			, _nfail(nfail)
+		{
+		}
+
+		virtual bool handle(size_t job, LabelResult& result)
+		{
+			size_t index = _first_label + job;
+			unsigned int reductionStep = index + 1;
+			label_type& label = _labels[index];
+			handled = job + 1;
+			if (result.status == LabelResult::OK)
+			{
+				//check if error of selected varibles based on indexes vector is less than max error
+				if (_reduction.isLess(result.error, _sorted_max_error, _indexes, _output_names))
+				{
+					cout << "delete term for label " << get<0>(label) << " with error " << result.error << std::endl;
+					//add label number to canceled_labels
+					_canceled_labels.push_back(get<0>(label));
+					_help_canceled_labels.push_back(index);
+					return false;
+				}
+				cout << "do nothing for label " << get<0>(label) << " with error " << result.error << std::endl;
+				_nfail++;
+				//check if looking for terms to reduce has failed more than allowed
+				if (_nfail > _settings->getNFail())
+				{
+					cout << "Redution stoped at step " << reductionStep + 1 << " because of exceeding max number of reduction fails" << std::endl;
+					stop = true;
+				}
+			}
+			else
+			{
+				if (!result.suppressed)
+					cout << "do nothing for label " << get<0>(label) << " with error " << result.message << std::endl;
+				_nfail++;
+				if (_nfail > _settings->getNFail())
+				{
+					cout << "Redution failed for " << _nfail << " times. So, it stoped at step " << reductionStep + 1 << std::endl;
+					stop = true;
+				}
+			}
+			return !stop;
+		}
+
+		size_t handled;	///< number of jobs decided
+		bool stop;		///< max number of reduction fails exceeded
+
+	private:
+		Reduction& _reduction;
+		IReduceDAESettings* _settings;
+		label_list_type& _labels;
+		size_t _first_label;
+		ublas::vector<double>& _sorted_max_error;
+		vector<int>& _indexes;
+		vector<string>& _output_names;
+		std::vector<unsigned int>& _canceled_labels;
+		std::vector<unsigned int>& _help_canceled_labels;
+		unsigned int& _nfail;
+	};
+}
+
 std::vector<unsigned int> Reduction::cancelTerms(label_list_type& labels, ublas::matrix<double>& Ro, shared_ptr<IMixedSystem> _system, IReduceDAESettings* _settings
                                                  ,SimSettings simsettings, string modelKey, vector<string> output_names, double timeout,ISimController* sim_controller)
 {
@@ -71,20 +154,13 @@ std::vector<unsigned int> Reduction::cancelTerms(label_list_type& labels, ublas:
 
 	//vector of labels to be canceled
 	std::vector<unsigned int> canceled_labels;
+	//indexes of the canceled labels, they stay removed in all following simulations
 	std::vector<unsigned int> help_canceled_labels;
 	//cast modelica system to reduce dae object
 
 	shared_ptr<IReduceDAE> reduce_dae = dynamic_pointer_cast<IReduceDAE>(_system);
-	//get history object to query simulation results
-	IHistory*  history;
-
-	//simulation results for output variables of k.-reduction
-	ublas::matrix<double> Rok;
-	//current label
-
 
 	unsigned int nfail = 0;
-	unsigned int reductionStep = 1;
 	if (reduce_dae)
 	{
 
@@ -115,105 +191,25 @@ std::vector<unsigned int> Reduction::cancelTerms(label_list_type& labels, ublas:
         #ifdef USE_CHRONO
 		auto start = high_resolution_clock::now();
         #endif
-		//loop over labels
-		FOREACH(label_type  label, labels)
+		LabelEvaluator evaluator(labels, Ro, _system, _settings, simsettings, modelKey, output_names, timeout, sim_controller);
+		Reduction reduction(_system, _settings);
+		//each label is tried together with the labels deleted so far; the next labels are
+		//simulated speculatively on all workers and decided in order
+		size_t next = 0;
+		bool stop = false;
+		while (!stop && next < labels.size())
 		{
-			try
-			{
-
-				//removing initialization from here and put it ouside of BOOST_FOREACH,
-				//cause not updated output values on Rok vector!!
-				#ifdef USE_CHRONO
-                auto startSim1 = high_resolution_clock::now();
-				#endif
-                sim_controller->initialize(simsettings, modelKey, timeout);
-				//set current label_1 to 0 and label_2 to 1
-				*(get<1>(label)) = 0;
-				*(get<2>(label)) = 1;
-				//by initialization all labels becomes 1,
-				// so with this help_canceled_labels we apply all labels which are zero untill now to the model again
-				for (int i = 0; i < help_canceled_labels.size(); i++)
-				{
-
-					//cout << "indexes of deleted labels applied to the model " <<  get<0>(labels[help_canceled_labels[i]]) <<std::endl;
-					*(get<1>(labels[help_canceled_labels[i]])) = 0;
-					*(get<2>(labels[help_canceled_labels[i]])) = 1;
-				}
-
-				//number of output variables
-				ublas::matrix<double>::size_type n;
-				n = Ro.size1();
-				//vector for errors
-				ublas::vector<double> error(n);
-				//run simulation
-				sim_controller->runReducedSimulation();
-				#ifdef USE_CHRONO
-                auto endSim1 =  high_resolution_clock::now();
-				double simtime = duration_cast<duration<double>>(endSim1 - startSim1).count();
-				#endif
-                std::cout << " time of simulation for reducing label " << get<0>(label) << " is " << simtime << " seconds" << std::endl;
-				history = reduce_dae->getHistory();
-
-				//query simulation result outputs
-				Rok.clear();
-				history->getOutputResults(Rok);
-
-				//error
-
-				Reduction reduction(_system, _settings);
-
-				error = reduction.getError(Rok, Ro, output_names);
-
-				//check if error of selected varibles based on indexes vector is less than max error
-				if (reduction.isLess(error, sorted_max_error, indexes, output_names))
-				{
-					cout << "delete term for label " << get<0>(label) << " with error " << error << std::endl;
-					//add label number to canceled_labels
-					canceled_labels.push_back(get<0>(label));
-					help_canceled_labels.push_back(reductionStep - 1);
-				}
-				else
-				{
-					cout << "do nothing for label " << get<0>(label) << " with error " << error << std::endl;
-					//reset current label values
-					*(get<1>(label)) = 1;
-					*(get<2>(label)) = 0;
-					nfail++;
-
-					//check if looking for terms to reduce has failed more than allowed
-					if ((nfail) > _settings->getNFail())
-					{
-						cout << "Redution stoped at step " << reductionStep + 1 << " because of exceeding max number of reduction fails" << std::endl;
-						//stop looking for terms to delete
-						break;
-					}
-
-				}
-
-			}
-
-			catch (ModelicaSimulationError& ex)
+			vector<vector<unsigned int> > jobs;
+			for (size_t k = next; k < labels.size() && jobs.size() < evaluator.getNumWorkers(); k++)
 			{
-				if (!ex.isSuppressed())
-					cout << "do nothing for label " << get<0>(label) << " with error " << ex.what() << std::endl;
-				// std::cerr << "Simulation stopped with error in " << error_id_string(ex.getErrorID()) << ": "  << ex.what();
-				//reset current label values
-				*(get<1>(label)) = 1;
-				*(get<2>(label)) = 0;
-				nfail++;
-
-				//check if looking for terms to reduce has failed more than allowed
-				if ((nfail) > _settings->getNFail())
-				{
-					cout << "Redution failed for " << nfail << " times. So, it stoped at step " << reductionStep + 1 << std::endl;
-					//stop looking for terms to delete
-					break;
-				}
-
+				jobs.push_back(help_canceled_labels);
+				jobs.back().push_back(k);
 			}
-
-			reductionStep++;
-
+			CancelTermsHandler handler(reduction, _settings, labels, next, sorted_max_error, indexes, output_names,
+			                           canceled_labels, help_canceled_labels, nfail);
+			evaluator.evaluate(jobs, handler);
+			next += handler.handled;
+			stop = handler.stop || handler.handled == 0;
 		}
         #ifdef USE_CHRONO
 		auto end = high_resolution_clock::now();
@@ -161,6 +161,8 @@ void SimController::Start(SimSettings simsettings, string modelKey)
         global_settings->setEmitResults(simsettings.emitResults);
         global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
         global_settings->setSolverThreads(simsettings.solverThreads);
+        if (simsettings.outputQueueDepth > 0)
+            global_settings->setOutputQueueDepth(simsettings.outputQueueDepth);
         global_settings->setInputPath(simsettings.inputPath);
         global_settings->setOutputPath(simsettings.outputPath);
 
@@ -262,6 +264,8 @@ void SimController::StartReduceDAE(SimSettings simsettings,string modelPath, str
         global_settings->setEmitResults(simsettings.emitResults);
         global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
         global_settings->setSolverThreads(simsettings.solverThreads);
+        if (simsettings.outputQueueDepth > 0)
+            global_settings->setOutputQueueDepth(simsettings.outputQueueDepth);
         /*shared_ptr<SimManager>*/ _simMgr = shared_ptr<SimManager>(new SimManager(mixedsystem, _config.get()));
 
         ISolverSettings* solver_settings = _config->getSolverSettings();
@@ -471,6 +475,8 @@ void SimController::initialize(SimSettings simsettings, string modelKey, double
         global_settings->setEmitResults(simsettings.emitResults);
         global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
         global_settings->setSolverThreads(simsettings.solverThreads);
+        if (simsettings.outputQueueDepth > 0)
+            global_settings->setOutputQueueDepth(simsettings.outputQueueDepth);
         /*shared_ptr<SimManager>*/ _simMgr = shared_ptr<SimManager>(new SimManager(mixedsystem, _config.get()));
 
         ISolverSettings* solver_settings = _config->getSolverSettings();
@@ -22,6 +22,7 @@ GlobalSettings::GlobalSettings()
   , _nonLinSolverContinueOnError(false)
   , _outputPointType(OPT_ALL)
   , _alarm_time(0)
+  , _outputQueueDepth(64)
   , _outputFormat(MAT)
 {
 }
@@ -221,6 +222,16 @@ int GlobalSettings::getSolverThreads()
   return _solverThreads;
 }
 
+void GlobalSettings::setOutputQueueDepth(unsigned int depth)
+{
+  _outputQueueDepth = depth;
+}
+
+unsigned int GlobalSettings::getOutputQueueDepth()
+{
+  return _outputQueueDepth;
+}
+
  OutputFormat GlobalSettings::getOutputFormat()
  {
      return _outputFormat;
@@ -0,0 +1,127 @@
+/** @addtogroup coreSolver
+ *
+ *  @{
+ */
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Solver/FactoryExport.h>
+#include <Core/Solver/ColoredSparseJacobian.h>
+
+ColoredSparseJacobian::ColoredSparseJacobian()
+  : _dim(0)
+  , _nnz(0)
+  , _numColors(0)
+{
+}
+
+ColoredSparseJacobian::~ColoredSparseJacobian()
+{
+}
+
+bool ColoredSparseJacobian::initialize(IMixedSystem* system, int dim)
+{
+  _dim = 0;
+  _nnz = 0;
+  _numColors = 0;
+  if (dim <= 0 || !system->isJacobianSparse() || !system->isAnalyticJacobianGenerated())
+    return false;
+
+  _numColors = system->getAMaxColors();
+  if (_numColors <= 0)
+    return false;
+  std::vector<int> colorOfColumn(dim);
+  system->getAColorOfColumn(&colorOfColumn[0], dim);
+
+  // rows of every column, including the diagonal
+  std::vector<std::vector<std::pair<int, bool> > > columns(dim);
+  for (int j = 0; j < dim; j++)
+    columns[j].push_back(std::make_pair(j, false));
+  try
+  {
+    const sparsematrix_t& A = system->getSparseJacobian();
+    if ((int)A.size1() != dim || (int)A.size2() != dim)
+    {
+      _numColors = 0;
+      return false;
+    }
+    for (sparsematrix_t::const_iterator2 it2 = A.begin2(); it2 != A.end2(); ++it2)
+    {
+      for (sparsematrix_t::const_iterator1 it1 = it2.begin(); it1 != it2.end(); ++it1)
+      {
+        int row = it1.index1(), col = it1.index2();
+        if (row == col)
+          columns[col][0].second = true;
+        else
+          columns[col].push_back(std::make_pair(row, true));
+      }
+    }
+  }
+  catch (std::exception&)
+  {
+    // the system has no sparse A matrix
+    _numColors = 0;
+    return false;
+  }
+
+  _colPtrs.assign(dim + 1, 0);
+  _rowVals.clear();
+  _structural.clear();
+  _diagonal.assign(dim, 0);
+  for (int j = 0; j < dim; j++)
+  {
+    std::sort(columns[j].begin(), columns[j].end());
+    columns[j].erase(std::unique(columns[j].begin(), columns[j].end()), columns[j].end());
+    for (size_t k = 0; k < columns[j].size(); k++)
+    {
+      if (columns[j][k].first == j)
+        _diagonal[j] = _rowVals.size();
+      _rowVals.push_back(columns[j][k].first);
+      _structural.push_back(columns[j][k].second);
+    }
+    _colPtrs[j + 1] = _rowVals.size();
+  }
+
+  // group the columns by color
+  _colorStart.assign(_numColors + 1, 0);
+  for (int j = 0; j < dim; j++)
+  {
+    if (colorOfColumn[j] < 1 || colorOfColumn[j] > _numColors)
+    {
+      _numColors = 0;
+      return false;
+    }
+    _colorStart[colorOfColumn[j]]++;
+  }
+  for (int c = 0; c < _numColors; c++)
+    _colorStart[c + 1] += _colorStart[c];
+  _colorColumns.resize(dim);
+  std::vector<int> next(_colorStart.begin(), _colorStart.end() - 1);
+  for (int j = 0; j < dim; j++)
+    _colorColumns[next[colorOfColumn[j] - 1]++] = j;
+
+  _dim = dim;
+  _nnz = _rowVals.size();
+  return true;
+}
+
+void ColoredSparseJacobian::copyPattern(int* colptrs, int* rowvals) const
+{
+  std::copy(_colPtrs.begin(), _colPtrs.end(), colptrs);
+  std::copy(_rowVals.begin(), _rowVals.end(), rowvals);
+}
+
+const int* ColoredSparseJacobian::getColorColumns(int color, int& n) const
+{
+  n = _colorStart[color + 1] - _colorStart[color];
+  return &_colorColumns[_colorStart[color]];
+}
+
+void ColoredSparseJacobian::storeColumn(int col, const double* fPerturbed, const double* f, double deltaInv, double* values) const
+{
+  for (int k = _colPtrs[col]; k < _colPtrs[col + 1]; k++)
+  {
+    int row = _rowVals[k];
+    values[k] = _structural[k] ? (fPerturbed[row] - f[row]) * deltaInv : 0.0;
+  }
+}
+/** @} */ // end of coreSolver
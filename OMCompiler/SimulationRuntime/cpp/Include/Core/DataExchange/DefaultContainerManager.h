@@ -51,5 +51,14 @@ class DefaultContainerManager : public Writer
     {
       writeContainer(container);
     };
+    /**
+     * Containers are written directly, so there is no queue.
+     */
+    void setWriteQueueDepth(unsigned int depth)
+    {
+    }
+    void flushContainers()
+    {
+    }
 };
 /** @} */ // end of dataexchange
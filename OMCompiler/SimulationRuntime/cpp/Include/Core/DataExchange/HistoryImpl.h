@@ -28,7 +28,8 @@ public:
 
   virtual ~HistoryImpl()
   {
-
+    //the writer policy must not be destroyed while queued rows are written
+    ResultsPolicy::flushContainers();
   }
 
   /*
@@ -40,6 +41,7 @@ public:
 
   virtual void init()
   {
+    ResultsPolicy::setWriteQueueDepth(_globalSettings.getOutputQueueDepth());
     ResultsPolicy::init(_globalSettings.getResultsFileName(), _dim);
   }
 
@@ -51,16 +53,19 @@ public:
 
   void getSimResults(const double time, ublas::vector<double>& v, ublas::vector<double>& dv)
   {
+    ResultsPolicy::flushContainers();
     ResultsPolicy::read(time,v,dv);
   }
 
   void getSimResults(ublas::matrix<double>& R, ublas::matrix<double>& dR)
   {
+    ResultsPolicy::flushContainers();
     ResultsPolicy::read(R,dR);
   }
 
   void getSimResults(ublas::matrix<double>& R, ublas::matrix<double>& dR, ublas::matrix<double>& Re)
   {
+    ResultsPolicy::flushContainers();
     ResultsPolicy::read(R, dR, Re);
   }
 
@@ -68,11 +73,13 @@ public:
   {
     //vector<unsigned int> ids;
     //boost::copy(_var_outputs | boost::adaptors::map_keys, std::back_inserter(ids));
+    ResultsPolicy::flushContainers();
     ResultsPolicy::read(Ro);
   }
 
   unsigned long getSize()
   {
+    ResultsPolicy::flushContainers();
     return ResultsPolicy::size();
   }
 
@@ -94,21 +101,25 @@ public:
   vector<double> getTimeEntries()
   {
     vector<double> time;
+    ResultsPolicy::flushContainers();
     ResultsPolicy::getTime(time);
     return time;
   }
 
  virtual  void clear()
   {
+    ResultsPolicy::flushContainers();
     ResultsPolicy::eraseAll();
   };
   virtual void write(const all_vars_t& v_list, double start_time, double end_time)
   {
+      ResultsPolicy::flushContainers();
       ResultsPolicy::write(v_list,start_time,end_time);
   };
   virtual void write(const all_names_t& s_list,const all_description_t& s_desc_list, const all_names_t& s_parameter_list,const all_description_t&
   s_desc_parameter_list)
   {
+      ResultsPolicy::flushContainers();
       ResultsPolicy::write(s_list,s_desc_list,s_parameter_list,s_desc_parameter_list);
   };
   virtual void write(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list)
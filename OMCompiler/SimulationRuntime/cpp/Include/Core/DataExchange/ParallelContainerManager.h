@@ -7,95 +7,177 @@
 #include <Core/Modelica.h>
 #include <Core/ModelicaDefine.h>
 
-#define CONTAINER_COUNT 3
+#define CONTAINER_COUNT 64
 
 /**
- * This container manager is designed to write simulation results in parallel. It has multiple data containers that
- * can be filled with values. The write routine works asynchronously with the help of a consumer-producer-queue.
+ * This container manager is designed to write simulation results in parallel. The simulation thread copies
+ * the values of every output row into a bounded ring of containers, a single writer thread drains all rows
+ * that are queued at once and hands them to the writer policy in one call. Both sides only sleep if the ring
+ * is full respectively empty, the lock just guards the ring indices.
  */
 class ParallelContainerManager : public Writer
 {
   private:
-    deque<write_data_t > _writeContainers;
-    deque<write_data_t > _freeContainers;
-    semaphore _freeContainerMutex;
-    semaphore _writeContainerMutex;
-    semaphore _nempty;
-    thread _writerThread;
+    /**
+     * Storage of the values of one output row, the pointers of the matching container point into it.
+     */
+    struct ContainerValues
+    {
+      boost::container::vector<double> realValues;
+      boost::container::vector<int> intValues;
+      boost::container::vector<bool> boolValues;
+      boost::container::vector<double> derValues;
+      boost::container::vector<double> resValues;
+    };
+
+    vector<write_data_t> _containers;
+    vector<ContainerValues> _containerValues;
+    size_t _head;             ///< number of containers taken by the writer thread
+    size_t _tail;             ///< number of containers queued by the simulation thread
+    size_t _written;          ///< number of containers that are written completely
+    mutex _mutex;
+    condition_variable _notEmpty;
+    condition_variable _notFull;
     bool _threadWorkDone;
+    thread _writerThread;
 
-  protected:
-    void writeThread()
+    template<typename T>
+    static void copyValues(const boost::container::vector<const T*>& vars, boost::container::vector<T>& values,
+                           boost::container::vector<const T*>& pointers)
     {
-      std::cerr << "Parallel writer thread used" << std::endl;
-      while(!_threadWorkDone)
-        writeContainer();
-
-      while(!_writeContainers.empty())
-        writeContainer();
+      size_t n = vars.size();
+      values.resize(n);
+      for (size_t i = 0; i < n; ++i)
+        values[i] = *vars[i];
+      pointers.resize(n);
+      for (size_t i = 0; i < n; ++i)
+        pointers[i] = &values[i];
     }
 
-    void writeContainer()
+    /**
+     * Waits until there is a free container at the tail of the ring.
+     */
+    void waitForFreeContainer()
     {
-      const write_data_t* container;
-
-      _writeContainerMutex.wait();
-      if (!_writeContainers.empty())
-        container = &_writeContainers.front();
-
-      _writeContainerMutex.post();
+      unique_lock<mutex> lock(_mutex);
+      while (_tail - _written >= _containers.size())
+        _notFull.wait(lock);
+    }
 
-      if (!container)
+  protected:
+    void writeThread()
+    {
+      while (true)
       {
-        usleep(5);
-        return;
+        size_t head, tail;
+        {
+          unique_lock<mutex> lock(_mutex);
+          while (_head == _tail && !_threadWorkDone)
+            _notEmpty.wait(lock);
+          if (_head == _tail)
+            return;
+          head = _head;
+          tail = _tail;
+          _head = tail;
+        }
+
+        //write all queued containers, in at most two contiguous parts of the ring
+        while (head != tail)
+        {
+          size_t begin = head % _containers.size();
+          size_t count = std::min(tail - head, _containers.size() - begin);
+          writeRows(&_containers[begin], count);
+          head += count;
+        }
+
+        {
+          unique_lock<mutex> lock(_mutex);
+          _written = tail;
+        }
+        _notFull.notify_all();
       }
-
-      write(get<0>(*container),get<1>(*container));
-
-      _writeContainerMutex.wait();
-      _writeContainers.pop_front();
-      _writeContainerMutex.post();
-
-      _freeContainerMutex.wait();
-      _freeContainers.push_back(*container);
-      _freeContainerMutex.post();
-      _nempty.post();
     }
 
   public:
     ParallelContainerManager() : Writer()
-      , _writeContainers()
-      ,_freeContainers()
-      ,_freeContainerMutex(1)
-      ,_writeContainerMutex(1)
-      ,_nempty(CONTAINER_COUNT)
-      ,_writerThread(&ParallelContainerManager::writeThread, this)
-      ,_threadWorkDone(false)
+      , _containers(CONTAINER_COUNT)
+      , _containerValues(CONTAINER_COUNT)
+      , _head(0)
+      , _tail(0)
+      , _written(0)
+      , _threadWorkDone(false)
     {
+      _writerThread = thread(&ParallelContainerManager::writeThread, this);
     }
 
     virtual ~ParallelContainerManager()
     {
-      _threadWorkDone = true;
+      {
+        unique_lock<mutex> lock(_mutex);
+        _threadWorkDone = true;
+      }
+      _notEmpty.notify_one();
       _writerThread.join();
     }
 
-    virtual write_data_t& getFreeContainer()
+    /**
+     * Sets the number of output rows that can be queued before the simulation has to wait for the writer.
+     */
+    void setWriteQueueDepth(unsigned int depth)
     {
-      _nempty.wait();
-      _freeContainerMutex.wait();
+      flushContainers();
+      unique_lock<mutex> lock(_mutex);
+      if (depth > 0 && depth != _containers.size())
+      {
+        _containers.resize(depth);
+        _containerValues.resize(depth);
+      }
+    }
 
-       write_data_t& container = _freeContainers.front();
-      _freeContainers.pop_front();
-      _freeContainerMutex.post();
+    /**
+     * Blocks until all queued containers are written.
+     */
+    void flushContainers()
+    {
+      unique_lock<mutex> lock(_mutex);
+      while (_written != _tail)
+        _notFull.wait(lock);
+    }
 
-      return container;
-  };
+    virtual write_data_t& getFreeContainer()
+    {
+      waitForFreeContainer();
+      return _containers[_tail % _containers.size()];
+    };
+
+    /**
+     * Copies the current values of the given container to the queue, so the simulation can go on while they are written.
+     */
+    virtual void addContainerToWriteQueue(const write_data_t& container)
+    {
+      waitForFreeContainer();
+
+      //the slot at the tail is owned by this thread until _tail is increased
+      size_t slot = _tail % _containers.size();
+      write_data_t& queued = _containers[slot];
+      ContainerValues& values = _containerValues[slot];
+      const all_vars_time_t& vars = get<0>(container);
+      all_vars_time_t& queuedVars = get<0>(queued);
+
+      copyValues(get<0>(vars), values.realValues, get<0>(queuedVars));
+      copyValues(get<1>(vars), values.intValues, get<1>(queuedVars));
+      copyValues(get<2>(vars), values.boolValues, get<2>(queuedVars));
+      get<3>(queuedVars) = get<3>(vars);
+      copyValues(get<4>(vars), values.derValues, get<4>(queuedVars));
+      copyValues(get<5>(vars), values.resValues, get<5>(queuedVars));
+      if (&queued != &container)
+        get<1>(queued) = get<1>(container);
 
-  virtual void addContainerToWriteQueue(const write_data_t& container)
-  {
-    _writeContainers.push_back(container);
-  };
+      {
+        unique_lock<mutex> lock(_mutex);
+        _tail++;
+      }
+      _notEmpty.notify_one();
+    };
 };
 /** @} */ // end of dataexchange
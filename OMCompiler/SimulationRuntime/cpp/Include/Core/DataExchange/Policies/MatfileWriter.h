@@ -704,54 +704,86 @@ class MatFileWriter : public ContainerManager
     virtual void write(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list)
     {
         unsigned int uiVarCount = get<0>(v_list).size() + get<1>(v_list).size() + get<2>(v_list).size() + 1;  // alle Variablen, alle abgeleiteten Variablen und die Zeit
-        double *doubleHelpMatrix = NULL;
 
         _uiValueCount++;
 
         // reset tempbuffer to zero
         memset(_doubleMatrixData2, 0, sizeof(double) * uiVarCount);
-        doubleHelpMatrix = _doubleMatrixData2;
+        writeRow(v_list, neg_v_list, _doubleMatrixData2);
+
+        // write matrix to file
+        writeMatVer4Matrix("data_2", uiVarCount, _uiValueCount, _doubleMatrixData2, sizeof(double));
+    }
+
+    /*=={function}===================================================================================*/
+    /*!
+     *  void writeRows(const write_data_t* rows, size_t count)
+     *
+     *  brief:
+     *  ------
+     *  function writes several time steps at once; the "data_2" header is updated only once
+     *  and all values are appended with one write
+     *
+     * \param[in]      rows
+     * \n        usage: output values of the time steps
+     * \n        range: not relevant
+     *
+     * \param[in]      count
+     * \n        usage: number of time steps
+     * \n        range: [0 ; +4294967295]
+     *
+     * \return
+     */
+    /*========================================================================================{end}==*/
+    virtual void writeRows(const write_data_t* rows, size_t count)
+    {
+        if (count == 0)
+            return;
+
+        const all_vars_time_t& v_list = get<0>(rows[0]);
+        unsigned int uiVarCount = get<0>(v_list).size() + get<1>(v_list).size() + get<2>(v_list).size() + 1;
+
+        _rowsBuffer.resize(uiVarCount * count);
+        for (size_t i = 0; i < count; ++i)
+            writeRow(get<0>(rows[i]), get<1>(rows[i]), &_rowsBuffer[i * uiVarCount]);
+
+        _uiValueCount += count;
+        writeMatVer4MatrixHeader("data_2", uiVarCount, _uiValueCount, sizeof(double));
+        _output_stream.write((const char*) &_rowsBuffer[0], sizeof(double) * uiVarCount * count);
+    }
+
+    /*=={function}===================================================================================*/
+    /*!
+     *  void writeRow(const all_vars_time_t& v_list, const neg_all_vars_t& neg_v_list, double *row)
+     *
+     *  brief:
+     *  ------
+     *  function copies the values of one time step to a row of the "data_2" matrix:
+     *  time, real, int and bool variables
+     *
+     * \return
+     */
+    /*========================================================================================{end}==*/
+    void writeRow(const all_vars_time_t& v_list, const neg_all_vars_t& neg_v_list, double *row)
+    {
+        size_t nReal = get<0>(v_list).size();
+        size_t nInt = get<1>(v_list).size();
 
         // first time ist written to "data_2" matrix...
-        *doubleHelpMatrix = get<3>(v_list);
-        doubleHelpMatrix++;
+        *row = get<3>(v_list);
+        row++;
 
         // ...followed by real variable values...
-        /*for (real_vars_t::const_iterator it = get<0>(v_list).begin(); it != get<0>(v_list).end(); ++it)
-        {
-            *doubleHelpMatrix = *(*it);
-            doubleHelpMatrix++;
-        }*/
-
         std::transform(get<0>(v_list).begin(), get<0>(v_list).end(), get<0>(neg_v_list).begin(),
-            doubleHelpMatrix, WriteOutputVar<double>());
-
+            row, WriteOutputVar<double>());
 
-        // ...followed by int variable values.
-        /*for (int_vars_t::const_iterator it = get<1>(v_list).begin(); it != get<1>(v_list).end(); ++it)
-        {
-            *doubleHelpMatrix = *(*it);
-            doubleHelpMatrix++;
-        }*/
-            size_t nReal = get<0>(v_list).size();
+        // ...followed by int variable values...
         std::transform(get<1>(v_list).begin(), get<1>(v_list).end(), get<1>(neg_v_list).begin(),
-            doubleHelpMatrix + nReal, WriteOutputVar<int>());
+            row + nReal, WriteOutputVar<int>());
+
         // ...followed by bool variable values.
-        /*for (bool_vars_t::const_iterator it = get<2>(v_list).begin(); it != get<2>(v_list).end(); ++it)
-        {
-            *doubleHelpMatrix = *(*it);
-            doubleHelpMatrix++;
-        }
-        */
-             size_t nInt = get<1>(v_list).size();
         std::transform(get<2>(v_list).begin(), get<2>(v_list).end(), get<2>(neg_v_list).begin(),
-            doubleHelpMatrix+nReal+nInt, WriteOutputVar<bool>());
-
-        // write matrix to file
-        writeMatVer4Matrix("data_2", uiVarCount, _uiValueCount, _doubleMatrixData2, sizeof(double));
-
-        // initialize pointer
-        doubleHelpMatrix = NULL;
+            row + nReal + nInt, WriteOutputVar<bool>());
     }
 
     /*=================================================================================*/
@@ -813,6 +845,7 @@ class MatFileWriter : public ContainerManager
     char *_stringMatrix;
     char *_pacString;
     int *_intMatrix;
+    vector<double> _rowsBuffer;          ///< values of the time steps written by writeRows
     vector<string> _var_outputs;
 };
 /** @} */ // end of dataexchangePolicies
@@ -108,6 +108,24 @@ class TextFileWriter : public ContainerManager
      @time
      */
     virtual void write(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list)
+    {
+        writeRow(v_list, neg_v_list);
+        _output_stream.flush();
+    }
+
+    /*
+     writes the simulation results of several time steps and flushes the file once
+     @rows values of the time steps
+     @count number of time steps
+     */
+    virtual void writeRows(const write_data_t* rows, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            writeRow(get<0>(rows[i]), get<1>(rows[i]));
+        _output_stream.flush();
+    }
+
+    void writeRow(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list)
     {
         _output_stream << get<3>(v_list) << SEPERATOR;
 
@@ -123,7 +141,7 @@ class TextFileWriter : public ContainerManager
         std::transform(get<2>(v_list).begin(), get<2>(v_list).end(), get<2>(neg_v_list).begin(),
            std::ostream_iterator<bool>(_output_stream,","), WriteOutputVar<bool>());
 
-        _output_stream << std::endl;
+        _output_stream << '\n';
     }
 
     void getTime(std::vector<double>& time)
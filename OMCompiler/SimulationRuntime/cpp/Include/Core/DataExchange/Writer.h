@@ -55,5 +55,14 @@ public:
 	virtual ~Writer() {}
 
 	virtual void write(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list ) = 0;
+
+	/**
+	 * Writes several output rows at once. Policies that can write them with fewer file operations override it.
+	 */
+	virtual void writeRows(const write_data_t* rows, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			write(get<0>(rows[i]), get<1>(rows[i]));
+	}
 };
 /** @} */ // end of dataexchange
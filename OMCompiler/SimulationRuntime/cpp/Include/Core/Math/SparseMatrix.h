@@ -38,14 +38,41 @@ struct BOOST_EXTENSION_EXPORT_DECL sparse_inserter  {
 
 };
 
+/**
+ * Square matrix in compressed column form (Ap column pointers, Ai row
+ * indices, Ax values) that keeps its UMFPACK factorization between solves.
+ *
+ * The symbolic analysis depends on the pattern only and is kept as long as
+ * build() sees the same pattern. Changing values only triggers a numeric
+ * refactorization in the next solve(). Values can also be written straight
+ * into Ax with setValue() or values(), without a sparse_inserter.
+ */
 struct BOOST_EXTENSION_EXPORT_DECL sparse_matrix {
     std::vector<int> Ap;
     std::vector<int> Ai;
     std::vector<double> Ax;
     int n;
-    sparse_matrix(int n=-1): n(n) {}
+    sparse_matrix(int n=-1): n(n), _symbolic(NULL), _numeric(NULL) {}
+    ~sparse_matrix();
 
+    /// (Re)builds the matrix, keeps the symbolic analysis if the pattern is unchanged
     void build(sparse_inserter& ins);
+    /// Position of the element in row i and column j (0-based) in Ax, -1 if it is not in the pattern
+    int index(int i, int j) const;
+    /// Sets the element in row i and column j (0-based), which has to be in the pattern
+    void setValue(int i, int j, double value);
+    /// Direct access to Ax; the next solve refactorizes the matrix
+    double* values();
+    /// Has to be called after Ax was changed through other means than setValue or values
+    void valuesChanged();
     int solve(const double* b,double* x);
-};
 
+private:
+    sparse_matrix(const sparse_matrix&);
+    sparse_matrix& operator=(const sparse_matrix&);
+    void freeNumeric();
+    void freeSymbolic();
+
+    void* _symbolic;  ///< UMFPACK symbolic analysis of the current pattern
+    void* _numeric;   ///< UMFPACK factorization of the current values
+};
@@ -32,4 +32,8 @@ public:
 	virtual void setMaxError(ublas::vector<double>& error)=0;
 	virtual IGlobalSettings* getGlobalSettings()=0;
     virtual vector<string> getOutputNames()=0;
+	virtual unsigned int getNumWorkers()=0;
+	virtual void setNumWorkers(unsigned int)=0;
+	virtual double getTimeoutFactor()=0;
+	virtual void setTimeoutFactor(double)=0;
 };
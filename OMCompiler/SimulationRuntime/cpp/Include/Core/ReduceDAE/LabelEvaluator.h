@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+Result of a simulation with some labels removed
+*/
+struct LabelResult
+{
+	enum STATUS
+	{
+		OK = 0,					///< simulation finished, error holds the error of each output variable
+		SIMULATION_ERROR = 1,	///< simulation failed with message
+		DIVISION_BY_ZERO = 2,
+		TIMEOUT = 3				///< simulation was aborted after the time limit
+	};
+	LabelResult() : status(OK), suppressed(false) {}
+	unsigned int status;
+	bool suppressed;
+	string message;
+	ublas::vector<double> error;
+};
+
+/*
+Receives the results of LabelEvaluator::evaluate in the order of the jobs
+*/
+class ILabelResultHandler
+{
+public:
+	virtual ~ILabelResultHandler() {};
+	//returns false to abort the remaining jobs
+	virtual bool handle(size_t job, LabelResult& result) = 0;
+};
+
+/*
+Runs the reduced simulations of independent label sets on worker processes.
+
+Every job is a list of label indexes that are removed for one simulation. Each worker is a
+forked copy of the simulation process, so the system and its labels are isolated without
+changes to the system. Results are handed to the handler strictly in job order, regardless
+of which worker finishes first. Without fork support or with one worker the jobs run serially.
+*/
+class LabelEvaluator
+{
+public:
+	LabelEvaluator(label_list_type& labels, ublas::matrix<double>& Ro, shared_ptr<IMixedSystem> system, IReduceDAESettings* settings,
+	               SimSettings simsettings, string modelKey, vector<string> output_names, double timeout, ISimController* sim_controller);
+	~LabelEvaluator();
+
+	void evaluate(const vector<vector<unsigned int> >& jobs, ILabelResultHandler& handler);
+	unsigned int getNumWorkers() const { return _num_workers; }
+
+private:
+	LabelResult simulate(const vector<unsigned int>& removed);
+	void evaluateSerial(const vector<vector<unsigned int> >& jobs, ILabelResultHandler& handler);
+	void evaluateParallel(const vector<vector<unsigned int> >& jobs, ILabelResultHandler& handler);
+
+	label_list_type& _labels;
+	ublas::matrix<double>& _Ro;
+	shared_ptr<IMixedSystem> _system;
+	IReduceDAESettings* _settings;
+	SimSettings _simsettings;
+	string _modelKey;
+	vector<string> _output_names;
+	double _timeout;
+	ISimController* _sim_controller;
+	unsigned int _num_workers;
+	double _time_limit;		///< wall time in seconds after which a worker is killed, 0 for no limit
+};
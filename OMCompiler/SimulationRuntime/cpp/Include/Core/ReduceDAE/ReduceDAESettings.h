@@ -27,6 +27,14 @@ public:
 	virtual IGlobalSettings* getGlobalSettings();
 	//initializes the settings object by an xml file
     virtual vector<string> getOutputNames();
+	//Returns the number of worker processes for label simulations, 0 for one per core
+	virtual unsigned int getNumWorkers();
+	//Sets the number of worker processes
+	virtual void setNumWorkers(unsigned int);
+	//Returns the factor on the time of the first simulation after which a label simulation is aborted, 0 for no limit
+	virtual double getTimeoutFactor();
+	//Sets the timeout factor
+	virtual void setTimeoutFactor(double);
 	void load(std::string xml_file);
 private:
 	IGlobalSettings*
@@ -34,7 +42,10 @@ private:
 	unsigned int
 		_ranking_method,				///< ranking mehtod
 		_reduction_method,				///< reduction mehtod
-		_nfail;							///< number of restarts after error bound was reached
+		_nfail,							///< number of restarts after error bound was reached
+		_num_workers;					///< number of worker processes for label simulations
+	double
+		_timeout_factor;				///< label simulations are aborted after this factor on the time of the first simulation
 	ublas::vector<double>
 		_max_error;						///< max error for all output variables, used in reduction algorithm
 
@@ -57,6 +68,8 @@ private:
 			ar & make_nvp("ReductionMethod", _reduction_method);
 
 			ar &   make_nvp("MaximumError", _max_error);
+			ar & make_nvp("NumWorkers", _num_workers);
+			ar & make_nvp("TimeoutFactor", _timeout_factor);
 
 		}
 		catch(std::exception& ex)
@@ -25,6 +25,7 @@ struct SimSettings
   EmitResults emitResults;
   string inputPath;
   string outputPath;
+  unsigned int outputQueueDepth;  ///< rows queued for the parallel result writer, 0 for the default
 };
 
 /**
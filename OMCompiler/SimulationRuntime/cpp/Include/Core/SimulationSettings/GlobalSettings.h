@@ -64,6 +64,10 @@ public:
   virtual void setSolverThreads(int);
   virtual int getSolverThreads();
 
+  ///< Number of output rows that can be queued for the parallel result writer (default: 64)
+  virtual void setOutputQueueDepth(unsigned int);
+  virtual unsigned int getOutputQueueDepth();
+
 private:
   double
       _startTime,   ///< Start time of integration (default: 0.0)
@@ -88,6 +92,7 @@ private:
   unsigned int _alarm_time;
 
   int _solverThreads;
+  unsigned int _outputQueueDepth;
   OutputFormat _outputFormat;
 };
 /** @} */ // end of coreSimulationSettings
@@ -103,5 +103,8 @@ public:
 
   virtual void setSolverThreads(int) = 0;
   virtual int getSolverThreads() = 0;
+
+  virtual void setOutputQueueDepth(unsigned int) = 0;
+  virtual unsigned int getOutputQueueDepth() = 0;
 };
 /** @} */ // end of coreSimulationSettings
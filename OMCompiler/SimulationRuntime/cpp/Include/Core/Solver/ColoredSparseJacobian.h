@@ -0,0 +1,53 @@
+#pragma once
+/** @addtogroup coreSolver
+ *
+ *  @{
+ */
+
+/**
+ * Compressed sparse column pattern of the ODE Jacobian A = df/dx with the
+ * column coloring of the generated system, used by the sundials solvers to
+ * fill a sparse KLU matrix with colored finite differences.
+ *
+ * The pattern is taken from the sparse A matrix of the system. The diagonal
+ * is always part of the pattern, since the iteration matrices of the solvers
+ * (e.g. I - gamma*J) need it; diagonal entries that are not in the pattern of
+ * the system stay zero.
+ */
+class BOOST_EXTENSION_SOLVER_DECL ColoredSparseJacobian
+{
+public:
+  ColoredSparseJacobian();
+  ~ColoredSparseJacobian();
+
+  /// Reads pattern and coloring from the system, returns false if the system does not provide them for dim states
+  bool initialize(IMixedSystem* system, int dim);
+
+  int getDim() const { return _dim; }
+  int getNonZeros() const { return _nnz; }
+  int getNumColors() const { return _numColors; }
+
+  /// Writes the pattern to colptrs (dim+1 entries) and rowvals (getNonZeros() entries)
+  void copyPattern(int* colptrs, int* rowvals) const;
+
+  /// Columns of the given color (0-based), their count is returned in n
+  const int* getColorColumns(int color, int& n) const;
+
+  /// Stores column col of the finite difference (fPerturbed - f) * deltaInv into the values of the pattern
+  void storeColumn(int col, const double* fPerturbed, const double* f, double deltaInv, double* values) const;
+
+  /// Position of the diagonal element of column col in the values of the pattern
+  int getDiagonalIndex(int col) const { return _diagonal[col]; }
+
+private:
+  int _dim;
+  int _nnz;
+  int _numColors;
+  std::vector<int> _colPtrs;
+  std::vector<int> _rowVals;
+  std::vector<bool> _structural;  ///< false for diagonal entries added to the pattern of the system
+  std::vector<int> _diagonal;
+  std::vector<int> _colorStart;   ///< columns of color c are _colorColumns[_colorStart[c].._colorStart[c+1]-1]
+  std::vector<int> _colorColumns;
+};
+/** @} */ // end of coreSolver
@@ -57,6 +57,8 @@ public:
     virtual bool getNonLinearSolverContinueOnError(){ return false; };
     virtual void setSolverThreads(int){};
     virtual int getSolverThreads() { return 1; };
+    virtual void setOutputQueueDepth(unsigned int) {};
+    virtual unsigned int getOutputQueueDepth() { return 64; };
     virtual OutputFormat getOutputFormat() {return EMPTY;};
     virtual void setOutputFormat(OutputFormat) {};
 private:
@@ -89,6 +89,8 @@ class FMU2GlobalSettings : public IGlobalSettings
   virtual bool getNonLinearSolverContinueOnError(){ return false; };
   virtual void setSolverThreads(int){};
   virtual int getSolverThreads() { return 1; };
+  virtual void setOutputQueueDepth(unsigned int) {};
+  virtual unsigned int getOutputQueueDepth() { return 64; };
   virtual OutputFormat getOutputFormat() {return EMPTY;};
   virtual void setOutputFormat(OutputFormat) {};
 };
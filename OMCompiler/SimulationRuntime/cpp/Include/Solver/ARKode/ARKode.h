@@ -5,6 +5,10 @@
 #include <Core/Solver/SolverDefaultImplementation.h>
 
 #include <nvector/nvector_serial.h>   // serial N_Vector types, fcts., macros
+#if defined(klu)
+  #include <sundials/sundials_sparse.h>   // def. of SlsMat
+  #include <Core/Solver/ColoredSparseJacobian.h>
+#endif
 // ARKode includieren
 //#include <cvode/cvode.h>
 
@@ -100,6 +104,12 @@ private:
   //int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
   //void initializeColoredJac();
 
+#if defined(klu)
+  // Sparse jacobian for KLU, filled with colored finite differences
+  static int ARK_SparseJCallback(realtype t, N_Vector y, N_Vector fy, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcSparseJacobian(double t, N_Vector fHelp, N_Vector errorWeight, double* y, N_Vector fy, SlsMat Jac);
+#endif
+
 
 
   ISolverSettings
@@ -164,6 +174,11 @@ double
   int const* _jacobianALeadindex;
 */
 
+#if defined(klu)
+  bool _sparse;                           ///< KLU with the sparse pattern of the system is used
+  ColoredSparseJacobian _sparseJacobian;
+#endif
+
 
 
   bool _arkode_initialized;
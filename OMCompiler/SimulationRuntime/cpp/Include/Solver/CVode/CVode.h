@@ -16,6 +16,11 @@
 #endif //USE_SUNDIALS_LAPACK
 #include <nvector/nvector_serial.h>
 #include <sundials/sundials_direct.h>
+#if defined(klu)
+  #include <cvode/cvode_klu.h>
+  #include <cvode/cvode_sparse.h>
+  #include <Core/Solver/ColoredSparseJacobian.h>
+#endif
 
 #ifdef RUNTIME_PROFILING
   #include <Core/Utils/extension/measure_time.hpp>
@@ -109,6 +114,11 @@ private:
   int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
   void initializeColoredJac();
 
+#if defined(klu)
+  // Sparse jacobian for KLU, filled with colored finite differences
+  static int CV_SparseJCallback(realtype t, N_Vector y, N_Vector fy, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcSparseJacobian(double t, N_Vector fHelp, N_Vector errorWeight, double* y, N_Vector fy, SlsMat Jac);
+#endif
 
 
   ISolverSettings
@@ -173,6 +183,11 @@ double
   int const* _jacobianAIndex;
   int const* _jacobianALeadindex;
 
+#if defined(klu)
+  bool _sparse;                           ///< KLU with the sparse pattern of the system is used
+  ColoredSparseJacobian _sparseJacobian;
+#endif
+
 
 
 
@@ -8,6 +8,11 @@
 #include <nvector/nvector_serial.h>
 #include <sundials/sundials_direct.h>
 #include <idas/idas_dense.h>
+#if defined(klu)
+  #include <idas/idas_klu.h>
+  #include <idas/idas_sparse.h>
+  #include <Core/Solver/ColoredSparseJacobian.h>
+#endif
 
 
 #ifdef RUNTIME_PROFILING
@@ -101,6 +106,12 @@ private:
   static int jacobianFunctionCB(long int N, realtype t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
   int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
 
+#if defined(klu)
+  // Sparse jacobian dF/dy + cj*dF/dyp for KLU, filled with colored finite differences (ODE form only)
+  static int sparseJacobianFunctionCB(realtype t, realtype cj, N_Vector y, N_Vector yp, N_Vector r, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcSparseJacobian(double t, double cj, double* y, double* yp, N_Vector r, N_Vector fHelp, N_Vector errorWeight, SlsMat Jac);
+#endif
+
 
 
 
@@ -176,6 +187,11 @@ double
   int const* _jacobianAIndex;
   int const* _jacobianALeadindex;
 
+#if defined(klu)
+  bool _sparse;                           ///< KLU with the sparse pattern of the system is used
+  ColoredSparseJacobian _sparseJacobian;
+#endif
+
 
   bool _ida_initialized;
 
@@ -6,6 +6,7 @@
 #include <Core/Solver/ILinearAlgLoopSolver.h>        // Export function from dll
 #include <Core/Solver/ILinSolverSettings.h>
 #include <Solver/UmfPack/UmfPackSettings.h>
+#include <Core/Math/SparseMatrix.h>
 
 
 class UmfPack : public ILinearAlgLoopSolver,  public AlgLoopSolverDefaultImplementation
@@ -37,6 +38,7 @@ private:
     ILinSolverSettings *_umfpackSettings;
     shared_ptr<ILinearAlgLoop> _algLoop;
 
+    sparse_matrix _sparseMatrix;  ///< A with its UMFPACK factorization, kept while the pattern of A is unchanged
     double * _jacd;
     double * _rhs;
     double * _x,
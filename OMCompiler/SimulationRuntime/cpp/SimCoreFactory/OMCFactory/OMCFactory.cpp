@@ -332,6 +332,7 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
           ("output-type,O", po::value< string >()->default_value("all"), "the points in time written to result file: all (output steps + events), step (just output points), none")
           ("output-format,P", po::value< string >()->default_value("mat"), "simulation results output format: csv, mat, buffer, empty")
           ("emit-results,U", po::value< string >()->default_value("public"), "emit results: all, public, none")
+          ("output-queue-depth", po::value< unsigned int >()->default_value(64), "number of output rows that can be queued for the parallel result writer")
           ;
 
      // a group for all options that should not be visible if '--help' is set
@@ -384,6 +385,7 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
      double stepsize =vm["step-size"].as<double>();
      bool nlsContinueOnError = vm["nls-continue"].as<bool>();
      int solverThreads = vm["solver-threads"].as<int>();
+     unsigned int outputQueueDepth = vm["output-queue-depth"].as<unsigned int>();
 
      if (!(stepsize > 0.0))
          stepsize = (stoptime - starttime) / vm["number-of-intervals"].as<int>();
@@ -477,7 +479,7 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
      libraries_path.make_preferred();
      modelica_path.make_preferred();
 
-     SimSettings settings = {solver, linSolver, nonLinSolver, starttime, stoptime, stepsize, 1e-24, 0.01, tolerance, resultsfilename, timeOut, outputPointType, logSettings, nlsContinueOnError, solverThreads, outputFormat, emitResults, inputPath, outputPath};
+     SimSettings settings = {solver, linSolver, nonLinSolver, starttime, stoptime, stepsize, 1e-24, 0.01, tolerance, resultsfilename, timeOut, outputPointType, logSettings, nlsContinueOnError, solverThreads, outputFormat, emitResults, inputPath, outputPath, outputQueueDepth};
 
      _library_path = libraries_path.string();
      _modelicasystem_path = modelica_path.string();
@@ -7,6 +7,10 @@
 #include <Core/Math/Functions.h>
 #include <arkode/arkode.h>
 #include <arkode/arkode_dense.h>      // prototype for ARKDense solver
+#if defined(klu)
+  #include <arkode/arkode_klu.h>      // prototype for ARKKLU solver
+  #include <arkode/arkode_sparse.h>
+#endif
 #include <sundials/sundials_dense.h>  // defs. of DlsMat and DENSE_ELEM
 #include <sundials/sundials_types.h>  // def. of type 'realtype'
 
@@ -44,6 +48,9 @@ Arkode::Arkode(IMixedSystem* system, ISolverSettings* settings)
       _ysave(NULL)
 {
   _data = ((void*) this);
+#if defined(klu)
+  _sparse = false;
+#endif
 }
 
 Arkode::~Arkode()
@@ -235,6 +242,19 @@ void Arkode::initialize()
       throw ModelicaSimulationError(SOLVER,"Cvode::initialize()");
 
     // Initialize linear solver
+#if defined(klu)
+    // KLU needs the sparse pattern of the system, otherwise stay dense
+    _sparse = _continuous_system->getDimContinuousStates() > 0
+      && _sparseJacobian.initialize(_mixed_system, _dimSys);
+    if (_sparse)
+    {
+      _idid = ARKKLU(_arkodeMem, _dimSys, _sparseJacobian.getNonZeros());
+      if (_idid < 0)
+        throw ModelicaSimulationError(SOLVER,"ARKode::initialize()");
+      _idid = ARKSlsSetSparseJacFn(_arkodeMem, &ARK_SparseJCallback);
+    }
+    else
+#endif
     /*
     #ifdef USE_SUNDIALS_LAPACK
       _idid = CVLapackDense(_cvodeMem, _dimSys);
@@ -608,6 +628,71 @@ int Arkode::ARK_fCallback(double t, N_Vector y, N_Vector ydot, void *user_data)
   return ((Arkode*) user_data)->calcFunction(t, NV_DATA_S(y), NV_DATA_S(ydot));
 }
 
+#if defined(klu)
+int Arkode::ARK_SparseJCallback(realtype t, N_Vector y, N_Vector fy, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+  return ((Arkode*) user_data)->calcSparseJacobian(t, tmp1, tmp2, NV_DATA_S(y), fy, Jac);
+}
+
+int Arkode::calcSparseJacobian(double t, N_Vector fHelp, N_Vector errorWeight, double* y, N_Vector fy, SlsMat Jac)
+{
+  try
+  {
+    double fnorm, minInc, *f_data, *fHelp_data, *errorWeight_data, h, srur;
+
+    f_data = NV_DATA_S(fy);
+    errorWeight_data = NV_DATA_S(errorWeight);
+    fHelp_data = NV_DATA_S(fHelp);
+
+    _idid = ARKodeGetErrWeights(_arkodeMem, errorWeight);
+    if (_idid < 0)
+      throw ModelicaSimulationError(SOLVER,"ARKode::calcSparseJacobian()");
+    _idid = ARKodeGetCurrentStep(_arkodeMem, &h);
+    if (_idid < 0)
+      throw ModelicaSimulationError(SOLVER,"ARKode::calcSparseJacobian()");
+
+    srur = sqrt(UROUND);
+    fnorm = N_VWrmsNorm(fy, errorWeight);
+    minInc = (fnorm != 0.0) ?
+      (1000.0 * abs(h) * UROUND * _dimSys * fnorm) : 1.0;
+
+    for (int j = 0; j < _dimSys; j++)
+    {
+      _delta[j] = max(srur*abs(y[j]), minInc/errorWeight_data[j]);
+      _deltaInv[j] = 1/_delta[j];
+    }
+
+    SlsSetToZero(Jac);
+    _sparseJacobian.copyPattern(Jac->colptrs, Jac->rowvals);
+
+    // columns of one color do not share rows and are perturbed together
+    for (int color = 0; color < _sparseJacobian.getNumColors(); color++)
+    {
+      int n;
+      const int* columns = _sparseJacobian.getColorColumns(color, n);
+      for (int i = 0; i < n; i++)
+      {
+        _ysave[columns[i]] = y[columns[i]];
+        y[columns[i]] += _delta[columns[i]];
+      }
+
+      calcFunction(t, y, fHelp_data);
+
+      for (int i = 0; i < n; i++)
+      {
+        y[columns[i]] = _ysave[columns[i]];
+        _sparseJacobian.storeColumn(columns[i], fHelp_data, f_data, _deltaInv[columns[i]], Jac->data);
+      }
+    }
+  }      //workaround until exception can be catch from c- libraries
+  catch (std::exception/* & ex */)
+  {
+    return 1;
+  }
+  return 0;
+}
+#endif
+
 void Arkode::giveZeroVal(const double &t, const double *y, double *zeroValue)
 {
   _time_system->setTime(t);
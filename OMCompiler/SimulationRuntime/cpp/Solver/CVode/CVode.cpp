@@ -52,6 +52,9 @@ Cvode::Cvode(IMixedSystem* system, ISolverSettings* settings)
 	_jacobianANonzeros(0)
 {
 	_data = ((void*) this);
+#if defined(klu)
+	_sparse = false;
+#endif
 
 #ifdef RUNTIME_PROFILING
 	if (MeasureTime::getInstance() != NULL)
@@ -284,6 +287,21 @@ void Cvode::initialize()
 			throw ModelicaSimulationError(SOLVER,/*_idid,_tCurrent,*/"Cvode::initialize()");
 
 		// Initialize linear solver
+#if defined(klu)
+		// KLU needs the sparse pattern of the system, otherwise stay dense
+		_sparse = _continuous_system->getDimContinuousStates() > 0
+			&& _sparseJacobian.initialize(_mixed_system, _dimSys);
+		if (_sparse)
+		{
+			_idid = CVKLU(_cvodeMem, _dimSys, _sparseJacobian.getNonZeros());
+			if (_idid < 0)
+				throw ModelicaSimulationError(SOLVER, "Cvode::initialize()");
+			_idid = CVSlsSetSparseJacFn(_cvodeMem, &CV_SparseJCallback);
+			LOGGER_WRITE("Cvode: using KLU with " + to_string(_sparseJacobian.getNonZeros()) + " nonzeros and "
+				+ to_string(_sparseJacobian.getNumColors()) + " colors", LC_SOLVER, LL_DEBUG);
+		}
+		else
+#endif
 #ifdef USE_SUNDIALS_LAPACK
 		_idid = CVLapackDense(_cvodeMem, _dimSys);
 #else
@@ -944,6 +962,81 @@ int Cvode::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeig
 	return 0;
 }
 
+#if defined(klu)
+int Cvode::CV_SparseJCallback(realtype t, N_Vector y, N_Vector fy, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+	return ((Cvode*)user_data)->calcSparseJacobian(t, tmp1, tmp2, NV_DATA_S(y), fy, Jac);
+}
+
+int Cvode::calcSparseJacobian(double t, N_Vector fHelp, N_Vector errorWeight, double* y, N_Vector fy, SlsMat Jac)
+{
+	try
+	{
+		double fnorm, minInc, *f_data, *fHelp_data, *errorWeight_data, h, srur;
+
+		f_data = NV_DATA_S(fy);
+		errorWeight_data = NV_DATA_S(errorWeight);
+		fHelp_data = NV_DATA_S(fHelp);
+
+		_idid = CVodeGetErrWeights(_cvodeMem, errorWeight);
+		if (_idid < 0)
+		{
+			_idid = -5;
+			throw ModelicaSimulationError(SOLVER, "Cvode::calcSparseJacobian()");
+		}
+		_idid = CVodeGetCurrentStep(_cvodeMem, &h);
+		if (_idid < 0)
+		{
+			_idid = -5;
+			throw ModelicaSimulationError(SOLVER, "Cvode::calcSparseJacobian()");
+		}
+
+		srur = sqrt(UROUND);
+		fnorm = N_VWrmsNorm(fy, errorWeight);
+		minInc = (fnorm != 0.0) ?
+			(1000.0 * abs(h) * UROUND * _dimSys * fnorm) : 1.0;
+
+		for (int j = 0; j < _dimSys; j++)
+		{
+			_delta[j] = max(srur*abs(y[j]), minInc / errorWeight_data[j]);
+			_deltaInv[j] = 1 / _delta[j];
+		}
+
+		// the solver overwrites the matrix with I - gamma*J after each call, so the pattern is written again
+		SlsSetToZero(Jac);
+		_sparseJacobian.copyPattern(Jac->colptrs, Jac->rowvals);
+
+		// columns of one color do not share rows and are perturbed together
+		for (int color = 0; color < _sparseJacobian.getNumColors(); color++)
+		{
+			int n;
+			const int* columns = _sparseJacobian.getColorColumns(color, n);
+			for (int i = 0; i < n; i++)
+			{
+				_ysave[columns[i]] = y[columns[i]];
+				y[columns[i]] += _delta[columns[i]];
+			}
+
+			calcFunction(t, y, fHelp_data);
+
+			for (int i = 0; i < n; i++)
+			{
+				y[columns[i]] = _ysave[columns[i]];
+				_sparseJacobian.storeColumn(columns[i], fHelp_data, f_data, _deltaInv[columns[i]], Jac->data);
+			}
+		}
+	}
+	//workaround until exception can be catch from c- libraries
+	catch (std::exception & ex)
+	{
+		cerr << "CVode integration error: " << ex.what();
+		return 1;
+	}
+
+	return 0;
+}
+#endif
+
 void Cvode::initializeColoredJac()
 {
 
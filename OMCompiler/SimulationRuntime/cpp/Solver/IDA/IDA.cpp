@@ -59,6 +59,9 @@ Ida::Ida(IMixedSystem* system, ISolverSettings* settings)
       _jacobianANonzeros(0)
 {
   _data = ((void*) this);
+#if defined(klu)
+  _sparse = false;
+#endif
   #ifdef RUNTIME_PROFILING
   if(MeasureTime::getInstance() != NULL)
   {
@@ -329,6 +332,20 @@ void Ida::initialize()
       throw std::invalid_argument(/*_idid,_tCurrent,*/"IDA::initialize()");
 
     // Initialize linear solver
+#if defined(klu)
+    // KLU needs the sparse pattern of the system, which only covers the ODE form
+    _sparse = _dimAE == 0 && _sparseJacobian.initialize(_mixed_system, _dimSys);
+    if (_sparse)
+    {
+      _idid = IDAKLU(_idaMem, _dimSys, _sparseJacobian.getNonZeros());
+      if (_idid < 0)
+        throw std::invalid_argument("IDA::initialize()");
+      _idid = IDASlsSetSparseJacFn(_idaMem, &sparseJacobianFunctionCB);
+      LOGGER_WRITE("IDA: using KLU with " + to_string(_sparseJacobian.getNonZeros()) + " nonzeros and "
+        + to_string(_sparseJacobian.getNumColors()) + " colors", LC_SOLVER, LL_DEBUG);
+    }
+    else
+#endif
     _idid = IDADense(_idaMem, _dimSys);
     if (_idid < 0)
       throw std::invalid_argument("IDA::initialize()");
@@ -1035,6 +1052,81 @@ int Ida::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight
 
 
 
+#if defined(klu)
+int Ida::sparseJacobianFunctionCB(realtype t, realtype cj, N_Vector y, N_Vector yp, N_Vector r, SlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+  return ((Ida*) user_data)->calcSparseJacobian(t, cj, NV_DATA_S(y), NV_DATA_S(yp), r, tmp1, tmp2, Jac);
+}
+
+int Ida::calcSparseJacobian(double t, double cj, double* y, double* yp, N_Vector r, N_Vector fHelp, N_Vector errorWeight, SlsMat Jac)
+{
+  try
+  {
+    double *r_data, *fHelp_data, *errorWeight_data, h, srur;
+
+    r_data = NV_DATA_S(r);
+    errorWeight_data = NV_DATA_S(errorWeight);
+    fHelp_data = NV_DATA_S(fHelp);
+
+    _idid = IDAGetErrWeights(_idaMem, errorWeight);
+    if (_idid < 0)
+    {
+      _idid = -5;
+      throw std::invalid_argument("IDA::calcSparseJacobian()");
+    }
+    _idid = IDAGetCurrentStep(_idaMem, &h);
+    if (_idid < 0)
+    {
+      _idid = -5;
+      throw std::invalid_argument("IDA::calcSparseJacobian()");
+    }
+
+    // same increments as the difference quotients of IDA
+    srur = sqrt(UROUND);
+    for (int j = 0; j < _dimSys; j++)
+    {
+      _delta[j] = max(srur*max(abs(y[j]), abs(h*yp[j])), 1.0/errorWeight_data[j]);
+      _deltaInv[j] = 1/_delta[j];
+    }
+
+    SlsSetToZero(Jac);
+    _sparseJacobian.copyPattern(Jac->colptrs, Jac->rowvals);
+
+    // the residual is f(y) - yp, so its difference quotient in y is df/dy
+    for (int color = 0; color < _sparseJacobian.getNumColors(); color++)
+    {
+      int n;
+      const int* columns = _sparseJacobian.getColorColumns(color, n);
+      for (int i = 0; i < n; i++)
+      {
+        _ysave[columns[i]] = y[columns[i]];
+        y[columns[i]] += _delta[columns[i]];
+      }
+
+      calcFunction(t, y, yp, fHelp_data);
+
+      for (int i = 0; i < n; i++)
+      {
+        y[columns[i]] = _ysave[columns[i]];
+        _sparseJacobian.storeColumn(columns[i], fHelp_data, r_data, _deltaInv[columns[i]], Jac->data);
+      }
+    }
+
+    // dF/dyp = -I
+    for (int j = 0; j < _dimSys; j++)
+      Jac->data[_sparseJacobian.getDiagonalIndex(j)] -= cj;
+  }      //workaround until exception can be catch from c- libraries
+  catch (std::exception& ex)
+  {
+    std::string error = ex.what();
+    cerr << "IDA integration error: " << error;
+    return 1;
+  }
+
+  return 0;
+}
+#endif
+
 int Ida::reportErrorMessage(ostream& messageStream)
 {
   if (_solverStatus == ISolver::SOLVERERROR)
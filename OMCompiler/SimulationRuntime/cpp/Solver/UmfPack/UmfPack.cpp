@@ -5,11 +5,6 @@
 
 #ifdef USE_UMFPACK
 #include "umfpack.h"
-#include <Core/Utils/numeric/bindings/umfpack/umfpack.hpp>
-#include <Core/Utils/numeric/bindings/ublas/vector.hpp>
-#include <Core/Utils/numeric/bindings/ublas.hpp>
-#include <boost/numeric/ublas/io.hpp>
-namespace umf = boost::numeric::bindings::umfpack;
 #endif
 UmfPack::UmfPack(ILinSolverSettings* settings,shared_ptr<ILinearAlgLoop> algLoop)
   :AlgLoopSolverDefaultImplementation()
@@ -124,33 +119,33 @@ void UmfPack::solve()
 
 
          int status;
-        // get the default control parameters
-		umf::control_type<> Control;
-		// change the default print level
-		Control [UMFPACK_PRL] = 6;
 
 		 _algLoop->evaluate();
         _algLoop->getb(_rhs);
-         long int dimSys = _algLoop->getDimReal();
         const sparsematrix_t& A = _algLoop->getSparseAMatrix();
-
-        adaptor_t rhs_adaptor(dimSys,_rhs);
-		shared_vector_t b(dimSys,rhs_adaptor);
-
-        adaptor_t x_adaptor(dimSys,_x);
-		shared_vector_t x(dimSys,x_adaptor);
-
-
-        umf::symbolic_type<double> Symbolic;
-        umf::numeric_type<double> Numeric;
-		status = umf::symbolic(A, Symbolic);
-        if(status<0)
-			//umf::report_status (Control, status)
-			throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack symbolic function");
-		status = umf::numeric (A, Symbolic, Numeric);
-		if(status<0)
-			throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack numeric function");
-        status = umf::solve (A, x, b, Numeric);
+        const int nnz = A.nnz();
+        const int* Ap = &A.index1_data()[0];
+        const int* Ai = &A.index2_data()[0];
+        const double* Ax = &A.value_data()[0];
+
+        // keep the symbolic analysis and only copy the values while the pattern of A is unchanged
+        bool samePattern = (int)_sparseMatrix.Ax.size() == nnz && (int)_sparseMatrix.Ap.size() == (int)A.filled1()
+                        && std::equal(_sparseMatrix.Ap.begin(), _sparseMatrix.Ap.end(), Ap)
+                        && std::equal(_sparseMatrix.Ai.begin(), _sparseMatrix.Ai.end(), Ai);
+        if(samePattern)
+        {
+            std::copy(Ax, Ax + nnz, _sparseMatrix.values());
+        }
+        else
+        {
+            sparse_inserter ins;
+            for(int col = 0; col + 1 < (int)A.filled1(); col++)
+                for(int k = Ap[col]; k < Ap[col+1]; k++)
+                    ins.content[make_pair(col, Ai[k])] = Ax[k];
+            _sparseMatrix.build(ins);
+        }
+
+        status = _sparseMatrix.solve(_rhs, _x);
 		if(status<0)
 			throw ModelicaSimulationError(ALGLOOP_SOLVER,"Error in umfpack solve function");
         _algLoop->setReal(_x);
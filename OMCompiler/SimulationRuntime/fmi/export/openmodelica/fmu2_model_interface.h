@@ -89,8 +89,15 @@ typedef struct {
   fmi2Real stopTime;
 
   int _need_update;
+  int _need_event_iteration; /* fmi2DoStep has to run an event iteration before integrating */
   int _has_jacobian;
   ANALYTIC_JACOBIAN* fmiDerJac;
+
+  /* work arrays of fmi2DoStep, allocated once in fmi2Instantiate */
+  fmi2Real* states;
+  fmi2Real* states_der;
+  fmi2Real* event_indicators;
+  fmi2Real* event_indicators_prev;
 } ModelInstance;
 
 /* reset alignment policy to the one set before reading this file */
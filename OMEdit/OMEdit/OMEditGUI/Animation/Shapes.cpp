@@ -38,7 +38,8 @@ ShapeObjectAttribute::ShapeObjectAttribute()
     : isConst(true),
       exp(0.0),
       cref("NONE"),
-      fmuValueRef(0)
+      fmuValueRef(0),
+      matVar(nullptr)
 {
 }
 
@@ -46,7 +47,8 @@ ShapeObjectAttribute::ShapeObjectAttribute(float value)
     : isConst(true),
       exp(value),
       cref("NONE"),
-      fmuValueRef(0)
+      fmuValueRef(0),
+      matVar(nullptr)
 {
 }
 
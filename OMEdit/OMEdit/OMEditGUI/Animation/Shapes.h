@@ -58,6 +58,7 @@ class ShapeObjectAttribute
   float exp;
   std::string cref;
   unsigned int fmuValueRef;
+  ModelicaMatVariable_t* matVar;
 };
 
 enum class stateSetAction {update, modify};
@@ -34,19 +34,23 @@
 
 #include "VisualizerMAT.h"
 
+#include <cmath>
+
 VisualizerMAT::VisualizerMAT(const std::string& modelFile, const std::string& path)
   : VisualizerAbstract(modelFile, path, VisType::MAT),
-    _matReader()
+    _matReader(),
+    _matCursor()
 {
 
 }
 
 /*!
  * \brief VisualizerMAT::~VisualizerMAT
- * Free the ModelicaMatReader
+ * Free the ModelicaMatReader and its cursor
  */
 VisualizerMAT::~VisualizerMAT()
 {
+  omc_matlab4_cursor_free(&_matCursor);
   if (_matReader.file) {
     omc_free_matlab4_reader(&_matReader);
   }
@@ -56,6 +60,7 @@ void VisualizerMAT::initData()
 {
   VisualizerAbstract::initData();
   readMat(mpOMVisualBase->getModelFile(), mpOMVisualBase->getPath());
+  setVarReferencesInVisAttributes();
   mpTimeManager->setStartTime(omc_matlab4_startTime(&_matReader));
   mpTimeManager->setEndTime(omc_matlab4_stopTime(&_matReader));
 }
@@ -74,6 +79,12 @@ void VisualizerMAT::readMat(const std::string& modelFile, const std::string& pat
 {
   std::string resFileName = path + modelFile;     // + "_res.mat";
 
+  // Free the rows of the cursor and the previously read file.
+  omc_matlab4_cursor_free(&_matCursor);
+  if (_matReader.file) {
+    omc_free_matlab4_reader(&_matReader);
+  }
+
   // Check if the MAT file exists.
   if (!fileExists(resFileName))
   {
@@ -85,6 +96,7 @@ void VisualizerMAT::readMat(const std::string& modelFile, const std::string& pat
   {
     // Read mat file.
     auto ret = omc_new_matlab4_reader(resFileName.c_str(), &_matReader);
+    omc_matlab4_cursor_init(&_matCursor, &_matReader);
     // Check return value.
 //    if (0 != ret)
 //    {
@@ -106,6 +118,69 @@ void VisualizerMAT::setSimulationSettings(const UserSimSettingsMAT& simSetMAT)
   mpTimeManager->setHVisual(newVal);
 }
 
+ModelicaMatVariable_t* VisualizerMAT::getVarReferencesForObjectAttribute(ShapeObjectAttribute* attr)
+{
+  ModelicaMatVariable_t* var = nullptr;
+  if (!attr->isConst && _matReader.file)
+  {
+    var = omc_matlab4_find_var(&_matReader, attr->cref.c_str());
+    if (var == nullptr) {
+      MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica,
+                                                            QString(QObject::tr("Did not get variable from result file. Variable name is %1."))
+                                                            .arg(attr->cref.c_str()), Helper::scriptingKind, Helper::errorLevel));
+    }
+  }
+  return var;
+}
+
+/*!
+ * \brief VisualizerMAT::setVarReferencesInVisAttributes
+ * Looks up the result file variables of all shape attributes once,
+ * so that the frames only interpolate their values.
+ */
+void VisualizerMAT::setVarReferencesInVisAttributes()
+{
+  for (auto& shape : mpOMVisualBase->_shapes)
+  {
+    shape._length.matVar = getVarReferencesForObjectAttribute(&shape._length);
+    shape._width.matVar = getVarReferencesForObjectAttribute(&shape._width);
+    shape._height.matVar = getVarReferencesForObjectAttribute(&shape._height);
+
+    shape._lDir[0].matVar = getVarReferencesForObjectAttribute(&shape._lDir[0]);
+    shape._lDir[1].matVar = getVarReferencesForObjectAttribute(&shape._lDir[1]);
+    shape._lDir[2].matVar = getVarReferencesForObjectAttribute(&shape._lDir[2]);
+
+    shape._wDir[0].matVar = getVarReferencesForObjectAttribute(&shape._wDir[0]);
+    shape._wDir[1].matVar = getVarReferencesForObjectAttribute(&shape._wDir[1]);
+    shape._wDir[2].matVar = getVarReferencesForObjectAttribute(&shape._wDir[2]);
+
+    shape._r[0].matVar = getVarReferencesForObjectAttribute(&shape._r[0]);
+    shape._r[1].matVar = getVarReferencesForObjectAttribute(&shape._r[1]);
+    shape._r[2].matVar = getVarReferencesForObjectAttribute(&shape._r[2]);
+
+    shape._rShape[0].matVar = getVarReferencesForObjectAttribute(&shape._rShape[0]);
+    shape._rShape[1].matVar = getVarReferencesForObjectAttribute(&shape._rShape[1]);
+    shape._rShape[2].matVar = getVarReferencesForObjectAttribute(&shape._rShape[2]);
+
+    shape._T[0].matVar = getVarReferencesForObjectAttribute(&shape._T[0]);
+    shape._T[1].matVar = getVarReferencesForObjectAttribute(&shape._T[1]);
+    shape._T[2].matVar = getVarReferencesForObjectAttribute(&shape._T[2]);
+    shape._T[3].matVar = getVarReferencesForObjectAttribute(&shape._T[3]);
+    shape._T[4].matVar = getVarReferencesForObjectAttribute(&shape._T[4]);
+    shape._T[5].matVar = getVarReferencesForObjectAttribute(&shape._T[5]);
+    shape._T[6].matVar = getVarReferencesForObjectAttribute(&shape._T[6]);
+    shape._T[7].matVar = getVarReferencesForObjectAttribute(&shape._T[7]);
+    shape._T[8].matVar = getVarReferencesForObjectAttribute(&shape._T[8]);
+
+    shape._color[0].matVar = getVarReferencesForObjectAttribute(&shape._color[0]);
+    shape._color[1].matVar = getVarReferencesForObjectAttribute(&shape._color[1]);
+    shape._color[2].matVar = getVarReferencesForObjectAttribute(&shape._color[2]);
+
+    shape._specCoeff.matVar = getVarReferencesForObjectAttribute(&shape._specCoeff);
+    shape._extra.matVar = getVarReferencesForObjectAttribute(&shape._extra);
+  }
+}
+
 void VisualizerMAT::updateVisAttributes(const double time)
 {
   //std::cout<<"updateVisAttributes at "<<time <<std::endl;
@@ -113,7 +188,9 @@ void VisualizerMAT::updateVisAttributes(const double time)
   unsigned int shapeIdx = 0;
   rAndT rT;
   osg::ref_ptr<osg::Node> child = nullptr;
-  ModelicaMatReader* tmpReaderPtr = &_matReader;
+  ModelicaMatCursor* tmpCursorPtr = &_matCursor;
+  // Position the cursor once; all attributes are read from the same rows.
+  omc_matlab4_cursor_seek(tmpCursorPtr, time);
   try
   {
     for (auto& shape : mpOMVisualBase->_shapes)
@@ -121,42 +198,42 @@ void VisualizerMAT::updateVisAttributes(const double time)
       //std::cout<<"shape "<<shape._id <<std::endl;
 
       // Get the values for the scene graph objects
-      updateObjectAttributeMAT(&shape._length, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._width, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._height, time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._lDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._lDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._wDir[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._wDir[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._r[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._r[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._rShape[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._rShape[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._T[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[2], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[3], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[4], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[5], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[6], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[7], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._T[8], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._color[0], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[1], time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._color[2], time, tmpReaderPtr);
-
-      updateObjectAttributeMAT(&shape._specCoeff, time, tmpReaderPtr);
-      updateObjectAttributeMAT(&shape._extra, time, tmpReaderPtr);
+      updateObjectAttributeMAT(&shape._length, tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._width, tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._height, tmpCursorPtr);
+
+      updateObjectAttributeMAT(&shape._lDir[0], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._lDir[1], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._lDir[2], tmpCursorPtr);
+
+      updateObjectAttributeMAT(&shape._wDir[0], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._wDir[1], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._wDir[2], tmpCursorPtr);
+
+      updateObjectAttributeMAT(&shape._r[0], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._r[1], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._r[2], tmpCursorPtr);
+
+      updateObjectAttributeMAT(&shape._rShape[0], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._rShape[1], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._rShape[2], tmpCursorPtr);
+
+      updateObjectAttributeMAT(&shape._T[0], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[1], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[2], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[3], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[4], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[5], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[6], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[7], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._T[8], tmpCursorPtr);
+
+      updateObjectAttributeMAT(&shape._color[0], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._color[1], tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._color[2], tmpCursorPtr);
+
+      updateObjectAttributeMAT(&shape._specCoeff, tmpCursorPtr);
+      updateObjectAttributeMAT(&shape._extra, tmpCursorPtr);
 
       rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
           osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
@@ -195,25 +272,18 @@ void VisualizerMAT::updateScene(const double time)
   mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / visTime);
 }
 
-void VisualizerMAT::updateObjectAttributeMAT(ShapeObjectAttribute* attr, double time, ModelicaMatReader* reader)
+void VisualizerMAT::updateObjectAttributeMAT(ShapeObjectAttribute* attr, ModelicaMatCursor* cursor)
 {
   if (!attr->isConst)
-    attr->exp = omcGetVarValue(reader, attr->cref.c_str(), time);
+    attr->exp = omcGetVarValue(cursor, attr->matVar);
 }
 
-double VisualizerMAT::omcGetVarValue(ModelicaMatReader* reader, const char* varName, double time)
+double VisualizerMAT::omcGetVarValue(ModelicaMatCursor* cursor, ModelicaMatVariable_t* var)
 {
-  double val = 0.0;
-  ModelicaMatVariable_t* var = nullptr;
-  var = omc_matlab4_find_var(reader, varName);
-  if (var == nullptr) {
-    MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica,
-                                                          QString(QObject::tr("Did not get variable from result file. Variable name is %1."))
-                                                          .arg(varName), Helper::scriptingKind, Helper::errorLevel));
-  } else {
-    omc_matlab4_val(&val, reader, var, time);
+  double val = NAN;
+  if (var == nullptr || omc_matlab4_cursor_vals(cursor, &var, 1, &val)) {
+    val = NAN;
   }
 
   return val;
 }
-
@@ -53,10 +53,13 @@ class VisualizerMAT : public VisualizerAbstract
   void simulate(TimeManager& omvm) override {Q_UNUSED(omvm);}
   void updateVisAttributes(const double time) override;
   void updateScene(const double time) override;
-  void updateObjectAttributeMAT(ShapeObjectAttribute* attr, double time, ModelicaMatReader* reader);
-  double omcGetVarValue(ModelicaMatReader* reader, const char* varName, double time);
+  ModelicaMatVariable_t* getVarReferencesForObjectAttribute(ShapeObjectAttribute* attr);
+  void setVarReferencesInVisAttributes();
+  void updateObjectAttributeMAT(ShapeObjectAttribute* attr, ModelicaMatCursor* cursor);
+  double omcGetVarValue(ModelicaMatCursor* cursor, ModelicaMatVariable_t* var);
 private:
   ModelicaMatReader _matReader;
+  ModelicaMatCursor _matCursor;
 };
 
 #endif // end VISUALIZERMAT_H
@@ -40,6 +40,7 @@
 #include "Options/OptionsDialog.h"
 #include "Modeling/MessagesWidget.h"
 #include "util/read_matlab4.h"
+#include "util/read_col.h"
 #include "Plotting/PlotWindowContainer.h"
 #include "Plotting/DiagramWindow.h"
 #include "Simulation/SimulationDialog.h"
@@ -125,7 +126,7 @@ void VariablesTreeItem::setActive()
 
 QIcon VariablesTreeItem::getVariableTreeItemIcon(QString name) const
 {
-  if (name.endsWith(".mat"))
+  if (name.endsWith(".mat") || name.endsWith(".col"))
     return QIcon(":/Resources/icons/mat.svg");
   else if (name.endsWith(".plt"))
     return QIcon(":/Resources/icons/plt.svg");
@@ -532,7 +533,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
   } else {
     toolTip = tr("Simulation Result File: %1\n%2: %3/%4").arg(fileName).arg(Helper::fileLocation).arg(filePath).arg(fileName);
   }
-  QRegExp resultTypeRegExp("(\\.mat|\\.plt|\\.csv|_res.mat|_res.plt|_res.csv)");
+  QRegExp resultTypeRegExp("(\\.mat|\\.plt|\\.csv|\\.col|_res.mat|_res.plt|_res.csv|_res.col)");
   QString text = QString(fileName).remove(resultTypeRegExp);
   QModelIndex index = variablesTreeItemIndex(mpRootVariablesTreeItem);
   QVector<QVariant> Variabledata;
@@ -569,9 +570,11 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
                                                             .arg(initFile.errorString()), Helper::scriptingKind, Helper::errorLevel));
     }
   }
-  /* open the .mat file */
+  /* open the .mat or .col file */
   ModelicaMatReader matReader;
   matReader.file = 0;
+  ModelicaColReader colReader;
+  colReader.file = 0;
   const char *msg[] = {""};
   if (fileName.endsWith(".mat")) {
     //Read in mat file
@@ -580,6 +583,20 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
                                                             GUIMessages::getMessage(GUIMessages::ERROR_OPENING_FILE).arg(fileName)
                                                             .arg(QString(msg[0])), Helper::scriptingKind, Helper::errorLevel));
     }
+  } else if (fileName.endsWith(".col")) {
+    if (0 != (msg[0] = omc_new_col_reader(QString(filePath + "/" + fileName).toStdString().c_str(), &colReader))) {
+      MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica,
+                                                            GUIMessages::getMessage(GUIMessages::ERROR_OPENING_FILE).arg(fileName)
+                                                            .arg(QString(msg[0])), Helper::scriptingKind, Helper::errorLevel));
+    }
+  }
+  /* read the final values of all variables in one go */
+  QVector<double> finalValues;
+  if (matReader.file && matReader.nrows > 0) {
+    finalValues.resize(matReader.nvar);
+    if (omc_matlab4_read_row(&matReader, matReader.nrows - 1, finalValues.data())) {
+      finalValues.clear();
+    }
   }
 
   // remove time from variables list
@@ -669,7 +686,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       /* get the variable information i.e value, unit, displayunit, description */
       QString value, variability, unit, displayUnit, description;
       bool changeAble = false;
-      getVariableInformation(&matReader, variableToFind, &value, &changeAble, &variability, &unit, &displayUnit, &description);
+      getVariableInformation(&matReader, &colReader, finalValues, variableToFind, &value, &changeAble, &variability, &unit, &displayUnit, &description);
       variableData << StringHandler::unparse(QString("\"").append(value).append("\""));
       /* set the variable unit */
       variableData << StringHandler::unparse(QString("\"").append(unit).append("\""));
@@ -737,11 +754,13 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       count++;
     }
   }
-  /* close the .mat file */
+  /* close the .mat or .col file */
   if (fileName.endsWith(".mat")) {
     if (matReader.file) {
       omc_free_matlab4_reader(&matReader);
     }
+  } else if (colReader.file) {
+    omc_free_col_reader(&colReader);
   }
   mpVariablesTreeView->collapseAll();
   QModelIndex idx = variablesTreeItemIndex(pTopVariablesTreeItem);
@@ -859,6 +878,7 @@ QHash<QString, QString> VariablesTreeModel::parseScalarVariable(QXmlStreamReader
  * \brief VariablesTreeModel::getVariableInformation
  * Returns the variable information like value, unit, displayunit and description.
  * \param pMatReader
+ * \param finalValues - the last row of the result file, if it could be read.
  * \param variableToFind
  * \param value
  * \param changeAble
@@ -867,8 +887,9 @@ QHash<QString, QString> VariablesTreeModel::parseScalarVariable(QXmlStreamReader
  * \param displayUnit
  * \param description
  */
-void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, QString variableToFind, QString *value, bool *changeAble,
-                                                QString *variability, QString *unit, QString *displayUnit, QString *description)
+void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, ModelicaColReader *pColReader, const QVector<double> &finalValues, QString variableToFind,
+                                                QString *value, bool *changeAble, QString *variability, QString *unit, QString *displayUnit,
+                                                QString *description)
 {
   QHash<QString, QString> hash = mScalarVariablesHash.value(variableToFind);
   if (hash["name"].compare(variableToFind) == 0) {
@@ -876,7 +897,14 @@ void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, Q
     *variability = hash["variability"];
     if (*changeAble) {
       *value = hash["start"];
-    } else { /* if the variable is not a tunable parameter then read the final value of the variable. Only mat result files are supported. */
+    } else if (pColReader->file != NULL) { /* the last chunk of the variable holds its final value */
+      *value = "";
+      ModelicaMatVariable_t *var = omc_col_find_var(pColReader, variableToFind.toStdString().c_str());
+      double res;
+      if (var && !omc_col_val(&res, pColReader, var, omc_col_stopTime(pColReader))) {
+        *value = QString::number(res);
+      }
+    } else { /* if the variable is not a tunable parameter then read the final value of the variable. Only mat and col result files are supported. */
       if ((pMatReader->file != NULL) && strcmp(pMatReader->fileName, "")) {
         *value = "";
         ModelicaMatVariable_t *var;
@@ -884,7 +912,10 @@ void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, Q
           qDebug() << QString("%1 not found in %2").arg(variableToFind).arg(pMatReader->fileName);
         }
         double res;
-        if (var && !omc_matlab4_val(&res, pMatReader, var, omc_matlab4_stopTime(pMatReader))) {
+        if (var && !var->isParam && !finalValues.isEmpty()) {
+          res = finalValues.at(abs(var->index) - 1);
+          *value = QString::number(var->index < 0 ? -res : res);
+        } else if (var && !omc_matlab4_val(&res, pMatReader, var, omc_matlab4_stopTime(pMatReader))) {
           *value = QString::number(res);
         }
       }
@@ -962,7 +993,7 @@ bool VariableTreeProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &
       VariablesTreeItem *pVariablesTreeItem = static_cast<VariablesTreeItem*>(index.internalPointer());
       if (pVariablesTreeItem) {
         QString variableName = pVariablesTreeItem->getVariableName();
-        variableName.remove(QRegExp("(\\.mat|\\.plt|\\.csv|_res.mat|_res.plt|_res.csv)"));
+        variableName.remove(QRegExp("(\\.mat|\\.plt|\\.csv|\\.col|_res.mat|_res.plt|_res.csv|_res.col)"));
         return variableName.contains(filterRegExp());
       } else {
         return sourceModel()->data(index).toString().contains(filterRegExp());
@@ -1143,6 +1174,7 @@ VariablesWidget::VariablesWidget(QWidget *pParent)
   mpVariablesTreeView->setColumnHidden(2, true); // hide Unit column
   mpLastActiveSubWindow = 0;
   mModelicaMatReader.file = 0;
+  mModelicaColReader.file = 0;
   mpCSVData = 0;
   // create the layout
   QGridLayout *pMainLayout = new QGridLayout;
@@ -1506,6 +1538,11 @@ double VariablesWidget::readVariableValue(QString variable, double time)
     if (var) {
       omc_matlab4_val(&value, &mModelicaMatReader, var, time);
     }
+  } else if (mModelicaColReader.file) {
+    ModelicaMatVariable_t* var = omc_col_find_var(&mModelicaColReader, variable.toStdString().c_str());
+    if (var) {
+      omc_col_val(&value, &mModelicaColReader, var, time);
+    }
   } else if (mpCSVData) {
     double *timeDataSet = read_csv_dataset(mpCSVData, "time");
     if (timeDataSet) {
@@ -2051,6 +2088,10 @@ void VariablesWidget::closeResultFile()
     omc_free_matlab4_reader(&mModelicaMatReader);
     mModelicaMatReader.file = 0;
   }
+  if (mModelicaColReader.file) {
+    omc_free_col_reader(&mModelicaColReader);
+    mModelicaColReader.file = 0;
+  }
   if (mpCSVData) {
     omc_free_csv_reader(mpCSVData);
     mpCSVData = 0;
@@ -2078,6 +2119,12 @@ void VariablesWidget::openResultFile()
         errorOpeningFile = true;
         errorString = msg[0];
       }
+    } else if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".col")) {
+      const char *msg[] = {""};
+      if (0 != (msg[0] = omc_new_col_reader(fileName.toStdString().c_str(), &mModelicaColReader))) {
+        errorOpeningFile = true;
+        errorString = msg[0];
+      }
     } else if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".csv")) {
       mpCSVData = read_csv(fileName.toStdString().c_str());
       if (!mpCSVData) {
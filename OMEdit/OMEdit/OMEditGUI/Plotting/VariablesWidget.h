@@ -141,8 +141,8 @@ private:
   VariablesTreeItem *mpActiveVariablesTreeItem;
   QHash<QString, QHash<QString,QString> > mScalarVariablesHash;
   QHash<QString, QString> parseScalarVariable(QXmlStreamReader &xmlReader);
-  void getVariableInformation(ModelicaMatReader *pMatReader, QString variableToFind, QString *value, bool *changeAble, QString *variability,
-                              QString *unit, QString *displayUnit, QString *description);
+  void getVariableInformation(ModelicaMatReader *pMatReader, ModelicaColReader *pColReader, const QVector<double> &finalValues, QString variableToFind, QString *value,
+                              bool *changeAble, QString *variability, QString *unit, QString *displayUnit, QString *description);
 signals:
   void itemChecked(const QModelIndex &index, qreal curveThickness, int curveStyle);
   void unitChanged(const QModelIndex &index);
@@ -221,6 +221,7 @@ private:
   QString mFileName;
   QMdiSubWindow *mpLastActiveSubWindow;
   ModelicaMatReader mModelicaMatReader;
+  ModelicaColReader mModelicaColReader;
   csv_data *mpCSVData;
   QFile mPlotFileReader;
   void selectInteractivePlotWindow(VariablesTreeItem *pVariablesTreeItem);
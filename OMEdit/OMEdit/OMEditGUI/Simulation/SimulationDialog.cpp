@@ -1905,7 +1905,7 @@ void SimulationDialog::simulationProcessFinished(SimulationOptions simulationOpt
     return;
   }
   QString workingDirectory = simulationOptions.getWorkingDirectory();
-  QRegExp regExp("\\b(mat|plt|csv)\\b");
+  QRegExp regExp("\\b(mat|plt|csv|col)\\b");
   bool resultFileKnown = regExp.indexIn(simulationOptions.getFullResultFileName()) != -1;
   // read the result file
   QFileInfo resultFileInfo(QString(workingDirectory).append("/").append(simulationOptions.getFullResultFileName()));
@@ -400,7 +400,7 @@ bool TVariableTreeProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex
       if (pTVariablesTreeItem)
       {
         QString variableName = pTVariablesTreeItem->getVariableName();
-        variableName.remove(QRegExp("(\\.mat|\\.plt|\\.csv|_res.mat|_res.plt|_res.csv)"));
+        variableName.remove(QRegExp("(\\.mat|\\.plt|\\.csv|\\.col|_res.mat|_res.plt|_res.csv|_res.col)"));
         return variableName.contains(filterRegExp());
       }
       else
@@ -56,7 +56,7 @@ QString Helper::xmlFileTypes = "XML Files (*.xml)";
 QString Helper::infoXmlFileTypes = "OM Info Files (*_info.json)";
 QString Helper::matFileTypes = "MAT Files (*.mat)";
 QString Helper::csvFileTypes = "CSV Files (*.csv)";
-QString Helper::omResultFileTypes = "OpenModelica Result Files (*.mat *.plt *.csv)";
+QString Helper::omResultFileTypes = "OpenModelica Result Files (*.mat *.plt *.csv *.col)";
 #ifdef WIN32
 QString Helper::exeFileTypes = "EXE Files (*.exe)";
 #else
@@ -75,7 +75,7 @@ QString Helper::modelicaFileFormat = "text/uri-list";
 QString Helper::busConnectorFormat = "bus/connector";
 qreal Helper::shapesStrokeWidth = 2.0;
 int Helper::headingFontSize = 18;
-QString Helper::ModelicaSimulationOutputFormats = "mat,plt,csv";
+QString Helper::ModelicaSimulationOutputFormats = "mat,plt,csv,col";
 QString Helper::clockOptions = ",RT,CYC,CPU";
 QString Helper::notificationLevel = ".OpenModelica.Scripting.ErrorLevel.notification";
 QString Helper::warningLevel = ".OpenModelica.Scripting.ErrorLevel.warning";
@@ -254,6 +254,18 @@ void PlotWindow::getStartStopTime(double &start, double &stop){
 
     // close the file
     omc_free_matlab4_reader(&reader);
+  }
+  //PLOT COL
+  else if(mFile.fileName().endsWith("col"))
+  {
+    ModelicaColReader reader;
+    const char *msg = "";
+    if(0 != (msg = omc_new_col_reader(mFile.fileName().toStdString().c_str(), &reader))) {
+      throw PlotException(msg);
+    }
+    start = omc_col_startTime(&reader);
+    stop = omc_col_stopTime(&reader);
+    omc_free_col_reader(&reader);
   } else {throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));}
 }
 
@@ -517,6 +529,17 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
       omc_free_matlab4_reader(&reader);
       throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
     }
+    // read the values of all variables to plot in one pass over the file
+    QVector<int> varIndices;
+    for (int i = 0; i < reader.nall; i++) {
+      if (!reader.allInfo[i].isParam && (mVariablesList.contains(reader.allInfo[i].name) or getPlotType() == PlotWindow::PLOTALL)) {
+        varIndices.append(reader.allInfo[i].index);
+      }
+    }
+    if (omc_matlab4_read_vars(&reader, varIndices.data(), varIndices.size())) {
+      omc_free_matlab4_reader(&reader);
+      throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
+    }
     // read in all values
     for (int i = 0; i < reader.nall; i++) {
       if (mVariablesList.contains(reader.allInfo[i].name) or getPlotType() == PlotWindow::PLOTALL) {
@@ -574,6 +597,63 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
     // close the file
     omc_free_matlab4_reader(&reader);
   }
+  //PLOT COL
+  else if(mFile.fileName().endsWith("col"))
+  {
+    ModelicaColReader reader;
+    const char *msg = "";
+    QStringList variablesPlotted;
+
+    if(0 != (msg = omc_new_col_reader(mFile.fileName().toStdString().c_str(), &reader))) {
+      throw PlotException(msg);
+    }
+    double startTime = omc_col_startTime(&reader);
+    double stopTime = omc_col_stopTime(&reader);
+    // only the columns of the plotted variables are decoded
+    double *timeVals = omc_col_read_vals(&reader, 1);
+    if (!timeVals) {
+      omc_free_col_reader(&reader);
+      throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
+    }
+    for (uint32_t i = 0; i < reader.nall; i++) {
+      ModelicaMatVariable_t *var = &reader.allInfo[i];
+      if (!mVariablesList.contains(var->name) && getPlotType() != PlotWindow::PLOTALL) {
+        continue;
+      }
+      variablesPlotted.append(var->name);
+      if (!editCase) {
+        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), var->name, "time", var->name, getUnit(), getDisplayUnit(), mpPlot);
+        mpPlot->addPlotCurve(pPlotCurve);
+      }
+      pPlotCurve->clearXAxisVector();
+      pPlotCurve->clearYAxisVector();
+      if (!var->isParam) {
+        double *vals = omc_col_read_vals(&reader, var->index);
+        if (!vals) {
+          omc_free_col_reader(&reader);
+          throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
+        }
+        for (uint32_t j = 0; j < reader.nrows; j++) {
+          pPlotCurve->addXAxisValue(timeVals[j]);
+          pPlotCurve->addYAxisValue(vals[j]);
+        }
+      } else {
+        double val;
+        omc_col_val(&val, &reader, var, 0.0);
+        pPlotCurve->addXAxisValue(startTime);
+        pPlotCurve->addYAxisValue(val);
+        pPlotCurve->addXAxisValue(stopTime);
+        pPlotCurve->addYAxisValue(val);
+      }
+      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+      pPlotCurve->attach(mpPlot);
+      mpPlot->replot();
+    }
+    // if plottype is PLOT then check which requested variables are not found in the file
+    if (getPlotType() == PlotWindow::PLOT)
+      checkForErrors(mVariablesList, variablesPlotted);
+    omc_free_col_reader(&reader);
+  }
 }
 
 void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
@@ -817,6 +897,49 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       mpPlot->replot();
       omc_free_matlab4_reader(&reader);
     }
+    //PLOT COL
+    else if(mFile.fileName().endsWith("col"))
+    {
+      ModelicaColReader reader;
+      ModelicaMatVariable_t *xVar, *yVar;
+      const char *msg = "";
+
+      if(0 != (msg = omc_new_col_reader(mFile.fileName().toStdString().c_str(), &reader)))
+        throw PlotException(msg);
+
+      xVar = omc_col_find_var(&reader, xVariable.toStdString().c_str());
+      yVar = omc_col_find_var(&reader, yVariable.toStdString().c_str());
+      if (!xVar || !yVar) {
+        omc_free_col_reader(&reader);
+        throw NoVariableException(QString("Variable doesn't exist : ").append(xVar ? yVariable : xVariable).toStdString().c_str());
+      }
+      double xParam, yParam;
+      double *xVals = xVar->isParam ? NULL : omc_col_read_vals(&reader, xVar->index);
+      double *yVals = yVar->isParam ? NULL : omc_col_read_vals(&reader, yVar->index);
+      if ((!xVar->isParam && !xVals) || (!yVar->isParam && !yVals)) {
+        omc_free_col_reader(&reader);
+        throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
+      }
+      omc_col_val(&xParam, &reader, xVar, 0.0);
+      omc_col_val(&yParam, &reader, yVar, 0.0);
+
+      if (!editCase) {
+        pPlotCurve = new PlotCurve(QFileInfo(mFile).fileName(), yVariable + " vs " + xVariable, xVariable, yVariable, getUnit(), getDisplayUnit(), mpPlot);
+        pPlotCurve->setXVariable(xVariable);
+        pPlotCurve->setYVariable(yVariable);
+        mpPlot->addPlotCurve(pPlotCurve);
+      }
+      pPlotCurve->clearXAxisVector();
+      pPlotCurve->clearYAxisVector();
+      for (uint32_t i = 0 ; i < reader.nrows ; i++) {
+        pPlotCurve->addXAxisValue(xVals ? xVals[i] : xParam);
+        pPlotCurve->addYAxisValue(yVals ? yVals[i] : yParam);
+      }
+      pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+      pPlotCurve->attach(mpPlot);
+      mpPlot->replot();
+      omc_free_col_reader(&reader);
+    }
   }
 }
 
@@ -2199,5 +2322,6 @@ void SetupDialog::applySetup()
 }
 
 #include "util/read_matlab4.c"
+#include "util/read_col.c"
 #include "util/libcsv.c"
 #include "util/read_csv.c"
@@ -48,6 +48,7 @@
 #endif
 #include <stdexcept>
 #include "util/read_matlab4.h"
+#include "util/read_col.h"
 #include "util/read_csv.h"
 #include "OMPlot.h"
 
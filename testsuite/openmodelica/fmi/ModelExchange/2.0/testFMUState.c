@@ -0,0 +1,177 @@
+/* Co-simulation master for testFMUState.mos.
+ *
+ * usage: testFMUState <unzipped fmu directory> <model name> <number of reals>
+ *
+ * Steps the FMU, takes a snapshot with fmi2GetFMUstate, steps on, restores
+ * the snapshot with fmi2SetFMUstate and repeats the steps. The same is done
+ * with a snapshot that went through fmi2SerializeFMUstate and
+ * fmi2DeSerializeFMUstate. All Real variables must match bit by bit.
+ */
+
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmi2FunctionTypes.h"
+
+#define MAX_REALS 64
+#define STEP_SIZE 0.01
+
+static fmi2GetFMUstateTYPE *getFMUstate;
+static fmi2SetFMUstateTYPE *setFMUstate;
+static fmi2FreeFMUstateTYPE *freeFMUstate;
+static fmi2SerializedFMUstateSizeTYPE *serializedFMUstateSize;
+static fmi2SerializeFMUstateTYPE *serializeFMUstate;
+static fmi2DeSerializeFMUstateTYPE *deSerializeFMUstate;
+static fmi2GetRealTYPE *getReal;
+static fmi2DoStepTYPE *doStep;
+
+static fmi2ValueReference vr[MAX_REALS];
+static size_t nReals;
+
+static void logger(fmi2ComponentEnvironment env, fmi2String instanceName, fmi2Status status, fmi2String category, fmi2String message, ...)
+{
+  /* the checks below report everything that is needed */
+}
+
+static void* loadFunction(void *handle, const char *name)
+{
+  void *f = dlsym(handle, name);
+  if (!f) {
+    printf("function %s not found\n", name);
+    exit(1);
+  }
+  return f;
+}
+
+/* reads the guid from modelDescription.xml */
+static void readGuid(const char *dir, char *guid, size_t size)
+{
+  char fileName[4096], line[4096];
+  char *begin, *end;
+  FILE *file;
+
+  snprintf(fileName, sizeof(fileName), "%s/modelDescription.xml", dir);
+  file = fopen(fileName, "r");
+  if (!file) {
+    printf("cannot open %s\n", fileName);
+    exit(1);
+  }
+  guid[0] = '\0';
+  while (fgets(line, sizeof(line), file)) {
+    begin = strstr(line, "guid=\"");
+    if (begin) {
+      begin += 6;
+      end = strchr(begin, '"');
+      if (end && (size_t)(end - begin) < size) {
+        memcpy(guid, begin, end - begin);
+        guid[end - begin] = '\0';
+      }
+      break;
+    }
+  }
+  fclose(file);
+}
+
+/* steps from communication point first to last and returns the Real variables */
+static void simulate(fmi2Component c, int first, int last, fmi2Real *values)
+{
+  int i;
+  for (i = first; i < last; i++) {
+    if (doStep(c, i * STEP_SIZE, STEP_SIZE, fmi2True) != fmi2OK) {
+      printf("fmi2DoStep failed at %g\n", i * STEP_SIZE);
+      exit(1);
+    }
+  }
+  getReal(c, vr, nReals, values);
+}
+
+static void check(const char *what, const fmi2Real *expected, const fmi2Real *actual)
+{
+  printf("%s: %s\n", what, memcmp(expected, actual, nReals * sizeof(fmi2Real)) ? "different" : "equal");
+}
+
+int main(int argc, char **argv)
+{
+  char library[4096], resources[4096], guid[256];
+  fmi2CallbackFunctions callbacks = {logger, calloc, free, NULL, NULL};
+  fmi2Real snapshot[MAX_REALS], reference[MAX_REALS], values[MAX_REALS];
+  fmi2FMUstate state = NULL, copy = NULL;
+  fmi2Byte *buffer;
+  size_t size, i;
+  fmi2Component c;
+  void *handle;
+
+  if (argc != 4) {
+    printf("usage: %s <fmu directory> <model name> <number of reals>\n", argv[0]);
+    return 1;
+  }
+  nReals = (size_t)atoi(argv[3]);
+  if (nReals > MAX_REALS) {
+    nReals = MAX_REALS;
+  }
+  for (i = 0; i < nReals; i++) {
+    vr[i] = (fmi2ValueReference)i;
+  }
+
+  snprintf(library, sizeof(library), "%s/binaries/linux64/%s.so", argv[1], argv[2]);
+  snprintf(resources, sizeof(resources), "file://%s/resources", argv[1]);
+  readGuid(argv[1], guid, sizeof(guid));
+
+  handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+  if (!handle) {
+    printf("cannot load %s\n", library);
+    return 1;
+  }
+  getFMUstate = (fmi2GetFMUstateTYPE*)loadFunction(handle, "fmi2GetFMUstate");
+  setFMUstate = (fmi2SetFMUstateTYPE*)loadFunction(handle, "fmi2SetFMUstate");
+  freeFMUstate = (fmi2FreeFMUstateTYPE*)loadFunction(handle, "fmi2FreeFMUstate");
+  serializedFMUstateSize = (fmi2SerializedFMUstateSizeTYPE*)loadFunction(handle, "fmi2SerializedFMUstateSize");
+  serializeFMUstate = (fmi2SerializeFMUstateTYPE*)loadFunction(handle, "fmi2SerializeFMUstate");
+  deSerializeFMUstate = (fmi2DeSerializeFMUstateTYPE*)loadFunction(handle, "fmi2DeSerializeFMUstate");
+  getReal = (fmi2GetRealTYPE*)loadFunction(handle, "fmi2GetReal");
+  doStep = (fmi2DoStepTYPE*)loadFunction(handle, "fmi2DoStep");
+
+  c = ((fmi2InstantiateTYPE*)loadFunction(handle, "fmi2Instantiate"))(argv[2], fmi2CoSimulation, guid, resources, &callbacks, fmi2False, fmi2False);
+  if (!c) {
+    printf("fmi2Instantiate failed\n");
+    return 1;
+  }
+  ((fmi2SetupExperimentTYPE*)loadFunction(handle, "fmi2SetupExperiment"))(c, fmi2False, 0.0, 0.0, fmi2True, 1.0);
+  ((fmi2EnterInitializationModeTYPE*)loadFunction(handle, "fmi2EnterInitializationMode"))(c);
+  ((fmi2ExitInitializationModeTYPE*)loadFunction(handle, "fmi2ExitInitializationMode"))(c);
+
+  /* get -> step -> set -> step */
+  simulate(c, 0, 30, snapshot);
+  printf("fmi2GetFMUstate: %s\n", getFMUstate(c, &state) == fmi2OK ? "ok" : "failed");
+  simulate(c, 30, 80, reference);
+  printf("fmi2SetFMUstate: %s\n", setFMUstate(c, state) == fmi2OK ? "ok" : "failed");
+  getReal(c, vr, nReals, values);
+  check("restored state", snapshot, values);
+  simulate(c, 30, 80, values);
+  check("steps after restore", reference, values);
+
+  /* serialize -> deserialize -> set -> step */
+  printf("fmi2SerializedFMUstateSize: %s\n", serializedFMUstateSize(c, state, &size) == fmi2OK && size > 0 ? "ok" : "failed");
+  buffer = (fmi2Byte*)malloc(size);
+  printf("fmi2SerializeFMUstate: %s\n", serializeFMUstate(c, state, buffer, size) == fmi2OK ? "ok" : "failed");
+  freeFMUstate(c, &state);
+  printf("fmi2DeSerializeFMUstate: %s\n", deSerializeFMUstate(c, buffer, size, &copy) == fmi2OK ? "ok" : "failed");
+  printf("fmi2SetFMUstate: %s\n", setFMUstate(c, copy) == fmi2OK ? "ok" : "failed");
+  getReal(c, vr, nReals, values);
+  check("deserialized state", snapshot, values);
+  simulate(c, 30, 80, values);
+  check("steps after deserialize", reference, values);
+  freeFMUstate(c, &copy);
+
+  /* a truncated state must be rejected */
+  printf("truncated state: %s\n", deSerializeFMUstate(c, buffer, size / 2, &copy) == fmi2OK ? "accepted" : "rejected");
+  free(buffer);
+
+  ((fmi2TerminateTYPE*)loadFunction(handle, "fmi2Terminate"))(c);
+  ((fmi2FreeInstanceTYPE*)loadFunction(handle, "fmi2FreeInstance"))(c);
+  dlclose(handle);
+  return 0;
+}
@@ -0,0 +1,166 @@
+/* Checker for testLinearizeMat.mos.
+ *
+ * usage: testLinearizeMat <linear model .mat file> <linear model .mo file>
+ *
+ * Reads the operating point x0 and the sparse matrices A, B, C and D written
+ * with -l_format=mat, formats them like the Modelica linear model and
+ * compares them with the text written by the default -l_format=modelica.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  uint32_t type;
+  uint32_t mrows;
+  uint32_t ncols;
+  uint32_t imagf;
+  uint32_t namelen;
+} MHeader_t;
+
+/* reads the matrix with the given name; returns the number of doubles in *data */
+static size_t readMatrix(FILE *file, const char *name, MHeader_t *hdr, double **data)
+{
+  char matName[256];
+  size_t n;
+  rewind(file);
+  while (1 == fread(hdr, sizeof(MHeader_t), 1, file)) {
+    if (hdr->namelen > sizeof(matName) || 1 != fread(matName, hdr->namelen, 1, file)) {
+      break;
+    }
+    n = (size_t)hdr->mrows * hdr->ncols;
+    if (0 == strcmp(matName, name)) {
+      *data = (double*) malloc((n ? n : 1) * sizeof(double));
+      if (n && 1 != fread(*data, n * sizeof(double), 1, file)) {
+        break;
+      }
+      return n;
+    }
+    fseek(file, (long)(n * sizeof(double)), SEEK_CUR);
+  }
+  printf("%s: not found\n", name);
+  exit(1);
+}
+
+static void append(char *str, const char *fmt, double value)
+{
+  sprintf(str + strlen(str), fmt, value);
+}
+
+/* formats a dense, column major matrix like array2string in linearize.cpp */
+static void formatMatrix(char *str, const double *dense, int rows, int cols)
+{
+  int i, j;
+  str[0] = '\0';
+  for (i = 0; i < rows; i++) {
+    for (j = 0; j < cols; j++) {
+      append(str, j + 1 < cols ? "%.16g, " : "%.16g", dense[i + j*rows]);
+    }
+    if (i + 1 != rows && cols != 0) {
+      strcat(str, "; ");
+    }
+  }
+}
+
+/* returns the text after "<name>[...] = " up to the end of the line, without ';' */
+static void findText(const char *text, const char *name, char *str)
+{
+  char pattern[32];
+  const char *begin, *end;
+  sprintf(pattern, "Real %s[", name);
+  begin = strstr(text, pattern);
+  if (!begin || !(begin = strstr(begin, "] = "))) {
+    printf("%s: not found in the text model\n", name);
+    exit(1);
+  }
+  begin += 4;
+  end = strchr(begin, '\n');
+  if (!end) {
+    end = begin + strlen(begin);
+  }
+  if (end > begin && end[-1] == ';') {
+    end--;
+  }
+  memcpy(str, begin, end - begin);
+  str[end - begin] = '\0';
+}
+
+static void check(const char *name, const char *expected, const char *actual, size_t nnz)
+{
+  if (nnz == (size_t)-1) {
+    printf("%s: %s\n", name, strcmp(expected, actual) ? "different" : "equal");
+  } else {
+    printf("%s: %d nonzeros, %s\n", name, (int)nnz, strcmp(expected, actual) ? "different" : "equal");
+  }
+  if (strcmp(expected, actual)) {
+    printf("  mat:  %s\n  text: %s\n", actual, expected);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const char *names[4] = {"A", "B", "C", "D"};
+  static char text[65536], expected[8192], actual[8192];
+  MHeader_t hdr;
+  double *data, *dense;
+  size_t n, nnz, k;
+  int i, rows, cols;
+  FILE *file;
+
+  if (argc != 3) {
+    printf("usage: %s <linear model .mat file> <linear model .mo file>\n", argv[0]);
+    return 1;
+  }
+  file = fopen(argv[2], "r");
+  if (!file) {
+    printf("cannot open %s\n", argv[2]);
+    return 1;
+  }
+  text[fread(text, 1, sizeof(text) - 1, file)] = '\0';
+  fclose(file);
+  file = fopen(argv[1], "rb");
+  if (!file) {
+    printf("cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  /* the operating point is a full column vector */
+  n = readMatrix(file, "x0", &hdr, &data);
+  strcpy(actual, "{");
+  formatMatrix(actual + 1, data, 1, (int)n);
+  strcat(actual, "}");
+  findText(text, "x0", expected);
+  check("x0", expected, actual, (size_t)-1);
+  free(data);
+
+  /* the matrices are (nnz+1) x 3 triplets, the last row holds the dimensions */
+  for (i = 0; i < 4; i++) {
+    readMatrix(file, names[i], &hdr, &data);
+    if (hdr.type % 10 != 2 || hdr.ncols != 3) {
+      printf("%s: not a sparse matrix\n", names[i]);
+      return 1;
+    }
+    nnz = hdr.mrows - 1;
+    rows = (int)data[nnz];
+    cols = (int)data[2*nnz + 1];
+    dense = (double*) calloc(rows*cols + 1, sizeof(double));
+    for (k = 0; k < nnz; k++) {
+      dense[(int)data[k] - 1 + ((int)data[nnz + 1 + k] - 1)*rows] = data[2*(nnz + 1) + k];
+    }
+    if (rows*cols == 0) {
+      sprintf(actual, "zeros(%c, %c)", "nnqq"[i], "npnp"[i]);
+    } else {
+      strcpy(actual, "[");
+      formatMatrix(actual + 1, dense, rows, cols);
+      strcat(actual, "]");
+    }
+    findText(text, names[i], expected);
+    check(names[i], expected, actual, nnz);
+    free(dense);
+    free(data);
+  }
+  fclose(file);
+  return 0;
+}